@@ -0,0 +1,214 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE BC1Tests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/bc1.h"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+const int width = 64;
+const int height = 32;
+const size_t rgbaBytesPerLine = 4 * width;
+
+std::vector<uint8_t> makeGradient(const int w, const int h)
+{
+    std::vector<uint8_t> pixels(size_t(w) * h * 4);
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            auto p = &pixels[4 * (size_t(y) * w + x)];
+            p[0] = uint8_t(255 * x / (w - 1));
+            p[1] = uint8_t(255 * y / (h - 1));
+            p[2] = 128;
+            p[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+double computePSNR(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b)
+{
+    double squaredError = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (i % 4 == 3)
+            continue; // alpha
+        const auto diff = double(a[i]) - double(b[i]);
+        squaredError += diff * diff;
+        ++count;
+    }
+    const auto mse = squaredError / count;
+    return mse == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+}
+
+BOOST_AUTO_TEST_CASE(compressed_size_is_one_eighth_of_rgba)
+{
+    BOOST_CHECK_EQUAL(bc1::getLevelSize(512, 512), 512 * 512 * 4 / 8);
+    BOOST_CHECK_EQUAL(bc1::getLevelSize(4, 4), 8);
+
+    // Partial blocks are padded
+    BOOST_CHECK_EQUAL(bc1::getLevelSize(1, 1), 8);
+    BOOST_CHECK_EQUAL(bc1::getLevelSize(5, 3), 16);
+}
+
+BOOST_AUTO_TEST_CASE(mipmap_level_count_and_size)
+{
+    BOOST_CHECK_EQUAL(bc1::getLevelCount(1, 1), 1);
+    BOOST_CHECK_EQUAL(bc1::getLevelCount(512, 512), 10);
+    BOOST_CHECK_EQUAL(bc1::getLevelCount(512, 100), 10);
+    BOOST_CHECK_EQUAL(bc1::getLevelCount(3, 1), 2);
+
+    // 8x8 -> 4x4 -> 2x2 -> 1x1
+    BOOST_CHECK_EQUAL(bc1::getCompressedSize(8, 8, 1), 32);
+    BOOST_CHECK_EQUAL(bc1::getCompressedSize(8, 8, 4), 32 + 8 + 8 + 8);
+}
+
+BOOST_AUTO_TEST_CASE(uniform_color_is_encoded_exactly)
+{
+    std::vector<uint8_t> pixels(4 * 4 * 4);
+    for (size_t i = 0; i < pixels.size(); i += 4)
+    {
+        pixels[i] = 255;   // 31 in 5 bits
+        pixels[i + 1] = 0; // 0 in 6 bits
+        pixels[i + 2] = 255;
+        pixels[i + 3] = 255;
+    }
+    const auto blocks =
+        bc1::encode(pixels.data(), 4, 4, 16, bc1::PixelOrder::rgba);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 8);
+
+    const auto decoded = bc1::decode(blocks.data(), 4, 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decoded.begin(), decoded.end(),
+                                  pixels.begin(), pixels.end());
+}
+
+BOOST_AUTO_TEST_CASE(two_colors_block_is_encoded_exactly)
+{
+    std::vector<uint8_t> pixels(4 * 4 * 4);
+    for (size_t i = 0; i < 16; ++i)
+    {
+        const auto white = (i % 4) < 2;
+        pixels[4 * i] = white ? 255 : 0;
+        pixels[4 * i + 1] = white ? 255 : 0;
+        pixels[4 * i + 2] = white ? 255 : 0;
+        pixels[4 * i + 3] = 255;
+    }
+    const auto blocks =
+        bc1::encode(pixels.data(), 4, 4, 16, bc1::PixelOrder::rgba);
+    const auto decoded = bc1::decode(blocks.data(), 4, 4);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decoded.begin(), decoded.end(),
+                                  pixels.begin(), pixels.end());
+}
+
+BOOST_AUTO_TEST_CASE(gradient_is_encoded_with_good_quality)
+{
+    const auto pixels = makeGradient(width, height);
+    const auto blocks = bc1::encode(pixels.data(), width, height,
+                                    rgbaBytesPerLine, bc1::PixelOrder::rgba);
+    BOOST_REQUIRE_EQUAL(blocks.size(), bc1::getLevelSize(width, height));
+
+    const auto decoded = bc1::decode(blocks.data(), width, height);
+    BOOST_CHECK_GT(computePSNR(pixels, decoded), 35.0);
+}
+
+BOOST_AUTO_TEST_CASE(bgra_input_is_swizzled)
+{
+    const auto rgba = makeGradient(width, height);
+    auto bgra = rgba;
+    for (size_t i = 0; i < bgra.size(); i += 4)
+        std::swap(bgra[i], bgra[i + 2]);
+
+    const auto fromRgba = bc1::encode(rgba.data(), width, height,
+                                      rgbaBytesPerLine, bc1::PixelOrder::rgba);
+    const auto fromBgra = bc1::encode(bgra.data(), width, height,
+                                      rgbaBytesPerLine, bc1::PixelOrder::bgra);
+    BOOST_CHECK(fromRgba == fromBgra);
+}
+
+BOOST_AUTO_TEST_CASE(image_with_stride_and_partial_blocks)
+{
+    const int w = 10;
+    const int h = 6;
+    const size_t stride = 4 * 16;
+    std::vector<uint8_t> pixels(stride * h, 0xAB); // padding
+    const auto gradient = makeGradient(w, h);
+    for (int y = 0; y < h; ++y)
+        std::copy_n(&gradient[4 * w * y], 4 * w, &pixels[stride * y]);
+
+    const auto blocks =
+        bc1::encode(pixels.data(), w, h, stride, bc1::PixelOrder::rgba);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 3 * 2 * 8);
+
+    const auto packed =
+        bc1::encode(gradient.data(), w, h, 4 * w, bc1::PixelOrder::rgba);
+    BOOST_CHECK(blocks == packed);
+}
+
+BOOST_AUTO_TEST_CASE(mipmaps_are_box_filtered)
+{
+    // 8x8 checkerboard of black and white pixels averages to grey
+    std::vector<uint8_t> pixels(8 * 8 * 4);
+    for (size_t i = 0; i < 64; ++i)
+    {
+        const auto white = ((i % 8) + (i / 8)) % 2 == 0;
+        pixels[4 * i] = pixels[4 * i + 1] = pixels[4 * i + 2] =
+            white ? 255 : 0;
+        pixels[4 * i + 3] = 255;
+    }
+    const auto levels = bc1::getLevelCount(8, 8);
+    const auto blocks =
+        bc1::encode(pixels.data(), 8, 8, 32, bc1::PixelOrder::rgba, levels);
+    BOOST_REQUIRE_EQUAL(blocks.size(), bc1::getCompressedSize(8, 8, levels));
+
+    const auto level1 = bc1::decode(blocks.data() + 32, 4, 4);
+    for (size_t i = 0; i < level1.size(); i += 4)
+    {
+        BOOST_CHECK_LE(std::abs(int(level1[i]) - 128), 4);
+        BOOST_CHECK_EQUAL(int(level1[i + 3]), 255);
+    }
+}
@@ -0,0 +1,125 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE BroadcastMailboxTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "network/BroadcastMailbox.h"
+
+#include "MinimalGlobalQtApp.h"
+
+BOOST_GLOBAL_FIXTURE(MinimalGlobalQtApp);
+
+namespace
+{
+const auto longInterval = std::chrono::milliseconds{1000};
+
+struct Fixture
+{
+    std::vector<std::pair<MessageType, std::string>> sent;
+    size_t serializeCount = 0;
+
+    BroadcastMailbox mailbox{[this](const MessageType type,
+                                    std::string data) {
+                                 sent.emplace_back(type, std::move(data));
+                             },
+                             longInterval};
+
+    BroadcastMailbox::Serializer makeSerializer(const std::string& data)
+    {
+        return [this, data] {
+            ++serializeCount;
+            return data;
+        };
+    }
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(latest_message_of_each_type_is_sent, Fixture)
+{
+    mailbox.post(MessageType::SCENE, makeSerializer("scene1"));
+    mailbox.post(MessageType::OPTIONS, makeSerializer("options1"));
+    mailbox.post(MessageType::SCENE, makeSerializer("scene2"));
+    mailbox.post(MessageType::SCENE, makeSerializer("scene3"));
+
+    BOOST_CHECK_EQUAL(mailbox.getPendingCount(), 2);
+    BOOST_CHECK(sent.empty());
+
+    mailbox.flush();
+
+    BOOST_REQUIRE_EQUAL(sent.size(), 2);
+    BOOST_CHECK(sent[0].first == MessageType::SCENE);
+    BOOST_CHECK_EQUAL(sent[0].second, "scene3");
+    BOOST_CHECK(sent[1].first == MessageType::OPTIONS);
+    BOOST_CHECK_EQUAL(sent[1].second, "options1");
+    BOOST_CHECK_EQUAL(mailbox.getPendingCount(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(dropped_messages_are_never_serialized, Fixture)
+{
+    mailbox.post(MessageType::MARKERS, makeSerializer("m1"));
+    mailbox.post(MessageType::MARKERS, makeSerializer("m2"));
+    BOOST_CHECK_EQUAL(serializeCount, 0);
+
+    mailbox.flush();
+    BOOST_CHECK_EQUAL(serializeCount, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(count_dropped_messages, Fixture)
+{
+    mailbox.post(MessageType::SCENE, makeSerializer("s1"));
+    mailbox.post(MessageType::SCENE, makeSerializer("s2"));
+    mailbox.post(MessageType::LOCK, makeSerializer("l1"));
+    mailbox.post(MessageType::SCENE, makeSerializer("s3"));
+    mailbox.flush();
+    mailbox.post(MessageType::LOCK, makeSerializer("l2"));
+    mailbox.post(MessageType::LOCK, makeSerializer("l3"));
+
+    BOOST_CHECK_EQUAL(mailbox.getDroppedCount(MessageType::SCENE), 2);
+    BOOST_CHECK_EQUAL(mailbox.getDroppedCount(MessageType::LOCK), 1);
+    BOOST_CHECK_EQUAL(mailbox.getDroppedCount(MessageType::MARKERS), 0);
+    BOOST_CHECK_EQUAL(mailbox.getDroppedCount(), 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(flush_with_no_pending_message_sends_nothing, Fixture)
+{
+    mailbox.flush();
+    BOOST_CHECK(sent.empty());
+}
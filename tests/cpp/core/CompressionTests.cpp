@@ -0,0 +1,175 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE CompressionTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/Compression.h"
+
+namespace
+{
+QByteArray makeCompressibleData()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i)
+        data.append(QByteArray::number(i % 100)).append(' ');
+    return data;
+}
+
+// Several blocks of each codec once compressed
+QByteArray makeRandomDigits()
+{
+    QByteArray data;
+    uint32_t value = 1;
+    for (int i = 0; i < 300000; ++i)
+    {
+        value = value * 1103515245u + 12345u;
+        data.append(char('0' + (value >> 16) % 10));
+    }
+    return data;
+}
+
+std::vector<Codec> availableCodecs()
+{
+    std::vector<Codec> codecs;
+    for (auto codec : {Codec::none, Codec::lz4, Codec::zstd})
+    {
+        if (compression::isAvailable(codec))
+            codecs.push_back(codec);
+    }
+    return codecs;
+}
+}
+
+BOOST_AUTO_TEST_CASE(no_compression_is_always_available)
+{
+    BOOST_CHECK(compression::isAvailable(Codec::none));
+}
+
+BOOST_AUTO_TEST_CASE(compress_and_decompress_data)
+{
+    const auto data = makeCompressibleData();
+
+    for (auto codec : availableCodecs())
+    {
+        const auto compressed =
+            compression::compress(codec, data.constData(), data.size());
+        if (codec != Codec::none)
+            BOOST_CHECK_LT(compressed.size(), data.size());
+
+        QByteArray decompressed(data.size(), Qt::Uninitialized);
+        compression::decompress(codec, compressed.constData(),
+                                compressed.size(), decompressed.data(),
+                                decompressed.size());
+        BOOST_CHECK(decompressed == data);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(decompress_with_wrong_size_throws)
+{
+    const auto data = makeCompressibleData();
+
+    for (auto codec : availableCodecs())
+    {
+        const auto compressed =
+            compression::compress(codec, data.constData(), data.size());
+
+        QByteArray decompressed(data.size() - 1, Qt::Uninitialized);
+        BOOST_CHECK_THROW(compression::decompress(codec, compressed.constData(),
+                                                  compressed.size(),
+                                                  decompressed.data(),
+                                                  decompressed.size()),
+                          std::runtime_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(decompress_data_while_it_is_received)
+{
+    const auto data = makeRandomDigits();
+
+    for (auto codec : availableCodecs())
+    {
+        const auto compressed =
+            compression::compress(codec, data.constData(), data.size());
+
+        QByteArray decompressed(data.size(), Qt::Uninitialized);
+        compression::Decompressor decompressor{codec, compressed.constData(),
+                                               size_t(compressed.size()),
+                                               decompressed.data(),
+                                               size_t(decompressed.size())};
+        const auto firstHalf = decompressor.update(compressed.size() / 2);
+        BOOST_CHECK_GT(firstHalf, 0);
+        BOOST_CHECK_LT(firstHalf, data.size());
+        BOOST_CHECK(decompressed.left(firstHalf) == data.left(firstHalf));
+
+        BOOST_CHECK_EQUAL(decompressor.update(compressed.size()), data.size());
+        BOOST_CHECK(decompressed == data);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(decompress_truncated_data_throws)
+{
+    const auto data = makeRandomDigits();
+
+    for (auto codec : availableCodecs())
+    {
+        const auto compressed =
+            compression::compress(codec, data.constData(), data.size());
+
+        QByteArray decompressed(data.size(), Qt::Uninitialized);
+        BOOST_CHECK_THROW(compression::decompress(codec, compressed.constData(),
+                                                  compressed.size() - 1,
+                                                  decompressed.data(),
+                                                  decompressed.size()),
+                          std::runtime_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unavailable_codec_throws)
+{
+    for (auto codec : {Codec::lz4, Codec::zstd})
+    {
+        if (compression::isAvailable(codec))
+            continue;
+        const char data[] = "data";
+        BOOST_CHECK_THROW(compression::compress(codec, data, sizeof(data)),
+                          std::runtime_error);
+    }
+}
@@ -148,8 +148,28 @@ BOOST_AUTO_TEST_CASE(test_minimal_configuration_default_values)
 
     BOOST_CHECK_EQUAL(config.master.headless, false);
     BOOST_CHECK_EQUAL(config.master.webservicePort, 8888);
+    BOOST_CHECK_EQUAL(config.master.wallUpdateRate, 60);
 
     BOOST_CHECK_EQUAL((int)config.global.swapsync, (int)SwapSync::software);
+    BOOST_CHECK_EQUAL(config.global.broadcastSegmentSize, 0);
+    BOOST_CHECK_EQUAL(config.global.broadcastSegmentsInFlight, 4);
+    BOOST_CHECK(config.global.mpiWait.probe == WaitPolicy::backoff);
+    BOOST_CHECK(config.global.mpiWait.receiveHeader == WaitPolicy::backoff);
+    BOOST_CHECK_EQUAL(config.global.mpiCompression.threshold, 65536u);
+    BOOST_CHECK(config.global.mpiCompression.scene == Codec::none);
+    BOOST_CHECK(config.global.mpiCompression.pixelstream == Codec::none);
+    BOOST_CHECK_EQUAL(config.global.shareFramesOnHost, false);
+    BOOST_CHECK_EQUAL(config.global.tileCacheSize, 1024u);
+    BOOST_CHECK_EQUAL(config.global.tileCacheDiskSize, 10240u);
+    BOOST_CHECK_EQUAL(config.global.texturePoolSize, 256u);
+    BOOST_CHECK_EQUAL(config.global.textureCompression.image, false);
+    BOOST_CHECK_EQUAL(config.global.textureCompression.imagePyramid, false);
+    BOOST_CHECK_EQUAL(config.global.textureCompression.pdf, false);
+    BOOST_CHECK_EQUAL(config.global.textureCompression.svg, false);
+    BOOST_CHECK_EQUAL(config.global.framePacing.enabled, false);
+    BOOST_CHECK_EQUAL(config.global.framePacing.safetyMargin, 2000u);
+    BOOST_CHECK_EQUAL(config.global.framePacing.refreshRate, 0u);
+    BOOST_CHECK_EQUAL(config.global.telemetryInterval, 1000u);
 
     BOOST_CHECK_EQUAL(config.settings.infoName, QString());
     BOOST_CHECK_EQUAL(config.settings.inactivityTimeout, 60);
@@ -161,6 +181,7 @@ BOOST_AUTO_TEST_CASE(test_minimal_configuration_default_values)
     BOOST_CHECK_EQUAL(config.folders.sessions, QDir::homePath());
     BOOST_CHECK_EQUAL(config.folders.upload, QDir::tempPath());
     BOOST_CHECK_EQUAL(config.folders.tmp, QDir::tempPath());
+    BOOST_CHECK(config.folders.tileCache.isEmpty());
 
     BOOST_CHECK_EQUAL(config.webbrowser.defaultUrl, "http://www.google.com");
 
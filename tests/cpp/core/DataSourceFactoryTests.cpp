@@ -45,6 +45,7 @@
 
 #include "datasources/DataSource.h"
 #include "datasources/DataSourceFactory.h"
+#include "tools/TileCache.h"
 
 #include "DummyContent.h"
 
@@ -68,6 +69,7 @@ const std::vector<ContentType> contentTypes
 #endif
         ContentType::pixel_stream, ContentType::svg, ContentType::image
 };
+const size_t cacheSize = 16 * 1024 * 1024;
 const std::vector<ContentType> unsupportedContentTypes{
     ContentType::invalid, ContentType::dynamic_texture};
 
@@ -81,12 +83,13 @@ ContentPtr make_dummy_content(const ContentType type)
 
 BOOST_AUTO_TEST_CASE(datasources_handle_files_access_problems_gracefully)
 {
+    TileCache cache{cacheSize};
     for (const auto& type : contentTypes)
     {
         auto content = make_dummy_content(type);
         try
         {
-            auto datasource = DataSourceFactory::create(*content);
+            auto datasource = DataSourceFactory::create(*content, cache);
 
             BOOST_CHECK(datasource->getTileRect(0).isEmpty());
             BOOST_CHECK(datasource->getTilesArea(0, 0).isEmpty());
@@ -106,10 +109,11 @@ BOOST_AUTO_TEST_CASE(datasources_handle_files_access_problems_gracefully)
 
 BOOST_AUTO_TEST_CASE(datasource_factory_throws_for_unsupported_contents)
 {
+    TileCache cache{cacheSize};
     for (const auto& type : unsupportedContentTypes)
     {
         auto content = make_dummy_content(type);
-        BOOST_CHECK_THROW(DataSourceFactory::create(*content),
+        BOOST_CHECK_THROW(DataSourceFactory::create(*content, cache),
                           std::logic_error);
     }
 }
@@ -0,0 +1,197 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE DiskTileCacheTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/DiskTileCache.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+namespace
+{
+const uint32_t width = 16;
+const uint32_t height = 8;
+const DiskTileCache::RasterInfo info{width, height, width * 4, 5};
+const size_t dataSize = width * 4 * height;
+const size_t fileSize = 64 + dataSize; // header + short key, aligned
+
+std::vector<uint8_t> makeData(const uint8_t value)
+{
+    return std::vector<uint8_t>(dataSize, value);
+}
+
+std::vector<std::string> listFiles(const std::string& directory)
+{
+    std::vector<std::string> files;
+    auto dir = ::opendir(directory.c_str());
+    while (const auto entry = ::readdir(dir))
+    {
+        const auto name = std::string{entry->d_name};
+        if (name != "." && name != "..")
+            files.push_back(directory + "/" + name);
+    }
+    ::closedir(dir);
+    return files;
+}
+
+void waitForNextTimestamp()
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+}
+
+struct Fixture
+{
+    std::string directory;
+
+    Fixture()
+    {
+        char tmpl[] = "/tmp/tideDiskTileCacheXXXXXX";
+        directory = ::mkdtemp(tmpl);
+    }
+
+    ~Fixture()
+    {
+        for (const auto& file : listFiles(directory))
+            ::unlink(file.c_str());
+        ::rmdir(directory.c_str());
+    }
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(store_and_load_raster, Fixture)
+{
+    DiskTileCache cache{directory, 1024 * 1024};
+    BOOST_CHECK(!cache.load("tile"));
+
+    const auto data = makeData(42);
+    BOOST_REQUIRE(cache.store("tile", info, data.data()));
+
+    const auto raster = cache.load("tile");
+    BOOST_REQUIRE(raster);
+    BOOST_CHECK_EQUAL(raster->getInfo().width, width);
+    BOOST_CHECK_EQUAL(raster->getInfo().height, height);
+    BOOST_CHECK_EQUAL(raster->getInfo().bytesPerLine, width * 4);
+    BOOST_CHECK_EQUAL(raster->getInfo().format, 5);
+    BOOST_CHECK_EQUAL_COLLECTIONS(raster->getData(),
+                                  raster->getData() + dataSize, data.begin(),
+                                  data.end());
+    BOOST_CHECK_EQUAL(cache.getSize(), fileSize);
+
+    const auto stats = cache.getStats();
+    BOOST_CHECK_EQUAL(stats.hits, 1);
+    BOOST_CHECK_EQUAL(stats.misses, 1);
+    BOOST_CHECK_EQUAL(stats.writes, 1);
+    BOOST_CHECK_EQUAL(stats.evictions, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(cache_persists_and_is_shared_between_instances,
+                        Fixture)
+{
+    const auto data = makeData(7);
+    {
+        DiskTileCache cache{directory, 1024 * 1024};
+        BOOST_REQUIRE(cache.store("tile", info, data.data()));
+    }
+    DiskTileCache cache{directory, 1024 * 1024};
+    BOOST_CHECK_EQUAL(cache.getSize(), fileSize);
+
+    DiskTileCache otherProcessCache{directory, 1024 * 1024};
+    const auto raster = otherProcessCache.load("tile");
+    BOOST_REQUIRE(raster);
+    BOOST_CHECK_EQUAL(raster->getData()[dataSize - 1], 7);
+}
+
+BOOST_FIXTURE_TEST_CASE(truncated_files_are_ignored, Fixture)
+{
+    DiskTileCache cache{directory, 1024 * 1024};
+    const auto data = makeData(1);
+    BOOST_REQUIRE(cache.store("tile", info, data.data()));
+
+    const auto files = listFiles(directory);
+    BOOST_REQUIRE_EQUAL(files.size(), 1);
+    BOOST_REQUIRE_EQUAL(::truncate(files[0].c_str(), fileSize / 2), 0);
+
+    BOOST_CHECK(!cache.load("tile"));
+}
+
+BOOST_FIXTURE_TEST_CASE(least_recently_used_files_are_deleted, Fixture)
+{
+    DiskTileCache cache{directory, 3 * fileSize + fileSize / 2};
+    const auto data = makeData(0);
+
+    BOOST_REQUIRE(cache.store("a", info, data.data()));
+    waitForNextTimestamp();
+    BOOST_REQUIRE(cache.store("b", info, data.data()));
+    waitForNextTimestamp();
+    BOOST_REQUIRE(cache.store("c", info, data.data()));
+    waitForNextTimestamp();
+    const auto raster = cache.load("a");
+    BOOST_REQUIRE(raster);
+    waitForNextTimestamp();
+    BOOST_REQUIRE(cache.store("d", info, data.data()));
+
+    BOOST_CHECK_EQUAL(cache.getStats().evictions, 1);
+    BOOST_CHECK_EQUAL(cache.getSize(), 3 * fileSize);
+    BOOST_CHECK(cache.load("a"));
+    BOOST_CHECK(!cache.load("b"));
+    BOOST_CHECK(cache.load("c"));
+    BOOST_CHECK(cache.load("d"));
+
+    // Mapped rasters remain valid after their file is deleted
+    cache.cleanup();
+    for (const auto& file : listFiles(directory))
+        ::unlink(file.c_str());
+    BOOST_CHECK_EQUAL(raster->getData()[0], 0);
+    cache.cleanup();
+    BOOST_CHECK_EQUAL(cache.getSize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_directory_throws)
+{
+    BOOST_CHECK_THROW(DiskTileCache("/proc/tideDiskTileCache", 1024),
+                      std::runtime_error);
+}
@@ -0,0 +1,142 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FFMPEGPictureTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/FFMPEGFrame.h"
+#include "data/FFMPEGPicture.h"
+
+#include <vector>
+
+namespace
+{
+const int width = 6;
+const int height = 4;
+
+uint8_t _value(const uint plane, const int x, const int y)
+{
+    return uint8_t(plane * 100 + y * 10 + x);
+}
+
+/** Fill a yuv420 frame, with the padded rows allocated by FFMPEG. */
+void _fillFrame(FFMPEGFrame& frame)
+{
+    auto& avFrame = frame.getAVFrame();
+    avFrame.format = AV_PIX_FMT_YUV420P;
+    avFrame.width = width;
+    avFrame.height = height;
+    BOOST_REQUIRE_EQUAL(av_frame_get_buffer(&avFrame, 32), 0);
+    BOOST_REQUIRE_GT(avFrame.linesize[0], width);
+
+    for (uint plane = 0; plane < 3; ++plane)
+    {
+        const auto planeWidth = plane == 0 ? width : width / 2;
+        const auto planeHeight = plane == 0 ? height : height / 2;
+        for (int y = 0; y < planeHeight; ++y)
+            for (int x = 0; x < planeWidth; ++x)
+                avFrame.data[plane][y * avFrame.linesize[plane] + x] =
+                    _value(plane, x, y);
+    }
+}
+
+void _checkPacked(const uint8_t* data, const FFMPEGPicture& picture,
+                  const uint plane)
+{
+    const auto size = picture.getTextureSize(plane);
+    for (int y = 0; y < size.height(); ++y)
+        for (int x = 0; x < size.width(); ++x)
+            BOOST_CHECK_EQUAL(data[y * size.width() + x], _value(plane, x, y));
+}
+}
+
+BOOST_AUTO_TEST_CASE(reference_frame_decoded_in_picture_format)
+{
+    FFMPEGFrame frame;
+    _fillFrame(frame);
+
+    const auto picture = FFMPEGPicture::reference(frame, TextureFormat::yuv420);
+    BOOST_REQUIRE(picture);
+    BOOST_CHECK_EQUAL(picture->getWidth(), width);
+    BOOST_CHECK_EQUAL(picture->getHeight(), height);
+    BOOST_CHECK_EQUAL(picture->getDataSize(0), size_t(width * height));
+    BOOST_CHECK_EQUAL(picture->getDataSize(1), size_t(width * height / 4));
+
+    // The picture keeps the decoded buffers alive
+    av_frame_unref(&frame.getAVFrame());
+
+    for (uint plane = 0; plane < 3; ++plane)
+    {
+        auto dest = std::vector<uint8_t>(picture->getDataSize(plane));
+        picture->writeData(plane, dest.data());
+        _checkPacked(dest.data(), *picture, plane);
+
+        const auto& image = static_cast<const FFMPEGPicture&>(*picture);
+        _checkPacked(image.getData(plane), *picture, plane);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frame_in_other_format_is_not_referenced)
+{
+    FFMPEGFrame frame;
+    _fillFrame(frame);
+
+    BOOST_CHECK(!FFMPEGPicture::reference(frame, TextureFormat::yuv444));
+    BOOST_CHECK(!FFMPEGPicture::reference(frame, TextureFormat::rgba));
+    av_frame_unref(&frame.getAVFrame());
+}
+
+BOOST_AUTO_TEST_CASE(writing_to_referenced_picture_leaves_frame_unchanged)
+{
+    FFMPEGFrame frame;
+    _fillFrame(frame);
+
+    const auto picture = FFMPEGPicture::reference(frame, TextureFormat::yuv420);
+    BOOST_REQUIRE(picture);
+    picture->getData(0)[0] = 255;
+
+    BOOST_CHECK_EQUAL(frame.getAVFrame().data[0][0], _value(0, 0, 0));
+    BOOST_CHECK_EQUAL(picture->getData(0)[1], _value(0, 1, 0));
+
+    auto dest = std::vector<uint8_t>(picture->getDataSize(0));
+    picture->writeData(0, dest.data());
+    BOOST_CHECK_EQUAL(dest[0], 255);
+    av_frame_unref(&frame.getAVFrame());
+}
@@ -0,0 +1,223 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FramePacerTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/FramePacer.h"
+
+namespace
+{
+using clock = FramePacer::clock;
+using us = std::chrono::microseconds;
+using ms = std::chrono::milliseconds;
+
+const auto t0 = clock::time_point{} + std::chrono::hours{1};
+const auto refresh60Hz = us{16667};
+const auto refreshFixed = ms{16};
+const auto margin = ms{2};
+const auto workTime = ms{5};
+
+FramePacer::Settings makeSettings(const clock::duration interval)
+{
+    FramePacer::Settings settings;
+    settings.refreshInterval = interval;
+    settings.safetyMargin = margin;
+    return settings;
+}
+
+/** @return a deterministic jitter in [-300; 300] us. */
+us jitter(const int i)
+{
+    return us{(i * 7919) % 601 - 300};
+}
+
+int64_t toUs(const clock::duration duration)
+{
+    return std::chrono::duration_cast<us>(duration).count();
+}
+
+/** @return the first refresh of the simulated display after a given time. */
+clock::time_point nextRefresh(const clock::time_point time)
+{
+    const auto periods = (time - t0 + refreshFixed - us{1}) / refreshFixed;
+    return t0 + periods * refreshFixed;
+}
+
+/** Simulate frames with a fixed work time, each swapped at a refresh. */
+clock::time_point runFrames(FramePacer& pacer, clock::time_point now,
+                            const int count, const clock::duration work)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const auto start = std::max(now, pacer.getNextFrameStart(now));
+        pacer.beginFrame(start);
+        pacer.endFrame(start + work);
+        now = nextRefresh(start + work);
+        pacer.addSwap(now);
+    }
+    return now;
+}
+}
+
+BOOST_AUTO_TEST_CASE(frames_are_not_paced_until_refresh_is_known)
+{
+    FramePacer pacer{makeSettings(clock::duration::zero())};
+    BOOST_CHECK(pacer.getRefreshInterval() == clock::duration::zero());
+    BOOST_CHECK(pacer.getNextFrameStart(t0) == t0);
+
+    pacer.addSwap(t0);
+    pacer.addSwap(t0 + refresh60Hz);
+    BOOST_CHECK(pacer.getRefreshInterval() == clock::duration::zero());
+    BOOST_CHECK(pacer.getNextFrameStart(t0 + ms{20}) == t0 + ms{20});
+    BOOST_CHECK_EQUAL(pacer.getStats().frames, 0);
+}
+
+BOOST_AUTO_TEST_CASE(refresh_interval_is_measured_from_swaps)
+{
+    FramePacer pacer{makeSettings(clock::duration::zero())};
+    for (int i = 0; i < 100; ++i)
+        pacer.addSwap(t0 + i * refresh60Hz + jitter(i));
+
+    BOOST_CHECK_LT(std::abs(toUs(pacer.getRefreshInterval() - refresh60Hz)),
+                   50);
+}
+
+BOOST_AUTO_TEST_CASE(missed_frames_and_pauses_do_not_affect_refresh_interval)
+{
+    FramePacer pacer{makeSettings(clock::duration::zero())};
+    auto vsync = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        vsync += (i % 5 == 0) ? 2 : 1; // missed frame
+        if (i == 50)
+            vsync += 60; // rendering paused for one second
+        pacer.addSwap(t0 + vsync * refresh60Hz + jitter(i));
+    }
+
+    BOOST_CHECK_LT(std::abs(toUs(pacer.getRefreshInterval() - refresh60Hz)),
+                   50);
+}
+
+BOOST_AUTO_TEST_CASE(fixed_refresh_interval_is_used_after_first_swap)
+{
+    FramePacer pacer{makeSettings(refreshFixed)};
+    pacer.addSwap(t0);
+    BOOST_CHECK(pacer.getRefreshInterval() == refreshFixed);
+
+    // No frame duration measured yet: only the safety margin is kept
+    const auto start = pacer.getNextFrameStart(t0 + ms{4});
+    BOOST_CHECK_EQUAL(toUs(start - t0), toUs(refreshFixed - margin));
+}
+
+BOOST_AUTO_TEST_CASE(frames_start_as_late_as_possible_before_deadline)
+{
+    FramePacer pacer{makeSettings(refreshFixed)};
+    pacer.addSwap(t0);
+    auto now = runFrames(pacer, t0, 10, workTime);
+
+    BOOST_CHECK(pacer.getFrameDuration() == workTime);
+    const auto stats = pacer.getStats();
+    BOOST_CHECK_EQUAL(stats.frames, 10);
+    BOOST_CHECK(stats.lastSlack == margin);
+
+    // The next frame starts one frame duration and margin before the refresh
+    const auto start = pacer.getNextFrameStart(now);
+    const auto deadline = start + workTime + margin;
+    BOOST_CHECK_EQUAL(toUs(deadline - now), toUs(refreshFixed));
+    BOOST_CHECK_EQUAL(toUs(deadline - t0) % toUs(refreshFixed), 0);
+}
+
+BOOST_AUTO_TEST_CASE(same_deadline_is_not_targeted_twice)
+{
+    FramePacer pacer{makeSettings(refreshFixed)};
+    pacer.addSwap(t0);
+    const auto now = runFrames(pacer, t0, 5, workTime);
+
+    // Frame rendered early for the next refresh, which is not swapped yet
+    const auto start = pacer.getNextFrameStart(now);
+    pacer.beginFrame(start);
+    pacer.endFrame(start + workTime);
+
+    const auto next = pacer.getNextFrameStart(start + workTime);
+    BOOST_CHECK_EQUAL(toUs(next - start), toUs(refreshFixed));
+}
+
+BOOST_AUTO_TEST_CASE(missed_deadlines_are_reported)
+{
+    FramePacer pacer{makeSettings(refreshFixed)};
+    pacer.addSwap(t0);
+    auto now = runFrames(pacer, t0, 5, workTime);
+    // Only the first frame, of unknown duration, has missed its deadline
+    BOOST_CHECK_EQUAL(pacer.getStats().missedDeadlines, 1);
+
+    // A frame longer than expected misses its deadline
+    const auto start = pacer.getNextFrameStart(now);
+    pacer.beginFrame(start);
+    now = start + ms{10};
+    pacer.endFrame(now);
+
+    auto stats = pacer.getStats();
+    BOOST_CHECK_EQUAL(stats.missedDeadlines, 2);
+    BOOST_CHECK_EQUAL(toUs(stats.lastSlack), toUs(workTime + margin - ms{10}));
+    BOOST_CHECK_LE(toUs(stats.minSlack), toUs(stats.lastSlack));
+    now = nextRefresh(now);
+    pacer.addSwap(now);
+
+    // The next frames expect the longer duration and start earlier
+    now = runFrames(pacer, now, 5, ms{10});
+    stats = pacer.getStats();
+    BOOST_CHECK_EQUAL(stats.missedDeadlines, 2);
+    BOOST_CHECK(stats.lastSlack == margin);
+}
+
+BOOST_AUTO_TEST_CASE(long_frames_target_later_refreshes)
+{
+    FramePacer pacer{makeSettings(refreshFixed)};
+    pacer.addSwap(t0);
+    const auto now = runFrames(pacer, t0, 5, ms{20});
+
+    const auto stats = pacer.getStats();
+    BOOST_CHECK(stats.lastSlack == margin);
+    const auto start = pacer.getNextFrameStart(now);
+    BOOST_CHECK(start >= now);
+    const auto deadline = start + ms{20} + margin;
+    BOOST_CHECK_EQUAL(toUs(deadline - t0) % toUs(refreshFixed), 0);
+}
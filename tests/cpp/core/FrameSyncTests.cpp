@@ -0,0 +1,158 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FrameSyncTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "network/FrameSync.h"
+#include "tools/SwapSyncObject.h"
+
+namespace
+{
+/** Simulate the exchange of the given frames between as many processes. */
+void exchange(std::vector<FrameSync>& frames)
+{
+    std::vector<uint64_t> values;
+    for (const auto& frame : frames)
+    {
+        const auto& local = frame.getLocalValues();
+        values.insert(values.end(), local.begin(), local.end());
+    }
+    for (auto& frame : frames)
+        frame.setGlobalValues(values);
+}
+}
+
+BOOST_AUTO_TEST_CASE(keys_follow_insertion_order)
+{
+    FrameSync frame;
+    BOOST_CHECK_EQUAL(frame.addVersion(7), 0);
+    BOOST_CHECK_EQUAL(frame.addFlag(true), 1);
+    BOOST_CHECK_EQUAL(frame.addValue(0.5), 2);
+    BOOST_CHECK_EQUAL(frame.getLocalValues().size(), 3);
+
+    frame.clear();
+    BOOST_CHECK(frame.getLocalValues().empty());
+    BOOST_CHECK_EQUAL(frame.addFlag(false), 0);
+}
+
+BOOST_AUTO_TEST_CASE(global_values_must_match_local_values)
+{
+    FrameSync frame;
+    frame.addVersion(1);
+    frame.addVersion(2);
+    BOOST_CHECK_THROW(frame.setGlobalValues({1, 2, 3}), std::invalid_argument);
+    BOOST_CHECK_NO_THROW(frame.setGlobalValues({1, 2, 1, 2}));
+    BOOST_CHECK_EQUAL(frame.getProcessCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(check_versions_of_all_processes)
+{
+    std::vector<FrameSync> frames(3);
+    std::vector<FrameSync::Key> same, different;
+    for (size_t rank = 0; rank < frames.size(); ++rank)
+    {
+        same.push_back(frames[rank].addVersion(42));
+        different.push_back(frames[rank].addVersion(rank == 1 ? 5 : 4));
+    }
+    exchange(frames);
+
+    for (size_t rank = 0; rank < frames.size(); ++rank)
+    {
+        BOOST_CHECK(frames[rank].checkVersion(same[rank]));
+        BOOST_CHECK(!frames[rank].checkVersion(different[rank]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(synchronize_swap_sync_object)
+{
+    std::vector<SwapSyncObject<int>> objects(2, SwapSyncObject<int>{0});
+    objects[0].update(1);
+    objects[1].update(1);
+
+    std::vector<FrameSync> frames(2);
+    std::vector<FrameSync::Key> keys;
+    for (size_t rank = 0; rank < frames.size(); ++rank)
+        keys.push_back(frames[rank].addVersion(objects[rank].getVersion()));
+    exchange(frames);
+
+    for (size_t rank = 0; rank < frames.size(); ++rank)
+    {
+        BOOST_CHECK(objects[rank].sync(frames[rank].getVersionCheck(keys[0])));
+        BOOST_CHECK_EQUAL(objects[rank].get(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(flags_and_leader_election)
+{
+    std::vector<FrameSync> frames(40);
+    for (size_t rank = 0; rank < frames.size(); ++rank)
+    {
+        frames[rank].addFlag(true);
+        frames[rank].addFlag(rank == 3 || rank == 35);
+        frames[rank].addFlag(false);
+    }
+    exchange(frames);
+
+    const auto& frame = frames[12];
+    BOOST_CHECK(frame.allTrue(0));
+    BOOST_CHECK(!frame.allTrue(1));
+    BOOST_CHECK_EQUAL(frame.getLastTrueRank(0), 39);
+    BOOST_CHECK_EQUAL(frame.getLastTrueRank(1), 35);
+    BOOST_CHECK_EQUAL(frame.getLastTrueRank(2), -1);
+}
+
+BOOST_AUTO_TEST_CASE(values_and_timestamps_of_each_process)
+{
+    const auto now = FrameSync::clock::now();
+
+    std::vector<FrameSync> frames(2);
+    frames[0].addValue(1.25);
+    frames[0].addTimestamp(now);
+    frames[1].addValue(-3.5);
+    frames[1].addTimestamp(now + std::chrono::milliseconds{5});
+    exchange(frames);
+
+    BOOST_CHECK_EQUAL(frames[1].getValue(0, 0), 1.25);
+    BOOST_CHECK_EQUAL(frames[0].getValue(0, 1), -3.5);
+    BOOST_CHECK(frames[1].getTimestamp(1, 0) == now);
+    BOOST_CHECK(frames[0].getTimestamp(1, 1) ==
+                now + std::chrono::milliseconds{5});
+}
@@ -0,0 +1,157 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE FrameWireFormatTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/FrameWireFormat.h"
+
+#include <stdexcept>
+
+namespace
+{
+deflect::server::Tile makeTile(const uint x, const QByteArray& data)
+{
+    deflect::server::Tile tile;
+    tile.x = x;
+    tile.y = 64;
+    tile.width = 32;
+    tile.height = 16;
+    tile.imageData = data;
+    tile.format = deflect::Format::jpeg;
+    tile.rowOrder = deflect::RowOrder::bottom_up;
+    tile.view = deflect::View::right_eye;
+    tile.channel = 3;
+    return tile;
+}
+
+deflect::server::Frame makeFrame()
+{
+    deflect::server::Frame frame;
+    frame.uri = "stream_é";
+    frame.tiles.push_back(makeTile(0, "Z&*#HUIRB"));
+    frame.tiles.push_back(makeTile(32, QByteArray()));
+    frame.tiles.push_back(makeTile(64, "0123456789"));
+    return frame;
+}
+
+QByteArray join(const std::vector<QByteArray>& buffers)
+{
+    QByteArray message;
+    for (const auto& buffer : buffers)
+        message.append(buffer);
+    return message;
+}
+}
+
+BOOST_AUTO_TEST_CASE(encode_references_image_data_in_place)
+{
+    const auto frame = makeFrame();
+    const auto buffers = wireformat::encode(frame);
+
+    // header followed by the non-empty tiles
+    BOOST_REQUIRE_EQUAL(buffers.size(), 3);
+    BOOST_CHECK(buffers[1].constData() == frame.tiles[0].imageData.constData());
+    BOOST_CHECK(buffers[2].constData() == frame.tiles[2].imageData.constData());
+}
+
+BOOST_AUTO_TEST_CASE(decode_restores_frame)
+{
+    const auto frame = makeFrame();
+    const auto decoded = wireformat::decode(join(wireformat::encode(frame)));
+
+    BOOST_CHECK(decoded->uri == frame.uri);
+    BOOST_REQUIRE_EQUAL(decoded->tiles.size(), frame.tiles.size());
+    for (size_t i = 0; i < frame.tiles.size(); ++i)
+    {
+        const auto& tile = frame.tiles[i];
+        const auto& decodedTile = decoded->tiles[i];
+        BOOST_CHECK_EQUAL(tile.x, decodedTile.x);
+        BOOST_CHECK_EQUAL(tile.y, decodedTile.y);
+        BOOST_CHECK_EQUAL(tile.width, decodedTile.width);
+        BOOST_CHECK_EQUAL(tile.height, decodedTile.height);
+        BOOST_CHECK(tile.format == decodedTile.format);
+        BOOST_CHECK(tile.rowOrder == decodedTile.rowOrder);
+        BOOST_CHECK(tile.view == decodedTile.view);
+        BOOST_CHECK_EQUAL(tile.channel, decodedTile.channel);
+        BOOST_CHECK_EQUAL(tile.imageData.toStdString(),
+                          decodedTile.imageData.toStdString());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(decode_wraps_message_without_copy)
+{
+    const auto frame = makeFrame();
+    const auto message = join(wireformat::encode(frame));
+    const auto decoded = wireformat::decode(message);
+
+    const auto begin = message.constData();
+    const auto end = begin + message.size();
+    for (const auto& tile : decoded->tiles)
+    {
+        if (tile.imageData.isEmpty())
+            continue;
+        BOOST_CHECK(tile.imageData.constData() >= begin);
+        BOOST_CHECK(tile.imageData.constData() + tile.imageData.size() <= end);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(decoded_frame_keeps_message_alive)
+{
+    deflect::server::FramePtr decoded;
+    {
+        auto message = join(wireformat::encode(makeFrame()));
+        decoded = wireformat::decode(message);
+        message.fill('x');
+    }
+    BOOST_CHECK_EQUAL(decoded->tiles[0].imageData.toStdString(), "Z&*#HUIRB");
+    BOOST_CHECK_EQUAL(decoded->tiles[2].imageData.toStdString(), "0123456789");
+}
+
+BOOST_AUTO_TEST_CASE(malformed_messages_are_rejected)
+{
+    const auto message = join(wireformat::encode(makeFrame()));
+
+    BOOST_CHECK_THROW(wireformat::decode(QByteArray()), std::runtime_error);
+    BOOST_CHECK_THROW(wireformat::decode(QByteArray(message.size(), 'x')),
+                      std::runtime_error);
+    BOOST_CHECK_THROW(wireformat::decode(message.left(message.size() - 1)),
+                      std::runtime_error);
+}
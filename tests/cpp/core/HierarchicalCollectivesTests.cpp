@@ -0,0 +1,199 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE HierarchicalCollectivesTests
+#include <boost/test/unit_test.hpp>
+
+#include "TransportRunner.h"
+
+#include "network/HierarchicalCollectives.h"
+#include "network/MPICommunicator.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+
+BOOST_GLOBAL_FIXTURE(MPIProcesses);
+
+namespace
+{
+using Selection = HierarchicalCollectives::Selection;
+
+// Processes on three hosts, which do not have contiguous ranks
+const std::vector<std::string> interleavedHosts{"a", "b", "c", "a",
+                                                "b", "c", "a"};
+
+std::vector<std::string> _makeHosts(const int size, const int hostCount)
+{
+    std::vector<std::string> hosts;
+    for (int rank = 0; rank < size; ++rank)
+        hosts.push_back("host" + std::to_string(rank % hostCount));
+    return hosts;
+}
+
+// Each process of the tests opens a socket to every other one
+bool _canConnectProcesses(const int size)
+{
+    const auto required = rlim_t(size * size + 64);
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_max < required)
+        return false;
+    limit.rlim_cur = std::max(limit.rlim_cur, required);
+    return ::setrlimit(RLIMIT_NOFILE, &limit) == 0;
+}
+
+void checkGatherAllOrdersValuesByRank(Transport& transport,
+                                      const Selection selection)
+{
+    const MPICommunicator communicator{transport.split(0)};
+    const HierarchicalCollectives collectives{communicator, selection};
+    const auto rank = uint64_t(communicator.getRank());
+    const auto size = uint64_t(communicator.getSize());
+
+    // Different counts of values use different layouts between the leaders
+    for (size_t count = 1; count <= 3; ++count)
+    {
+        std::vector<uint64_t> values;
+        for (size_t i = 0; i < count; ++i)
+            values.push_back(rank * 10 + i);
+
+        std::vector<uint64_t> expected;
+        for (uint64_t r = 0; r < size; ++r)
+        {
+            for (size_t i = 0; i < count; ++i)
+                expected.push_back(r * 10 + i);
+        }
+        expect(collectives.gatherAll(values) == expected,
+               "values not ordered by rank");
+    }
+}
+
+void checkElectLeader(Transport& transport, const Selection selection)
+{
+    const MPICommunicator communicator{transport.split(0)};
+    const HierarchicalCollectives collectives{communicator, selection};
+    const auto rank = communicator.getRank();
+    const auto size = communicator.getSize();
+
+    // Same as WallToWallChannel::electLeader(): the highest candidate wins
+    const auto isCandidate = [](const int r) { return r % 16 == 1; };
+    int expected = -1;
+    for (int r = 0; r < size; ++r)
+        expected = isCandidate(r) ? r : expected;
+
+    const auto leader = collectives.globalMax(isCandidate(rank) ? rank : -1);
+    expect(leader == expected, "wrong leader elected");
+    expect(collectives.globalMax(-1) == -1, "elected without candidates");
+    expect(collectives.globalSum(rank) == size * (size - 1) / 2,
+           "wrong sum");
+}
+}
+
+BOOST_AUTO_TEST_CASE(two_level_gather_orders_values_by_rank)
+{
+    runOnHosts(interleavedHosts, [](Transport& transport) {
+        const MPICommunicator communicator{transport.split(0)};
+        const HierarchicalCollectives collectives{communicator,
+                                                  Selection::hierarchical};
+        expect(collectives.isHierarchical(), "not hierarchical");
+        expect(collectives.getNodeCount() == 3, "wrong number of nodes");
+    });
+    runOnHosts(interleavedHosts, [](Transport& transport) {
+        checkGatherAllOrdersValuesByRank(transport, Selection::hierarchical);
+    });
+    runOnMPI([](Transport& transport) {
+        checkGatherAllOrdersValuesByRank(transport, Selection::hierarchical);
+    });
+}
+
+BOOST_AUTO_TEST_CASE(collectives_are_flat_with_one_node_or_one_process_per_node)
+{
+    for (const auto& hosts : {_makeHosts(4, 1), _makeHosts(4, 4)})
+    {
+        runOnHosts(hosts, [](Transport& transport) {
+            const MPICommunicator communicator{transport.split(0)};
+            const HierarchicalCollectives collectives{communicator,
+                                                      Selection::hierarchical};
+            expect(!collectives.isHierarchical(), "hierarchical");
+        });
+        runOnHosts(hosts, [](Transport& transport) {
+            checkGatherAllOrdersValuesByRank(transport,
+                                             Selection::hierarchical);
+        });
+    }
+}
+
+BOOST_AUTO_TEST_CASE(all_processes_make_the_same_measured_selection)
+{
+    runOnHosts(interleavedHosts, [](Transport& transport) {
+        const MPICommunicator communicator{transport.split(0)};
+        const HierarchicalCollectives collectives{communicator,
+                                                  Selection::measure};
+        const auto isHierarchical = collectives.isHierarchical() ? 1 : 0;
+        const auto count = communicator.globalSum(isHierarchical);
+        expect(count == 0 || count == communicator.getSize(),
+               "processes disagree on the collectives to use");
+        checkGatherAllOrdersValuesByRank(transport, Selection::measure);
+    });
+}
+
+BOOST_AUTO_TEST_CASE(elect_leader_among_more_than_31_processes)
+{
+    const int size = 36;
+    if (_canConnectProcesses(size))
+    {
+        SocketTransport::Options options;
+        options.ringSize = 0;
+        for (auto selection : {Selection::flat, Selection::hierarchical})
+        {
+            runOnHosts(_makeHosts(size, 3),
+                       [selection](Transport& transport) {
+                           checkElectLeader(transport, selection);
+                       },
+                       options);
+        }
+    }
+    else
+        BOOST_WARN_MESSAGE(false, "not enough file descriptors for "
+                                      << size << " processes, skipped");
+
+    runOnMPI([](Transport& transport) {
+        checkElectLeader(transport, Selection::hierarchical);
+    });
+}
@@ -0,0 +1,194 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE PixelStreamRouterTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "MinimalGlobalQtApp.h"
+
+#include "configuration/Configuration.h"
+#include "network/PixelStreamRouter.h"
+#include "scene/Background.h"
+#include "scene/DisplayGroup.h"
+#include "scene/PixelStreamContent.h"
+#include "scene/Scene.h"
+#include "scene/Window.h"
+
+#include <deflect/server/Frame.h>
+
+BOOST_GLOBAL_FIXTURE(MinimalGlobalQtApp);
+
+namespace
+{
+const QString streamUri("test_stream");
+const QSize streamSize(2048, 1024);
+const int tileSize = 512;
+
+using namespace std::chrono_literals;
+
+/** Two processes with a single 1000x1000 screen each, side by side. */
+Configuration makeConfig()
+{
+    Configuration config;
+    SurfaceConfig surface;
+    surface.displayWidth = 1000;
+    surface.displayHeight = 1000;
+    surface.screenCountX = 2;
+    config.surfaces.push_back(surface);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        Screen screen;
+        screen.globalIndex = QPoint(i, 0);
+        screen.position = QPoint(i * 1000, 0);
+        config.processes.push_back(Process{"localhost", {screen}});
+    }
+    return config;
+}
+
+deflect::server::Frame makeFrame()
+{
+    deflect::server::Frame frame;
+    frame.uri = streamUri;
+    for (int y = 0; y < streamSize.height(); y += tileSize)
+    {
+        for (int x = 0; x < streamSize.width(); x += tileSize)
+        {
+            deflect::server::Tile tile;
+            tile.x = x;
+            tile.y = y;
+            tile.width = tileSize;
+            tile.height = tileSize;
+            tile.imageData = QByteArray(16, 'x');
+            frame.tiles.push_back(tile);
+        }
+    }
+    return frame;
+}
+
+std::vector<uint> tilesWithData(const deflect::server::Frame& frame)
+{
+    std::vector<uint> columns;
+    for (const auto& tile : frame.tiles)
+    {
+        if (!tile.imageData.isEmpty())
+            columns.push_back(tile.x / tileSize);
+    }
+    return columns;
+}
+
+struct Fixture
+{
+    Configuration config = makeConfig();
+    ScenePtr scene = Scene::create(config.surfaces);
+    WindowPtr window = std::make_shared<Window>(
+        std::make_unique<PixelStreamContent>(streamUri, streamSize, false));
+
+    Fixture() { scene->getGroup(0).add(window); }
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(unknown_stream_is_broadcast, Fixture)
+{
+    PixelStreamRouter router{config, 0ms};
+    BOOST_CHECK(router.split(makeFrame()).empty());
+
+    router.update(*scene);
+    auto otherFrame = makeFrame();
+    otherFrame.uri = "other_stream";
+    BOOST_CHECK(router.split(otherFrame).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(stream_is_broadcast_while_layout_is_changing, Fixture)
+{
+    window->setCoordinates(QRectF(0, 0, 1000, 500));
+
+    PixelStreamRouter router{config, 1h};
+    router.update(*scene);
+    BOOST_CHECK(router.split(makeFrame()).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(stream_on_a_single_screen, Fixture)
+{
+    window->setCoordinates(QRectF(0, 0, 1000, 500));
+
+    PixelStreamRouter router{config, 0ms};
+    router.update(*scene);
+
+    const auto frames = router.split(makeFrame());
+    BOOST_REQUIRE_EQUAL(frames.size(), 2);
+    BOOST_CHECK_EQUAL(frames[0]->tiles.size(), 8);
+    BOOST_CHECK_EQUAL(frames[1]->tiles.size(), 8);
+    BOOST_CHECK_EQUAL(tilesWithData(*frames[0]).size(), 8);
+    BOOST_CHECK(tilesWithData(*frames[1]).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(stream_across_two_screens, Fixture)
+{
+    window->setCoordinates(QRectF(500, 0, 1000, 500));
+
+    PixelStreamRouter router{config, 0ms};
+    router.update(*scene);
+
+    const auto frames = router.split(makeFrame());
+    BOOST_REQUIRE_EQUAL(frames.size(), 2);
+
+    const auto left = std::vector<uint>{0, 1, 0, 1};
+    const auto right = std::vector<uint>{2, 3, 2, 3};
+    const auto tiles0 = tilesWithData(*frames[0]);
+    const auto tiles1 = tilesWithData(*frames[1]);
+    BOOST_CHECK_EQUAL_COLLECTIONS(tiles0.begin(), tiles0.end(), left.begin(),
+                                  left.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(tiles1.begin(), tiles1.end(), right.begin(),
+                                  right.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(stream_needed_everywhere_is_broadcast, Fixture)
+{
+    window->setCoordinates(QRectF(0, 0, 1000, 1000));
+    auto otherWindow = std::make_shared<Window>(
+        std::make_unique<PixelStreamContent>(streamUri, streamSize, false));
+    otherWindow->setCoordinates(QRectF(1000, 0, 1000, 1000));
+    scene->getGroup(0).add(otherWindow);
+
+    PixelStreamRouter router{config, 0ms};
+    router.update(*scene);
+    BOOST_CHECK(router.split(makeFrame()).empty());
+}
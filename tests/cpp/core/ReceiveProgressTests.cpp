@@ -0,0 +1,134 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ReceiveProgressTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/ReceiveProgress.h"
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace
+{
+const auto timeout = std::chrono::seconds{5};
+
+std::string readAll(std::istream& stream)
+{
+    return {std::istreambuf_iterator<char>(stream),
+            std::istreambuf_iterator<char>()};
+}
+}
+
+BOOST_AUTO_TEST_CASE(wait_for_part_of_message)
+{
+    ReceiveProgress progress;
+    progress.reset(10);
+    progress.setReceived(4);
+
+    BOOST_CHECK_EQUAL(progress.waitFor(0), 4);
+    BOOST_CHECK_EQUAL(progress.waitFor(4), 4);
+
+    progress.setReceived(10);
+    BOOST_CHECK_EQUAL(progress.waitFor(100), 10);
+    progress.wait();
+}
+
+BOOST_AUTO_TEST_CASE(empty_message_is_received)
+{
+    ReceiveProgress progress;
+    progress.reset(0);
+    progress.wait();
+    BOOST_CHECK_EQUAL(progress.waitFor(1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(stream_ends_with_received_message)
+{
+    const std::string message = "received message";
+    ReceiveProgress progress;
+    progress.reset(message.size());
+    progress.setReceived(message.size());
+
+    ReceiveStreamBuffer buffer{message.data(), progress};
+    std::istream stream{&buffer};
+    BOOST_CHECK_EQUAL(readAll(stream), message);
+    BOOST_CHECK_EQUAL(stream.peek(), std::istream::traits_type::eof());
+}
+
+BOOST_AUTO_TEST_CASE(first_segment_is_read_before_last_one_is_received)
+{
+    const std::string message = "first segment|last segment";
+    const size_t firstSegmentSize = 14;
+    std::string received(message.size(), '\0');
+
+    ReceiveProgress progress;
+    progress.reset(message.size());
+
+    std::promise<std::string> firstSegment;
+    std::string rest;
+    std::thread reader{[&] {
+        ReceiveStreamBuffer buffer{received.data(), progress};
+        std::istream stream{&buffer};
+        std::string segment(firstSegmentSize, '\0');
+        stream.read(&segment[0], segment.size());
+        firstSegment.set_value(segment);
+        rest = readAll(stream);
+    }};
+
+    std::memcpy(&received[0], message.data(), firstSegmentSize);
+    progress.setReceived(firstSegmentSize);
+
+    auto future = firstSegment.get_future();
+    const auto status = future.wait_for(timeout);
+    BOOST_CHECK(status == std::future_status::ready);
+
+    std::memcpy(&received[firstSegmentSize], message.data() + firstSegmentSize,
+                message.size() - firstSegmentSize);
+    progress.setReceived(message.size());
+    reader.join();
+
+    BOOST_CHECK_EQUAL(future.get(), "first segment|");
+    BOOST_CHECK_EQUAL(rest, "last segment");
+}
@@ -0,0 +1,138 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ReceiveRingTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/ReceiveRing.h"
+
+#include <thread>
+
+BOOST_AUTO_TEST_CASE(slots_are_processed_in_order)
+{
+    ReceiveRing<int> ring{3};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        *ring.acquire() = i;
+        ring.commit();
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        BOOST_CHECK_EQUAL(*ring.next(), i);
+        ring.release();
+    }
+
+    const auto metrics = ring.getMetrics();
+    BOOST_CHECK_EQUAL(metrics.slotsCount, 3);
+    BOOST_CHECK_EQUAL(metrics.occupiedSlots, 0);
+    BOOST_CHECK_EQUAL(metrics.peakOccupiedSlots, 3);
+    BOOST_CHECK_EQUAL(metrics.receivedCount, 3);
+    BOOST_CHECK_EQUAL(metrics.stalledCount, 0);
+}
+
+BOOST_AUTO_TEST_CASE(slot_being_processed_is_not_reused)
+{
+    ReceiveRing<int> ring{2};
+
+    *ring.acquire() = 1;
+    ring.commit();
+    auto processed = ring.next();
+
+    auto received = ring.acquire();
+    BOOST_CHECK(received != processed);
+    *received = 2;
+    ring.commit();
+
+    BOOST_CHECK_EQUAL(*processed, 1);
+    BOOST_CHECK_EQUAL(ring.getMetrics().occupiedSlots, 2);
+}
+
+BOOST_AUTO_TEST_CASE(full_ring_blocks_receiving_until_a_slot_is_released)
+{
+    ReceiveRing<int> ring{1};
+
+    *ring.acquire() = 1;
+    ring.commit();
+
+    std::thread receiver{[&ring] {
+        *ring.acquire() = 2;
+        ring.commit();
+    }};
+
+    while (ring.getMetrics().stalledCount == 0)
+        std::this_thread::yield();
+
+    BOOST_CHECK_EQUAL(*ring.next(), 1);
+    ring.release();
+    receiver.join();
+
+    BOOST_CHECK_EQUAL(*ring.next(), 2);
+    ring.release();
+    BOOST_CHECK_EQUAL(ring.getMetrics().stalledCount, 1);
+    BOOST_CHECK_EQUAL(ring.getMetrics().peakOccupiedSlots, 1);
+}
+
+BOOST_AUTO_TEST_CASE(close_drains_received_slots)
+{
+    ReceiveRing<int> ring{4};
+
+    *ring.acquire() = 1;
+    ring.commit();
+    ring.close();
+
+    BOOST_CHECK(ring.acquire() == nullptr);
+    BOOST_CHECK_EQUAL(*ring.next(), 1);
+    ring.release();
+    BOOST_CHECK(ring.next() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(close_unblocks_processing_thread)
+{
+    ReceiveRing<int> ring{2};
+
+    int value = 0;
+    int* slot = &value;
+    std::thread processor{[&ring, &slot] { slot = ring.next(); }};
+    ring.close();
+    processor.join();
+
+    BOOST_CHECK(slot == nullptr);
+}
@@ -0,0 +1,200 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE RectangleSetTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/RectangleSet.h"
+#include "types.h"
+
+namespace
+{
+const QRectF rect{0, 0, 100, 100};
+
+using Rects = std::vector<QRectF>;
+
+bool contains(const Rects& rects, const QRectF& rect)
+{
+    return std::find(rects.begin(), rects.end(), rect) != rects.end();
+}
+}
+
+BOOST_AUTO_TEST_CASE(empty_set)
+{
+    const auto set = RectangleSet();
+    BOOST_CHECK(set.isEmpty());
+    BOOST_CHECK_EQUAL(set.getArea(), 0.0);
+    BOOST_CHECK_EQUAL(set.getBoundingRect(), QRectF());
+    BOOST_CHECK(set.getRects().empty());
+    BOOST_CHECK(!set.intersects(rect));
+
+    BOOST_CHECK(RectangleSet(QRectF()).isEmpty());
+    BOOST_CHECK(RectangleSet(QRectF(10, 10, 0, 50)).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(single_rectangle)
+{
+    const auto set = RectangleSet(rect);
+    BOOST_CHECK(!set.isEmpty());
+    BOOST_CHECK_EQUAL(set.getArea(), 10000.0);
+    BOOST_CHECK_EQUAL(set.getBoundingRect(), rect);
+    BOOST_REQUIRE_EQUAL(set.getRects().size(), 1);
+    BOOST_CHECK_EQUAL(set.getRects()[0], rect);
+    BOOST_CHECK_EQUAL(set.translated(10, 20).getBoundingRect(),
+                      QRectF(10, 20, 100, 100));
+}
+
+BOOST_AUTO_TEST_CASE(subtract_corner_leaves_l_shape)
+{
+    const auto set =
+        RectangleSet(rect).subtracted(RectangleSet(QRectF(50, 50, 100, 100)));
+    BOOST_CHECK_EQUAL(set.getArea(), 7500.0);
+    BOOST_CHECK_EQUAL(set.getBoundingRect(), rect);
+
+    const auto rects = set.getRects();
+    BOOST_REQUIRE_EQUAL(rects.size(), 2);
+    BOOST_CHECK(contains(rects, QRectF(0, 0, 100, 50)));
+    BOOST_CHECK(contains(rects, QRectF(0, 50, 50, 50)));
+
+    BOOST_CHECK(set.intersects(QRectF(40, 60, 20, 20)));
+    BOOST_CHECK(!set.intersects(QRectF(60, 60, 20, 20)));
+    // Touching is not intersecting
+    BOOST_CHECK(!set.intersects(QRectF(50, 50, 50, 50)));
+}
+
+BOOST_AUTO_TEST_CASE(subtract_center_leaves_frame)
+{
+    const auto set =
+        RectangleSet(rect).subtracted(RectangleSet(QRectF(25, 25, 50, 50)));
+    BOOST_CHECK_EQUAL(set.getArea(), 7500.0);
+    BOOST_CHECK_EQUAL(set.getBoundingRect(), rect);
+    BOOST_CHECK_EQUAL(set.getRects().size(), 4);
+    BOOST_CHECK(!set.intersects(QRectF(30, 30, 40, 40)));
+    BOOST_CHECK(set.intersects(QRectF(30, 10, 40, 40)));
+}
+
+BOOST_AUTO_TEST_CASE(subtract_everything_or_nothing)
+{
+    const auto set = RectangleSet(rect);
+    BOOST_CHECK(set.subtracted(RectangleSet(QRectF(-10, -10, 200, 200)))
+                    .isEmpty());
+    BOOST_CHECK(set.subtracted(RectangleSet(QRectF(200, 0, 10, 10))) == set);
+    BOOST_CHECK(set.subtracted(RectangleSet()) == set);
+}
+
+BOOST_AUTO_TEST_CASE(union_of_adjacent_rectangles_is_coalesced)
+{
+    const auto left = RectangleSet(QRectF(0, 0, 50, 100));
+    const auto right = RectangleSet(QRectF(50, 0, 50, 100));
+    BOOST_CHECK(left.united(right) == RectangleSet(rect));
+
+    const auto top = RectangleSet(QRectF(0, 0, 100, 50));
+    const auto bottom = RectangleSet(QRectF(0, 50, 100, 50));
+    BOOST_CHECK(top.united(bottom) == RectangleSet(rect));
+}
+
+BOOST_AUTO_TEST_CASE(union_of_overlapping_rectangles)
+{
+    const auto set = RectangleSet(rect).united(
+        RectangleSet(QRectF(50, 50, 100, 100)));
+    BOOST_CHECK_EQUAL(set.getArea(), 17500.0);
+    BOOST_CHECK_EQUAL(set.getBoundingRect(), QRectF(0, 0, 150, 150));
+    BOOST_CHECK_EQUAL(set.getRects().size(), 3);
+    BOOST_CHECK(!set.intersects(QRectF(110, 0, 40, 40)));
+    BOOST_CHECK(!set.intersects(QRectF(0, 110, 40, 40)));
+}
+
+BOOST_AUTO_TEST_CASE(subtracting_a_union_cuts_all_its_parts)
+{
+    // Two windows covering the left and right edges, a third one the middle
+    const auto covered = RectangleSet(QRectF(-10, -10, 30, 200))
+                             .united(RectangleSet(QRectF(80, -10, 30, 200)))
+                             .united(RectangleSet(QRectF(40, 40, 20, 20)));
+    const auto visible = RectangleSet(rect).subtracted(covered);
+    BOOST_CHECK_EQUAL(visible.getArea(), 6000.0 - 400.0);
+    BOOST_CHECK_EQUAL(visible.getBoundingRect(), QRectF(20, 0, 60, 100));
+    BOOST_CHECK(!visible.intersects(QRectF(45, 45, 10, 10)));
+    BOOST_CHECK(visible.intersects(QRectF(45, 10, 10, 10)));
+
+    // Covering the remaining parts leaves nothing
+    const auto rest = RectangleSet(QRectF(20, 0, 60, 100));
+    BOOST_CHECK(visible.subtracted(rest).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(random_operations_match_pixel_coverage)
+{
+    // Compare with the coverage of the pixels of a small grid
+    const int gridSize = 32;
+    auto covered = std::vector<bool>(gridSize * gridSize, false);
+    auto set = RectangleSet();
+
+    unsigned int seed = 42;
+    const auto random = [&seed](const int max) {
+        seed = seed * 1103515245u + 12345u;
+        return int((seed >> 16) % max);
+    };
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto x = random(gridSize);
+        const auto y = random(gridSize);
+        const auto w = 1 + random(gridSize - x);
+        const auto h = 1 + random(gridSize - y);
+        const auto add = random(3) > 0;
+
+        const auto other = RectangleSet(QRectF(x, y, w, h));
+        set = add ? set.united(other) : set.subtracted(other);
+        for (int py = y; py < y + h; ++py)
+            for (int px = x; px < x + w; ++px)
+                covered[py * gridSize + px] = add;
+
+        const auto count = std::count(covered.begin(), covered.end(), true);
+        BOOST_REQUIRE_EQUAL(set.getArea(), qreal(count));
+    }
+
+    for (int py = 0; py < gridSize; ++py)
+    {
+        for (int px = 0; px < gridSize; ++px)
+        {
+            BOOST_CHECK_EQUAL(set.intersects(QRectF(px, py, 1, 1)),
+                              bool(covered[py * gridSize + px]));
+        }
+    }
+}
@@ -0,0 +1,177 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ResourcePoolTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/ResourcePool.h"
+
+#include <utility>
+
+namespace
+{
+using Key = std::pair<int, int>; // width, height
+const Key smallKey{64, 64};
+const Key largeKey{512, 512};
+
+struct Resource
+{
+    Resource(const int id_, int& deleted_)
+        : id{id_}
+        , deleted{deleted_}
+    {
+    }
+    ~Resource() { ++deleted; }
+    const int id;
+    int& deleted;
+};
+
+using Pool = ResourcePool<Key, Resource>;
+}
+
+BOOST_AUTO_TEST_CASE(take_from_empty_pool_is_a_miss)
+{
+    Pool pool{1000};
+    BOOST_CHECK(!pool.take(smallKey));
+
+    const auto stats = pool.getStats();
+    BOOST_CHECK_EQUAL(stats.hits, 0);
+    BOOST_CHECK_EQUAL(stats.misses, 1);
+    BOOST_CHECK_EQUAL(stats.count, 0);
+    BOOST_CHECK_EQUAL(stats.size, 0);
+    BOOST_CHECK_EQUAL(stats.maxSize, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(resources_given_back_are_reused_for_the_same_key)
+{
+    int deleted = 0;
+    Pool pool{1000};
+    pool.give(smallKey, std::make_unique<Resource>(1, deleted), 100);
+    pool.give(largeKey, std::make_unique<Resource>(2, deleted), 400);
+
+    BOOST_CHECK_EQUAL(pool.getStats().count, 2);
+    BOOST_CHECK_EQUAL(pool.getStats().size, 500);
+
+    BOOST_CHECK(!pool.take(Key{64, 32}));
+
+    auto resource = pool.take(largeKey);
+    BOOST_REQUIRE(resource);
+    BOOST_CHECK_EQUAL(resource->id, 2);
+    BOOST_CHECK(!pool.take(largeKey));
+
+    const auto stats = pool.getStats();
+    BOOST_CHECK_EQUAL(stats.hits, 1);
+    BOOST_CHECK_EQUAL(stats.misses, 2);
+    BOOST_CHECK_EQUAL(stats.recycled, 2);
+    BOOST_CHECK_EQUAL(stats.count, 1);
+    BOOST_CHECK_EQUAL(stats.size, 100);
+    BOOST_CHECK_EQUAL(deleted, 0);
+}
+
+BOOST_AUTO_TEST_CASE(several_resources_can_share_the_same_key)
+{
+    int deleted = 0;
+    Pool pool{1000};
+    pool.give(smallKey, std::make_unique<Resource>(1, deleted), 100);
+    pool.give(smallKey, std::make_unique<Resource>(2, deleted), 100);
+
+    auto a = pool.take(smallKey);
+    auto b = pool.take(smallKey);
+    BOOST_REQUIRE(a && b);
+    BOOST_CHECK_NE(a->id, b->id);
+    BOOST_CHECK(!pool.take(smallKey));
+    BOOST_CHECK_EQUAL(pool.getStats().size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_given_resources_are_evicted)
+{
+    int deleted = 0;
+    Pool pool{300};
+    pool.give(Key{1, 1}, std::make_unique<Resource>(1, deleted), 100);
+    pool.give(Key{2, 2}, std::make_unique<Resource>(2, deleted), 100);
+    pool.give(Key{1, 1}, std::make_unique<Resource>(3, deleted), 100);
+    BOOST_CHECK_EQUAL(deleted, 0);
+
+    pool.give(Key{3, 3}, std::make_unique<Resource>(4, deleted), 100);
+    BOOST_CHECK_EQUAL(deleted, 1);
+
+    auto resource = pool.take(Key{1, 1});
+    BOOST_REQUIRE(resource);
+    BOOST_CHECK_EQUAL(resource->id, 3);
+    BOOST_CHECK(!pool.take(Key{1, 1}));
+    BOOST_CHECK(pool.take(Key{2, 2}));
+    BOOST_CHECK(pool.take(Key{3, 3}));
+
+    const auto stats = pool.getStats();
+    BOOST_CHECK_EQUAL(stats.evictions, 1);
+    BOOST_CHECK_EQUAL(stats.count, 0);
+    BOOST_CHECK_EQUAL(stats.size, 0);
+}
+
+BOOST_AUTO_TEST_CASE(resources_larger_than_the_budget_are_deleted)
+{
+    int deleted = 0;
+    Pool pool{300};
+    pool.give(largeKey, std::make_unique<Resource>(1, deleted), 400);
+
+    BOOST_CHECK_EQUAL(deleted, 1);
+    BOOST_CHECK(!pool.take(largeKey));
+    BOOST_CHECK_EQUAL(pool.getStats().evictions, 1);
+    BOOST_CHECK_EQUAL(pool.getStats().recycled, 0);
+}
+
+BOOST_AUTO_TEST_CASE(reducing_max_size_evicts_resources)
+{
+    int deleted = 0;
+    Pool pool{1000};
+    pool.give(smallKey, std::make_unique<Resource>(1, deleted), 100);
+    pool.give(largeKey, std::make_unique<Resource>(2, deleted), 400);
+
+    pool.setMaxSize(400);
+    BOOST_CHECK_EQUAL(deleted, 1);
+    BOOST_CHECK(!pool.take(smallKey));
+
+    pool.setMaxSize(0);
+    BOOST_CHECK_EQUAL(deleted, 2);
+    BOOST_CHECK_EQUAL(pool.getStats().count, 0);
+
+    pool.give(smallKey, std::make_unique<Resource>(3, deleted), 100);
+    BOOST_CHECK_EQUAL(deleted, 3);
+}
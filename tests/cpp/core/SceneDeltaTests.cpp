@@ -0,0 +1,173 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SceneDeltaTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "network/SceneDeltaDecoder.h"
+#include "network/SceneDeltaEncoder.h"
+#include "scene/DisplayGroup.h"
+#include "scene/Scene.h"
+#include "scene/SceneDelta.h"
+#include "scene/Window.h"
+#include "serialization/utils.h"
+
+#include "DummyContent.h"
+
+namespace
+{
+const QSize wallSize(1000, 1000);
+const QSize contentSize(512, 512);
+
+WindowPtr makeWindow()
+{
+    return std::make_shared<Window>(
+        std::make_unique<DummyContent>(contentSize));
+}
+
+struct Fixture
+{
+    WindowPtr window0 = makeWindow();
+    WindowPtr window1 = makeWindow();
+    ScenePtr scene = Scene::create(wallSize);
+    SceneDeltaEncoder encoder{2};
+    SceneDeltaDecoder decoder;
+
+    Fixture()
+    {
+        scene->getGroup(0).add(window0);
+        scene->getGroup(0).add(window1);
+    }
+
+    ScenePtr transmit()
+    {
+        return decoder.apply(serialization::binaryCopy(encoder.encode(scene)));
+    }
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(first_update_is_a_keyframe, Fixture)
+{
+    const auto delta = encoder.encode(scene);
+    BOOST_CHECK(delta.isKeyframe());
+    BOOST_CHECK_EQUAL(delta.version, 1);
+    BOOST_CHECK(delta.windows.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(patch_contains_only_modified_windows, Fixture)
+{
+    encoder.encode(scene);
+
+    window1->setCoordinates(QRectF(10, 20, 300, 400));
+    const auto delta = encoder.encode(scene);
+
+    BOOST_REQUIRE(!delta.isKeyframe());
+    BOOST_CHECK_EQUAL(delta.baseVersion, 1);
+    BOOST_CHECK_EQUAL(delta.version, 2);
+    BOOST_REQUIRE_EQUAL(delta.windows.size(), 1);
+    BOOST_CHECK_EQUAL(delta.windows[0], window1);
+    BOOST_REQUIRE_EQUAL(delta.surfaces.size(), 1);
+    BOOST_REQUIRE_EQUAL(delta.surfaces[0].windowIds.size(), 2);
+    BOOST_CHECK(delta.surfaces[0].windowIds[0] == window0->getID());
+    BOOST_CHECK(delta.surfaces[0].windowIds[1] == window1->getID());
+}
+
+BOOST_FIXTURE_TEST_CASE(decoder_reuses_unmodified_windows, Fixture)
+{
+    const auto keyframe = transmit();
+    BOOST_REQUIRE(keyframe);
+    BOOST_REQUIRE_EQUAL(keyframe->getWindows().size(), 2);
+
+    window1->setCoordinates(QRectF(10, 20, 300, 400));
+    const auto patched = transmit();
+    BOOST_REQUIRE(patched);
+    BOOST_CHECK_EQUAL(decoder.getVersion(), 2);
+
+    const auto windows = patched->getWindows();
+    BOOST_REQUIRE_EQUAL(windows.size(), 2);
+    BOOST_CHECK_EQUAL(windows[0], keyframe->getWindows()[0]);
+    BOOST_CHECK_NE(windows[1], keyframe->getWindows()[1]);
+    BOOST_CHECK_EQUAL(windows[1]->getCoordinates(), QRectF(10, 20, 300, 400));
+}
+
+BOOST_FIXTURE_TEST_CASE(decoder_follows_window_order_and_removal, Fixture)
+{
+    transmit();
+
+    auto window2 = makeWindow();
+    scene->getGroup(0).add(window2);
+    scene->getGroup(0).moveToFront(window0);
+    scene->getGroup(0).remove(window1);
+
+    const auto patched = transmit();
+    BOOST_REQUIRE(patched);
+
+    const auto windows = patched->getWindows();
+    BOOST_REQUIRE_EQUAL(windows.size(), 2);
+    BOOST_CHECK(windows[0]->getID() == window2->getID());
+    BOOST_CHECK(windows[1]->getID() == window0->getID());
+}
+
+BOOST_FIXTURE_TEST_CASE(decoder_resyncs_on_next_keyframe, Fixture)
+{
+    transmit();
+
+    // patch lost, the following ones can't be applied
+    encoder.encode(scene);
+    window0->setCoordinates(QRectF(1, 2, 3, 4));
+    BOOST_CHECK(!transmit());
+    BOOST_CHECK(!decoder.isInSync());
+
+    // keyframe interval of 2 reached
+    window0->setCoordinates(QRectF(5, 6, 7, 8));
+    const auto keyframe = transmit();
+    BOOST_REQUIRE(keyframe);
+    BOOST_CHECK(decoder.isInSync());
+    BOOST_CHECK_EQUAL(decoder.getVersion(), 4);
+    BOOST_CHECK_EQUAL(keyframe->getWindows()[0]->getCoordinates(),
+                      QRectF(5, 6, 7, 8));
+}
+
+BOOST_FIXTURE_TEST_CASE(decoder_ignores_patches_before_first_keyframe, Fixture)
+{
+    encoder.encode(scene);
+    BOOST_CHECK(!transmit());
+    BOOST_CHECK(!decoder.isInSync());
+}
@@ -45,12 +45,52 @@
 #include "MinimalGlobalQtApp.h"
 #include "imageCompare.h"
 
+#include <QBuffer>
 #include <QColor>
+#include <QPainter>
+#include <QThread>
+
+#include <cmath>
+#include <future>
 
 namespace
 {
 const SurfaceConfig referenceSurface{1920, 1080, 2, 1, 2, 3, 14, 12, QSizeF()};
 const QString referenceScreenshot{"./reference_screenshot.png"};
+
+QImage _makeScreenImage(const QPoint& index, const QSize& size)
+{
+    QImage screen{size, QImage::Format_RGB32};
+    screen.fill(QColor{index.x() * 64, index.y() * 64, 128});
+    return screen;
+}
+
+QByteArray _encode(const QImage& image)
+{
+    QByteArray data;
+    QBuffer buffer{&data};
+    image.save(&buffer, "png");
+    return data;
+}
+
+// The assembler emits its signals from its worker thread
+std::future<QImage> _getScreenshot(ScreenshotAssembler& assembler)
+{
+    auto promise = std::make_shared<std::promise<QImage>>();
+    assembler.connect(&assembler, &ScreenshotAssembler::screenshotComplete,
+                      [promise](const QImage image) {
+                          promise->set_value(image);
+                      });
+    return promise->get_future();
+}
+
+bool _isReady(const std::future<QImage>& future,
+              const std::chrono::seconds timeout = std::chrono::seconds{0})
+{
+    return future.wait_for(timeout) == std::future_status::ready;
+}
+
+const auto assemblyTimeout = std::chrono::seconds{30};
 }
 
 // Needed for relative path to resources to work
@@ -61,12 +101,7 @@ BOOST_AUTO_TEST_CASE(test_assemble_screenshot)
     const auto& surface = referenceSurface;
 
     ScreenshotAssembler assembler{surface};
-
-    QImage screenshot;
-    assembler.connect(&assembler, &ScreenshotAssembler::screenshotComplete,
-                      [&screenshot](const QImage image) {
-                          screenshot = image;
-                      });
+    auto result = _getScreenshot(assembler);
 
     const QSize screenSize{(int)surface.getScreenWidth(),
                            (int)surface.getScreenHeight()};
@@ -82,10 +117,12 @@ BOOST_AUTO_TEST_CASE(test_assemble_screenshot)
             assembler.addImage(screen, {x, y});
             const auto index = x + y * surface.screenCountX;
             if (index < screenCount - 1)
-                BOOST_CHECK(screenshot.isNull());
+                BOOST_CHECK(!_isReady(result));
         }
     }
 
+    BOOST_REQUIRE(_isReady(result, assemblyTimeout));
+    const auto screenshot = result.get();
     BOOST_CHECK(!screenshot.isNull());
     BOOST_CHECK_EQUAL(screenshot.size(), surface.getTotalSize());
 
@@ -93,3 +130,63 @@ BOOST_AUTO_TEST_CASE(test_assemble_screenshot)
     BOOST_REQUIRE(reference.load(referenceScreenshot));
     BOOST_CHECK_LT(compareImages(screenshot, reference), 0.005);
 }
+
+BOOST_AUTO_TEST_CASE(test_stream_scaled_screenshot_by_bands)
+{
+    const auto& surface = referenceSurface;
+    const auto scale = 0.25;
+
+    ScreenshotAssembler reference{surface, scale};
+    ScreenshotAssembler assembler{surface, scale,
+                                  ScreenshotAssembler::Output::bands};
+
+    const auto size = QSize(std::round(surface.getTotalWidth() * scale),
+                            std::round(surface.getTotalHeight() * scale));
+    BOOST_CHECK_EQUAL(reference.getSize(), size);
+    BOOST_CHECK_EQUAL(assembler.getSize(), size);
+
+    auto expected = _getScreenshot(reference);
+    auto result = _getScreenshot(assembler);
+
+    auto bands = std::vector<QImage>();
+    auto onWorkerThread = true;
+    const auto testThread = QThread::currentThread();
+    assembler.connect(&assembler, &ScreenshotAssembler::bandComplete,
+                      [&](const QImage band) {
+                          bands.push_back(band);
+                          if (QThread::currentThread() == testThread)
+                              onWorkerThread = false;
+                      });
+
+    const QSize screenSize(std::round(surface.getScreenWidth() * scale),
+                           std::round(surface.getScreenHeight() * scale));
+
+    // Images arrive in reverse order: no band is complete until the last one
+    for (auto y = (int)surface.screenCountY - 1; y >= 0; --y)
+    {
+        for (auto x = (int)surface.screenCountX - 1; x >= 0; --x)
+        {
+            BOOST_CHECK(bands.empty());
+            const auto screen = _makeScreenImage({x, y}, screenSize);
+            reference.addImage(screen, {x, y});
+            assembler.addEncodedImage(_encode(screen), {x, y});
+        }
+    }
+    BOOST_REQUIRE(_isReady(result, assemblyTimeout));
+    BOOST_REQUIRE(_isReady(expected, assemblyTimeout));
+    BOOST_CHECK(result.get().isNull());
+    BOOST_CHECK(assembler.isComplete());
+    BOOST_CHECK(onWorkerThread);
+    BOOST_REQUIRE_EQUAL(bands.size(), surface.screenCountY);
+
+    auto screenshot = QImage{size, QImage::Format_RGB32};
+    auto top = 0;
+    for (const auto& band : bands)
+    {
+        BOOST_CHECK_EQUAL(band.width(), size.width());
+        QPainter{&screenshot}.drawImage(0, top, band);
+        top += band.height();
+    }
+    BOOST_CHECK_EQUAL(top, size.height());
+    BOOST_CHECK(screenshot == expected.get());
+}
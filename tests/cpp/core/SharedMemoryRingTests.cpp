@@ -0,0 +1,204 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SharedMemoryRingTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/SharedMemory.h"
+#include "network/SharedMemoryRing.h"
+
+#include <unistd.h>
+
+#include <cstring>
+
+namespace
+{
+std::string makePrefix(const std::string& test)
+{
+    return "/tide-test-ring-" + test + "-" + std::to_string(::getpid());
+}
+
+bool write(SharedMemoryRing& ring, const std::string& payload,
+           const uint32_t readersCount, SharedMemoryRing::Slot& slot)
+{
+    return ring.write(payload.data(), payload.size(), readersCount, slot);
+}
+
+std::string toString(const std::shared_ptr<const char>& payload,
+                     const SharedMemoryRing::Slot& slot)
+{
+    return std::string(payload.get(), slot.size);
+}
+}
+
+BOOST_AUTO_TEST_CASE(read_payload_written_in_slot)
+{
+    const auto prefix = makePrefix("read");
+    SharedMemoryRing ring{prefix, 2};
+    SharedMemoryRingReader reader{prefix};
+
+    SharedMemoryRing::Slot slot;
+    BOOST_REQUIRE(write(ring, "first", 1, slot));
+    BOOST_CHECK_EQUAL(slot.index, 0);
+    BOOST_CHECK_EQUAL(toString(reader.read(slot), slot), "first");
+
+    BOOST_REQUIRE(write(ring, "second", 1, slot));
+    BOOST_CHECK_EQUAL(slot.index, 1);
+    BOOST_CHECK_EQUAL(toString(reader.read(slot), slot), "second");
+}
+
+BOOST_AUTO_TEST_CASE(slot_reused_once_released_by_all_readers)
+{
+    const auto prefix = makePrefix("release");
+    SharedMemoryRing ring{prefix, 2};
+    SharedMemoryRingReader reader1{prefix};
+    SharedMemoryRingReader reader2{prefix};
+
+    SharedMemoryRing::Slot first;
+    SharedMemoryRing::Slot second;
+    BOOST_REQUIRE(write(ring, "a", 2, first));
+    BOOST_REQUIRE(write(ring, "b", 2, second));
+    auto payload1 = reader1.read(first);
+    auto payload2 = reader2.read(first);
+    const auto payload3 = reader1.read(second);
+    const auto payload4 = reader2.read(second);
+
+    SharedMemoryRing::Slot slot;
+    payload1.reset();
+    BOOST_CHECK(!write(ring, "c", 2, slot));
+
+    payload2.reset();
+    BOOST_REQUIRE(write(ring, "c", 2, slot));
+    BOOST_CHECK_EQUAL(slot.index, first.index);
+    BOOST_CHECK_EQUAL(slot.generation, first.generation);
+    BOOST_CHECK_EQUAL(toString(reader1.read(slot), slot), "c");
+}
+
+BOOST_AUTO_TEST_CASE(segment_recreated_for_larger_payload)
+{
+    const auto prefix = makePrefix("grow");
+    SharedMemoryRing ring{prefix, 1};
+    SharedMemoryRingReader reader{prefix};
+
+    SharedMemoryRing::Slot slot;
+    BOOST_REQUIRE(write(ring, "small", 1, slot));
+    reader.read(slot);
+
+    const auto large = std::string(10000, 'x');
+    BOOST_REQUIRE(write(ring, large, 1, slot));
+    BOOST_CHECK_EQUAL(slot.generation, 1);
+    BOOST_CHECK_EQUAL(toString(reader.read(slot), slot), large);
+
+    BOOST_REQUIRE(write(ring, "small again", 1, slot));
+    BOOST_CHECK_EQUAL(slot.generation, 1);
+}
+
+BOOST_AUTO_TEST_CASE(segment_unlinked_once_mapped_by_all_readers)
+{
+    const auto prefix = makePrefix("unlink");
+    const auto name = prefix + "-0-0";
+    SharedMemoryRing ring{prefix, 1};
+    SharedMemoryRingReader reader1{prefix};
+    SharedMemoryRingReader reader2{prefix};
+
+    SharedMemoryRing::Slot slot;
+    BOOST_REQUIRE(write(ring, "payload", 2, slot));
+    reader1.read(slot);
+    BOOST_CHECK(!write(ring, "next", 2, slot));
+    BOOST_CHECK_NO_THROW(SharedMemory::open(name));
+
+    reader2.read(slot);
+    BOOST_REQUIRE(write(ring, "next", 2, slot));
+    BOOST_CHECK_THROW(SharedMemory::open(name), std::runtime_error);
+    BOOST_CHECK_EQUAL(toString(reader1.read(slot), slot), "next");
+    BOOST_CHECK_EQUAL(toString(reader2.read(slot), slot), "next");
+}
+
+BOOST_AUTO_TEST_CASE(remaining_segments_unlinked_with_ring)
+{
+    const auto prefix = makePrefix("destroy");
+    {
+        SharedMemoryRing ring{prefix, 2};
+        SharedMemoryRing::Slot slot;
+        BOOST_REQUIRE(write(ring, "payload", 1, slot));
+        BOOST_CHECK_NO_THROW(SharedMemory::open(prefix + "-0-0"));
+    }
+    BOOST_CHECK_THROW(SharedMemory::open(prefix + "-0-0"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(slot_released_by_reader_which_fails_to_map_it)
+{
+    const auto prefix = makePrefix("fail");
+    SharedMemoryRing ring{prefix, 1};
+    SharedMemoryRingReader reader1{prefix};
+    SharedMemoryRingReader reader2{prefix};
+
+    SharedMemoryRing::Slot slot;
+    BOOST_REQUIRE(write(ring, "payload", 2, slot));
+    const auto payload = reader1.read(slot);
+
+    // The second reader can no longer open the segment
+    SharedMemory::open(prefix + "-0-0")->unlink();
+    BOOST_CHECK_THROW(reader2.read(slot), std::runtime_error);
+    BOOST_CHECK(!write(ring, "next", 2, slot));
+
+    BOOST_CHECK_EQUAL(toString(payload, slot), "payload");
+}
+
+BOOST_AUTO_TEST_CASE(slot_reused_after_all_readers_failed_to_map_it)
+{
+    const auto prefix = makePrefix("failall");
+    SharedMemoryRing ring{prefix, 1};
+    SharedMemoryRingReader reader{prefix};
+
+    SharedMemoryRing::Slot slot;
+    BOOST_REQUIRE(write(ring, "payload", 1, slot));
+    SharedMemory::open(prefix + "-0-0")->unlink();
+    BOOST_CHECK_THROW(reader.read(slot), std::runtime_error);
+
+    BOOST_REQUIRE(write(ring, "next", 1, slot));
+    BOOST_CHECK_EQUAL(slot.index, 0);
+}
+
+BOOST_AUTO_TEST_CASE(reader_needs_the_ring)
+{
+    BOOST_CHECK_THROW(SharedMemoryRingReader{makePrefix("missing")},
+                      std::runtime_error);
+}
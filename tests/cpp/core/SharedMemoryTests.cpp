@@ -0,0 +1,105 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SharedMemoryTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/SharedMemory.h"
+
+#include <unistd.h>
+
+#include <cstring>
+
+namespace
+{
+std::string makeName(const std::string& test)
+{
+    return "/tide-test-" + test + "-" + std::to_string(::getpid());
+}
+}
+
+BOOST_AUTO_TEST_CASE(open_segment_written_by_creator)
+{
+    const auto name = makeName("open");
+    const auto segment = SharedMemory::create(name, 4096);
+    BOOST_CHECK_EQUAL(segment->getName(), name);
+    BOOST_CHECK_EQUAL(segment->getSize(), 4096);
+    std::strcpy(segment->getData(), "hello");
+
+    const auto reader = SharedMemory::open(name);
+    BOOST_CHECK_EQUAL(reader->getSize(), 4096);
+    BOOST_CHECK_EQUAL(std::string(reader->getData()), "hello");
+
+    segment->unlink();
+}
+
+BOOST_AUTO_TEST_CASE(memory_stays_mapped_after_unlink)
+{
+    const auto name = makeName("unlink");
+    auto segment = SharedMemory::create(name, 100);
+    const auto reader = SharedMemory::open(name);
+    segment->unlink();
+    BOOST_CHECK_THROW(SharedMemory::open(name), std::runtime_error);
+
+    segment->getData()[99] = 42;
+    segment.reset();
+    BOOST_CHECK_EQUAL(reader->getData()[99], 42);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_segments_throw)
+{
+    const auto name = makeName("invalid");
+    BOOST_CHECK_THROW(SharedMemory::open(name), std::runtime_error);
+    BOOST_CHECK_THROW(SharedMemory::create(name, 0), std::runtime_error);
+
+    const auto segment = SharedMemory::create(name, 10);
+    BOOST_CHECK_THROW(SharedMemory::create(name, 10), std::runtime_error);
+    segment->unlink();
+}
+
+BOOST_AUTO_TEST_CASE(writable_segment_shares_writes_with_creator)
+{
+    const auto name = makeName("writable");
+    const auto segment = SharedMemory::create(name, 10);
+    const auto writer = SharedMemory::openWritable(name);
+    writer->getData()[0] = 42;
+    BOOST_CHECK_EQUAL(segment->getData()[0], 42);
+    segment->unlink();
+}
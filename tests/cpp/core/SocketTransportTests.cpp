@@ -0,0 +1,162 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE SocketTransportTests
+#include <boost/test/unit_test.hpp>
+
+#include "TransportRunner.h"
+
+#include <future>
+
+// The checks common to all transports are in TransportTests.
+
+BOOST_AUTO_TEST_CASE(send_large_messages_with_and_without_shared_memory)
+{
+    const auto message = makeData(10 * 1024 * 1024 + 17);
+    for (auto ringSize : {size_t(0), SocketTransport::defaultRingSize})
+    {
+        SocketTransport::Options options;
+        options.ringSize = ringSize;
+        runOnSockets(2,
+                     [&](Transport& transport) {
+                         if (transport.getRank() == 0)
+                             sendMessage(transport, message, 1, 0);
+                         else
+                             expect(receiveMessage(transport, 0, 0) == message,
+                                    "corrupt data");
+                     },
+                     options);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(processes_on_different_hosts_use_only_sockets)
+{
+    const auto message = makeData(SocketTransport::defaultRingSize + 17);
+    runOnHosts({"a", "b"}, [&](Transport& transport) {
+        if (transport.getRank() == 0)
+            sendMessage(transport, message, 1, 0);
+        else
+            expect(receiveMessage(transport, 0, 0) == message, "corrupt data");
+    });
+}
+
+BOOST_AUTO_TEST_CASE(split_by_host_groups_processes_with_the_same_host_name)
+{
+    std::vector<int> ranks(5), sizes(5);
+    runOnHosts({"a", "b", "a", "c", "b"}, [&](Transport& transport) {
+        const auto rank = transport.getRank();
+        const auto host = transport.splitByHost();
+        ranks[rank] = host->getRank();
+        sizes[rank] = host->getSize();
+    });
+    BOOST_CHECK(ranks == std::vector<int>({0, 0, 1, 0, 1}));
+    BOOST_CHECK(sizes == std::vector<int>({2, 2, 2, 1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(sender_blocks_until_pending_messages_are_received)
+{
+    // Much more than the socket buffers, so the sender must wait
+    const size_t messageSize = 1024 * 1024;
+    const int messageCount = 64;
+
+    for (auto ringSize : {size_t(0), SocketTransport::defaultRingSize})
+    {
+        SocketTransport::Options options;
+        options.ringSize = ringSize;
+        options.inboxCapacity = messageSize;
+
+        std::promise<void> sent;
+        auto allSent = sent.get_future();
+        bool sentBeforeReceiving = false;
+        std::vector<std::vector<char>> received;
+        runOnSockets(2,
+                     [&](Transport& transport) {
+                         if (transport.getRank() == 0)
+                         {
+                             for (int i = 0; i < messageCount; ++i)
+                             {
+                                 auto data = makeData(messageSize);
+                                 data[0] = char(i);
+                                 sendMessage(transport, data, 1, 0);
+                             }
+                             sent.set_value();
+                             return;
+                         }
+                         // The sender can not finish while nothing is received
+                         const auto status =
+                             allSent.wait_for(std::chrono::milliseconds{200});
+                         sentBeforeReceiving =
+                             status == std::future_status::ready;
+                         for (int i = 0; i < messageCount; ++i)
+                             received.push_back(
+                                 receiveMessage(transport, 0, 0));
+                     },
+                     options);
+
+        BOOST_CHECK(!sentBeforeReceiving);
+        BOOST_REQUIRE_EQUAL(received.size(), messageCount);
+        for (int i = 0; i < messageCount; ++i)
+        {
+            BOOST_CHECK_EQUAL(received[i].size(), messageSize);
+            BOOST_CHECK_EQUAL(received[i][0], char(i));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sending_to_a_process_which_is_gone_throws)
+{
+    SocketTransport::Listener listener;
+    const auto port = listener.getPort();
+    std::promise<void> gone;
+    std::thread receiver{[&] {
+        {
+            SocketTransport transport{1, 2, "localhost", port};
+        }
+        gone.set_value();
+    }};
+    SocketTransport transport{std::move(listener), 2,
+                              SocketTransport::Options()};
+    gone.get_future().wait();
+
+    // Larger than the shared memory ring, which nobody empties anymore
+    const auto message = makeData(2 * SocketTransport::defaultRingSize);
+    BOOST_CHECK_THROW(sendMessage(transport, message, 1, 0),
+                      std::runtime_error);
+    receiver.join();
+}
@@ -0,0 +1,207 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TelemetryAggregatorTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "configuration/Configuration.h"
+#include "tools/TelemetryAggregator.h"
+
+namespace
+{
+using clock = TelemetryAggregator::clock;
+using ms = std::chrono::milliseconds;
+
+const auto t0 = clock::time_point{} + std::chrono::hours{1};
+
+// Processes 0-2 on surface 0, process 3 on surfaces 0 and 1
+Configuration makeConfig()
+{
+    Configuration config;
+    config.surfaces.resize(2);
+    config.processes.resize(4);
+    for (size_t i = 0; i < config.processes.size(); ++i)
+    {
+        auto& process = config.processes[i];
+        process.host = "host" + QString::number(int(i));
+        process.screens.resize(2);
+        process.screens[0].surfaceIndex = 0;
+        process.screens[1].surfaceIndex = i < 3 ? 0 : 1;
+    }
+    config.global.telemetryInterval = 1000;
+    return config;
+}
+
+WallTelemetry makeTelemetry(const int rank, const float workTime)
+{
+    WallTelemetry telemetry;
+    telemetry.rank = rank;
+    telemetry.period = 1000.f;
+    telemetry.frames = 60;
+    telemetry.frameTimeMean = 16.f;
+    telemetry.frameTimeP99 = 16.f + rank;
+    telemetry.syncWaitMean = 16.f - workTime;
+    telemetry.tileQueueDepth = 2;
+    telemetry.cacheBytes = 1000;
+    return telemetry;
+}
+}
+
+BOOST_AUTO_TEST_CASE(ranks_are_known_from_configuration)
+{
+    const TelemetryAggregator aggregator{makeConfig()};
+    BOOST_CHECK(aggregator.getInterval() == ms{1000});
+
+    const auto ranks = aggregator.getRanks(t0);
+    BOOST_REQUIRE_EQUAL(ranks.size(), 4);
+    BOOST_CHECK_EQUAL(ranks[1].rank, 1);
+    BOOST_CHECK_EQUAL(ranks[1].host, "host1");
+    BOOST_CHECK(ranks[1].surfaces == std::vector<uint>{0});
+    BOOST_CHECK(ranks[3].surfaces == (std::vector<uint>{0, 1}));
+    for (const auto& rank : ranks)
+    {
+        BOOST_CHECK(!rank.received);
+        BOOST_CHECK(!rank.straggler);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(telemetry_of_unknown_rank_is_ignored)
+{
+    TelemetryAggregator aggregator{makeConfig()};
+    aggregator.add(makeTelemetry(-1, 5.f), t0);
+    aggregator.add(makeTelemetry(4, 5.f), t0);
+    for (const auto& rank : aggregator.getRanks(t0))
+        BOOST_CHECK(!rank.received);
+}
+
+BOOST_AUTO_TEST_CASE(surfaces_aggregate_their_processes)
+{
+    TelemetryAggregator aggregator{makeConfig()};
+    for (int i = 0; i < 4; ++i)
+        aggregator.add(makeTelemetry(i, 5.f), t0);
+
+    auto telemetry = makeTelemetry(1, 5.f);
+    telemetry.frames = 30;
+    aggregator.add(telemetry, t0);
+
+    const auto surfaces = aggregator.getSurfaces(t0 + ms{100});
+    BOOST_REQUIRE_EQUAL(surfaces.size(), 2);
+
+    BOOST_CHECK_EQUAL(surfaces[0].processes, 4);
+    BOOST_CHECK_EQUAL(surfaces[0].reporting, 4);
+    BOOST_CHECK_EQUAL(surfaces[0].minFps, 30.f);
+    BOOST_CHECK_EQUAL(surfaces[0].maxFrameTimeP99, 19.f);
+    BOOST_CHECK_EQUAL(surfaces[0].tileQueueDepth, 8);
+    BOOST_CHECK_EQUAL(surfaces[0].cacheBytes, 4000);
+    BOOST_CHECK(surfaces[0].stragglers.empty());
+
+    BOOST_CHECK_EQUAL(surfaces[1].processes, 1);
+    BOOST_CHECK_EQUAL(surfaces[1].reporting, 1);
+    BOOST_CHECK_EQUAL(surfaces[1].minFps, 60.f);
+    BOOST_CHECK_EQUAL(surfaces[1].maxFrameTimeP99, 19.f);
+}
+
+BOOST_AUTO_TEST_CASE(ranks_without_recent_reports_are_stale)
+{
+    TelemetryAggregator aggregator{makeConfig()};
+    aggregator.add(makeTelemetry(0, 5.f), t0);
+    aggregator.add(makeTelemetry(1, 5.f), t0 + ms{2500});
+
+    const auto ranks = aggregator.getRanks(t0 + ms{3500});
+    BOOST_CHECK(ranks[0].stale);
+    BOOST_CHECK_EQUAL(ranks[0].age, 3500.f);
+    BOOST_CHECK(!ranks[1].stale);
+    BOOST_CHECK_EQUAL(ranks[1].age, 1000.f);
+    BOOST_CHECK(!ranks[2].received);
+
+    const auto surfaces = aggregator.getSurfaces(t0 + ms{3500});
+    BOOST_CHECK_EQUAL(surfaces[0].reporting, 1);
+}
+
+BOOST_AUTO_TEST_CASE(slowest_process_is_a_straggler)
+{
+    TelemetryAggregator aggregator{makeConfig()};
+    aggregator.add(makeTelemetry(0, 4.f), t0);
+    aggregator.add(makeTelemetry(1, 5.f), t0);
+    aggregator.add(makeTelemetry(2, 4.5f), t0);
+    aggregator.add(makeTelemetry(3, 12.f), t0);
+
+    const auto ranks = aggregator.getRanks(t0);
+    BOOST_CHECK(!ranks[0].straggler);
+    BOOST_CHECK(!ranks[1].straggler);
+    BOOST_CHECK(!ranks[2].straggler);
+    BOOST_CHECK(ranks[3].straggler);
+
+    const auto surfaces = aggregator.getSurfaces(t0);
+    BOOST_CHECK(surfaces[0].stragglers == std::vector<int>{3});
+    BOOST_CHECK(surfaces[1].stragglers == std::vector<int>{3});
+
+    // Once stale, a process is no longer compared to the others
+    aggregator.add(makeTelemetry(0, 4.f), t0 + ms{3500});
+    aggregator.add(makeTelemetry(1, 5.f), t0 + ms{3500});
+    BOOST_CHECK(!aggregator.getRanks(t0 + ms{3500})[3].straggler);
+}
+
+BOOST_AUTO_TEST_CASE(small_differences_of_work_time_are_not_stragglers)
+{
+    TelemetryAggregator aggregator{makeConfig()};
+    aggregator.add(makeTelemetry(0, 0.5f), t0);
+    aggregator.add(makeTelemetry(1, 0.5f), t0);
+    aggregator.add(makeTelemetry(2, 0.5f), t0);
+    aggregator.add(makeTelemetry(3, 1.2f), t0); // > 1.5x but < 1 ms more
+
+    for (const auto& rank : aggregator.getRanks(t0))
+        BOOST_CHECK(!rank.straggler);
+}
+
+BOOST_AUTO_TEST_CASE(idle_processes_are_not_stragglers)
+{
+    TelemetryAggregator aggregator{makeConfig()};
+    aggregator.add(makeTelemetry(0, 4.f), t0);
+    aggregator.add(makeTelemetry(1, 12.f), t0);
+    auto idle = makeTelemetry(2, 4.f);
+    idle.frames = 0;
+    aggregator.add(idle, t0);
+
+    // Median of the two rendering processes: 8 ms
+    const auto ranks = aggregator.getRanks(t0);
+    BOOST_CHECK(!ranks[1].straggler);
+    BOOST_CHECK(!ranks[2].straggler);
+}
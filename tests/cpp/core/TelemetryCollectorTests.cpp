@@ -0,0 +1,136 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TelemetryCollectorTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/TelemetryCollector.h"
+
+namespace
+{
+using clock = TelemetryCollector::clock;
+using ms = std::chrono::milliseconds;
+
+const auto t0 = clock::time_point{} + std::chrono::hours{1};
+const auto interval = ms{1000};
+}
+
+BOOST_AUTO_TEST_CASE(empty_period_has_no_counters)
+{
+    TelemetryCollector collector{interval, t0};
+    BOOST_CHECK(collector.getInterval() == interval);
+
+    const auto telemetry = collector.collect(t0 + interval);
+    BOOST_CHECK_EQUAL(telemetry.rank, -1);
+    BOOST_CHECK_EQUAL(telemetry.period, 1000.f);
+    BOOST_CHECK_EQUAL(telemetry.frames, 0u);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeMean, 0.f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeP99, 0.f);
+    BOOST_CHECK_EQUAL(telemetry.tilesLoaded, 0u);
+    BOOST_CHECK_EQUAL(telemetry.getFps(), 0.f);
+}
+
+BOOST_AUTO_TEST_CASE(frame_times_are_summarized)
+{
+    TelemetryCollector collector{interval, t0};
+    // 100 frames of 1..100 ms, each waiting 1 ms in the frame sync
+    for (int i = 1; i <= 100; ++i)
+        collector.addFrame(ms{i}, ms{1});
+
+    const auto telemetry = collector.collect(t0 + ms{2000});
+    BOOST_CHECK_EQUAL(telemetry.period, 2000.f);
+    BOOST_CHECK_EQUAL(telemetry.frames, 100u);
+    BOOST_CHECK_EQUAL(telemetry.getFps(), 50.f);
+    BOOST_CHECK_CLOSE(telemetry.frameTimeMean, 50.5f, 0.001f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeP50, 50.f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeP90, 90.f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeP99, 99.f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeMax, 100.f);
+    BOOST_CHECK_EQUAL(telemetry.syncWaitMean, 1.f);
+    BOOST_CHECK_EQUAL(telemetry.syncWaitMax, 1.f);
+    BOOST_CHECK_CLOSE(telemetry.getWorkTimeMean(), 49.5f, 0.001f);
+}
+
+BOOST_AUTO_TEST_CASE(swap_waits_and_tile_loads_are_summarized)
+{
+    TelemetryCollector collector{interval, t0};
+    collector.addSwapWait(ms{2});
+    collector.addSwapWait(ms{4});
+    collector.addTileLoad(ms{10});
+    collector.addTileLoad(ms{20});
+    collector.addTileLoad(ms{30});
+
+    const auto telemetry = collector.collect(t0 + interval);
+    BOOST_CHECK_EQUAL(telemetry.swapWaitMean, 3.f);
+    BOOST_CHECK_EQUAL(telemetry.swapWaitMax, 4.f);
+    BOOST_CHECK_EQUAL(telemetry.tilesLoaded, 3u);
+    BOOST_CHECK_EQUAL(telemetry.decodeTimeMean, 20.f);
+    BOOST_CHECK_EQUAL(telemetry.decodeTimeMax, 30.f);
+}
+
+BOOST_AUTO_TEST_CASE(collect_starts_a_new_period)
+{
+    TelemetryCollector collector{interval, t0};
+    collector.addFrame(ms{40}, ms{0});
+    collector.addTileLoad(ms{5});
+    collector.collect(t0 + interval);
+
+    collector.addFrame(ms{10}, ms{2});
+    const auto telemetry = collector.collect(t0 + ms{1500});
+    BOOST_CHECK_EQUAL(telemetry.period, 500.f);
+    BOOST_CHECK_EQUAL(telemetry.frames, 1u);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeMax, 10.f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeP50, 10.f);
+    BOOST_CHECK_EQUAL(telemetry.tilesLoaded, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(percentiles_are_bounded_to_max_frame_samples)
+{
+    TelemetryCollector collector{interval, t0};
+    const auto count = TelemetryCollector::maxFrameSamples + 100;
+    for (size_t i = 0; i < count; ++i)
+        collector.addFrame(ms{i < TelemetryCollector::maxFrameSamples ? 1 : 50},
+                           ms{0});
+
+    const auto telemetry = collector.collect(t0 + interval);
+    BOOST_CHECK_EQUAL(telemetry.frames, count);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeMax, 50.f);
+    BOOST_CHECK_EQUAL(telemetry.frameTimeP99, 1.f);
+}
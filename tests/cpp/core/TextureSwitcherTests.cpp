@@ -53,6 +53,7 @@ public:
     }
     virtual QRectF getCoord() const { return coord; }
     virtual void setCoord(const QRectF& rect) { coord = rect; }
+    virtual void setDisplaySize(const QSizeF&) {}
     virtual void uploadTexture(const Image& im) { image = &im; }
     virtual void swap() { swapped = true; }
     TextureFormat format;
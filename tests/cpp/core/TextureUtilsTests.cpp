@@ -0,0 +1,70 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TextureUtilsTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "qml/textureUtils.h"
+
+#include <QSizeF>
+
+BOOST_AUTO_TEST_CASE(mipmaps_are_not_needed_at_one_to_one_scale_or_magnified)
+{
+    const auto textureSize = QSize{512, 256};
+
+    BOOST_CHECK(!textureUtils::needMipmaps(textureSize, QSizeF{512, 256}));
+    BOOST_CHECK(!textureUtils::needMipmaps(textureSize, QSizeF{1024, 512}));
+    BOOST_CHECK(!textureUtils::needMipmaps(textureSize, QSizeF{450, 220}));
+}
+
+BOOST_AUTO_TEST_CASE(mipmaps_are_needed_for_minified_textures)
+{
+    const auto textureSize = QSize{512, 256};
+
+    BOOST_CHECK(textureUtils::needMipmaps(textureSize, QSizeF{256, 128}));
+    BOOST_CHECK(textureUtils::needMipmaps(textureSize, QSizeF{512, 128}));
+    BOOST_CHECK(textureUtils::needMipmaps(textureSize, QSizeF{400, 256}));
+}
+
+BOOST_AUTO_TEST_CASE(mipmaps_are_needed_if_the_display_size_is_unknown)
+{
+    BOOST_CHECK(textureUtils::needMipmaps(QSize{512, 256}, QSizeF()));
+    BOOST_CHECK(textureUtils::needMipmaps(QSize{512, 256}, QSizeF{0, 0}));
+}
@@ -0,0 +1,109 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TiffTileWriterTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "data/TiffPyramidReader.h"
+#include "data/TiffTileWriter.h"
+#include "types.h"
+
+#include <QFile>
+
+namespace
+{
+const QString imageFile{"tiff_tile_writer_test.tif"};
+const QSize imageSize{1000, 700};
+const QSize tileSize{256, 128};
+
+QImage _makeTestImage()
+{
+    QImage image{imageSize, QImage::Format_RGB888};
+    for (auto y = 0; y < image.height(); ++y)
+        for (auto x = 0; x < image.width(); ++x)
+            image.setPixel(x, y, qRgb(x % 256, y % 256, (x + y) % 256));
+    return image;
+}
+
+struct FileRemover
+{
+    ~FileRemover() { QFile::remove(imageFile); }
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_write_image_in_bands)
+{
+    const auto image = _makeTestImage();
+    FileRemover remover;
+    {
+        TiffTileWriter writer{imageFile, imageSize, tileSize};
+        auto y = 0;
+        for (const auto height : {300, 90, 310})
+        {
+            writer.write(image.copy(0, y, imageSize.width(), height));
+            y += height;
+            BOOST_CHECK_EQUAL(writer.getRowCount(), y);
+        }
+    }
+
+    TiffPyramidReader reader{imageFile};
+    BOOST_CHECK_EQUAL(reader.getImageSize(), imageSize);
+    BOOST_CHECK_EQUAL(reader.getTileSize(), tileSize);
+    BOOST_CHECK(reader.readImage(0) == image);
+}
+
+BOOST_AUTO_TEST_CASE(test_rows_must_fit_in_image)
+{
+    FileRemover remover;
+    TiffTileWriter writer{imageFile, imageSize, tileSize};
+
+    const auto tooWide = QImage{imageSize.width() + 1, 1, QImage::Format_RGB32};
+    BOOST_CHECK_THROW(writer.write(tooWide), std::invalid_argument);
+
+    writer.write(QImage{imageSize, QImage::Format_RGB32});
+    const auto extraRow = QImage{imageSize.width(), 1, QImage::Format_RGB32};
+    BOOST_CHECK_THROW(writer.write(extraRow), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_tile_size)
+{
+    BOOST_CHECK_THROW(TiffTileWriter(imageFile, imageSize, QSize(100, 100)),
+                      std::invalid_argument);
+}
@@ -0,0 +1,170 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TileCacheTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/TileCache.h"
+
+namespace
+{
+const QSize tileSize{16, 16};
+const size_t tileBytes = 16 * 16 * 4;
+const int sourceA = 0;
+const int sourceB = 1;
+
+QImage makeImage()
+{
+    return QImage{tileSize, QImage::Format_ARGB32};
+}
+
+TileCache::Key makeKey(const uint tileId, const void* source = &sourceA)
+{
+    return {source, tileId, 0};
+}
+}
+
+BOOST_AUTO_TEST_CASE(get_counts_hits_and_misses)
+{
+    TileCache cache{10 * tileBytes};
+
+    BOOST_CHECK(cache.get(makeKey(0)).isNull());
+    BOOST_CHECK(cache.insert(makeKey(0), makeImage()));
+    BOOST_CHECK(!cache.get(makeKey(0)).isNull());
+    BOOST_CHECK(cache.get(makeKey(0, &sourceB)).isNull());
+    BOOST_CHECK(cache.get(TileCache::Key{&sourceA, 0, 1}).isNull());
+
+    const auto stats = cache.getStats();
+    BOOST_CHECK_EQUAL(stats.hits, 1);
+    BOOST_CHECK_EQUAL(stats.misses, 3);
+    BOOST_CHECK_EQUAL(stats.evictions, 0);
+    BOOST_CHECK_EQUAL(stats.tileCount, 1);
+    BOOST_CHECK_EQUAL(stats.size, tileBytes);
+    BOOST_CHECK_EQUAL(stats.maxSize, 10 * tileBytes);
+}
+
+BOOST_AUTO_TEST_CASE(contains_does_not_affect_stats)
+{
+    TileCache cache{10 * tileBytes};
+    cache.insert(makeKey(0), makeImage());
+
+    BOOST_CHECK(cache.contains(makeKey(0)));
+    BOOST_CHECK(!cache.contains(makeKey(1)));
+    BOOST_CHECK_EQUAL(cache.getStats().hits, 0);
+    BOOST_CHECK_EQUAL(cache.getStats().misses, 0);
+}
+
+BOOST_AUTO_TEST_CASE(replacing_a_tile_does_not_grow_the_cache)
+{
+    TileCache cache{10 * tileBytes};
+
+    BOOST_CHECK(cache.insert(makeKey(0), makeImage()));
+    BOOST_CHECK(!cache.insert(makeKey(0), makeImage()));
+    BOOST_CHECK_EQUAL(cache.getStats().tileCount, 1);
+    BOOST_CHECK_EQUAL(cache.getStats().size, tileBytes);
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used_tiles_are_evicted_first)
+{
+    TileCache cache{3 * tileBytes};
+    cache.insert(makeKey(0), makeImage());
+    cache.insert(makeKey(1), makeImage());
+    cache.insert(makeKey(2), makeImage());
+    cache.get(makeKey(0));
+
+    cache.insert(makeKey(3), makeImage());
+
+    BOOST_CHECK(cache.contains(makeKey(0)));
+    BOOST_CHECK(!cache.contains(makeKey(1)));
+    BOOST_CHECK(cache.contains(makeKey(2)));
+    BOOST_CHECK(cache.contains(makeKey(3)));
+    BOOST_CHECK_EQUAL(cache.getStats().evictions, 1);
+    BOOST_CHECK_EQUAL(cache.getStats().size, 3 * tileBytes);
+}
+
+BOOST_AUTO_TEST_CASE(pinned_tiles_are_not_evicted)
+{
+    TileCache cache{2 * tileBytes};
+    cache.pin(&sourceA, 0);
+    cache.pin(&sourceA, 1);
+    cache.insert(makeKey(0), makeImage());
+    cache.insert(makeKey(1), makeImage());
+    cache.insert(makeKey(2), makeImage());
+
+    // The unpinned tile goes first, even though it is the most recent one
+    BOOST_CHECK(cache.contains(makeKey(0)));
+    BOOST_CHECK(cache.contains(makeKey(1)));
+    BOOST_CHECK(!cache.contains(makeKey(2)));
+
+    // Visible tiles are kept even if they exceed the budget
+    cache.pin(&sourceA, 2);
+    cache.insert(makeKey(2), makeImage());
+    BOOST_CHECK_EQUAL(cache.getStats().tileCount, 3);
+    BOOST_CHECK_EQUAL(cache.getStats().size, 3 * tileBytes);
+
+    // Pins are reference counted
+    cache.pin(&sourceA, 0);
+    cache.unpin(&sourceA, 0);
+    BOOST_CHECK(cache.contains(makeKey(0)));
+
+    // The least recently used tile is evicted once unpinned
+    cache.unpin(&sourceA, 0);
+    BOOST_CHECK(!cache.contains(makeKey(0)));
+    BOOST_CHECK_EQUAL(cache.getStats().size, 2 * tileBytes);
+    BOOST_CHECK_EQUAL(cache.getStats().evictions, 2);
+}
+
+BOOST_AUTO_TEST_CASE(remove_source_clears_its_tiles_and_pins)
+{
+    TileCache cache{10 * tileBytes};
+    cache.pin(&sourceA, 0);
+    cache.insert(makeKey(0), makeImage());
+    cache.insert(makeKey(1), makeImage());
+    cache.insert(makeKey(0, &sourceB), makeImage());
+
+    cache.remove(&sourceA);
+
+    BOOST_CHECK(!cache.contains(makeKey(0)));
+    BOOST_CHECK(!cache.contains(makeKey(1)));
+    BOOST_CHECK(cache.contains(makeKey(0, &sourceB)));
+    BOOST_CHECK_EQUAL(cache.getStats().tileCount, 1);
+    BOOST_CHECK_EQUAL(cache.getStats().size, tileBytes);
+    BOOST_CHECK_EQUAL(cache.getStats().evictions, 0);
+}
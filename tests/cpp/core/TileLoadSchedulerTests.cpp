@@ -0,0 +1,180 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TileLoadSchedulerTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/TileLoadScheduler.h"
+
+#include <atomic>
+#include <future>
+
+namespace
+{
+using Request = TileLoadScheduler::Request;
+using SourceType = TileLoadScheduler::SourceType;
+
+struct Fixture
+{
+    // A single thread, kept busy until release() so that requests queue up
+    TileLoadScheduler scheduler{1};
+    std::promise<void> gate;
+    std::vector<int> loaded;
+
+    Fixture()
+    {
+        std::promise<void> started;
+        auto future = gate.get_future().share();
+        Request blocker;
+        blocker.load = [&started, future] {
+            started.set_value();
+            future.wait();
+        };
+        scheduler.submit(blocker);
+        started.get_future().wait();
+    }
+
+    Request makeRequest(const int id, const SourceType type,
+                        const unsigned int lod = 0, const double area = 0.0)
+    {
+        Request request;
+        request.sourceType = type;
+        request.lod = lod;
+        request.area = area;
+        request.load = [this, id] { loaded.push_back(id); };
+        return request;
+    }
+
+    void release()
+    {
+        gate.set_value();
+        scheduler.waitForIdle();
+    }
+};
+}
+
+BOOST_FIXTURE_TEST_CASE(requests_are_loaded_by_priority, Fixture)
+{
+    scheduler.submit(makeRequest(0, SourceType::static_, 0, 100.0));
+    scheduler.submit(makeRequest(1, SourceType::static_, 2, 10.0));
+    scheduler.submit(makeRequest(2, SourceType::movie));
+    scheduler.submit(makeRequest(3, SourceType::static_, 0, 500.0));
+    scheduler.submit(makeRequest(4, SourceType::stream));
+    scheduler.submit(makeRequest(5, SourceType::static_, 2, 10.0));
+    scheduler.submit(makeRequest(6, SourceType::static_, 1, 1000.0));
+    scheduler.submit(makeRequest(7, SourceType::prefetch, 5, 1000.0));
+    BOOST_CHECK_EQUAL(scheduler.getPendingCount(), 8);
+
+    release();
+
+    const auto expected = std::vector<int>{4, 2, 1, 5, 6, 3, 0, 7};
+    BOOST_CHECK_EQUAL_COLLECTIONS(loaded.begin(), loaded.end(),
+                                  expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(scheduler.getStats().loaded, 9);
+    BOOST_CHECK_EQUAL(scheduler.getStats().cancelled, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(obsolete_requests_are_cancelled_before_start, Fixture)
+{
+    auto obsolete = std::make_shared<std::atomic<bool>>(false);
+
+    auto request = makeRequest(0, SourceType::static_);
+    request.isObsolete = [obsolete] { return obsolete->load(); };
+    scheduler.submit(request);
+    scheduler.submit(makeRequest(1, SourceType::static_));
+
+    *obsolete = true;
+    release();
+
+    BOOST_REQUIRE_EQUAL(loaded.size(), 1);
+    BOOST_CHECK_EQUAL(loaded[0], 1);
+    BOOST_CHECK_EQUAL(scheduler.getStats().cancelled, 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(cancel_obsolete_pending_requests, Fixture)
+{
+    auto obsolete = std::make_shared<std::atomic<bool>>(false);
+    for (auto i = 0; i < 10; ++i)
+    {
+        auto request = makeRequest(i, SourceType::static_, 0, i);
+        if (i % 2)
+            request.isObsolete = [obsolete] { return obsolete->load(); };
+        scheduler.submit(request);
+    }
+
+    BOOST_CHECK_EQUAL(scheduler.cancelObsoleteRequests(), 0);
+    *obsolete = true;
+    BOOST_CHECK_EQUAL(scheduler.cancelObsoleteRequests(), 5);
+    BOOST_CHECK_EQUAL(scheduler.getPendingCount(), 5);
+
+    release();
+
+    // Removing entries must preserve the priority order of the others
+    const auto expected = std::vector<int>{8, 6, 4, 2, 0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(loaded.begin(), loaded.end(),
+                                  expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(scheduler.getStats().cancelled, 5);
+}
+
+BOOST_AUTO_TEST_CASE(pending_requests_are_cancelled_on_destruction)
+{
+    std::atomic<int> loadCount{0};
+    std::promise<void> submitted;
+    auto future = submitted.get_future().share();
+    {
+        TileLoadScheduler scheduler{1};
+
+        // Keep the only thread busy until the destructor empties the queue
+        Request blocker;
+        blocker.load = [&scheduler, future] {
+            future.wait();
+            while (scheduler.getPendingCount() > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        };
+        scheduler.submit(blocker);
+
+        Request request;
+        request.load = [&loadCount] { ++loadCount; };
+        for (auto i = 0; i < 5; ++i)
+            scheduler.submit(request);
+        submitted.set_value();
+    }
+    BOOST_CHECK_EQUAL(loadCount, 0);
+}
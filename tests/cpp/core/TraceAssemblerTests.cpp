@@ -0,0 +1,209 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TraceAssemblerTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/TraceAssembler.h"
+
+#include "MinimalGlobalQtApp.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+using ns = std::chrono::nanoseconds;
+using us = std::chrono::microseconds;
+using ms = std::chrono::milliseconds;
+
+// The clock of the walls is ahead of the master's
+const auto wallClockOffset = ms{5};
+
+// Long enough never to expire during a test, unless stated otherwise
+const auto noTimeout = ms{3600000};
+
+TraceReply makeReply(const int64_t masterSendTime, const us requestDelay,
+                     const us replyDelay)
+{
+    const auto offset = ns{wallClockOffset}.count();
+    TraceReply reply;
+    reply.requestSendTime = masterSendTime;
+    reply.requestReceiveTime =
+        masterSendTime + ns{requestDelay}.count() + offset;
+    reply.sendTime = reply.requestReceiveTime + ns{ms{2}}.count();
+    reply.receiveTime = reply.sendTime + ns{replyDelay}.count() - offset;
+    return reply;
+}
+}
+
+BOOST_GLOBAL_FIXTURE(MinimalGlobalQtApp);
+
+BOOST_AUTO_TEST_CASE(estimate_clock_offset_with_symmetric_delays)
+{
+    const auto replies = std::vector<TraceReply>{
+        makeReply(1000000000, us{100}, us{100})};
+    BOOST_CHECK(TraceAssembler::estimateClockOffset(replies) ==
+                wallClockOffset);
+}
+
+BOOST_AUTO_TEST_CASE(estimate_clock_offset_uses_shortest_round_trip)
+{
+    const auto replies = std::vector<TraceReply>{
+        makeReply(1000000000, us{900}, us{100}),
+        makeReply(1000000000, us{50}, us{50}),
+        makeReply(1000000000, us{100}, us{1500})};
+    BOOST_CHECK(TraceAssembler::estimateClockOffset(replies) ==
+                wallClockOffset);
+}
+
+BOOST_AUTO_TEST_CASE(estimate_clock_offset_without_replies)
+{
+    BOOST_CHECK(TraceAssembler::estimateClockOffset({}) ==
+                trace::clock::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(assemble_trace_of_all_processes)
+{
+    const auto begin = trace::clock::time_point{} + ms{1000};
+    auto event = trace::Event{"sendFrame", begin, ms{1}};
+    auto masterEvents = std::vector<trace::ThreadEvents>{{1, "Send", {event}}};
+
+    TraceAssembler assembler{std::move(masterEvents), 2, noTimeout};
+
+    QByteArray json;
+    std::vector<int> missingRanks{-1};
+    QObject::connect(&assembler, &TraceAssembler::traceComplete,
+                     [&](const QByteArray data, const std::vector<int> ranks) {
+                         json = data;
+                         missingRanks = ranks;
+                     });
+
+    event.name = "syncAndRender";
+    auto reply = makeReply(1000000000, us{100}, us{100});
+    reply.events = trace::toChromeEvents({{1, "Main", {event}}}, 1, "Wall");
+    assembler.addReply(reply);
+    BOOST_CHECK(!assembler.isComplete());
+    BOOST_CHECK(json.isEmpty());
+
+    reply.rank = 1;
+    reply.events = trace::toChromeEvents({{1, "Main", {event}}}, 2, "Wall");
+    assembler.addReply(reply);
+    BOOST_CHECK(assembler.isFinished());
+    BOOST_CHECK(missingRanks.empty());
+    BOOST_CHECK(assembler.isComplete());
+    BOOST_REQUIRE(!json.isEmpty());
+
+    const auto doc = QJsonDocument::fromJson(json);
+    BOOST_REQUIRE(doc.isObject());
+    const auto events = doc.object()["traceEvents"].toArray();
+    // process_name, thread_name and one event for each of the 3 processes
+    BOOST_REQUIRE_EQUAL(events.size(), 9);
+
+    auto masterEvent = events[2].toObject();
+    BOOST_CHECK_EQUAL(masterEvent["ph"].toString().toStdString(), "X");
+    BOOST_CHECK_EQUAL(masterEvent["name"].toString().toStdString(),
+                      "sendFrame");
+    BOOST_CHECK_EQUAL(masterEvent["pid"].toInt(), 0);
+    BOOST_CHECK_EQUAL(masterEvent["ts"].toDouble(), 1005000.0);
+    BOOST_CHECK_EQUAL(masterEvent["dur"].toDouble(), 1000.0);
+
+    for (int i = 3; i < events.size(); ++i)
+    {
+        const auto wallEvent = events[i].toObject();
+        BOOST_CHECK_EQUAL(wallEvent["pid"].toInt(), i < 6 ? 1 : 2);
+        if (wallEvent["ph"].toString() == "X")
+            BOOST_CHECK_EQUAL(wallEvent["ts"].toDouble(), 1000000.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(finish_assembles_trace_without_missing_processes)
+{
+    TraceAssembler assembler{{}, 3, noTimeout};
+
+    QByteArray json;
+    std::vector<int> missingRanks;
+    size_t traces = 0;
+    QObject::connect(&assembler, &TraceAssembler::traceComplete,
+                     [&](const QByteArray data, const std::vector<int> ranks) {
+                         json = data;
+                         missingRanks = ranks;
+                         ++traces;
+                     });
+
+    auto reply = makeReply(1000000000, us{100}, us{100});
+    reply.rank = 1;
+    assembler.addReply(reply);
+    assembler.addReply(reply); // duplicates are ignored
+    BOOST_CHECK(assembler.getMissingRanks() == (std::vector<int>{0, 2}));
+
+    assembler.finish();
+    BOOST_CHECK(assembler.isFinished());
+    BOOST_CHECK(!assembler.isComplete());
+    BOOST_CHECK_EQUAL(traces, 1);
+    BOOST_CHECK(!json.isEmpty());
+    BOOST_CHECK(missingRanks == (std::vector<int>{0, 2}));
+
+    // Late replies and further calls are ignored
+    reply.rank = 0;
+    assembler.addReply(reply);
+    assembler.finish();
+    BOOST_CHECK_EQUAL(traces, 1);
+    BOOST_CHECK(assembler.getMissingRanks() == (std::vector<int>{0, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(trace_assembled_after_timeout)
+{
+    TraceAssembler assembler{{}, 2, ms{0}};
+
+    std::vector<int> missingRanks;
+    QObject::connect(&assembler, &TraceAssembler::traceComplete,
+                     [&](const QByteArray, const std::vector<int> ranks) {
+                         missingRanks = ranks;
+                     });
+    assembler.addReply(makeReply(1000000000, us{100}, us{100}));
+    BOOST_CHECK(!assembler.isFinished());
+
+    for (int i = 0; i < 100 && !assembler.isFinished(); ++i)
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    BOOST_CHECK(assembler.isFinished());
+    BOOST_CHECK(missingRanks == std::vector<int>{1});
+}
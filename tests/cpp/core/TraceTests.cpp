@@ -0,0 +1,162 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TraceTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils/trace.h"
+
+#include <thread>
+
+namespace
+{
+using ns = std::chrono::nanoseconds;
+using us = std::chrono::microseconds;
+
+const auto t0 = trace::clock::time_point{} + std::chrono::seconds{1};
+
+struct Fixture
+{
+    Fixture() { trace::clear(); }
+    ~Fixture()
+    {
+        trace::setEnabled(false);
+        trace::clear();
+    }
+};
+
+size_t countEvents(const std::vector<trace::ThreadEvents>& threads)
+{
+    size_t count = 0;
+    for (const auto& thread : threads)
+        count += thread.events.size();
+    return count;
+}
+}
+
+BOOST_FIXTURE_TEST_CASE(tracing_is_disabled_by_default, Fixture)
+{
+    BOOST_CHECK(!trace::isEnabled());
+    {
+        TIDE_TRACE_SCOPE("disabled");
+    }
+    BOOST_CHECK_EQUAL(countEvents(trace::getEvents()), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(scopes_are_recorded_when_they_end, Fixture)
+{
+    trace::setEnabled(true);
+    {
+        TIDE_TRACE_SCOPE("outer");
+        {
+            TIDE_TRACE_SCOPE("inner");
+        }
+    }
+    trace::setEnabled(false);
+    {
+        TIDE_TRACE_SCOPE("ignored");
+    }
+
+    const auto threads = trace::getEvents();
+    BOOST_REQUIRE_EQUAL(threads.size(), 1);
+    const auto& events = threads[0].events;
+    BOOST_REQUIRE_EQUAL(events.size(), 2);
+    BOOST_CHECK_EQUAL(events[0].name, "inner");
+    BOOST_CHECK_EQUAL(events[1].name, "outer");
+    BOOST_CHECK(events[1].begin <= events[0].begin);
+    BOOST_CHECK(events[1].begin + events[1].duration >=
+                events[0].begin + events[0].duration);
+}
+
+BOOST_FIXTURE_TEST_CASE(ring_buffer_keeps_most_recent_events, Fixture)
+{
+    const auto count = trace::bufferCapacity + 10;
+    for (size_t i = 0; i < count; ++i)
+        trace::record("event", t0 + us{i}, t0 + us{i + 1});
+
+    const auto threads = trace::getEvents();
+    BOOST_REQUIRE_EQUAL(threads.size(), 1);
+    const auto& events = threads[0].events;
+    BOOST_REQUIRE_EQUAL(events.size(), trace::bufferCapacity);
+    BOOST_CHECK(events.front().begin == t0 + us{10});
+    BOOST_CHECK(events.back().begin == t0 + us{count - 1});
+    for (size_t i = 1; i < events.size(); ++i)
+        BOOST_REQUIRE(events[i - 1].begin < events[i].begin);
+}
+
+BOOST_FIXTURE_TEST_CASE(each_thread_has_its_own_buffer, Fixture)
+{
+    trace::record("main", t0, t0 + us{1});
+    std::thread thread{[] { trace::record("worker", t0, t0 + us{2}); }};
+    thread.join();
+
+    auto threads = trace::getEvents();
+    BOOST_REQUIRE_EQUAL(threads.size(), 2);
+    BOOST_CHECK_NE(threads[0].id, threads[1].id);
+    BOOST_CHECK_EQUAL(threads[0].events.size(), 1);
+    BOOST_CHECK_EQUAL(threads[1].events.size(), 1);
+
+    // Events of terminated threads are kept until cleared
+    trace::clear();
+    trace::record("main", t0, t0 + us{1});
+    threads = trace::getEvents();
+    BOOST_REQUIRE_EQUAL(threads.size(), 1);
+    BOOST_CHECK_EQUAL(threads[0].events[0].name, "main");
+}
+
+BOOST_FIXTURE_TEST_CASE(chrome_events_format, Fixture)
+{
+    const auto begin = trace::clock::time_point{} + ns{1234567891};
+    trace::record("swap", begin, begin + ns{16667001});
+    auto threads = trace::getEvents();
+    BOOST_REQUIRE_EQUAL(threads.size(), 1);
+    threads[0].name = "Render \"#0\"";
+    const auto tid = std::to_string(threads[0].id);
+
+    const auto json = trace::toChromeEvents(threads, 3, "wall", -us{1000});
+    const auto expected =
+        std::string{"{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":3,"} +
+        "\"tid\":0,\"args\":{\"name\":\"wall\"}}," +
+        "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":3,\"tid\":" + tid +
+        ",\"args\":{\"name\":\"Render \\\"#0\\\"\"}}," +
+        "{\"ph\":\"X\",\"name\":\"swap\",\"pid\":3,\"tid\":" + tid +
+        ",\"ts\":1233567.891,\"dur\":16667.001}";
+    BOOST_CHECK_EQUAL(json, expected);
+}
@@ -0,0 +1,359 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE TransportTests
+#include <boost/test/unit_test.hpp>
+
+#include "TransportRunner.h"
+
+#include <algorithm>
+
+// Each check runs on the processes connected by sockets, then on the
+// processes of the MPI program: a single one, or as many as started with
+// mpiexec (e.g. "mpiexec -n 4 TransportTests").
+
+BOOST_GLOBAL_FIXTURE(MPIProcesses);
+
+namespace
+{
+using Block = Transport::Block;
+
+const int socketProcesses = 4;
+
+template <typename F>
+void runOnAllTransports(const F& check)
+{
+    runOnSockets(socketProcesses, check);
+    runOnMPI(check);
+}
+
+std::vector<uint64_t> _range(const uint64_t begin, const uint64_t end,
+                             const uint64_t step = 1)
+{
+    std::vector<uint64_t> values;
+    for (auto value = begin; value < end; value += step)
+        values.push_back(value);
+    return values;
+}
+
+void checkRankAndSize(Transport& transport)
+{
+    const auto size = transport.getSize();
+    const auto ranks = transport.allgather({uint64_t(transport.getRank())});
+    expect(ranks == _range(0, size), "ranks are not 0 to size - 1");
+
+    const auto sizes = transport.allgather({uint64_t(size)});
+    expect(sizes == std::vector<uint64_t>(size, size), "sizes differ");
+}
+
+void checkReceiveFromAnySource(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto size = transport.getSize();
+    if (rank > 0)
+    {
+        sendMessage(transport, std::vector<char>(rank, char(rank)), 0, 7);
+        return;
+    }
+    std::vector<int> received(size, 0);
+    for (int i = 1; i < size; ++i)
+    {
+        const auto data = receiveMessage(transport, Transport::anySource,
+                                         Transport::anyTag);
+        expect(!data.empty() && data[0] > 0 && data[0] < size,
+               "unexpected source");
+        expect(data == std::vector<char>(data[0], data[0]), "corrupt data");
+        ++received[data[0]];
+    }
+    for (int src = 1; src < size; ++src)
+        expect(received[src] == 1, "message not received exactly once");
+}
+
+void checkMatchBySourceAndTag(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto sender = transport.getSize() - 1;
+    if (rank == sender)
+    {
+        sendMessage(transport, {'a'}, 0, 1);
+        sendMessage(transport, {'b'}, 0, 2);
+        sendMessage(transport, {'c'}, 0, 1);
+    }
+    if (rank != 0)
+        return;
+    expect(receiveMessage(transport, sender, 2)[0] == 'b', "wrong tag");
+    expect(receiveMessage(transport, sender, 1)[0] == 'a', "wrong order");
+    expect(receiveMessage(transport, sender, 1)[0] == 'c', "wrong order");
+}
+
+void checkLargeMessage(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto receiver = transport.getSize() - 1;
+    if (receiver == 0)
+        return; // a large message to self would wait for its receive on MPI
+
+    const auto message = makeData(10 * 1024 * 1024 + 17);
+    if (rank == 0)
+        sendMessage(transport, message, receiver, 0);
+    else if (rank == receiver)
+        expect(receiveMessage(transport, 0, 0) == message, "corrupt data");
+}
+
+void checkBroadcast(Transport& transport)
+{
+    const auto root = transport.getSize() - 1;
+    Waiter waiter;
+    int value = transport.getRank() == root ? 42 : 0;
+    transport.broadcast((char*)&value, sizeof(value), root, waiter);
+    expect(value == 42, "value not broadcast");
+}
+
+void checkBroadcastSegments(Transport& transport)
+{
+    const auto root = transport.getSize() / 2;
+    const auto message = makeData(1000);
+    const size_t split = 300;
+    auto data = transport.getRank() == root
+                    ? message
+                    : std::vector<char>(message.size());
+    const std::vector<Block> blocks{{data.data(), split},
+                                    {data.data() + split,
+                                     data.size() - split}};
+    transport.broadcast(blocks, data.size(), root, 128, 2, {});
+    expect(data == message, "blocks not broadcast");
+}
+
+void checkSegmentsReachConsumerBeforeLastOne(Transport& transport)
+{
+    const auto root = 0;
+    const size_t segmentSize = 128;
+    const size_t segmentsCount = 8;
+    const auto isRoot = transport.getRank() == root;
+    const auto message = makeData(segmentsCount * segmentSize);
+    auto data = isRoot ? message : std::vector<char>(message.size(), -1);
+    const auto lastSegment = data.end() - segmentSize;
+
+    size_t receivedSize = 0;
+    bool lastSegmentPending = false;
+    transport.broadcast({Block{data.data(), data.size()}}, data.size(), root,
+                        segmentSize, 2,
+                        [&](const size_t offset, const size_t size) {
+                            expect(offset == receivedSize && size > 0,
+                                   "segments not received in order");
+                            if (offset == 0 && !isRoot)
+                            {
+                                lastSegmentPending = std::all_of(
+                                    lastSegment, data.end(),
+                                    [](const char c) { return c == -1; });
+                            }
+                            receivedSize += size;
+                        });
+    expect(receivedSize == message.size(), "not all segments consumed");
+    expect(isRoot || lastSegmentPending,
+           "first segment consumed after the last one was received");
+    expect(data == message, "segments not broadcast");
+}
+
+void checkScatter(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto size = transport.getSize();
+    const auto root = size - 1;
+    if (rank == root)
+    {
+        std::vector<std::vector<char>> data;
+        data.reserve(size);
+        std::vector<std::vector<Block>> messages;
+        for (int i = 0; i < size; ++i)
+        {
+            data.emplace_back(i + 1, char('a' + i));
+            auto& message = data.back();
+            messages.push_back({Block{message.data(), 1},
+                                Block{message.data() + 1, message.size() - 1}});
+        }
+        transport.scatter(messages);
+        return;
+    }
+    std::vector<char> received;
+    transport.receiveScatter(root, [&received](const size_t size) {
+        received.resize(size);
+        return received.data();
+    });
+    expect(received == std::vector<char>(rank + 1, char('a' + rank)),
+           "wrong message scattered");
+}
+
+void checkCollectives(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto size = transport.getSize();
+    transport.barrier();
+
+    const auto sum = transport.allreduce(rank + 1, Transport::Operation::sum);
+    expect(sum == size * (size + 1) / 2, "wrong sum");
+    const auto max = transport.allreduce(-rank, Transport::Operation::max);
+    expect(max == 0, "wrong maximum");
+
+    std::vector<uint64_t> expected;
+    for (int i = 0; i < size; ++i)
+        expected.insert(expected.end(), {uint64_t(i), 10});
+    const auto root = size / 2;
+    const auto gathered = transport.gather({uint64_t(rank), 10}, root);
+    expect(gathered == (rank == root ? expected : std::vector<uint64_t>()),
+           "wrong gather");
+    expect(transport.allgather({uint64_t(rank), 10}) == expected,
+           "wrong allgather");
+
+    std::vector<uint64_t> expectedVariable;
+    for (int i = 0; i < size; ++i)
+        expectedVariable.insert(expectedVariable.end(), i, i);
+    const auto values = std::vector<uint64_t>(rank, rank);
+    expect(transport.allgatherVariable(values) == expectedVariable,
+           "wrong allgather of variable sizes");
+
+    // Known counts, with the values of the last process first
+    std::vector<int> counts, offsets(size);
+    for (int i = 0; i < size; ++i)
+        counts.push_back(i);
+    for (int i = size - 2; i >= 0; --i)
+        offsets[i] = offsets[i + 1] + counts[i + 1];
+    std::vector<uint64_t> expectedPlaced;
+    for (int i = size - 1; i >= 0; --i)
+        expectedPlaced.insert(expectedPlaced.end(), i, i);
+    expect(transport.allgatherVariable(values, counts, offsets) ==
+               expectedPlaced,
+           "wrong allgather of known sizes");
+    transport.barrier();
+}
+
+void checkSplitGroupsAreIsolated(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto size = transport.getSize();
+    const auto group = transport.split(rank % 2);
+    expect(group->getRank() == rank / 2, "wrong rank in group");
+    expect(group->getSize() == (size + 1 - rank % 2) / 2,
+           "wrong group size");
+    expect(group->allgather({uint64_t(rank)}) == _range(rank % 2, size, 2),
+           "wrong group members");
+
+    // The same tag in the parent group does not interfere
+    if (group->getSize() < 2 || size < 2)
+        return;
+    if (group->getRank() == 0)
+        sendMessage(*group, {char(rank)}, 1, 3);
+    if (rank == 0)
+        sendMessage(transport, {'x'}, 1, 3);
+    if (group->getRank() == 1)
+    {
+        const auto data = receiveMessage(*group, 0, 3);
+        expect(data[0] == char(rank % 2), "message from the parent group");
+    }
+    if (rank == 1)
+        expect(receiveMessage(transport, 0, 3)[0] == 'x', "wrong message");
+}
+
+void checkSplitByHost(Transport& transport)
+{
+    const auto rank = transport.getRank();
+    const auto host = transport.splitByHost();
+    const auto members = host->allgather({uint64_t(rank)});
+    expect(int(members.size()) == host->getSize(), "wrong host size");
+    expect(std::is_sorted(members.begin(), members.end()),
+           "host ranks are not ordered like the parent ranks");
+    expect(members[host->getRank()] == uint64_t(rank), "wrong host rank");
+}
+}
+
+BOOST_AUTO_TEST_CASE(processes_get_their_rank_and_size)
+{
+    runOnAllTransports(checkRankAndSize);
+}
+
+BOOST_AUTO_TEST_CASE(probe_and_receive_messages_from_any_source)
+{
+    runOnAllTransports(checkReceiveFromAnySource);
+}
+
+BOOST_AUTO_TEST_CASE(messages_are_matched_by_source_and_tag)
+{
+    runOnAllTransports(checkMatchBySourceAndTag);
+}
+
+BOOST_AUTO_TEST_CASE(send_large_message)
+{
+    runOnAllTransports(checkLargeMessage);
+}
+
+BOOST_AUTO_TEST_CASE(broadcast_small_message)
+{
+    runOnAllTransports(checkBroadcast);
+}
+
+BOOST_AUTO_TEST_CASE(broadcast_blocks_in_segments)
+{
+    runOnAllTransports(checkBroadcastSegments);
+}
+
+BOOST_AUTO_TEST_CASE(broadcast_segments_reach_consumer_before_last_one)
+{
+    runOnAllTransports(checkSegmentsReachConsumerBeforeLastOne);
+}
+
+BOOST_AUTO_TEST_CASE(scatter_messages)
+{
+    runOnAllTransports(checkScatter);
+}
+
+BOOST_AUTO_TEST_CASE(collective_operations)
+{
+    runOnAllTransports(checkCollectives);
+}
+
+BOOST_AUTO_TEST_CASE(split_groups_are_isolated)
+{
+    runOnAllTransports(checkSplitGroupsAreIsolated);
+}
+
+BOOST_AUTO_TEST_CASE(split_by_host_keeps_the_order_of_ranks)
+{
+    runOnAllTransports(checkSplitByHost);
+    runOnHosts({"a", "b", "a", "c", "b"}, checkSplitByHost);
+}
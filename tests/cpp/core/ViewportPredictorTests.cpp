@@ -0,0 +1,153 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE ViewportPredictorTests
+
+#include <boost/test/unit_test.hpp>
+
+#include "tools/ViewportPredictor.h"
+#include "types.h" // operator<< for Qt types
+
+namespace
+{
+using Viewport = ViewportPredictor::Viewport;
+using ms = std::chrono::milliseconds;
+
+const auto t0 = ViewportPredictor::clock::time_point{};
+const auto frameInterval = ms{16};
+const auto frameCount = 20;
+const QSizeF displaySize{1000.0, 500.0};
+
+Viewport makeViewport(const qreal x, const qreal y, const qreal scale = 1.0)
+{
+    return {QRectF{x, y, 0.5 / scale, 0.5 / scale}, displaySize * scale};
+}
+
+ViewportPredictor::clock::time_point frameTime(const int frame)
+{
+    return t0 + frame * frameInterval;
+}
+}
+
+BOOST_AUTO_TEST_CASE(static_viewport_is_not_moving)
+{
+    ViewportPredictor predictor;
+    BOOST_CHECK(!predictor.isMoving());
+
+    for (int i = 0; i < frameCount; ++i)
+        predictor.addSample(makeViewport(0.25, 0.25), frameTime(i));
+
+    BOOST_CHECK(!predictor.isMoving());
+    BOOST_CHECK_EQUAL(predictor.predict().area, makeViewport(0.25, 0.25).area);
+    BOOST_CHECK_EQUAL(predictor.predict().displaySize, displaySize);
+}
+
+BOOST_AUTO_TEST_CASE(constant_pan_is_extrapolated)
+{
+    ViewportPredictor predictor{ms{250}};
+
+    // Pan to the right at 0.5 content widths per second
+    const auto speed = 0.5;
+    for (int i = 0; i < frameCount; ++i)
+    {
+        const auto x = speed * i * 0.016;
+        predictor.addSample(makeViewport(x, 0.0), frameTime(i));
+    }
+    BOOST_REQUIRE(predictor.isMoving());
+
+    const auto lastX = speed * (frameCount - 1) * 0.016;
+    const auto prediction = predictor.predict();
+    BOOST_CHECK_CLOSE(prediction.area.x(), lastX + speed * 0.25, 0.1);
+    BOOST_CHECK_SMALL(prediction.area.y(), 1e-9);
+    BOOST_CHECK_CLOSE(prediction.area.width(), 0.5, 1e-6);
+    BOOST_CHECK_EQUAL(prediction.displaySize, displaySize);
+}
+
+BOOST_AUTO_TEST_CASE(zoom_in_increases_predicted_display_size)
+{
+    ViewportPredictor predictor;
+
+    for (int i = 0; i < frameCount; ++i)
+        predictor.addSample(makeViewport(0.0, 0.0, 1.0 + 0.1 * i),
+                            frameTime(i));
+    BOOST_REQUIRE(predictor.isMoving());
+
+    const auto last = makeViewport(0.0, 0.0, 1.0 + 0.1 * (frameCount - 1));
+    const auto prediction = predictor.predict();
+    BOOST_CHECK_GT(prediction.displaySize.width(), last.displaySize.width());
+    BOOST_CHECK_GT(prediction.displaySize.height(), last.displaySize.height());
+    BOOST_CHECK_LT(prediction.area.width(), last.area.width());
+    BOOST_CHECK_GE(prediction.area.width(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(pause_resets_motion)
+{
+    ViewportPredictor predictor;
+
+    for (int i = 0; i < frameCount; ++i)
+        predictor.addSample(makeViewport(0.01 * i, 0.0), frameTime(i));
+    BOOST_REQUIRE(predictor.isMoving());
+
+    const auto viewport = makeViewport(0.5, 0.0);
+    predictor.addSample(viewport, frameTime(frameCount) + ms{500});
+    BOOST_CHECK(!predictor.isMoving());
+    BOOST_CHECK_EQUAL(predictor.predict().area, viewport.area);
+}
+
+BOOST_AUTO_TEST_CASE(out_of_order_samples_are_ignored)
+{
+    ViewportPredictor predictor;
+
+    predictor.addSample(makeViewport(0.0, 0.0), frameTime(1));
+    predictor.addSample(makeViewport(0.5, 0.5), frameTime(0));
+    BOOST_CHECK(!predictor.isMoving());
+    BOOST_CHECK_EQUAL(predictor.predict().area, makeViewport(0.0, 0.0).area);
+}
+
+BOOST_AUTO_TEST_CASE(reset_forgets_motion)
+{
+    ViewportPredictor predictor;
+
+    for (int i = 0; i < frameCount; ++i)
+        predictor.addSample(makeViewport(0.01 * i, 0.0), frameTime(i));
+    BOOST_REQUIRE(predictor.isMoving());
+
+    predictor.reset();
+    BOOST_CHECK(!predictor.isMoving());
+}
@@ -254,3 +254,64 @@ BOOST_FIXTURE_TEST_CASE(testHiddenWindowNotObstructingOthers, Fixture)
     BOOST_CHECK_EQUAL(helper.getVisibleArea(*window), QRectF());
     BOOST_CHECK_EQUAL(helper.getVisibleArea(*otherWindow), coord);
 }
+
+BOOST_FIXTURE_TEST_CASE(testVisibleRegionIsExact, Fixture)
+{
+    auto otherWindow = std::make_shared<Window>(makeDummyContent());
+    group->add(otherWindow);
+
+    // Corner overlap: the bounding rectangle is not cut but the region is
+    otherWindow->setCoordinates(QRectF(QPointF(100, 100), size));
+    const auto region = helper.getVisibleRegion(*window);
+    BOOST_CHECK_EQUAL(region.getBoundingRect(), window->getCoordinates());
+    BOOST_CHECK_EQUAL(region.getArea(), 200.0 * 200.0 - 100.0 * 100.0);
+    BOOST_CHECK(region.intersects(QRectF(0, 0, 50, 50)));
+    BOOST_CHECK(region.intersects(QRectF(150, 0, 50, 50)));
+    BOOST_CHECK(region.intersects(QRectF(0, 150, 50, 50)));
+    BOOST_CHECK(!region.intersects(QRectF(150, 150, 50, 50)));
+}
+
+BOOST_FIXTURE_TEST_CASE(testWindowCoveredByTwoWindows, Fixture)
+{
+    auto leftWindow = std::make_shared<Window>(makeDummyContent());
+    auto rightWindow = std::make_shared<Window>(makeDummyContent());
+    group->add(leftWindow);
+    group->add(rightWindow);
+
+    leftWindow->setCoordinates(QRectF(0, 0, 100, 200));
+    rightWindow->setCoordinates(QRectF(100, 0, 100, 200));
+    BOOST_CHECK(helper.getVisibleRegion(*window).isEmpty());
+    BOOST_CHECK_EQUAL(helper.getVisibleArea(*window), QRectF());
+
+    rightWindow->setCoordinates(QRectF(100, 0, 100, 150));
+    BOOST_CHECK_EQUAL(helper.getVisibleArea(*window),
+                      QRectF(QPointF(100, 150), QSize(100, 50)));
+}
+
+BOOST_FIXTURE_TEST_CASE(testVisibleRegionsOfAllWindows, Fixture)
+{
+    auto alphaHelper = VisibilityHelper{*group, viewRect, true};
+
+    auto otherWindow = std::make_shared<Window>(makeDummyContent());
+    otherWindow->setCoordinates(QRectF(QPointF(100, 50), size));
+    group->add(otherWindow);
+
+    auto transparentWindow = std::make_shared<Window>(makeTransparentContent());
+    transparentWindow->setCoordinates(QRectF(QPointF(50, 150), size));
+    group->add(transparentWindow);
+
+    auto focusWindow = std::make_shared<Window>(makeDummyContent());
+    group->add(focusWindow);
+    focusWindow->setFocusedCoordinates(QRectF(QPointF(150, 0), size));
+    group->addFocusedWindow(focusWindow);
+    group->moveToFront(window);
+
+    for (const auto* h : {&helper, &alphaHelper})
+    {
+        const auto regions = h->getVisibleRegions();
+        const auto& windows = group->getWindows();
+        BOOST_REQUIRE_EQUAL(regions.size(), windows.size());
+        for (size_t i = 0; i < windows.size(); ++i)
+            BOOST_CHECK(regions[i] == h->getVisibleRegion(*windows[i]));
+    }
+}
@@ -0,0 +1,215 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE WaiterTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "network/Waiter.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace
+{
+/** A test which completes after a given number of calls. */
+struct CompleteAfter
+{
+    size_t calls;
+    mutable size_t count = 0;
+    bool operator()() const { return ++count > calls; }
+};
+
+/** A time source which only advances when told to, or when sleeping. */
+struct FakeTime
+{
+    Waiter::clock::time_point now;
+    std::vector<int64_t> sleepsUs;
+    size_t yields = 0;
+
+    Waiter::TimeSource source()
+    {
+        return {[this] { return now; },
+                [this](const nanoseconds duration) {
+                    sleepsUs.push_back(
+                        duration_cast<microseconds>(duration).count());
+                    now += duration;
+                },
+                [this] { ++yields; }};
+    }
+
+    /** @return a test which advances the time at each call. */
+    std::function<bool()> advance(const nanoseconds step, const size_t calls)
+    {
+        auto count = std::make_shared<size_t>(0);
+        return [this, step, calls, count] {
+            now += step;
+            return ++*count > calls;
+        };
+    }
+};
+}
+
+BOOST_AUTO_TEST_CASE(histogram_buckets_are_powers_of_two_microseconds)
+{
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(nanoseconds{0}), 0);
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(nanoseconds{999}), 0);
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(microseconds{1}), 1);
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(microseconds{2}), 2);
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(microseconds{3}), 2);
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(microseconds{100}), 7);
+    BOOST_CHECK_EQUAL(WaitHistogram::getBucket(hours{1}),
+                      WaitHistogram::bucketsCount - 1);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_counts_waits)
+{
+    WaitHistogram histogram;
+    histogram.add(nanoseconds{500});
+    histogram.add(microseconds{100});
+    histogram.add(microseconds{120});
+
+    BOOST_CHECK_EQUAL(histogram.getCount(), 3);
+    BOOST_CHECK_EQUAL(histogram.getCount(0), 1);
+    BOOST_CHECK_EQUAL(histogram.getCount(7), 2);
+    BOOST_CHECK_EQUAL(histogram.toString(), "1us:1 128us:2");
+}
+
+BOOST_AUTO_TEST_CASE(wait_returns_immediately_if_complete)
+{
+    for (auto policy : {WaitPolicy::spin, WaitPolicy::spinThenYield,
+                        WaitPolicy::backoff, WaitPolicy::adaptive})
+    {
+        Waiter waiter{policy};
+        CompleteAfter test{0};
+        waiter.wait(test);
+        BOOST_CHECK_EQUAL(test.count, 1);
+        BOOST_CHECK_EQUAL(waiter.getHistogram().getCount(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(wait_until_complete_with_all_policies)
+{
+    for (auto policy : {WaitPolicy::spin, WaitPolicy::spinThenYield,
+                        WaitPolicy::backoff, WaitPolicy::adaptive})
+    {
+        Waiter waiter{policy};
+        CompleteAfter test{5};
+        waiter.wait(test);
+        BOOST_CHECK_EQUAL(test.count, 6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(backoff_sleeps_twice_longer_up_to_a_maximum)
+{
+    FakeTime time;
+    Waiter waiter{WaitPolicy::backoff, time.source()};
+    waiter.wait(CompleteAfter{10});
+
+    const auto expected =
+        std::vector<int64_t>{1, 2, 4, 8, 16, 32, 64, 100, 100, 100};
+    BOOST_CHECK_EQUAL_COLLECTIONS(time.sleepsUs.begin(), time.sleepsUs.end(),
+                                  expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(time.yields, 0);
+}
+
+BOOST_AUTO_TEST_CASE(wait_records_its_duration)
+{
+    FakeTime time;
+    Waiter waiter{WaitPolicy::backoff, time.source()};
+    waiter.wait(CompleteAfter{3});
+
+    // 1 + 2 + 4 us of sleep
+    BOOST_CHECK_EQUAL(waiter.getHistogram().getCount(), 1);
+    BOOST_CHECK_EQUAL(waiter.getHistogram().getCount(
+                          WaitHistogram::getBucket(microseconds{7})),
+                      1);
+    BOOST_CHECK_EQUAL(waiter.getExpectedWait().count(), 7000 / 8);
+}
+
+BOOST_AUTO_TEST_CASE(spin_then_yield_yields_after_spinning)
+{
+    FakeTime time;
+    Waiter waiter{WaitPolicy::spinThenYield, time.source()};
+    waiter.wait(time.advance(microseconds{10}, 4));
+
+    // Tested at 10, 20, 30, 40 us; yields from 20 us on
+    BOOST_CHECK_EQUAL(time.yields, 3);
+    BOOST_CHECK(time.sleepsUs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(spin_never_pauses)
+{
+    FakeTime time;
+    Waiter waiter{WaitPolicy::spin, time.source()};
+    waiter.wait(time.advance(milliseconds{1}, 4));
+
+    BOOST_CHECK_EQUAL(time.yields, 0);
+    BOOST_CHECK(time.sleepsUs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_policy_learns_expected_wait)
+{
+    FakeTime time;
+    Waiter waiter{WaitPolicy::adaptive, time.source()};
+    BOOST_CHECK_EQUAL(waiter.getExpectedWait().count(), 0);
+
+    // Sleeps after the minimum spin; 4 * 50us of tests and 1 + 2 + 4us sleeps
+    waiter.wait(time.advance(microseconds{50}, 3));
+    BOOST_CHECK_EQUAL(time.sleepsUs.size(), 3);
+    BOOST_CHECK_EQUAL(waiter.getExpectedWait().count(), 207000 / 8);
+
+    // Now spins for twice the expected wait (51.75us) before sleeping
+    time.sleepsUs.clear();
+    waiter.wait(time.advance(microseconds{50}, 2));
+    BOOST_CHECK_EQUAL(time.sleepsUs.size(), 1);
+    BOOST_CHECK_EQUAL(time.sleepsUs.front(), 1);
+    BOOST_CHECK_EQUAL(waiter.getHistogram().getCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(policy_can_be_changed)
+{
+    Waiter waiter;
+    BOOST_CHECK(waiter.getPolicy() == WaitPolicy::backoff);
+    waiter.setPolicy(WaitPolicy::spin);
+    BOOST_CHECK(waiter.getPolicy() == WaitPolicy::spin);
+}
@@ -0,0 +1,205 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TRANSPORTRUNNER_H
+#define TRANSPORTRUNNER_H
+
+#include "network/MPITransport.h"
+#include "network/SocketTransport.h"
+#include "network/Waiter.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The processes of the MPI program running the tests.
+ *
+ * Use it as a global fixture: MPI can only be initialized once per process.
+ * Without mpiexec, the program is a single process.
+ */
+struct MPIProcesses
+{
+    MPIProcesses()
+    {
+        auto& testSuite = boost::unit_test::framework::master_test_suite();
+        world().reset(new MPITransport(testSuite.argc, testSuite.argv));
+    }
+    ~MPIProcesses() { world().reset(); }
+
+    static std::unique_ptr<Transport>& world()
+    {
+        static std::unique_ptr<Transport> transport;
+        return transport;
+    }
+};
+
+/** @return data of the given size, with a repeating pattern. */
+inline std::vector<char> makeData(const size_t size)
+{
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = char(i % 251);
+    return data;
+}
+
+inline void sendMessage(Transport& transport, std::vector<char> data,
+                        const int dest, const int tag)
+{
+    Waiter waiter;
+    transport.send({Transport::Block{data.data(), data.size()}}, dest, tag,
+                   waiter);
+}
+
+inline std::vector<char> receiveMessage(Transport& transport, const int src,
+                                        const int tag)
+{
+    Waiter waiter;
+    const auto result = transport.probe(src, tag, waiter);
+    std::vector<char> data(result.size);
+    transport.receive(data.data(), data.size(), result.src,
+                      int(result.messageType), waiter);
+    return data;
+}
+
+/** Throw if a condition of a check does not hold (thread safe). */
+inline void expect(const bool condition, const std::string& what)
+{
+    if (!condition)
+        throw std::runtime_error(what);
+}
+
+/**
+ * Run a check on all processes of the MPI program, in a separate group.
+ * Requires the MPIProcesses global fixture.
+ */
+template <typename F>
+void runOnMPI(const F& check)
+{
+    try
+    {
+        const auto group = MPIProcesses::world()->split(0);
+        check(*group);
+    }
+    catch (const std::exception& e)
+    {
+        BOOST_ERROR("rank " << MPIProcesses::world()->getRank() << ": "
+                            << e.what());
+    }
+}
+
+/**
+ * Run a check on processes connected by sockets, one thread per process.
+ *
+ * @param hostNames The name of the host of each process, to simulate several
+ *        hosts on a single machine.
+ * @param check The function to run with the transport of each process.
+ * @param options The settings of the transport, the host name is overridden.
+ */
+template <typename F>
+void runOnHosts(const std::vector<std::string>& hostNames, const F& check,
+                SocketTransport::Options options = SocketTransport::Options())
+{
+    const int size = hostNames.size();
+    SocketTransport::Listener listener;
+    const auto port = listener.getPort();
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(size);
+    for (int rank = 0; rank < size; ++rank)
+    {
+        options.hostName = hostNames[rank];
+        threads.emplace_back([&, rank, options]() mutable {
+            try
+            {
+                if (rank == 0)
+                {
+                    SocketTransport transport{std::move(listener), size,
+                                              options};
+                    check(transport);
+                }
+                else
+                {
+                    SocketTransport transport{rank, size, "localhost", port,
+                                              options};
+                    check(transport);
+                }
+            }
+            catch (...)
+            {
+                errors[rank] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int rank = 0; rank < size; ++rank)
+    {
+        try
+        {
+            if (errors[rank])
+                std::rethrow_exception(errors[rank]);
+        }
+        catch (const std::exception& e)
+        {
+            BOOST_ERROR("rank " << rank << ": " << e.what());
+        }
+    }
+}
+
+/**
+ * Run a check on processes connected by sockets, all on the same host.
+ *
+ * @param size The number of processes.
+ * @param check The function to run with the transport of each process.
+ * @param options The settings of the transport.
+ */
+template <typename F>
+void runOnSockets(const int size, const F& check,
+                  SocketTransport::Options options = SocketTransport::Options())
+{
+    runOnHosts(std::vector<std::string>(size, "localhost"), check, options);
+}
+
+#endif
@@ -37,45 +37,56 @@
 /* or implied, of Ecole polytechnique federale de Lausanne.          */
 /*********************************************************************/
 
+#include "network/FrameSync.h"
+#include "network/FrameWireFormat.h"
+#include "json/serialization.h"
+#include "network/HierarchicalCollectives.h"
 #include "network/MPICommunicator.h"
-#include "network/ReceiveBuffer.h"
+#include "network/SceneDeltaDecoder.h"
+#include "network/SceneDeltaEncoder.h"
+#include "network/WallToWallChannel.h"
+#include "scene/ContentFactory.h"
+#include "scene/DisplayGroup.h"
+#include "scene/Scene.h"
+#include "scene/SceneDelta.h"
+#include "scene/Window.h"
 #include "serialization/utils.h"
 #include "utils/CommandLineParser.h"
 
+#include <deflect/server/Frame.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
 #include <chrono>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <string>
 
 #define MEGABYTE 1000000
-#define GIGABYTE (1000 * MEGABYTE)
-#define BITS 8
 #define RANK0 0
+#define WALL0 1
+#define TILE_SIZE 512
+#define SCENE_OBJECTS 7
 
-// Example ways to run this program:
-// mpirun -n 6 -H localhost ./tideBenchmarkMPI --datasize 60 --packets 100
+// Measure the message patterns of the Tide protocol between the master (rank 0)
+// and the wall processes (all other ranks), and write the results as JSON:
+// - raw broadcast of random bytes, monolithic and pipelined
+// - scene updates with N windows (keyframes and patches)
+// - deflect frame fan-out, broadcast or scattered to the wall processes
+// - the per-frame synchronization of the wall processes, sequential or fused
+// - the swap barrier of the wall processes
+// The message benchmarks can be repeated with each compression codec.
 //
-// Object size [Mbytes]: 60
-// Time to send 100 objects: 3.445
-// Time per object: 0.03445
-// Throughput [Mbytes/sec]: 1741.66
+// Example ways to run this program:
+// mpirun -n 6 -H localhost ./tideBenchmarkMPI --packets 100
+// mpirun -n 17 -H host1,host2 ./tideBenchmarkMPI -s 1 10 60 -w 1 50 -o a.json
+// mpirun -n 5 -H host1,host2 ./tideBenchmarkMPI --tile-data 0 -c lz4 zstd
 
 namespace
 {
-class Timer
-{
-public:
-    using clock = std::chrono::high_resolution_clock;
-
-    void start() { _startTime = clock::now(); }
-    float elapsed() const
-    {
-        const auto now = clock::now();
-        return std::chrono::duration<float>{now - _startTime}.count();
-    }
-
-private:
-    clock::time_point _startTime;
-};
+using clock = std::chrono::high_resolution_clock;
 
 namespace po = boost::program_options;
 
@@ -86,69 +97,544 @@ public:
     {
         // clang-format off
         desc.add_options()
-            ("datasize,s", po::value<float>()->default_value( 0.f ),
-             "Size of each data packet [MB]")
-            ("packets,p", po::value<size_t>()->default_value( 0u ),
-             "number of packets to transmit")
+            ("datasize,s", po::value<std::vector<float>>()->multitoken()->
+             default_value( std::vector<float>{ 1.f, 10.f }, "1 10" ),
+             "Sizes of the raw broadcasts [MB]")
+            ("packets,p", po::value<size_t>()->default_value( 100u ),
+             "number of packets to transmit for each measurement")
+            ("segment-size,g", po::value<float>()->default_value( 1.f ),
+             "Size of the segments of pipelined broadcasts [MB]")
+            ("segments-in-flight,i", po::value<size_t>()->default_value( 4u ),
+             "Maximum number of segments in flight")
+            ("windows,w", po::value<std::vector<size_t>>()->multitoken()->
+             default_value( std::vector<size_t>{ 1u, 10u, 100u }, "1 10 100" ),
+             "Numbers of windows in the scene")
+            ("stream-width", po::value<uint>()->default_value( 3840u ),
+             "Width of the deflect frames [pixels]")
+            ("stream-height", po::value<uint>()->default_value( 2160u ),
+             "Height of the deflect frames [pixels]")
+            ("tile-data", po::value<size_t>()->default_value( 64u ),
+             "Size of the compressed data of each 512x512 tile [KB], "
+             "0 for uncompressed RGBA tiles")
+            ("codecs,c", po::value<std::vector<std::string>>()->multitoken()->
+             default_value( std::vector<std::string>(), "" ),
+             "Compression codecs to compare to uncompressed messages "
+             "(lz4, zstd)")
+            ("frames,f", po::value<size_t>()->default_value( 1000u ),
+             "number of frames to synchronize")
+            ("dynamic-sources,d", po::value<size_t>()->default_value( 1u ),
+             "number of dynamic data sources (movies and streams)")
+            ("output,o", po::value<std::string>()->default_value( "" ),
+             "JSON output file (default: standard output)")
         ;
         // clang-format on
     }
-    size_t dataSize() const { return vm["datasize"].as<float>() * MEGABYTE; }
+    std::vector<size_t> dataSizes() const
+    {
+        std::vector<size_t> sizes;
+        for (const auto size : vm["datasize"].as<std::vector<float>>())
+            sizes.push_back(size * MEGABYTE);
+        return sizes;
+    }
     size_t packetsCount() const { return vm["packets"].as<size_t>(); }
+    size_t segmentSize() const
+    {
+        return vm["segment-size"].as<float>() * MEGABYTE;
+    }
+    size_t segmentsInFlight() const
+    {
+        return vm["segments-in-flight"].as<size_t>();
+    }
+    std::vector<size_t> windows() const
+    {
+        return vm["windows"].as<std::vector<size_t>>();
+    }
+    QSize streamSize() const
+    {
+        return QSize(vm["stream-width"].as<uint>(),
+                     vm["stream-height"].as<uint>());
+    }
+    size_t tileDataSize() const { return vm["tile-data"].as<size_t>() * 1000; }
+    size_t framesCount() const { return vm["frames"].as<size_t>(); }
+    size_t sourcesCount() const { return vm["dynamic-sources"].as<size_t>(); }
+    std::string output() const { return vm["output"].as<std::string>(); }
+    std::vector<Codec> codecs() const
+    {
+        std::vector<Codec> codecs;
+        for (const auto& name : vm["codecs"].as<std::vector<std::string>>())
+        {
+            auto codec = Codec::none;
+            json::deserialize(QString::fromStdString(name), codec);
+            codecs.push_back(codec);
+        }
+        return codecs;
+    }
 };
+
+QByteArray makeNoise(const size_t size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (auto& elem : data)
+        elem = rand();
+    return data;
 }
 
-/**
- * Send data via MPI to benchmark the effective link speed at application level.
- */
-int main(int argc, char** argv)
+/** @return an RGBA image with smooth gradients, like typical desktop content */
+QByteArray makeImage(const int width, const int height)
 {
-    COMMAND_LINE_PARSER_CHECK(BenchmarkOptions, "tideBenchmarkMPI");
+    QByteArray data(width * height * 4, Qt::Uninitialized);
+    auto pixel = reinterpret_cast<uchar*>(data.data());
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            *pixel++ = uchar(x);
+            *pixel++ = uchar(y);
+            *pixel++ = uchar((x + y) / 4 + rand() % 4);
+            *pixel++ = 255;
+        }
+    }
+    return data;
+}
 
-    MPICommunicator mpiComm(argc, argv);
+ScenePtr makeScene(const size_t windowsCount)
+{
+    auto scene = Scene::create(QSize{7680, 4320});
+    for (size_t i = 0; i < windowsCount; ++i)
+    {
+        const auto uri = QString("stream%1").arg(i);
+        auto content =
+            ContentFactory::createPixelStreamContent(uri, QSize{1920, 1080});
+        auto window = std::make_shared<Window>(std::move(content));
+        window->setCoordinates(QRectF{i % 4 * 1920.0, i / 4 % 4 * 1080.0,
+                                      1920.0, 1080.0});
+        scene->getGroup(0).add(window);
+    }
+    return scene;
+}
 
-    // Send buffer
-    std::vector<char> noiseBuffer(commandLine.dataSize());
-    for (auto& elem : noiseBuffer)
-        elem = rand();
-    const auto serializedData = serialization::toBinary(noiseBuffer);
+deflect::server::Frame makeFrame(const QSize& size, const size_t tileData)
+{
+    deflect::server::Frame frame;
+    frame.uri = "benchmark";
+    for (int y = 0; y < size.height(); y += TILE_SIZE)
+    {
+        for (int x = 0; x < size.width(); x += TILE_SIZE)
+        {
+            deflect::server::Tile tile;
+            tile.x = x;
+            tile.y = y;
+            tile.width = std::min(TILE_SIZE, size.width() - x);
+            tile.height = std::min(TILE_SIZE, size.height() - y);
+            if (tileData > 0)
+            {
+                tile.format = deflect::Format::jpeg;
+                tile.imageData = makeNoise(tileData);
+            }
+            else
+            {
+                tile.format = deflect::Format::rgba;
+                tile.imageData = makeImage(tile.width, tile.height);
+            }
+            frame.tiles.push_back(tile);
+        }
+    }
+    return frame;
+}
 
-    // Receive buffer
-    ReceiveBuffer buffer;
-    Timer timer;
-    size_t counter = 0;
+/** Split the frame by tile columns between the wall processes. */
+std::vector<std::vector<QByteArray>> splitFrame(
+    const deflect::server::Frame& frame, const int wallsCount)
+{
+    std::vector<std::vector<QByteArray>> data(1);
+    for (int wall = 0; wall < wallsCount; ++wall)
+    {
+        auto wallFrame = frame;
+        for (auto& tile : wallFrame.tiles)
+        {
+            if (int(tile.x / TILE_SIZE) % wallsCount != wall)
+                tile.imageData.clear();
+        }
+        data.push_back(wireformat::encode(wallFrame));
+    }
+    return data;
+}
 
-    mpiComm.globalBarrier();
-    timer.start();
+size_t sizeOf(const std::vector<QByteArray>& buffers)
+{
+    size_t size = 0;
+    for (const auto& buffer : buffers)
+        size += buffer.size();
+    return size;
+}
 
-    while (counter < commandLine.packetsCount())
+class Benchmark
+{
+public:
+    Benchmark(MPICommunicator& worldComm, const BenchmarkOptions& options)
+        : _worldComm(worldComm)
+        , _wallComm(worldComm, _isMaster() ? 0 : 1)
+        , _options(options)
     {
-        if (mpiComm.getRank() == RANK0)
-            mpiComm.broadcast(MessageType::NONE, serializedData);
-        else
+    }
+
+    QJsonObject run()
+    {
+        for (const auto size : _options.dataSizes())
+        {
+            _benchmarkBroadcast(size, false);
+            _benchmarkBroadcast(size, true);
+        }
+        for (const auto windows : _options.windows())
+            _benchmarkScene(windows);
+        _benchmarkFrame(false);
+        _benchmarkFrame(true);
+
+        for (const auto codec : _options.codecs())
         {
-            const auto header = mpiComm.receiveBroadcastHeader(RANK0);
-            buffer.setSize(header.size);
-            mpiComm.receiveBroadcast(RANK0, buffer.data(), header.size);
+            _setCompression(codec);
+            for (const auto size : _options.dataSizes())
+                _benchmarkBroadcast(size, false);
+            for (const auto windows : _options.windows())
+                _benchmarkScene(windows);
+            _benchmarkFrame(false);
         }
-        ++counter;
+        _setCompression(Codec::none);
+
+        _benchmarkWallSync();
+        _benchmarkSwapBarrier();
+
+        const auto flat = HierarchicalCollectives::Selection::flat;
+        const auto nodes =
+            HierarchicalCollectives{_worldComm, flat}.getNodeCount();
+        return QJsonObject{{"processes", _worldComm.getSize()},
+                           {"nodes", int(nodes)},
+                           {"packets", int(_options.packetsCount())},
+                           {"frames", int(_options.framesCount())},
+                           {"results", _results}};
     }
 
-    const float time = timer.elapsed();
+private:
+    MPICommunicator& _worldComm;
+    MPICommunicator _wallComm;
+    const BenchmarkOptions& _options;
+    QJsonArray _results;
+    Codec _codec = Codec::none;
+
+    bool _isMaster() const { return _worldComm.getRank() == RANK0; }
 
-    if (mpiComm.getRank() == RANK0)
+    /**
+     * Measure an operation on all processes.
+     * @return the average latency of the operation, waiting for all processes
+     *         to complete it [us]; and the throughput of successive operations
+     *         [MB/s] given the number of bytes transmitted by each of them.
+     */
+    template <typename F>
+    std::pair<double, double> _measure(const F& operation, const size_t bytes)
     {
-        std::cout << "Object size [Mbytes]: "
-                  << (float)serializedData.size() / MEGABYTE << std::endl;
-        std::cout << "Time to send " << counter << " objects: " << time
-                  << std::endl;
-        std::cout << "Time per object: " << time / counter << std::endl;
-        std::cout << "Throughput [Mbytes/sec]: "
-                  << counter * serializedData.size() / time / MEGABYTE
-                  << std::endl;
-        std::cout << "Throughput [Gbit/sec]: "
-                  << counter * serializedData.size() * BITS / time / GIGABYTE
+        const auto packets = _options.packetsCount();
+
+        auto latency = clock::duration{0};
+        for (size_t i = 0; i < packets; ++i)
+        {
+            _worldComm.globalBarrier();
+            const auto start = clock::now();
+            operation();
+            _worldComm.globalBarrier();
+            latency += clock::now() - start;
+        }
+
+        _worldComm.globalBarrier();
+        const auto start = clock::now();
+        for (size_t i = 0; i < packets; ++i)
+            operation();
+        _worldComm.globalBarrier();
+        const auto duration = clock::now() - start;
+
+        using us = std::chrono::duration<double, std::micro>;
+        using sec = std::chrono::duration<double>;
+        return {us{latency}.count() / packets,
+                packets * bytes / sec{duration}.count() / MEGABYTE};
+    }
+
+    /** @return the average duration of a wall operation on wall 0 [us]. */
+    template <typename F>
+    double _measureWalls(const F& operation)
+    {
+        double latency = 0.0;
+        if (!_isMaster())
+        {
+            const auto frames = _options.framesCount();
+            _wallComm.globalBarrier();
+            const auto start = clock::now();
+            for (size_t i = 0; i < frames; ++i)
+                operation();
+            const auto elapsed = clock::now() - start;
+            using us = std::chrono::duration<double, std::micro>;
+            latency = us{elapsed}.count() / frames;
+        }
+        return _fromWall0(latency);
+    }
+
+    /** @return the value of wall 0 on the master process. */
+    double _fromWall0(const double value)
+    {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(value));
+        const auto values = _worldComm.gatherAll(bits);
+        double result = 0.0;
+        std::memcpy(&result, &values[WALL0], sizeof(result));
+        return result;
+    }
+
+    /** Compress all the messages broadcast by the master (except scatter). */
+    void _setCompression(const Codec codec)
+    {
+        _codec = codec;
+        _worldComm.setCompressionThreshold(0);
+        for (auto type : {MessageType::NONE, MessageType::SCENE,
+                          MessageType::PIXELSTREAM})
+        {
+            _worldComm.setCompression(type, codec);
+        }
+    }
+
+    void _addResult(QJsonObject result)
+    {
+        if (_isMaster())
+            _results.append(result);
+    }
+
+    QByteArray _receiveBroadcast()
+    {
+        const auto header = _worldComm.receiveBroadcastHeader(RANK0);
+        QByteArray data(header.size, Qt::Uninitialized);
+        _worldComm.receiveBroadcast(RANK0, data.data(), data.size());
+        return data;
+    }
+
+    void _benchmarkBroadcast(const size_t size, const bool pipelined)
+    {
+        if (pipelined)
+        {
+            _worldComm.setBroadcastPipeline(_options.segmentSize(),
+                                            _options.segmentsInFlight());
+        }
+        const auto data = _isMaster() ? makeNoise(size) : QByteArray();
+
+        const auto result = _measure(
+            [&] {
+                if (_isMaster())
+                    _worldComm.broadcast(MessageType::NONE, data);
+                else
+                    _receiveBroadcast();
+            },
+            size);
+        _worldComm.setBroadcastPipeline(0, 1);
+
+        _addResult({{"benchmark", "broadcast"},
+                    {"codec", json::serialize(_codec)},
+                    {"mode", pipelined ? "pipelined" : "monolithic"},
+                    {"bytes", double(size)},
+                    {"latency_us", result.first},
+                    {"throughput_MBps", result.second}});
+    }
+
+    void _benchmarkScene(const size_t windows)
+    {
+        auto scene = _isMaster() ? makeScene(windows) : ScenePtr();
+        SceneDeltaEncoder encoder;
+        SceneDeltaDecoder decoder;
+        size_t moves = 0;
+
+        for (const auto keyframe : {true, false})
+        {
+            std::string data;
+            const auto update = [&] {
+                if (!_isMaster())
+                {
+                    const auto message = _receiveBroadcast();
+                    decoder.apply(serialization::get<SceneDelta>(message));
+                    return;
+                }
+                if (keyframe)
+                    encoder.requestKeyframe();
+                else
+                {
+                    // A window being moved by a user
+                    auto& window = *scene->getGroup(0).getWindows().front();
+                    window.setCoordinates(window.getCoordinates().translated(
+                        ++moves % 2 ? 10.0 : -10.0, 0.0));
+                }
+                data = serialization::toBinary(encoder.encode(scene));
+                _worldComm.broadcast(MessageType::SCENE, data);
+            };
+            update(); // get the size of the message
+            const auto bytes = _fromMaster(data.size());
+            const auto result = _measure(update, bytes);
+
+            _addResult({{"benchmark", "scene"},
+                        {"codec", json::serialize(_codec)},
+                        {"mode", keyframe ? "keyframe" : "patch"},
+                        {"windows", int(windows)},
+                        {"bytes", double(bytes)},
+                        {"latency_us", result.first},
+                        {"throughput_MBps", result.second}});
+        }
+    }
+
+    /** @return the size of a message from the master, on all processes. */
+    size_t _fromMaster(const size_t size)
+    {
+        return _worldComm.gatherAll(uint64_t(size))[RANK0];
+    }
+
+    void _benchmarkFrame(const bool scatter)
+    {
+        const auto wallsCount = _worldComm.getSize() - 1;
+        auto frame = deflect::server::Frame();
+        auto wallData = std::vector<std::vector<QByteArray>>();
+        size_t bytes = 0;
+        if (_isMaster())
+        {
+            frame = makeFrame(_options.streamSize(), _options.tileDataSize());
+            if (scatter)
+            {
+                wallData = splitFrame(frame, wallsCount);
+                for (const auto& data : wallData)
+                    bytes += sizeOf(data);
+            }
+            else
+                bytes = sizeOf(wireformat::encode(frame));
+        }
+        bytes = _fromMaster(bytes);
+
+        const auto result = _measure(
+            [&] {
+                if (_isMaster())
+                {
+                    if (scatter)
+                        _worldComm.scatter(MessageType::PIXELSTREAM_SCATTER,
+                                           wallData);
+                    else
+                    {
+                        _worldComm.broadcast(MessageType::PIXELSTREAM,
+                                             wireformat::encode(frame));
+                    }
+                    return;
+                }
+                if (scatter)
+                {
+                    _worldComm.receiveBroadcastHeader(RANK0);
+                    wireformat::decode(_worldComm.receiveScatter(RANK0));
+                }
+                else
+                    wireformat::decode(_receiveBroadcast());
+            },
+            bytes);
+
+        const auto size = _options.streamSize();
+        _addResult({{"benchmark", "frame"},
+                    {"codec", json::serialize(_codec)},
+                    {"mode", scatter ? "scatter" : "broadcast"},
+                    {"width", size.width()},
+                    {"height", size.height()},
+                    {"tiles", int(frame.tiles.size())},
+                    {"bytes", double(bytes)},
+                    {"latency_us", result.first},
+                    {"throughput_MBps", result.second}});
+    }
+
+    void _benchmarkWallSync()
+    {
+        if (_worldComm.getSize() < 2)
+            return;
+
+        // Only the wall processes take part in the collectives
+        std::unique_ptr<WallToWallChannel> channel;
+        if (!_isMaster())
+            channel.reset(new WallToWallChannel{_wallComm});
+
+        const auto sources = _options.sourcesCount();
+
+        // The sequence of collectives previously used by the RenderController
+        const auto sequential = _measureWalls([&] {
+            for (uint64_t i = 0; i < SCENE_OBJECTS; ++i)
+                channel->checkVersion(i);
+            if (channel->getRank() == 0)
+                channel->broadcast(0.0);
+            else
+                channel->receiveTimestampBroadcast(0);
+            for (size_t i = 0; i < sources; ++i)
+                channel->allReady(true); // swap tiles
+            for (size_t i = 0; i < sources; ++i)
+                channel->electLeader(true); // movie playback
+            for (size_t i = 0; i < sources; ++i)
+                channel->allReady(true); // frame advance
+            channel->allReady(false);    // redraw
+        });
+
+        // The single collective exchanging the same data, used by FrameSync
+        FrameSync frame;
+        const auto fused = _measureWalls([&] {
+            frame.clear();
+            for (uint64_t i = 0; i < SCENE_OBJECTS; ++i)
+                frame.addVersion(i);
+            for (size_t i = 0; i < sources; ++i)
+            {
+                frame.addVersion(i);
+                frame.addFlag(true);
+                frame.addFlag(true);
+                frame.addValue(0.0);
+            }
+            frame.addFlag(false);
+            channel->synchronize(frame);
+        });
+
+        _addResult({{"benchmark", "wall_sync"},
+                    {"mode", "sequential"},
+                    {"dynamic_sources", int(sources)},
+                    {"latency_us", sequential}});
+        _addResult({{"benchmark", "wall_sync"},
+                    {"mode", "fused"},
+                    {"dynamic_sources", int(sources)},
+                    {"latency_us", fused}});
+    }
+
+    void _benchmarkSwapBarrier()
+    {
+        const auto latency = _measureWalls([&] { _wallComm.globalBarrier(); });
+        _addResult({{"benchmark", "swap_barrier"}, {"latency_us", latency}});
+    }
+};
+}
+
+/**
+ * Benchmark the message patterns of the Tide protocol between the master and
+ * wall processes.
+ */
+int main(int argc, char** argv)
+{
+    COMMAND_LINE_PARSER_CHECK(BenchmarkOptions, "tideBenchmarkMPI");
+
+    MPICommunicator worldComm(argc, argv);
+    if (worldComm.getSize() < 2)
+    {
+        std::cerr << "At least 2 processes are required: master and wall"
                   << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Benchmark benchmark{worldComm, commandLine};
+    const auto results = benchmark.run();
+
+    if (worldComm.getRank() == RANK0)
+    {
+        const auto json = QJsonDocument{results}.toJson();
+        if (commandLine.output().empty())
+            std::cout << json.constData();
+        else
+            std::ofstream{commandLine.output()} << json.constData();
     }
 
     return EXIT_SUCCESS;
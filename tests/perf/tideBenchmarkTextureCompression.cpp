@@ -0,0 +1,179 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "tools/bc1.h"
+#include "utils/CommandLineParser.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#define GIGABYTE (size_t(1) << 30)
+
+// Measure the CPU encoding of static tiles to BC1 compressed textures and the
+// number of tiles which fit in a given amount of GPU memory, compared to the
+// RGBA8 textures used otherwise. Mipmaps are included in both cases.
+//
+// Example ways to run this program:
+// ./tideBenchmarkTextureCompression
+// ./tideBenchmarkTextureCompression --tile-size 256 --tiles 500 -o a.json
+
+namespace
+{
+using clock = std::chrono::high_resolution_clock;
+
+namespace po = boost::program_options;
+
+class BenchmarkOptions : public CommandLineParser
+{
+public:
+    BenchmarkOptions()
+    {
+        // clang-format off
+        desc.add_options()
+            ("tile-size,s", po::value<int>()->default_value( 512 ),
+             "Size of the square tiles [pixels]")
+            ("tiles,t", po::value<size_t>()->default_value( 100u ),
+             "number of tiles to encode")
+            ("vram,v", po::value<float>()->default_value( 1.f ),
+             "GPU memory available for the tile textures [GB]")
+            ("output,o", po::value<std::string>()->default_value( "" ),
+             "JSON output file (default: standard output)")
+        ;
+        // clang-format on
+    }
+    int tileSize() const { return vm["tile-size"].as<int>(); }
+    size_t tilesCount() const { return vm["tiles"].as<size_t>(); }
+    size_t vram() const { return vm["vram"].as<float>() * GIGABYTE; }
+    std::string output() const { return vm["output"].as<std::string>(); }
+};
+
+/** @return a BGRA image with smooth gradients, like typical static content */
+std::vector<uint8_t> makeImage(const int size, const int seed)
+{
+    std::vector<uint8_t> data(size_t(size) * size * 4);
+    auto pixel = data.data();
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            *pixel++ = uint8_t(x + seed);
+            *pixel++ = uint8_t(y);
+            *pixel++ = uint8_t((x + y) / 4 + rand() % 4);
+            *pixel++ = 255;
+        }
+    }
+    return data;
+}
+
+double computePSNR(const std::vector<uint8_t>& bgra,
+                   const std::vector<uint8_t>& rgba)
+{
+    double squaredError = 0.0;
+    for (size_t i = 0; i < bgra.size(); i += 4)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            const auto diff = double(bgra[i + 2 - c]) - double(rgba[i + c]);
+            squaredError += diff * diff;
+        }
+    }
+    const auto mse = squaredError / (bgra.size() / 4 * 3);
+    return mse == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+size_t getRgbaTextureSize(const int size)
+{
+    const auto size0 = size_t(size) * size * 4;
+    return size0 + size0 / 3; // mipmaps
+}
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE_PARSER_CHECK(BenchmarkOptions,
+                              "tideBenchmarkTextureCompression");
+
+    const auto size = commandLine.tileSize();
+    const auto tilesCount = commandLine.tilesCount();
+    const auto levels = bc1::getLevelCount(size, size);
+
+    std::vector<std::vector<uint8_t>> images;
+    for (size_t i = 0; i < tilesCount; ++i)
+        images.push_back(makeImage(size, int(i)));
+
+    std::vector<std::vector<uint8_t>> blocks(tilesCount);
+    const auto start = clock::now();
+    for (size_t i = 0; i < tilesCount; ++i)
+        blocks[i] = bc1::encode(images[i].data(), size, size, size_t(size) * 4,
+                                bc1::PixelOrder::bgra, levels);
+    const auto end = clock::now();
+
+    const auto duration = std::chrono::duration<double>(end - start).count();
+    const auto pixels = double(size) * size * tilesCount;
+    const auto decoded = bc1::decode(blocks[0].data(), size, size);
+    const auto psnr = computePSNR(images[0], decoded);
+
+    const auto rgbaSize = getRgbaTextureSize(size);
+    const auto bc1Size = bc1::getCompressedSize(size, size, levels);
+    const auto vram = commandLine.vram();
+
+    const auto results = QJsonObject{
+        {"tileSize", size},
+        {"tiles", int(tilesCount)},
+        {"encodeMsPerTile", duration * 1000.0 / tilesCount},
+        {"encodeMPixelsPerSecond", pixels / duration / 1e6},
+        {"psnr", psnr},
+        {"rgbaTextureBytes", double(rgbaSize)},
+        {"bc1TextureBytes", double(bc1Size)},
+        {"rgbaTilesPerVram", double(vram / rgbaSize)},
+        {"bc1TilesPerVram", double(vram / bc1Size)}};
+
+    const auto json = QJsonDocument{results}.toJson();
+    if (commandLine.output().empty())
+        std::cout << json.constData();
+    else
+        std::ofstream{commandLine.output()} << json.constData();
+
+    return EXIT_SUCCESS;
+}
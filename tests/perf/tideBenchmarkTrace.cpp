@@ -0,0 +1,147 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "utils/CommandLineParser.h"
+#include "utils/trace.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+// Measure the cost of a trace scope when tracing is disabled and enabled, with
+// several threads recording concurrently into their own ring buffers, and the
+// time needed to format the recorded events as a Chrome trace.
+//
+// Example ways to run this program:
+// ./tideBenchmarkTrace
+// ./tideBenchmarkTrace --scopes 10000000 --threads 8 -o a.json
+
+namespace
+{
+using clock = std::chrono::high_resolution_clock;
+
+namespace po = boost::program_options;
+
+class BenchmarkOptions : public CommandLineParser
+{
+public:
+    BenchmarkOptions()
+    {
+        // clang-format off
+        desc.add_options()
+            ("scopes,s", po::value<size_t>()->default_value( 1000000u ),
+             "number of trace scopes per thread")
+            ("threads,t", po::value<size_t>()->default_value( 4u ),
+             "number of threads recording concurrently")
+            ("output,o", po::value<std::string>()->default_value( "" ),
+             "JSON output file (default: standard output)")
+        ;
+        // clang-format on
+    }
+    size_t scopesCount() const { return vm["scopes"].as<size_t>(); }
+    size_t threadsCount() const { return vm["threads"].as<size_t>(); }
+    std::string output() const { return vm["output"].as<std::string>(); }
+};
+
+// Keep the traced loop from being optimized away
+volatile size_t counter = 0;
+
+void runScopes(const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        TIDE_TRACE_SCOPE("benchmark");
+        counter = counter + 1;
+    }
+}
+
+/** @return the mean duration of a scope on each thread in nanoseconds. */
+double measureScopes(const size_t scopes, const size_t threadsCount)
+{
+    const auto start = clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadsCount; ++i)
+        threads.emplace_back([scopes] { runScopes(scopes); });
+    for (auto& thread : threads)
+        thread.join();
+    const auto end = clock::now();
+
+    const auto duration = std::chrono::duration<double, std::nano>(end - start);
+    return duration.count() / scopes;
+}
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE_PARSER_CHECK(BenchmarkOptions, "tideBenchmarkTrace");
+
+    const auto scopes = commandLine.scopesCount();
+    const auto threads = commandLine.threadsCount();
+
+    trace::setEnabled(false);
+    const auto disabledNs = measureScopes(scopes, threads);
+
+    trace::setEnabled(true);
+    const auto enabledNs = measureScopes(scopes, threads);
+    trace::setEnabled(false);
+
+    const auto start = clock::now();
+    const auto events = trace::toChromeEvents(trace::getEvents(), 1, "bench");
+    const auto end = clock::now();
+    const auto exportMs =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    const auto results = QJsonObject{{"scopesPerThread", double(scopes)},
+                                     {"threads", int(threads)},
+                                     {"disabledNsPerScope", disabledNs},
+                                     {"enabledNsPerScope", enabledNs},
+                                     {"exportMs", exportMs},
+                                     {"exportBytes", double(events.size())}};
+
+    const auto json = QJsonDocument{results}.toJson();
+    if (commandLine.output().empty())
+        std::cout << json.constData();
+    else
+        std::ofstream{commandLine.output()} << json.constData();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "scene/DisplayGroup.h"
+#include "scene/ErrorContent.h"
+#include "scene/Window.h"
+#include "tools/VisibilityHelper.h"
+#include "utils/CommandLineParser.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+// Measure the computation of the visible regions of many overlapping windows,
+// either all at once in a single pass over the windows or one window at a time
+// as when each window is compared with all the others.
+//
+// Example ways to run this program:
+// ./tideBenchmarkVisibility
+// ./tideBenchmarkVisibility --windows 1000 --repeat 10 -o a.json
+
+namespace
+{
+using clock = std::chrono::high_resolution_clock;
+
+namespace po = boost::program_options;
+
+const QSize groupSize(15360, 4320);
+const QRect screenRect(0, 0, 3840, 2160);
+
+class BenchmarkOptions : public CommandLineParser
+{
+public:
+    BenchmarkOptions()
+    {
+        // clang-format off
+        desc.add_options()
+            ("windows,w", po::value<size_t>()->default_value( 300u ),
+             "number of windows in the display group")
+            ("repeat,r", po::value<size_t>()->default_value( 20u ),
+             "number of times each computation is repeated")
+            ("output,o", po::value<std::string>()->default_value( "" ),
+             "JSON output file (default: standard output)")
+        ;
+        // clang-format on
+    }
+    size_t windowsCount() const { return vm["windows"].as<size_t>(); }
+    size_t repeatCount() const { return vm["repeat"].as<size_t>(); }
+    std::string output() const { return vm["output"].as<std::string>(); }
+};
+
+DisplayGroupPtr makeDisplayGroup(const size_t windowsCount)
+{
+    auto group = DisplayGroup::create(groupSize);
+
+    std::mt19937 generator{0};
+    std::uniform_real_distribution<qreal> x{0.0, groupSize.width() * 0.9};
+    std::uniform_real_distribution<qreal> y{0.0, groupSize.height() * 0.9};
+    std::uniform_real_distribution<qreal> size{200.0, 2000.0};
+
+    for (size_t i = 0; i < windowsCount; ++i)
+    {
+        const auto windowSize = QSize(size(generator), size(generator));
+        auto content = std::make_unique<ErrorContent>("", windowSize);
+        auto window = std::make_shared<Window>(std::move(content));
+        window->setCoordinates(
+            QRectF{QPointF{x(generator), y(generator)}, windowSize});
+        group->add(window);
+    }
+    return group;
+}
+
+/** @return the mean duration of a computation in milliseconds. */
+template <typename F>
+double measure(const size_t repeatCount, F&& computation)
+{
+    const auto start = clock::now();
+    for (size_t i = 0; i < repeatCount; ++i)
+        computation();
+    const auto end = clock::now();
+    const auto duration = std::chrono::duration<double>(end - start).count();
+    return duration * 1000.0 / repeatCount;
+}
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE_PARSER_CHECK(BenchmarkOptions, "tideBenchmarkVisibility");
+
+    const auto windowsCount = commandLine.windowsCount();
+    const auto repeatCount = commandLine.repeatCount();
+
+    const auto group = makeDisplayGroup(windowsCount);
+    const auto helper = VisibilityHelper{*group, screenRect, false};
+
+    size_t visibleWindows = 0;
+    qreal visibleArea = 0.0;
+    for (const auto& region : helper.getVisibleRegions())
+    {
+        visibleWindows += region.isEmpty() ? 0 : 1;
+        visibleArea += region.getArea();
+    }
+
+    const auto allAtOnce =
+        measure(repeatCount, [&helper] { helper.getVisibleRegions(); });
+
+    const auto oneByOne = measure(repeatCount, [&helper, &group] {
+        for (const auto& window : group->getWindows())
+            helper.getVisibleRegion(*window);
+    });
+
+    const auto results = QJsonObject{
+        {"windows", int(windowsCount)},
+        {"visibleWindows", int(visibleWindows)},
+        {"visibleAreaRatio", visibleArea / (screenRect.width() *
+                                            screenRect.height())},
+        {"allWindowsAtOnceMs", allAtOnce},
+        {"oneWindowAtATimeMs", oneByOne}};
+
+    const auto json = QJsonDocument{results}.toJson();
+    if (commandLine.output().empty())
+        std::cout << json.constData();
+    else
+        std::ofstream{commandLine.output()} << json.constData();
+
+    return EXIT_SUCCESS;
+}
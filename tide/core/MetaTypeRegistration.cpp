@@ -41,6 +41,10 @@
 #include "types.h"
 
 #include "network/MessageHeader.h"
+#include "network/ScreenshotRequest.h"
+#include "network/TraceReply.h"
+#include "network/TraceRequest.h"
+#include "network/WallTelemetry.h"
 #include "scene/Window.h"
 
 #include <QMetaType>
@@ -69,9 +73,13 @@ struct MetaTypeRegistration
         qRegisterMetaType<OptionsPtr>("OptionsPtr");
         qRegisterMetaType<QUuid>("QUuid");
         qRegisterMetaType<ScreenLockPtr>("ScreenLockPtr");
+        qRegisterMetaType<ScreenshotRequest>("ScreenshotRequest");
         qRegisterMetaType<std::string>("std::string");
         qRegisterMetaType<TilePtr>("TilePtr");
         qRegisterMetaType<TileWeakPtr>("TileWeakPtr");
+        qRegisterMetaType<TraceReply>("TraceReply");
+        qRegisterMetaType<TraceRequest>("TraceRequest");
+        qRegisterMetaType<WallTelemetry>("WallTelemetry");
         qRegisterMetaTypeStreamOperators<QUuid>("QUuid");
     }
 };
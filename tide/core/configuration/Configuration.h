@@ -81,11 +81,89 @@ public:
 
         /** Directory for saving session contents uploaded via web interface. */
         QString upload;
+
+        /**
+         * Directory of the persistent tile cache of the wall processes,
+         * preferably on a fast local disk. Empty to disable the cache.
+         */
+        QString tileCache;
     } folders;
 
     struct Global
     {
         SwapSync swapsync = SwapSync::software;
+
+        /** Segment size for pipelining large broadcasts [bytes], 0: off. */
+        uint broadcastSegmentSize = 0;
+
+        /** Maximum number of broadcast segments in flight. */
+        uint broadcastSegmentsInFlight = 4;
+
+        /** Wait policy of each blocking MPI operation. */
+        struct MpiWait
+        {
+            WaitPolicy send = WaitPolicy::backoff;
+            WaitPolicy probe = WaitPolicy::backoff;
+            WaitPolicy receive = WaitPolicy::backoff;
+            WaitPolicy broadcastHeader = WaitPolicy::backoff;
+            WaitPolicy receiveHeader = WaitPolicy::backoff;
+        } mpiWait;
+
+        /** Compression of the messages broadcast to the walls. */
+        struct MpiCompression
+        {
+            /** Minimum size of a message to compress it [bytes]. */
+            uint threshold = 65536;
+
+            Codec scene = Codec::none;
+            Codec markers = Codec::none;
+            Codec pixelstream = Codec::none;
+        } mpiCompression;
+
+        /**
+         * Send pixel stream frames once per host, sharing them between its
+         * wall processes through shared memory.
+         */
+        bool shareFramesOnHost = false;
+
+        /** Memory budget of the tile image cache of each wall process [MB]. */
+        uint tileCacheSize = 1024;
+
+        /** Size limit of the persistent tile cache (folders.tileCache) [MB]. */
+        uint tileCacheDiskSize = 10240;
+
+        /** Memory budget of the unused GPU textures of each window [MB]. */
+        uint texturePoolSize = 256;
+
+        /**
+         * Upload the opaque tiles of these static contents as compressed
+         * textures, using 8x less GPU memory at a small loss of quality.
+         */
+        struct TextureCompression
+        {
+            bool image = false;
+            bool imagePyramid = false;
+            bool pdf = false;
+            bool svg = false;
+        } textureCompression;
+
+        /**
+         * Start the frames of the wall processes just in time for the next
+         * refresh of the displays, instead of as soon as possible.
+         */
+        struct FramePacing
+        {
+            bool enabled = false;
+
+            /** Time kept free before each swap deadline [us]. */
+            uint safetyMargin = 2000;
+
+            /** Refresh rate of the displays [Hz], 0: measured from swaps. */
+            uint refreshRate = 0;
+        } framePacing;
+
+        /** Interval of the wall performance reports [ms], 0: disabled. */
+        uint telemetryInterval = 1000;
     } global;
 
     struct Launcher
@@ -114,6 +192,9 @@ public:
 
         /** Port for the WebService server to listen for incoming requests. */
         uint16_t webservicePort = 8888;
+
+        /** Maximum rate of updates sent to the walls [Hz], 0 for no limit. */
+        uint wallUpdateRate = 60;
     } master;
 
     struct Settings
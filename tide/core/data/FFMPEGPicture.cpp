@@ -39,9 +39,41 @@
 
 #include "FFMPEGPicture.h"
 
+#include "FFMPEGFrame.h"
+
+#include <cstring>
+
 #pragma clang diagnostic ignored "-Wdeprecated"
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
+// FFMPEG 2.1, reference counted frames
+#define HAS_FRAME_REF_API (LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(55, 28, 0))
+
+namespace
+{
+size_t _getPlanesCount(const TextureFormat format)
+{
+    return format == TextureFormat::rgba ? 1 : 3;
+}
+
+bool _isSameFormat(const AVPixelFormat avFormat, const TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::rgba:
+        return avFormat == AV_PIX_FMT_RGBA;
+    case TextureFormat::yuv420:
+        return avFormat == AV_PIX_FMT_YUV420P;
+    case TextureFormat::yuv422:
+        return avFormat == AV_PIX_FMT_YUV422P;
+    case TextureFormat::yuv444:
+        return avFormat == AV_PIX_FMT_YUV444P;
+    default:
+        return false;
+    }
+}
+}
+
 FFMPEGPicture::FFMPEGPicture(const uint width, const uint height,
                              const TextureFormat format)
     : _width{width}
@@ -69,6 +101,40 @@ FFMPEGPicture::FFMPEGPicture(const uint width, const uint height,
     }
 }
 
+FFMPEGPicture::FFMPEGPicture(AVFrame* frame, const TextureFormat format)
+    : _width(frame->width)
+    , _height(frame->height)
+    , _format{format}
+    , _frame{frame}
+{
+}
+
+FFMPEGPicture::~FFMPEGPicture()
+{
+#if HAS_FRAME_REF_API
+    av_frame_free(&_frame);
+#endif
+}
+
+std::shared_ptr<FFMPEGPicture> FFMPEGPicture::reference(
+    const FFMPEGFrame& frame, const TextureFormat format)
+{
+#if HAS_FRAME_REF_API
+    if (!_isSameFormat(frame.getAVPixelFormat(), format))
+        return nullptr;
+
+    // Shares the reference counted buffers of the decoder
+    auto avFrame = av_frame_clone(&frame.getAVFrame());
+    if (!avFrame)
+        return nullptr;
+    return std::shared_ptr<FFMPEGPicture>{new FFMPEGPicture(avFrame, format)};
+#else
+    Q_UNUSED(frame);
+    Q_UNUSED(format);
+    return nullptr;
+#endif
+}
+
 int FFMPEGPicture::getWidth() const
 {
     return _width;
@@ -81,9 +147,16 @@ int FFMPEGPicture::getHeight() const
 
 const uint8_t* FFMPEGPicture::getData(const uint texture) const
 {
-    if (texture >= _data.size())
+    if (texture >= _getPlanesCount(_format))
         return nullptr;
 
+    if (_frame)
+    {
+        if (size_t(_frame->linesize[texture]) == _getLineSize(texture))
+            return _frame->data[texture];
+        // getData() has no row padding, pack the padded planes of the decoder
+        std::call_once(_packed, [this] { _pack(); });
+    }
     return reinterpret_cast<const uint8_t*>(_data[texture].constData());
 }
 
@@ -97,20 +170,36 @@ ColorSpace FFMPEGPicture::getColorSpace() const
     return ColorSpace::yCbCrVideo;
 }
 
+void FFMPEGPicture::writeData(const uint texture, uint8_t* dest) const
+{
+    if (_frame && texture < _getPlanesCount(_format))
+        _copyFramePlane(texture, dest);
+    else
+        YUVImage::writeData(texture, dest);
+}
+
 uint8_t* FFMPEGPicture::getData(const uint texture)
 {
-    if (texture >= _data.size())
+    if (texture >= _getPlanesCount(_format))
         return nullptr;
 
+    // Never write to the buffers of the decoder, it may still reference them
+    if (_frame)
+    {
+        std::call_once(_packed, [this] { _pack(); });
+#if HAS_FRAME_REF_API
+        av_frame_free(&_frame);
+#endif
+    }
     return reinterpret_cast<uint8_t*>(_data[texture].data());
 }
 
 size_t FFMPEGPicture::getDataSize(const uint texture) const
 {
-    if (texture >= _data.size())
+    if (texture >= _getPlanesCount(_format))
         return 0;
 
-    return _data[texture].size();
+    return _getLineSize(texture) * getTextureSize(texture).height();
 }
 
 QImage FFMPEGPicture::toQImage() const
@@ -120,3 +209,34 @@ QImage FFMPEGPicture::toQImage() const
 
     return QImage(getData(), getWidth(), getHeight(), QImage::Format_RGBA8888);
 }
+
+size_t FFMPEGPicture::_getLineSize(const uint texture) const
+{
+    const auto bytesPerPixel = _format == TextureFormat::rgba ? 4 : 1;
+    return getTextureSize(texture).width() * bytesPerPixel;
+}
+
+void FFMPEGPicture::_copyFramePlane(const uint texture, uint8_t* dest) const
+{
+    const auto lineSize = _getLineSize(texture);
+    const auto height = size_t(getTextureSize(texture).height());
+    const auto src = _frame->data[texture];
+    const auto srcLineSize = size_t(_frame->linesize[texture]);
+
+    if (srcLineSize == lineSize)
+    {
+        std::memcpy(dest, src, lineSize * height);
+        return;
+    }
+    for (size_t y = 0; y < height; ++y)
+        std::memcpy(dest + y * lineSize, src + y * srcLineSize, lineSize);
+}
+
+void FFMPEGPicture::_pack() const
+{
+    for (uint i = 0; i < _getPlanesCount(_format); ++i)
+    {
+        _data[i] = QByteArray{int(getDataSize(i)), Qt::Uninitialized};
+        _copyFramePlane(i, reinterpret_cast<uint8_t*>(_data[i].data()));
+    }
+}
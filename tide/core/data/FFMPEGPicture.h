@@ -46,9 +46,18 @@
 #include <QImage>
 
 #include <array>
+#include <memory>
+#include <mutex>
+
+struct AVFrame;
+class FFMPEGFrame;
 
 /**
  * A decoded frame of the movie stream in RGBA or YUV format.
+ *
+ * The picture either owns its pixels, or references those of a decoded frame
+ * which is already in the requested format. In the latter case the planes are
+ * written straight from the decoder's buffers to the texture upload buffers.
  */
 class FFMPEGPicture : public YUVImage
 {
@@ -56,6 +65,18 @@ public:
     /** Allocate a new picture. */
     FFMPEGPicture(uint width, uint height, TextureFormat format);
 
+    /** Release the pixels, or the reference to the decoded frame. */
+    ~FFMPEGPicture();
+
+    /**
+     * Reference the pixels of a decoded frame, without copying them.
+     * @param frame the decoded frame.
+     * @param format the format of the picture.
+     * @return the picture, or nullptr if the frame is not in the given format.
+     */
+    static std::shared_ptr<FFMPEGPicture> reference(const FFMPEGFrame& frame,
+                                                    TextureFormat format);
+
     /** @copydoc Image::getWidth */
     int getWidth() const final;
 
@@ -71,6 +92,9 @@ public:
     /** @copydoc Image::getColorSpace */
     ColorSpace getColorSpace() const final;
 
+    /** @copydoc Image::writeData */
+    void writeData(uint texture, uint8_t* dest) const final;
+
     /** @return write access to fill a given image texture plane. */
     uint8_t* getData(uint texture);
 
@@ -84,7 +108,17 @@ private:
     const uint _width;
     const uint _height;
     const TextureFormat _format;
-    std::array<QByteArray, 3> _data;
+    mutable std::array<QByteArray, 3> _data;
+    AVFrame* _frame = nullptr;
+    mutable std::once_flag _packed;
+
+    FFMPEGPicture(AVFrame* frame, TextureFormat format);
+    FFMPEGPicture(const FFMPEGPicture&) = delete;
+    FFMPEGPicture& operator=(const FFMPEGPicture&) = delete;
+
+    size_t _getLineSize(uint texture) const;
+    void _copyFramePlane(uint texture, uint8_t* dest) const;
+    void _pack() const;
 };
 
 #endif
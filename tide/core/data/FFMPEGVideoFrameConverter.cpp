@@ -86,6 +86,11 @@ FFMPEGVideoFrameConverter::~FFMPEGVideoFrameConverter()
 PicturePtr FFMPEGVideoFrameConverter::convert(const FFMPEGFrame& srcFrame,
                                               const TextureFormat format)
 {
+    // Frames decoded in the requested format need no conversion: reference
+    // them, the texture upload copies them straight from the decoder buffers
+    if (auto picture = FFMPEGPicture::reference(srcFrame, format))
+        return picture;
+
     auto picture =
         std::make_shared<FFMPEGPicture>(srcFrame.getWidth(),
                                         srcFrame.getHeight(), format);
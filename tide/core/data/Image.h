@@ -43,6 +43,8 @@
 
 #include "types.h"
 
+#include <cstring> // std::memcpy
+
 /**
  * An interface to provide necessary image information for the texture upload.
  *
@@ -80,6 +82,21 @@ public:
         return tex.width() * tex.height() * bpp;
     }
 
+    /**
+     * Write the pixels of the given texture plane to a destination buffer.
+     *
+     * This is used to fill the (mapped) upload buffers of the textures. The
+     * default implementation copies getData(); images which decode or convert
+     * their pixels can override it to write them straight to the destination.
+     *
+     * @param texture the texture plane.
+     * @param dest the destination, of at least getDataSize(texture) bytes.
+     */
+    virtual void writeData(const uint texture, uint8_t* dest) const
+    {
+        std::memcpy(dest, getData(texture), getDataSize(texture));
+    }
+
     /** @return the row order of the image data. */
     virtual deflect::RowOrder getRowOrder() const
     {
@@ -94,6 +111,21 @@ public:
     /** @return the OpenGL pixel format of the image data. */
     virtual uint getGLPixelFormat() const = 0;
 
+    /**
+     * @return the OpenGL format of the compressed data of the image, or 0 if
+     *         the image has no compressed representation.
+     */
+    virtual uint getGLCompressedFormat() const { return 0; }
+
+    /**
+     * @return the compressed data, including all the mipmap levels down to
+     *         1x1 (optional, only if getGLCompressedFormat() is not 0).
+     */
+    virtual const uint8_t* getCompressedData() const { return nullptr; }
+
+    /** @return the size of the compressed data buffer. */
+    virtual size_t getCompressedDataSize() const { return 0; }
+
     /** @return true if generateGpuImage must be called from render thread. */
     virtual bool isGpuImage() const { return false; }
     /**
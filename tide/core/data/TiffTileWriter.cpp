@@ -0,0 +1,204 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TiffTileWriter.h"
+
+#include "utils/log.h"
+
+#include <tiffio.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+const int bytesPerPixel = 3;
+
+// Classic TIFF files use 32 bit offsets, switch to BigTIFF well before that.
+const qint64 maxClassicTiffSize = qint64(1) << 31;
+
+struct TIFFDeleter
+{
+    void operator()(TIFF* file) { TIFFClose(file); }
+};
+using TIFFPtr = std::unique_ptr<TIFF, TIFFDeleter>;
+
+const char* _getOpenMode(const QSize& imageSize)
+{
+    const auto size = qint64(imageSize.width()) * imageSize.height();
+    return size * bytesPerPixel < maxClassicTiffSize ? "w" : "w8";
+}
+}
+
+struct TiffTileWriter::Impl
+{
+    TIFFPtr tif;
+    const QSize imageSize;
+    const QSize tileSize;
+
+    // The rows of the current row of tiles
+    QImage band;
+    int bandRows = 0;
+    int bandTop = 0;
+    int rowCount = 0;
+
+    Impl(const QString& uri, const QSize& imageSize_, const QSize& tileSize_)
+        : imageSize{imageSize_}
+        , tileSize{tileSize_}
+    {
+        if (imageSize.isEmpty())
+            throw std::invalid_argument("Invalid image size");
+
+        if (tileSize.isEmpty() || tileSize.width() % 16 ||
+            tileSize.height() % 16)
+        {
+            throw std::invalid_argument("Tile size must be a multiple of 16");
+        }
+
+        const auto filename = uri.toLocal8Bit();
+        tif.reset(TIFFOpen(filename.constData(), _getOpenMode(imageSize)));
+        if (!tif)
+            throw std::runtime_error("File could not be created");
+
+        writeHeader();
+        band = QImage{imageSize.width(), tileSize.height(),
+                      QImage::Format_RGB888};
+    }
+
+    ~Impl()
+    {
+        try
+        {
+            writeTiles();
+        }
+        catch (const std::runtime_error& e)
+        {
+            print_log(LOG_ERROR, LOG_TIFF, "%s", e.what());
+        }
+        if (rowCount < imageSize.height())
+            print_log(LOG_WARN, LOG_TIFF, "image closed after %d of %d rows",
+                      rowCount, imageSize.height());
+    }
+
+    void writeHeader()
+    {
+        auto file = tif.get();
+        TIFFSetField(file, TIFFTAG_IMAGEWIDTH, imageSize.width());
+        TIFFSetField(file, TIFFTAG_IMAGELENGTH, imageSize.height());
+        TIFFSetField(file, TIFFTAG_TILEWIDTH, tileSize.width());
+        TIFFSetField(file, TIFFTAG_TILELENGTH, tileSize.height());
+        TIFFSetField(file, TIFFTAG_SAMPLESPERPIXEL, bytesPerPixel);
+        TIFFSetField(file, TIFFTAG_BITSPERSAMPLE, 8);
+        TIFFSetField(file, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+        TIFFSetField(file, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+        TIFFSetField(file, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+        TIFFSetField(file, TIFFTAG_PREDICTOR, PREDICTOR_HORIZONTAL);
+    }
+
+    void append(const QImage& rows)
+    {
+        const auto rowSize = size_t(imageSize.width()) * bytesPerPixel;
+        for (auto y = 0; y < rows.height(); ++y)
+        {
+            std::memcpy(band.scanLine(bandRows++), rows.constScanLine(y),
+                        rowSize);
+            ++rowCount;
+            if (bandRows == band.height())
+                writeTiles();
+        }
+    }
+
+    void writeTiles()
+    {
+        if (bandRows == 0)
+            return;
+
+        const auto tileWidth = tileSize.width();
+        const auto tileRowSize = size_t(tileWidth) * bytesPerPixel;
+        auto tile = std::vector<uchar>(tileRowSize * tileSize.height(), 0);
+
+        for (auto x = 0; x < imageSize.width(); x += tileWidth)
+        {
+            const auto width = std::min(tileWidth, imageSize.width() - x);
+            for (auto y = 0; y < bandRows; ++y)
+            {
+                std::memcpy(tile.data() + y * tileRowSize,
+                            band.constScanLine(y) + x * bytesPerPixel,
+                            size_t(width) * bytesPerPixel);
+            }
+            if (TIFFWriteTile(tif.get(), tile.data(), x, bandTop, 0, 0) < 0)
+                throw std::runtime_error("Could not write tile");
+        }
+        bandTop += bandRows;
+        bandRows = 0;
+    }
+};
+
+TiffTileWriter::TiffTileWriter(const QString& uri, const QSize& imageSize,
+                               const QSize& tileSize)
+    : _impl{new Impl{uri, imageSize, tileSize}}
+{
+}
+
+TiffTileWriter::~TiffTileWriter() = default;
+
+QSize TiffTileWriter::getImageSize() const
+{
+    return _impl->imageSize;
+}
+
+int TiffTileWriter::getRowCount() const
+{
+    return _impl->rowCount;
+}
+
+void TiffTileWriter::write(const QImage& rows)
+{
+    if (rows.width() != _impl->imageSize.width() ||
+        _impl->rowCount + rows.height() > _impl->imageSize.height())
+    {
+        throw std::invalid_argument("Rows do not fit in the image");
+    }
+
+    if (rows.format() == QImage::Format_RGB888)
+        _impl->append(rows);
+    else
+        _impl->append(rows.convertToFormat(QImage::Format_RGB888));
+}
@@ -0,0 +1,90 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TIFFTILEWRITER_H
+#define TIFFTILEWRITER_H
+
+#include <QImage>
+#include <memory>
+
+/**
+ * Writer for tiled TIFF images, which are streamed to disk one band of rows at
+ * a time.
+ *
+ * Only the rows needed to complete the current row of tiles are kept in
+ * memory, which allows writing images much larger than the available memory.
+ * The images are stored as lossless compressed RGB tiles.
+ */
+class TiffTileWriter
+{
+public:
+    /**
+     * Create an image file for writing.
+     * @param uri the TIFF image file to create
+     * @param imageSize the full size of the image
+     * @param tileSize the size of the image tiles, a multiple of 16
+     * @throw std::invalid_argument if the image or tile size is invalid
+     * @throw std::runtime_error if the file could not be created
+     */
+    TiffTileWriter(const QString& uri, const QSize& imageSize,
+                   const QSize& tileSize = QSize(512, 512));
+
+    /** Close the image, writing any remaining rows. */
+    ~TiffTileWriter();
+
+    /** Get the full size of the image. */
+    QSize getImageSize() const;
+
+    /** Get the number of rows of the image written so far. */
+    int getRowCount() const;
+
+    /**
+     * Append a band of rows to the image.
+     * @param rows the next rows of the image, must be as wide as the image
+     * @throw std::invalid_argument if the rows do not fit in the image
+     * @throw std::runtime_error if the tiles could not be written
+     */
+    void write(const QImage& rows);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+
+#endif
@@ -70,6 +70,38 @@ QJsonValue serialize(const SwapSync swapsync)
     }
 }
 
+QJsonValue serialize(const WaitPolicy policy)
+{
+    switch (policy)
+    {
+    case WaitPolicy::spin:
+        return "spin";
+    case WaitPolicy::spinThenYield:
+        return "spinThenYield";
+    case WaitPolicy::backoff:
+        return "backoff";
+    case WaitPolicy::adaptive:
+        return "adaptive";
+    default:
+        throw std::logic_error("unsupported WaitPolicy type");
+    }
+}
+
+QJsonValue serialize(const Codec codec)
+{
+    switch (codec)
+    {
+    case Codec::none:
+        return "none";
+    case Codec::lz4:
+        return "lz4";
+    case Codec::zstd:
+        return "zstd";
+    default:
+        throw std::logic_error("unsupported Codec type");
+    }
+}
+
 QJsonValue serialize(const deflect::View view)
 {
     switch (view)
@@ -138,6 +170,36 @@ void deserialize(const QJsonValue& value, SwapSync& result)
     }
 }
 
+void deserialize(const QJsonValue& value, WaitPolicy& result)
+{
+    if (value.isString())
+    {
+        const auto policy = value.toString();
+        if (policy == "spin")
+            result = WaitPolicy::spin;
+        else if (policy == "spinThenYield")
+            result = WaitPolicy::spinThenYield;
+        else if (policy == "backoff")
+            result = WaitPolicy::backoff;
+        else if (policy == "adaptive")
+            result = WaitPolicy::adaptive;
+    }
+}
+
+void deserialize(const QJsonValue& value, Codec& result)
+{
+    if (value.isString())
+    {
+        const auto codec = value.toString();
+        if (codec == "none")
+            result = Codec::none;
+        else if (codec == "lz4")
+            result = Codec::lz4;
+        else if (codec == "zstd")
+            result = Codec::zstd;
+    }
+}
+
 void deserialize(const QJsonValue& value, deflect::View& result)
 {
     if (value.isString())
@@ -193,15 +255,62 @@ QJsonObject serialize(const Options& options)
 
 QJsonObject serialize(const Configuration& config)
 {
+    const auto& wait = config.global.mpiWait;
+    const auto mpiWait =
+        QJsonObject{{"send", serialize(wait.send)},
+                    {"probe", serialize(wait.probe)},
+                    {"receive", serialize(wait.receive)},
+                    {"broadcastHeader", serialize(wait.broadcastHeader)},
+                    {"receiveHeader", serialize(wait.receiveHeader)}};
+
+    const auto& compression = config.global.mpiCompression;
+    const auto mpiCompression =
+        QJsonObject{{"threshold", static_cast<int>(compression.threshold)},
+                    {"scene", serialize(compression.scene)},
+                    {"markers", serialize(compression.markers)},
+                    {"pixelstream", serialize(compression.pixelstream)}};
+
+    const auto& textures = config.global.textureCompression;
+    const auto textureCompression =
+        QJsonObject{{"image", textures.image},
+                    {"imagePyramid", textures.imagePyramid},
+                    {"pdf", textures.pdf},
+                    {"svg", textures.svg}};
+
+    const auto& pacing = config.global.framePacing;
+    const auto framePacing =
+        QJsonObject{{"enabled", pacing.enabled},
+                    {"safetyMargin", static_cast<int>(pacing.safetyMargin)},
+                    {"refreshRate", static_cast<int>(pacing.refreshRate)}};
+
     return QJsonObject{
         {"surfaces", serialize(config.surfaces)},
         {"processes", serialize(config.processes)},
         {"folders", QJsonObject{{"contents", config.folders.contents},
                                 {"sessions", config.folders.sessions},
                                 {"tmp", config.folders.tmp},
-                                {"upload", config.folders.upload}}},
+                                {"upload", config.folders.upload},
+                                {"tileCache", config.folders.tileCache}}},
         {"global",
-         QJsonObject{{"swapsync", serialize(config.global.swapsync)}}},
+         QJsonObject{{"swapsync", serialize(config.global.swapsync)},
+                     {"broadcastSegmentSize",
+                      static_cast<int>(config.global.broadcastSegmentSize)},
+                     {"broadcastSegmentsInFlight",
+                      static_cast<int>(
+                          config.global.broadcastSegmentsInFlight)},
+                     {"mpiWait", mpiWait},
+                     {"mpiCompression", mpiCompression},
+                     {"shareFramesOnHost", config.global.shareFramesOnHost},
+                     {"tileCacheSize",
+                      static_cast<int>(config.global.tileCacheSize)},
+                     {"tileCacheDiskSize",
+                      static_cast<int>(config.global.tileCacheDiskSize)},
+                     {"texturePoolSize",
+                      static_cast<int>(config.global.texturePoolSize)},
+                     {"textureCompression", textureCompression},
+                     {"framePacing", framePacing},
+                     {"telemetryInterval",
+                      static_cast<int>(config.global.telemetryInterval)}}},
         {"launcher",
          QJsonObject{{"display", config.launcher.display},
                      {"demoServiceUrl", config.launcher.demoServiceUrl}}},
@@ -210,7 +319,9 @@ QJsonObject serialize(const Configuration& config)
                      {"display", config.master.display},
                      {"headless", config.master.headless},
                      {"webservicePort", config.master.webservicePort},
-                     {"planarSerialPort", config.master.planarSerialPort}}},
+                     {"planarSerialPort", config.master.planarSerialPort},
+                     {"wallUpdateRate",
+                      static_cast<int>(config.master.wallUpdateRate)}}},
         {"settings",
          QJsonObject{{"infoName", config.settings.infoName},
                      {"touchpointsToWakeup",
@@ -418,9 +529,51 @@ bool deserialize(const QJsonObject& object, Configuration& config)
     deserialize(foldersObj["sessions"], config.folders.sessions);
     deserialize(foldersObj["tmp"], config.folders.tmp);
     deserialize(foldersObj["upload"], config.folders.upload);
+    deserialize(foldersObj["tileCache"], config.folders.tileCache);
 
     const auto globalObj = object["global"].toObject();
     deserialize(globalObj["swapsync"], config.global.swapsync);
+    deserialize(globalObj["broadcastSegmentSize"],
+                config.global.broadcastSegmentSize);
+    deserialize(globalObj["broadcastSegmentsInFlight"],
+                config.global.broadcastSegmentsInFlight);
+
+    const auto mpiWaitObj = globalObj["mpiWait"].toObject();
+    deserialize(mpiWaitObj["send"], config.global.mpiWait.send);
+    deserialize(mpiWaitObj["probe"], config.global.mpiWait.probe);
+    deserialize(mpiWaitObj["receive"], config.global.mpiWait.receive);
+    deserialize(mpiWaitObj["broadcastHeader"],
+                config.global.mpiWait.broadcastHeader);
+    deserialize(mpiWaitObj["receiveHeader"],
+                config.global.mpiWait.receiveHeader);
+
+    const auto compressionObj = globalObj["mpiCompression"].toObject();
+    auto& compression = config.global.mpiCompression;
+    deserialize(compressionObj["threshold"], compression.threshold);
+    deserialize(compressionObj["scene"], compression.scene);
+    deserialize(compressionObj["markers"], compression.markers);
+    deserialize(compressionObj["pixelstream"], compression.pixelstream);
+    deserialize(globalObj["shareFramesOnHost"],
+                config.global.shareFramesOnHost);
+    deserialize(globalObj["tileCacheSize"], config.global.tileCacheSize);
+    deserialize(globalObj["tileCacheDiskSize"],
+                config.global.tileCacheDiskSize);
+    deserialize(globalObj["texturePoolSize"], config.global.texturePoolSize);
+
+    const auto texturesObj = globalObj["textureCompression"].toObject();
+    auto& textures = config.global.textureCompression;
+    deserialize(texturesObj["image"], textures.image);
+    deserialize(texturesObj["imagePyramid"], textures.imagePyramid);
+    deserialize(texturesObj["pdf"], textures.pdf);
+    deserialize(texturesObj["svg"], textures.svg);
+
+    const auto pacingObj = globalObj["framePacing"].toObject();
+    auto& pacing = config.global.framePacing;
+    deserialize(pacingObj["enabled"], pacing.enabled);
+    deserialize(pacingObj["safetyMargin"], pacing.safetyMargin);
+    deserialize(pacingObj["refreshRate"], pacing.refreshRate);
+    deserialize(globalObj["telemetryInterval"],
+                config.global.telemetryInterval);
 
     const auto launcherObj = object["launcher"].toObject();
     deserialize(launcherObj["display"], config.launcher.display);
@@ -432,6 +585,7 @@ bool deserialize(const QJsonObject& object, Configuration& config)
     deserialize(masterObj["headless"], config.master.headless);
     deserialize(masterObj["webservicePort"], config.master.webservicePort);
     deserialize(masterObj["planarSerialPort"], config.master.planarSerialPort);
+    deserialize(masterObj["wallUpdateRate"], config.master.wallUpdateRate);
 
     const auto settingsObj = object["settings"].toObject();
     deserialize(settingsObj["infoName"], config.settings.infoName);
@@ -59,6 +59,8 @@ QUuid url_decode(const QString& uuid);
 /** @name Serialize custom enum types as JSON value. */
 //@{
 QJsonValue serialize(SwapSync result);
+QJsonValue serialize(WaitPolicy result);
+QJsonValue serialize(Codec result);
 QJsonValue serialize(deflect::View result);
 //@}
 
@@ -71,6 +73,8 @@ void deserialize(const QJsonValue& value, ushort& result);
 void deserialize(const QJsonValue& value, double& result);
 void deserialize(const QJsonValue& value, QString& result);
 void deserialize(const QJsonValue& value, SwapSync& result);
+void deserialize(const QJsonValue& value, WaitPolicy& result);
+void deserialize(const QJsonValue& value, Codec& result);
 void deserialize(const QJsonValue& value, deflect::View& result);
 //@}
 
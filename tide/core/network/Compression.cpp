@@ -0,0 +1,343 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "Compression.h"
+
+#if TIDE_USE_LZ4
+#include <lz4.h>
+#endif
+#if TIDE_USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+#if TIDE_USE_LZ4
+const bool hasLz4 = true;
+#else
+const bool hasLz4 = false;
+#endif
+#if TIDE_USE_ZSTD
+const bool hasZstd = true;
+#else
+const bool hasZstd = false;
+#endif
+
+// Favor speed, the messages are compressed for every frame
+const int zstdCompressionLevel = 1;
+
+// LZ4 data are a sequence of blocks, each preceded by its compressed size, so
+// that the first blocks can be decompressed before the next ones are
+// received. The blocks reference the previous ones like a single block would.
+const size_t lz4BlockSize = 64 * 1024;
+
+void _checkAvailable(const Codec codec)
+{
+    if (!compression::isAvailable(codec))
+        throw std::runtime_error("Compression codec not available");
+}
+
+void _checkSize(const size_t size)
+{
+    if (size > size_t(std::numeric_limits<int>::max()))
+        throw std::runtime_error("Message too large for compression");
+}
+
+#if TIDE_USE_LZ4
+QByteArray _compressLz4(const char* data, const size_t size)
+{
+    size_t bound = 0;
+    for (size_t offset = 0; offset < size; offset += lz4BlockSize)
+    {
+        const auto blockSize = std::min(lz4BlockSize, size - offset);
+        bound += sizeof(uint32_t) + LZ4_compressBound(blockSize);
+    }
+    QByteArray output(bound, Qt::Uninitialized);
+
+    std::unique_ptr<LZ4_stream_t, decltype(&LZ4_freeStream)> stream{
+        LZ4_createStream(), &LZ4_freeStream};
+    if (!stream)
+        throw std::runtime_error("LZ4 compression failed");
+
+    size_t outputSize = 0;
+    for (size_t offset = 0; offset < size; offset += lz4BlockSize)
+    {
+        const auto blockSize = std::min(lz4BlockSize, size - offset);
+        const auto block = output.data() + outputSize + sizeof(uint32_t);
+        const auto capacity = bound - outputSize - sizeof(uint32_t);
+        const auto compressedSize =
+            LZ4_compress_fast_continue(stream.get(), data + offset, block,
+                                       int(blockSize), int(capacity), 1);
+        if (compressedSize <= 0)
+            throw std::runtime_error("LZ4 compression failed");
+
+        const auto header = uint32_t(compressedSize);
+        std::memcpy(output.data() + outputSize, &header, sizeof(header));
+        outputSize += sizeof(header) + compressedSize;
+    }
+    output.resize(outputSize);
+    return output;
+}
+#endif
+}
+
+namespace compression
+{
+bool isAvailable(const Codec codec)
+{
+    switch (codec)
+    {
+    case Codec::none:
+        return true;
+    case Codec::lz4:
+        return hasLz4;
+    case Codec::zstd:
+        return hasZstd;
+    default:
+        return false;
+    }
+}
+
+QByteArray compress(const Codec codec, const char* data, const size_t size)
+{
+    _checkAvailable(codec);
+    _checkSize(size);
+
+    QByteArray output;
+    switch (codec)
+    {
+    case Codec::none:
+        output = QByteArray(data, size);
+        break;
+#if TIDE_USE_LZ4
+    case Codec::lz4:
+        output = _compressLz4(data, size);
+        break;
+#endif
+#if TIDE_USE_ZSTD
+    case Codec::zstd:
+    {
+        output.resize(ZSTD_compressBound(size));
+        const auto outputSize = ZSTD_compress(output.data(), output.size(),
+                                              data, size, zstdCompressionLevel);
+        if (ZSTD_isError(outputSize))
+            throw std::runtime_error("Zstd compression failed");
+        output.resize(outputSize);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+    return output;
+}
+
+void decompress(const Codec codec, const char* data, const size_t size,
+                char* output, const size_t outputSize)
+{
+    Decompressor{codec, data, size, output, outputSize}.update(size);
+}
+
+struct Decompressor::Impl
+{
+    Impl(const Codec codec_, const char* data_, const size_t size_,
+         char* output_, const size_t outputSize_)
+        : codec{codec_}
+        , data{data_}
+        , size{size_}
+        , output{output_}
+        , outputSize{outputSize_}
+    {
+        _checkAvailable(codec);
+        _checkSize(outputSize);
+#if TIDE_USE_LZ4
+        if (codec == Codec::lz4)
+        {
+            lz4Stream = LZ4_createStreamDecode();
+            if (!lz4Stream)
+                throw std::runtime_error("LZ4 decompression failed");
+        }
+#endif
+#if TIDE_USE_ZSTD
+        if (codec == Codec::zstd)
+        {
+            zstdStream = ZSTD_createDStream();
+            if (!zstdStream || ZSTD_isError(ZSTD_initDStream(zstdStream)))
+            {
+                ZSTD_freeDStream(zstdStream);
+                throw std::runtime_error("Zstd decompression failed");
+            }
+        }
+#endif
+    }
+
+    ~Impl()
+    {
+#if TIDE_USE_LZ4
+        LZ4_freeStreamDecode(lz4Stream);
+#endif
+#if TIDE_USE_ZSTD
+        ZSTD_freeDStream(zstdStream);
+#endif
+    }
+
+    const Codec codec;
+    const char* const data;
+    const size_t size;
+    char* const output;
+    const size_t outputSize;
+
+    size_t inputOffset = 0;
+    size_t outputOffset = 0;
+    bool complete = false;
+
+#if TIDE_USE_LZ4
+    LZ4_streamDecode_t* lz4Stream = nullptr;
+#endif
+#if TIDE_USE_ZSTD
+    ZSTD_DStream* zstdStream = nullptr;
+#endif
+
+    void update(const size_t receivedSize)
+    {
+        switch (codec)
+        {
+        case Codec::none:
+            _copy(receivedSize);
+            break;
+#if TIDE_USE_LZ4
+        case Codec::lz4:
+            _decompressLz4(receivedSize);
+            break;
+#endif
+#if TIDE_USE_ZSTD
+        case Codec::zstd:
+            _decompressZstd(receivedSize);
+            break;
+#endif
+        default:
+            break;
+        }
+    }
+
+private:
+    void _copy(const size_t receivedSize)
+    {
+        const auto end = std::min(receivedSize, outputSize);
+        if (end > outputOffset)
+            std::memcpy(output + outputOffset, data + outputOffset,
+                        end - outputOffset);
+        inputOffset = receivedSize;
+        outputOffset = std::max(outputOffset, end);
+        complete = size == outputSize && outputOffset == outputSize;
+    }
+
+#if TIDE_USE_LZ4
+    void _decompressLz4(const size_t receivedSize)
+    {
+        uint32_t blockSize = 0;
+        while (inputOffset + sizeof(blockSize) <= receivedSize)
+        {
+            std::memcpy(&blockSize, data + inputOffset, sizeof(blockSize));
+            const auto block = inputOffset + sizeof(blockSize);
+            if (block + blockSize > receivedSize)
+                break;
+
+            const auto count =
+                int(std::min(lz4BlockSize, outputSize - outputOffset));
+            if (count == 0 ||
+                LZ4_decompress_safe_continue(lz4Stream, data + block,
+                                             output + outputOffset,
+                                             int(blockSize), count) != count)
+            {
+                throw std::runtime_error("Corrupted compressed data");
+            }
+            inputOffset = block + blockSize;
+            outputOffset += count;
+        }
+        complete = outputOffset == outputSize;
+    }
+#endif
+
+#if TIDE_USE_ZSTD
+    void _decompressZstd(const size_t receivedSize)
+    {
+        ZSTD_inBuffer in{data, receivedSize, inputOffset};
+        ZSTD_outBuffer out{output, outputSize, outputOffset};
+        while (in.pos < in.size && out.pos < out.size)
+        {
+            const auto result = ZSTD_decompressStream(zstdStream, &out, &in);
+            if (ZSTD_isError(result))
+                throw std::runtime_error("Corrupted compressed data");
+            complete = result == 0;
+        }
+        inputOffset = in.pos;
+        outputOffset = out.pos;
+    }
+#endif
+};
+
+Decompressor::Decompressor(const Codec codec, const char* data,
+                           const size_t size, char* output,
+                           const size_t outputSize)
+    : _impl{new Impl{codec, data, size, output, outputSize}}
+{
+}
+
+Decompressor::~Decompressor() = default;
+
+size_t Decompressor::update(const size_t receivedSize)
+{
+    _impl->update(std::min(receivedSize, _impl->size));
+
+    if (receivedSize >= _impl->size &&
+        (!_impl->complete || _impl->inputOffset != _impl->size ||
+         _impl->outputOffset != _impl->outputSize))
+    {
+        throw std::runtime_error("Corrupted compressed data");
+    }
+    return _impl->outputOffset;
+}
+}
@@ -0,0 +1,126 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include "types.h"
+
+#include <QByteArray>
+
+#include <memory>
+
+/**
+ * Lossless compression of network messages.
+ *
+ * The codecs are optional dependencies; Codec::none is always available.
+ */
+namespace compression
+{
+/** @return true if the codec is available in this build. */
+bool isAvailable(Codec codec);
+
+/**
+ * Compress data.
+ *
+ * @param codec The codec to use.
+ * @param data The data to compress.
+ * @param size The size of the data.
+ * @return the compressed data.
+ * @throw std::runtime_error if the codec is not available or fails.
+ */
+QByteArray compress(Codec codec, const char* data, size_t size);
+
+/**
+ * Decompress data.
+ *
+ * @param codec The codec that was used for compressing the data.
+ * @param data The compressed data.
+ * @param size The size of the compressed data.
+ * @param output The buffer for the decompressed data.
+ * @param outputSize The exact size of the decompressed data.
+ * @throw std::runtime_error if the codec is not available or if the data is
+ *        corrupted.
+ */
+void decompress(Codec codec, const char* data, size_t size, char* output,
+                size_t outputSize);
+
+/**
+ * Decompress data while it is being received.
+ *
+ * The data received so far are decompressed as far as they allow, so that the
+ * beginning of the output can be processed before the end of the data has
+ * arrived.
+ */
+class Decompressor
+{
+public:
+    /**
+     * Prepare the decompression of data received in order in a buffer.
+     *
+     * @param codec The codec that was used for compressing the data.
+     * @param data The buffer of the compressed data.
+     * @param size The size of the compressed data.
+     * @param output The buffer for the decompressed data.
+     * @param outputSize The exact size of the decompressed data.
+     * @throw std::runtime_error if the codec is not available.
+     */
+    Decompressor(Codec codec, const char* data, size_t size, char* output,
+                 size_t outputSize);
+
+    /** Destructor. */
+    ~Decompressor();
+
+    /**
+     * Decompress the data received since the previous call.
+     *
+     * @param receivedSize The size of the data received so far.
+     * @return the size of the output decompressed so far.
+     * @throw std::runtime_error if the data is corrupted, which may only be
+     *        detected once all the data is received.
+     */
+    size_t update(size_t receivedSize);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+};
+}
+
+#endif
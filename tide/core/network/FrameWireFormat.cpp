@@ -0,0 +1,192 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "FrameWireFormat.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+const uint32_t magicNumber = 0x54464d31; // "TFM1"
+
+struct FrameHeader
+{
+    uint32_t magic;
+    uint32_t uriSize;
+    uint32_t tilesCount;
+    uint32_t reserved;
+};
+
+struct TileDescriptor
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+    uint32_t dataSize;
+    uint8_t format;
+    uint8_t rowOrder;
+    uint8_t view;
+    uint8_t channel;
+};
+
+static_assert(sizeof(FrameHeader) == 16, "FrameHeader layout must be fixed");
+static_assert(sizeof(TileDescriptor) == 24,
+              "TileDescriptor layout must be fixed");
+
+template <typename T>
+void _append(QByteArray& buffer, const T& value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T _read(const QByteArray& message, size_t& offset)
+{
+    if (offset + sizeof(T) > size_t(message.size()))
+        throw std::runtime_error("Truncated frame message");
+    T value;
+    std::memcpy(&value, message.constData() + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+TileDescriptor _makeDescriptor(const deflect::server::Tile& tile)
+{
+    return TileDescriptor{tile.x,
+                          tile.y,
+                          tile.width,
+                          tile.height,
+                          uint32_t(tile.imageData.size()),
+                          uint8_t(tile.format),
+                          uint8_t(tile.rowOrder),
+                          uint8_t(tile.view),
+                          uint8_t(tile.channel)};
+}
+
+deflect::server::Tile _makeTile(const TileDescriptor& desc)
+{
+    deflect::server::Tile tile;
+    tile.x = desc.x;
+    tile.y = desc.y;
+    tile.width = desc.width;
+    tile.height = desc.height;
+    tile.format = deflect::Format(desc.format);
+    tile.rowOrder = deflect::RowOrder(desc.rowOrder);
+    tile.view = deflect::View(desc.view);
+    tile.channel = desc.channel;
+    return tile;
+}
+}
+
+namespace wireformat
+{
+std::vector<QByteArray> encode(const deflect::server::Frame& frame)
+{
+    const auto uri = frame.uri.toUtf8();
+
+    QByteArray header;
+    header.reserve(sizeof(FrameHeader) + uri.size() +
+                   frame.tiles.size() * sizeof(TileDescriptor));
+    _append(header, FrameHeader{magicNumber, uint32_t(uri.size()),
+                                uint32_t(frame.tiles.size()), 0});
+    header.append(uri);
+    for (const auto& tile : frame.tiles)
+        _append(header, _makeDescriptor(tile));
+
+    std::vector<QByteArray> buffers;
+    buffers.reserve(frame.tiles.size() + 1);
+    buffers.push_back(header);
+    for (const auto& tile : frame.tiles)
+    {
+        if (!tile.imageData.isEmpty())
+            buffers.push_back(tile.imageData);
+    }
+    return buffers;
+}
+
+deflect::server::FramePtr decode(QByteArray message,
+                                 std::shared_ptr<const void> owner)
+{
+    size_t offset = 0;
+    const auto header = _read<FrameHeader>(message, offset);
+    if (header.magic != magicNumber)
+        throw std::runtime_error("Invalid frame message");
+
+    const auto descriptorsSize = header.tilesCount * sizeof(TileDescriptor);
+    if (offset + header.uriSize + descriptorsSize > size_t(message.size()))
+        throw std::runtime_error("Truncated frame message");
+
+    // The tiles reference the message buffer, the frame keeps it alive for as
+    // long as they may be used.
+    const auto deleter = [message, owner](deflect::server::Frame* f) {
+        delete f;
+    };
+    auto frame =
+        deflect::server::FramePtr{new deflect::server::Frame, deleter};
+    frame->uri = QString::fromUtf8(message.constData() + offset,
+                                   header.uriSize);
+    offset += header.uriSize;
+
+    std::vector<TileDescriptor> descriptors;
+    descriptors.reserve(header.tilesCount);
+    for (uint32_t i = 0; i < header.tilesCount; ++i)
+        descriptors.push_back(_read<TileDescriptor>(message, offset));
+
+    frame->tiles.reserve(descriptors.size());
+    for (const auto& desc : descriptors)
+    {
+        if (offset + desc.dataSize > size_t(message.size()))
+            throw std::runtime_error("Truncated frame message");
+
+        auto tile = _makeTile(desc);
+        if (desc.dataSize > 0)
+        {
+            tile.imageData =
+                QByteArray::fromRawData(message.constData() + offset,
+                                        int(desc.dataSize));
+        }
+        offset += desc.dataSize;
+        frame->tiles.push_back(tile);
+    }
+    return frame;
+}
+}
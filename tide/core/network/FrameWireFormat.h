@@ -0,0 +1,89 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef FRAMEWIREFORMAT_H
+#define FRAMEWIREFORMAT_H
+
+#include <deflect/server/Frame.h>
+
+#include <QByteArray>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Binary wire format for sending deflect frames between processes.
+ *
+ * A message starts with a small fixed-layout header, followed by the frame uri
+ * and one descriptor per tile. The raw image data of the tiles come last, in
+ * the order of the descriptors.
+ *
+ * Unlike the boost archive, the tiles' image data are never copied: the
+ * encoder references them in place for the sender to gather, and the decoder
+ * wraps the received message.
+ */
+namespace wireformat
+{
+/**
+ * Encode a frame for sending.
+ *
+ * @param frame The frame to encode.
+ * @return the buffers that make up the message, in order: the header and tile
+ *         descriptors followed by the (implicitly shared) image data of each
+ *         non-empty tile.
+ */
+std::vector<QByteArray> encode(const deflect::server::Frame& frame);
+
+/**
+ * Decode a received message.
+ *
+ * The image data of the tiles point directly into the message, which is kept
+ * alive by the returned frame.
+ *
+ * @param message The message, as received.
+ * @param owner Optional owner of the memory of a message which wraps raw data,
+ *        also kept alive by the returned frame.
+ * @return the decoded frame.
+ * @throw std::runtime_error if the message is malformed.
+ */
+deflect::server::FramePtr decode(QByteArray message,
+                                 std::shared_ptr<const void> owner = {});
+}
+
+#endif
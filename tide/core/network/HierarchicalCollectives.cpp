@@ -0,0 +1,216 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "HierarchicalCollectives.h"
+
+#include "MPICommunicator.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+const int NODE_LEADER = 0;
+
+// The number of values gathered per process and the number of rounds used to
+// compare the flat and two-level gathers; close to a frame synchronization.
+const size_t CALIBRATION_VALUES = 8;
+const int CALIBRATION_ROUNDS = 20;
+
+template <typename F>
+int _measureMicroseconds(const MPICommunicator& communicator, const F& function)
+{
+    communicator.globalBarrier();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALIBRATION_ROUNDS; ++i)
+        function();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+        .count();
+}
+}
+
+HierarchicalCollectives::HierarchicalCollectives(
+    const MPICommunicator& communicator, const Selection selection)
+    : _communicator{communicator}
+    , _nodeComm{new MPICommunicator{communicator,
+                                    MPICommunicator::SplitType::sharedMemory}}
+{
+    // The leaders of all nodes share a communicator; the other processes are
+    // grouped by node rank in communicators which are never used.
+    _leadersComm.reset(new MPICommunicator{communicator, _nodeComm->getRank()});
+
+    _nodeCount = communicator.globalSum(_isNodeLeader() ? 1 : 0);
+    const auto maxNodeSize = communicator.globalMax(_nodeComm->getSize());
+    if (_nodeCount == 1 || maxNodeSize == 1 || selection == Selection::flat)
+        return;
+
+    if (_isNodeLeader())
+    {
+        // The number of processes of each node does not change, so the
+        // leaders exchange the counts only once.
+        const auto nodeSizes =
+            _leadersComm->gatherAll(uint64_t(_nodeComm->getSize()));
+        auto& layout = _layouts[1];
+        int offset = 0;
+        for (const auto nodeSize : nodeSizes)
+        {
+            layout.counts.push_back(int(nodeSize));
+            layout.offsets.push_back(offset);
+            offset += int(nodeSize);
+        }
+    }
+
+    // Processes of a node may not have contiguous ranks
+    const auto rank = uint64_t(communicator.getRank());
+    const auto nodeRanks = _nodeComm->gather({rank}, NODE_LEADER);
+    if (_isNodeLeader())
+    {
+        const auto& layout = _getLayout(1);
+        const auto ranks = _leadersComm->gatherAllVariable(nodeRanks,
+                                                           layout.counts,
+                                                           layout.offsets);
+        _ranksInGatherOrder.assign(ranks.begin(), ranks.end());
+    }
+
+    _hierarchical = selection == Selection::hierarchical ||
+                    _isTwoLevelGatherFaster();
+}
+
+HierarchicalCollectives::~HierarchicalCollectives()
+{
+}
+
+bool HierarchicalCollectives::isHierarchical() const
+{
+    return _hierarchical;
+}
+
+int HierarchicalCollectives::getNodeCount() const
+{
+    return _nodeCount;
+}
+
+int HierarchicalCollectives::globalSum(const int localValue) const
+{
+    if (!_hierarchical)
+        return _communicator.globalSum(localValue);
+
+    auto sum = _nodeComm->globalSum(localValue);
+    if (_isNodeLeader())
+        sum = _leadersComm->globalSum(sum);
+    return _nodeComm->broadcastValue(sum, NODE_LEADER);
+}
+
+int HierarchicalCollectives::globalMax(const int localValue) const
+{
+    if (!_hierarchical)
+        return _communicator.globalMax(localValue);
+
+    auto max = _nodeComm->globalMax(localValue);
+    if (_isNodeLeader())
+        max = _leadersComm->globalMax(max);
+    return _nodeComm->broadcastValue(max, NODE_LEADER);
+}
+
+std::vector<uint64_t> HierarchicalCollectives::gatherAll(
+    const std::vector<uint64_t>& values) const
+{
+    if (!_hierarchical)
+        return _communicator.gatherAll(values);
+    return _gatherAllInTwoLevels(values);
+}
+
+bool HierarchicalCollectives::_isNodeLeader() const
+{
+    return _nodeComm->getRank() == NODE_LEADER;
+}
+
+const HierarchicalCollectives::Layout& HierarchicalCollectives::_getLayout(
+    const size_t count) const
+{
+    auto it = _layouts.find(count);
+    if (it != _layouts.end())
+        return it->second;
+
+    const auto& processes = _layouts.at(1);
+    Layout layout;
+    for (size_t i = 0; i < processes.counts.size(); ++i)
+    {
+        layout.counts.push_back(processes.counts[i] * int(count));
+        layout.offsets.push_back(processes.offsets[i] * int(count));
+    }
+    return _layouts.emplace(count, std::move(layout)).first->second;
+}
+
+std::vector<uint64_t> HierarchicalCollectives::_gatherAllInTwoLevels(
+    const std::vector<uint64_t>& values) const
+{
+    const auto count = values.size();
+    const auto nodeValues = _nodeComm->gather(values, NODE_LEADER);
+
+    std::vector<uint64_t> results(count * _communicator.getSize());
+    if (_isNodeLeader())
+    {
+        const auto& layout = _getLayout(count);
+        const auto gathered =
+            _leadersComm->gatherAllVariable(nodeValues, layout.counts,
+                                            layout.offsets);
+        for (size_t i = 0; i < _ranksInGatherOrder.size(); ++i)
+        {
+            std::copy_n(gathered.begin() + i * count, count,
+                        results.begin() + _ranksInGatherOrder[i] * count);
+        }
+    }
+    _nodeComm->broadcastValues(results, NODE_LEADER);
+    return results;
+}
+
+bool HierarchicalCollectives::_isTwoLevelGatherFaster() const
+{
+    const std::vector<uint64_t> values(CALIBRATION_VALUES);
+    const auto flat = _measureMicroseconds(_communicator, [&] {
+        _communicator.gatherAll(values);
+    });
+    const auto twoLevels = _measureMicroseconds(_communicator, [&] {
+        _gatherAllInTwoLevels(values);
+    });
+    // The slowest process decides, so that all processes agree
+    return _communicator.globalMax(twoLevels) < _communicator.globalMax(flat);
+}
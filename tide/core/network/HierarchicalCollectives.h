@@ -0,0 +1,143 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef HIERARCHICALCOLLECTIVES_H
+#define HIERARCHICALCOLLECTIVES_H
+
+#include "types.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Node-aware collective operations for a group of MPI processes.
+ *
+ * The processes are split in groups sharing the memory of the same node, each
+ * with a leader. Collective operations are first performed within each node,
+ * then between the node leaders only, before the results are broadcast within
+ * each node. This reduces the number of messages crossing the network when
+ * several processes run on each node.
+ *
+ * The flat collectives of the communicator are used when there is a single
+ * node or a single process per node, or when they are measured to be faster
+ * at construction.
+ *
+ * The constructor and all the methods are collective operations which must be
+ * called by all processes of the communicator.
+ */
+class HierarchicalCollectives
+{
+public:
+    /** How to choose between the flat and the two-level collectives. */
+    enum class Selection
+    {
+        measure,     /**< Time both and use the fastest. */
+        flat,        /**< Always use the flat collectives. */
+        hierarchical /**< Use two levels whenever the topology allows it. */
+    };
+
+    /**
+     * Create the node-local and node-leader communicators.
+     * @param communicator The communicator of all the processes.
+     * @param selection How to choose the collectives, identical on all
+     *        processes.
+     */
+    explicit HierarchicalCollectives(const MPICommunicator& communicator,
+                                     Selection selection = Selection::measure);
+
+    /** Destructor, closes the node communicators. */
+    ~HierarchicalCollectives();
+
+    /** @return true if the operations are performed in two levels. */
+    bool isHierarchical() const;
+
+    /** @return the number of nodes. */
+    int getNodeCount() const;
+
+    /**
+     * Get the sum of the given local values across all processes.
+     * @param localValue The value to sum
+     * @return the sum of the localValues
+     */
+    int globalSum(int localValue) const;
+
+    /**
+     * Get the maximum of the given local values across all processes.
+     * @param localValue The local value
+     * @return the maximum of the localValues
+     */
+    int globalMax(int localValue) const;
+
+    /**
+     * Gather a fixed number of values accross all the processes.
+     * @param values The local values, of the same size on all processes
+     * @return A vector of values of size getSize() * values.size(), ordered by
+     *         process rank
+     */
+    std::vector<uint64_t> gatherAll(const std::vector<uint64_t>& values) const;
+
+private:
+    const MPICommunicator& _communicator;
+    std::unique_ptr<MPICommunicator> _nodeComm;
+    std::unique_ptr<MPICommunicator> _leadersComm;
+    int _nodeCount = 0;
+    bool _hierarchical = false;
+
+    /** On node leaders, the rank of the processes in leaders' gather order. */
+    std::vector<int> _ranksInGatherOrder;
+
+    /** Position of the values of each node leader in the gathered values. */
+    struct Layout
+    {
+        std::vector<int> counts;
+        std::vector<int> offsets;
+    };
+
+    /** On node leaders, the layouts by number of values per process. */
+    mutable std::map<size_t, Layout> _layouts;
+
+    bool _isNodeLeader() const;
+    const Layout& _getLayout(size_t count) const;
+    std::vector<uint64_t> _gatherAllInTwoLevels(
+        const std::vector<uint64_t>& values) const;
+    bool _isTwoLevelGatherFaster() const;
+};
+
+#endif
@@ -39,80 +39,202 @@
 
 #include "MPICommunicator.h"
 
-#include "MPIContext.h"
-#include "MPINospin.h"
+#include "Compression.h"
 
+#include "configuration/Configuration.h"
 #include "utils/log.h"
 
-// WAR some deadlocks receiving MPI_IBcast with OpenMPI (version 1.10.2)
-#ifdef OPEN_MPI
-#define DISBALE_MPI_IBCAST
-#endif
-
-// #define instead of a function so that print_log prints the correct reference
-#define MPI_CHECK(func)                                                 \
-    {                                                                   \
-        const int err = (func);                                         \
-        if (err != MPI_SUCCESS)                                         \
-            print_log(LOG_ERROR, LOG_MPI, "Error detected! (%d)", err); \
-    }
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace
+{
+using Block = Transport::Block;
+
+QByteArray _compress(const Codec codec, const std::vector<Block>& blocks,
+                     const size_t size)
+{
+    if (blocks.size() == 1)
+        return compression::compress(codec, blocks[0].first, size);
+
+    QByteArray data;
+    data.reserve(size);
+    for (const auto& block : blocks)
+        data.append(block.first, block.second);
+    return compression::compress(codec, data.constData(), size);
+}
+}
 
 MPICommunicator::MPICommunicator(int argc, char* argv[])
-    : _mpiContext{new MPIContext{argc, argv}}
-    , _mpiComm{MPI_COMM_WORLD}
+    : _transport{Transport::create(argc, argv)}
+{
+}
+
+MPICommunicator::MPICommunicator(std::unique_ptr<Transport> transport)
+    : _transport{std::move(transport)}
 {
-    _initRankAndSize();
 }
 
 MPICommunicator::MPICommunicator(const MPICommunicator& parent, const int color)
-    : _mpiContext{parent._mpiContext}
+    : _transport{parent._transport->split(color)}
+{
+}
+
+MPICommunicator::MPICommunicator(const MPICommunicator& parent,
+                                 const SplitType type)
 {
-    MPI_Comm_split(parent._mpiComm, color, parent.getRank(), &_mpiComm);
-    _initRankAndSize();
+    switch (type)
+    {
+    case SplitType::sharedMemory:
+        _transport = parent._transport->splitByHost();
+        break;
+    }
 }
 
 MPICommunicator::~MPICommunicator()
 {
-    if (_mpiComm != MPI_COMM_WORLD)
-        MPI_Comm_disconnect(&_mpiComm);
+    const char* sites[] = {"send", "probe", "receive", "broadcast header",
+                           "receive header"};
+    for (size_t i = 0; i < _waiters.size(); ++i)
+    {
+        const auto& histogram = _waiters[i].getHistogram();
+        if (histogram.getCount() > 0)
+        {
+            print_log(LOG_DEBUG, LOG_MPI, "%s wait times: %s", sites[i],
+                      histogram.toString().c_str());
+        }
+    }
 }
 
 int MPICommunicator::getRank() const
 {
-    return _mpiRank;
+    return _transport->getRank();
 }
 
 int MPICommunicator::getSize() const
 {
-    return _mpiSize;
+    return _transport->getSize();
+}
+
+void MPICommunicator::setWaitPolicy(const WaitSite site,
+                                    const WaitPolicy policy)
+{
+    _getWaiter(site).setPolicy(policy);
+}
+
+void MPICommunicator::setWaitPolicies(const Configuration& config)
+{
+    const auto& policies = config.global.mpiWait;
+    setWaitPolicy(WaitSite::send, policies.send);
+    setWaitPolicy(WaitSite::probe, policies.probe);
+    setWaitPolicy(WaitSite::receive, policies.receive);
+    setWaitPolicy(WaitSite::broadcastHeader, policies.broadcastHeader);
+    setWaitPolicy(WaitSite::receiveHeader, policies.receiveHeader);
+}
+
+const WaitHistogram& MPICommunicator::getWaitHistogram(
+    const WaitSite site) const
+{
+    return _waiters[size_t(site)].getHistogram();
+}
+
+Waiter& MPICommunicator::_getWaiter(const WaitSite site)
+{
+    return _waiters[size_t(site)];
+}
+
+void MPICommunicator::setBroadcastPipeline(const size_t segmentSize,
+                                           const size_t segmentsInFlight)
+{
+    _segmentSize = segmentSize;
+    _segmentsInFlight = std::max(segmentsInFlight, size_t(1));
+}
+
+void MPICommunicator::setCompression(const MessageType type,
+                                     const Codec codec)
+{
+    if (!compression::isAvailable(codec))
+    {
+        print_log(LOG_WARN, LOG_MPI, "compression codec not available: %d",
+                  int(codec));
+        return;
+    }
+    _codecs[type] = codec;
+}
+
+void MPICommunicator::setCompressionThreshold(const size_t threshold)
+{
+    _compressionThreshold = threshold;
+}
+
+void MPICommunicator::setCompression(const Configuration& config)
+{
+    const auto& settings = config.global.mpiCompression;
+    setCompressionThreshold(settings.threshold);
+    setCompression(MessageType::SCENE, settings.scene);
+    setCompression(MessageType::MARKERS, settings.markers);
+    setCompression(MessageType::PIXELSTREAM, settings.pixelstream);
 }
 
 void MPICommunicator::globalBarrier() const
 {
-    MPI_Barrier(_mpiComm);
+    _transport->barrier();
 }
 
 int MPICommunicator::globalSum(const int localValue) const
 {
-    int globalValue = 0;
-    MPI_Allreduce((void*)&localValue, (void*)&globalValue, 1, MPI_INT, MPI_SUM,
-                  _mpiComm);
-    return globalValue;
+    return _transport->allreduce(localValue, Transport::Operation::sum);
+}
+
+int MPICommunicator::globalMax(const int localValue) const
+{
+    return _transport->allreduce(localValue, Transport::Operation::max);
+}
+
+std::vector<uint64_t> MPICommunicator::gatherAll(const uint64_t value) const
+{
+    return _transport->allgather({value});
+}
+
+std::vector<uint64_t> MPICommunicator::gatherAll(
+    const std::vector<uint64_t>& values) const
+{
+    return _transport->allgather(values);
+}
+
+std::vector<uint64_t> MPICommunicator::gatherAllVariable(
+    const std::vector<uint64_t>& values) const
+{
+    return _transport->allgatherVariable(values);
+}
+
+std::vector<uint64_t> MPICommunicator::gatherAllVariable(
+    const std::vector<uint64_t>& values, const std::vector<int>& counts,
+    const std::vector<int>& offsets) const
+{
+    return _transport->allgatherVariable(values, counts, offsets);
+}
+
+std::vector<uint64_t> MPICommunicator::gather(
+    const std::vector<uint64_t>& values, const int root) const
+{
+    return _transport->gather(values, root);
 }
 
-std::vector<uint64_t> MPICommunicator::gatherAll(const uint64_t value)
+void MPICommunicator::broadcastValues(std::vector<uint64_t>& values,
+                                      const int root) const
 {
-    std::vector<uint64_t> results(_mpiSize);
-    MPI_CHECK(MPI_Allgather((void*)&value, 1, MPI_LONG_LONG_INT,
-                            (void*)results.data(), 1, MPI_LONG_LONG_INT,
-                            _mpiComm));
-    return results;
+    const auto size = values.size() * sizeof(uint64_t);
+    _transport->broadcast({Block{(char*)values.data(), size}}, size, root, 0,
+                          1, {});
 }
 
-void MPICommunicator::_initRankAndSize()
+int MPICommunicator::broadcastValue(int value, const int root) const
 {
-    MPI_Comm_rank(_mpiComm, &_mpiRank);
-    MPI_Comm_size(_mpiComm, &_mpiSize);
+    _transport->broadcast({Block{(char*)&value, sizeof(value)}}, sizeof(value),
+                          root, 0, 1, {});
+    return value;
 }
 
 void MPICommunicator::send(const MessageType type,
@@ -121,35 +243,21 @@ void MPICommunicator::send(const MessageType type,
     if (!_isValidAndNotSelf(dest))
         return;
 
-    MPI_CHECK(MPI_Send_Nospin((void*)serializedData.data(),
-                              serializedData.size(), MPI_BYTE, dest, int(type),
-                              _mpiComm));
+    const auto data = const_cast<char*>(serializedData.data());
+    _transport->send({Block{data, serializedData.size()}}, dest, int(type),
+                     _getWaiter(WaitSite::send));
 }
 
 ProbeResult MPICommunicator::probe(const int src, const int tag)
 {
-    MPI_Status status;
-    MPI_CHECK(MPI_Probe_Nospin(src, tag, _mpiComm, &status));
-
-    int count = MPI_UNDEFINED;
-    MPI_CHECK(MPI_Get_count(&status, MPI_BYTE, &count));
-
-    return ProbeResult{status.MPI_SOURCE, count, MessageType(status.MPI_TAG)};
+    return _transport->probe(src, tag, _getWaiter(WaitSite::probe));
 }
 
 void MPICommunicator::receive(const int src, char* dataBuffer,
                               const size_t messageSize, const int tag)
 {
-    MPI_Status status;
-    MPI_CHECK(MPI_Recv_Nospin((void*)dataBuffer, messageSize, MPI_BYTE, src,
-                              tag, _mpiComm, &status));
-
-    // Validate the number of bytes received
-    int count = 0;
-    MPI_CHECK(MPI_Get_count(&status, MPI_BYTE, &count));
-    if (count != (int)messageSize)
-        print_log(LOG_ERROR, LOG_MPI, "incorrect bytes count: %d / %d", count,
-                  messageSize);
+    _transport->receive(dataBuffer, messageSize, src, tag,
+                        _getWaiter(WaitSite::receive));
 }
 
 void MPICommunicator::broadcast(const MessageType type)
@@ -164,8 +272,23 @@ void MPICommunicator::broadcast(const MessageType type, const std::string& data)
 
 void MPICommunicator::broadcast(const MessageType type, const QByteArray& data)
 {
-    _broadcast(MessageHeader{type, (uint)data.size()});
-    _broadcast(data.constData(), data.size());
+    const auto size = size_t(data.size());
+    _broadcast(type, {Block{const_cast<char*>(data.constData()), size}}, size);
+}
+
+void MPICommunicator::broadcast(const MessageType type,
+                                const std::vector<QByteArray>& buffers)
+{
+    // The buffers are sent in place, without gathering them in a single one
+    std::vector<Block> blocks;
+    size_t size = 0;
+    for (const auto& buffer : buffers)
+    {
+        blocks.emplace_back(const_cast<char*>(buffer.constData()),
+                            buffer.size());
+        size += buffer.size();
+    }
+    _broadcast(type, blocks, size);
 }
 
 MessageHeader MPICommunicator::receiveBroadcastHeader(const int src)
@@ -173,13 +296,9 @@ MessageHeader MPICommunicator::receiveBroadcastHeader(const int src)
     // No-spin so that waiting for a message in a thread does not burn 100% CPU.
     // This does not reduce broadcast performance (tideBenchmarkMPI).
     MessageHeader mh;
-#ifdef DISBALE_MPI_IBCAST
-    MPI_CHECK(MPI_Recv_Nospin((void*)&mh, sizeof(MessageHeader), MPI_BYTE, src,
-                              0, _mpiComm, MPI_STATUS_IGNORE));
-#else
-    MPI_CHECK(MPI_Bcast_Nospin((void*)&mh, sizeof(MessageHeader), MPI_BYTE, src,
-                               _mpiComm));
-#endif
+    _transport->broadcast((char*)&mh, sizeof(MessageHeader), src,
+                          _getWaiter(WaitSite::receiveHeader));
+    _receivedHeader = mh;
     return mh;
 }
 
@@ -189,34 +308,131 @@ void MPICommunicator::receiveBroadcast(const int src, char* dataBuffer,
     // Use regular MPI_Bcast for transfering the payload. The no-spin version
     // brings no benefits once the header has been received; but it degrades the
     // broadcast performance by an order of magnitude (tideBenchmarkMPI).
-    MPI_CHECK(
-        MPI_Bcast((void*)dataBuffer, messageSize, MPI_BYTE, src, _mpiComm));
+    receiveBroadcast(src, dataBuffer, messageSize, {});
+}
+
+void MPICommunicator::receiveBroadcast(const int src, char* dataBuffer,
+                                       const size_t messageSize,
+                                       const SegmentCallback& callback)
+{
+    const auto header = _receivedHeader;
+    _receivedHeader = MessageHeader();
+
+    if (header.codec == Codec::none)
+    {
+        _broadcast(src, {Block{dataBuffer, messageSize}}, messageSize,
+                   callback);
+        return;
+    }
+
+    // Decompress each segment once received, so that the first part of the
+    // payload is available while the next segments are still in transit.
+    // Errors are deferred so as not to abandon the pending segments.
+    QByteArray data(header.wireSize, Qt::Uninitialized);
+    compression::Decompressor decompressor{header.codec, data.constData(),
+                                           header.wireSize, dataBuffer,
+                                           messageSize};
+    size_t decompressedSize = 0;
+    std::exception_ptr error;
+    const auto decompress = [&](const size_t offset, const size_t size) {
+        if (error)
+            return;
+        try
+        {
+            const auto end = decompressor.update(offset + size);
+            if (callback && end > decompressedSize)
+                callback(decompressedSize, end - decompressedSize);
+            decompressedSize = end;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    };
+    _broadcast(src, {Block{data.data(), header.wireSize}}, header.wireSize,
+               decompress);
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void MPICommunicator::scatter(
+    const MessageType type, const std::vector<std::vector<QByteArray>>& data)
+{
+    if (data.size() != size_t(getSize()))
+        throw std::invalid_argument("scatter requires a message per process");
+
+    size_t totalSize = 0;
+    std::vector<std::vector<Block>> messages(data.size());
+    for (int i = 0; i < getSize(); ++i)
+    {
+        if (!_isValidAndNotSelf(i))
+            continue;
+        for (const auto& part : data[i])
+        {
+            messages[i].emplace_back(const_cast<char*>(part.constData()),
+                                     part.size());
+            totalSize += part.size();
+        }
+    }
+
+    _broadcast(MessageHeader{type, (uint)totalSize});
+    _transport->scatter(messages);
+}
+
+QByteArray MPICommunicator::receiveScatter(const int src)
+{
+    _receivedHeader = MessageHeader();
+
+    QByteArray buffer;
+    _transport->receiveScatter(src, [&buffer](const size_t size) {
+        buffer = QByteArray(size, Qt::Uninitialized);
+        return buffer.data();
+    });
+    return buffer;
 }
 
 void MPICommunicator::_broadcast(const MessageHeader& mh)
 {
-#ifdef DISBALE_MPI_IBCAST
-    for (auto i = 0; i < getSize(); ++i)
+    auto header = mh;
+    _transport->broadcast((char*)&header, sizeof(MessageHeader), getRank(),
+                          _getWaiter(WaitSite::broadcastHeader));
+}
+
+void MPICommunicator::_broadcast(const MessageType type,
+                                 const std::vector<Block>& blocks,
+                                 const size_t size)
+{
+    const auto it = _codecs.find(type);
+    const auto codec = it != _codecs.end() ? it->second : Codec::none;
+    if (codec != Codec::none && size > _compressionThreshold)
     {
-        if (_isValidAndNotSelf(i))
+        const auto data = _compress(codec, blocks, size);
+        const auto wireSize = size_t(data.size());
+        if (wireSize < size)
         {
-            MPI_CHECK(MPI_Send_Nospin((void*)&mh, sizeof(MessageHeader),
-                                      MPI_BYTE, i, 0, _mpiComm));
+            _broadcast(MessageHeader{type, (uint)size, codec, (uint)wireSize});
+            const auto compressed = const_cast<char*>(data.constData());
+            _broadcast(getRank(), {Block{compressed, wireSize}}, wireSize, {});
+            return;
         }
     }
-#else
-    MPI_CHECK(MPI_Bcast_Nospin((void*)&mh, sizeof(MessageHeader), MPI_BYTE,
-                               _mpiRank, _mpiComm));
-#endif
+    _broadcast(MessageHeader{type, (uint)size});
+    _broadcast(getRank(), blocks, size, {});
 }
 
-void MPICommunicator::_broadcast(const char* data, const size_t size)
+void MPICommunicator::_broadcast(const int root,
+                                 const std::vector<Block>& blocks,
+                                 const size_t size,
+                                 const SegmentCallback& callback)
 {
-    MPI_CHECK(
-        MPI_Bcast(const_cast<char*>(data), size, MPI_BYTE, _mpiRank, _mpiComm));
+    if (size == 0)
+        return;
+
+    _transport->broadcast(blocks, size, root, _segmentSize, _segmentsInFlight,
+                          callback);
 }
 
 bool MPICommunicator::_isValidAndNotSelf(const int dest) const
 {
-    return dest != _mpiRank && dest >= 0 && dest < _mpiSize;
+    return dest != getRank() && dest >= 0 && dest < getSize();
 }
@@ -42,59 +42,68 @@
 
 #include "NetworkBarrier.h"
 #include "network/MessageHeader.h"
+#include "network/Transport.h"
+#include "network/Waiter.h"
 #include "types.h"
 
-#include <mpi.h>
-
-class MPIContext;
+#include <array>
+#include <functional>
+#include <map>
 
 /**
- * The result of a probe operation on the network communicator.
- */
-struct ProbeResult
-{
-    /** The source process that has sent a message */
-    const int src;
-
-    /** The size of the message */
-    const int size;
-
-    /** The type of the message */
-    const MessageType messageType;
-
-    /** @return True if the probe was successful and receive() is safe */
-    bool isValid() const { return size >= 0; }
-};
-
-/**
- * Handle network communication between a set of MPI processes.
+ * Handle network communication between a set of processes.
+ *
+ * The messages are exchanged through a Transport, selected at launch (MPI by
+ * default, see Transport::create()).
  */
 class MPICommunicator : public NetworkBarrier
 {
 public:
     /**
-     * Create a new communicator, initializing the MPI context.
+     * Create a new communicator, initializing the transport.
      *
      * This constructor should only be used once per program.
      * Use the alternative constructor to create additional communicators which
-     * share the primary MPIContext.
+     * share the primary transport.
      *
      * @param argc main program arguments count
      * @param argv main program arguments
      */
     MPICommunicator(int argc, char* argv[]);
 
+    /**
+     * Create a communicator over a given transport.
+     * @param transport The transport between the processes of the group.
+     */
+    explicit MPICommunicator(std::unique_ptr<Transport> transport);
+
     /**
      * Create a communicator by splitting a parent one.
      *
      * The new ranks are ordered according to the ranks in the parent.
      *
-     * @param parent The parent context to split, sharing the same MPIContext.
+     * @param parent The parent context to split, sharing the same transport.
      * @param color All processes with the same color belong to the same group.
      */
     MPICommunicator(const MPICommunicator& parent, int color);
 
-    /** Destructor, closes the MPI communicator. */
+    /** Types of split which depend on the location of the processes. */
+    enum class SplitType
+    {
+        sharedMemory /**< Processes which can share memory (same node). */
+    };
+
+    /**
+     * Create a communicator by splitting a parent one by location.
+     *
+     * The new ranks are ordered according to the ranks in the parent.
+     *
+     * @param parent The parent context to split, sharing the same transport.
+     * @param type The type of split.
+     */
+    MPICommunicator(const MPICommunicator& parent, SplitType type);
+
+    /** Destructor, closes the communicator. */
     ~MPICommunicator();
 
     /** Get the rank of this process in this group. */
@@ -103,6 +112,68 @@ public:
     /** Get the number of processes in this group. */
     int getSize() const;
 
+    /** The blocking operations which wait without spinning by default. */
+    enum class WaitSite
+    {
+        send,            /**< send() */
+        probe,           /**< probe(), waiting for any incoming message */
+        receive,         /**< receive(), after a successful probe() */
+        broadcastHeader, /**< sending the header of a broadcast or scatter */
+        receiveHeader    /**< receiveBroadcastHeader() */
+    };
+
+    /**
+     * Set how a blocking operation waits for completion.
+     * @param site The blocking operation
+     * @param policy The wait policy to use for it
+     */
+    void setWaitPolicy(WaitSite site, WaitPolicy policy);
+
+    /** Set the wait policies of all operations from the configuration. */
+    void setWaitPolicies(const Configuration& config);
+
+    /** @return the histogram of the wait times of a blocking operation. */
+    const WaitHistogram& getWaitHistogram(WaitSite site) const;
+
+    /**
+     * Pipeline the broadcast of large payloads.
+     *
+     * Payloads larger than the segment size are broadcast as a sequence of
+     * segments, with several non-blocking broadcasts in flight. This allows
+     * receivers to process the first segments while the next ones are still
+     * in transit. All processes must use the same settings.
+     *
+     * @param segmentSize The size of a segment in bytes, 0 to disable.
+     * @param segmentsInFlight The maximum number of pending segments.
+     */
+    void setBroadcastPipeline(size_t segmentSize, size_t segmentsInFlight);
+
+    /**
+     * Compress the payload of broadcasts of the given type.
+     *
+     * Only payloads larger than the compression threshold are compressed, and
+     * only if that makes them smaller. The receivers decompress them
+     * transparently in receiveBroadcast(), using the codec of the header.
+     *
+     * @param type The message type.
+     * @param codec The codec to use, Codec::none to disable compression. A
+     *        codec which is not available in this build is ignored.
+     */
+    void setCompression(MessageType type, Codec codec);
+
+    /** @param threshold The minimum size of a payload to compress [bytes]. */
+    void setCompressionThreshold(size_t threshold);
+
+    /** Set the compression of all message types from the configuration. */
+    void setCompression(const Configuration& config);
+
+    /**
+     * Callback for a received segment of a broadcast payload.
+     * @param offset The offset of the segment in the payload
+     * @param size The size of the segment
+     */
+    using SegmentCallback = Transport::SegmentCallback;
+
     /** @name One-to-one communication. */
     //@{
     /**
@@ -122,7 +193,8 @@ public:
      * @param tag The message tag of interest (default: any)
      * @return The probe result for a subsequent receive()
      */
-    ProbeResult probe(int src = MPI_ANY_SOURCE, int tag = MPI_ANY_TAG);
+    ProbeResult probe(int src = Transport::anySource,
+                      int tag = Transport::anyTag);
 
     /**
      * Receive a message from a specific process.
@@ -154,6 +226,17 @@ public:
     void broadcast(MessageType type, const std::string& data);
     void broadcast(MessageType type, const QByteArray& data);
 
+    /**
+     * Brodcast a message made of several buffers to all other processes.
+     *
+     * The buffers are sent in place as a single message, without being copied
+     * into a contiguous buffer first.
+     * @see receiveBroadcastHeader()
+     * @param type The message type
+     * @param buffers The buffers that make up the message, in order
+     */
+    void broadcast(MessageType type, const std::vector<QByteArray>& buffers);
+
     /**
      * Receive a header broadcast by a specific process.
      * This call is blocking.
@@ -172,6 +255,42 @@ public:
      * @param messageSize The number of bytes to receive
      */
     void receiveBroadcast(int src, char* dataBuffer, size_t messageSize);
+
+    /**
+     * Recieve a broadcast, processing the payload as it arrives.
+     * This call is blocking.
+     * @see receiveBroadcastHeader()
+     * @see setBroadcastPipeline()
+     * @param src The source process
+     * @param dataBuffer The target data buffer
+     * @param messageSize The number of bytes to receive
+     * @param callback Called in order for each segment once it is received,
+     *        only once for the whole payload if it is not pipelined. For a
+     *        compressed payload, called with the part decompressed after each
+     *        received segment.
+     */
+    void receiveBroadcast(int src, char* dataBuffer, size_t messageSize,
+                          const SegmentCallback& callback);
+
+    /**
+     * Send a different message to each process.
+     * @see receiveBroadcastHeader()
+     * @param type The message type, broadcast to all processes
+     * @param data The buffers that make up the message for each process,
+     *        ordered by rank. The message for the calling process is ignored.
+     * @throw std::invalid_argument if the number of messages is not getSize()
+     */
+    void scatter(MessageType type,
+                 const std::vector<std::vector<QByteArray>>& data);
+
+    /**
+     * Receive the message scattered by a specific process.
+     * This call is blocking.
+     * @see receiveBroadcastHeader()
+     * @param src The source process
+     * @return the received message
+     */
+    QByteArray receiveScatter(int src);
     //@}
 
     /** @name Collective operations. */
@@ -186,23 +305,96 @@ public:
      */
     int globalSum(int localValue) const;
 
+    /**
+     * Get the maximum of the given local values across all processes.
+     * @param localValue The local value
+     * @return the maximum of the localValues
+     */
+    int globalMax(int localValue) const;
+
     /**
      * Gather the values accross all the processes.
      * @param value The local value
      * @return A vector of values of size getSize(), ordered by process rank
      */
-    std::vector<uint64_t> gatherAll(uint64_t value);
+    std::vector<uint64_t> gatherAll(uint64_t value) const;
+
+    /**
+     * Gather a fixed number of values accross all the processes.
+     * @param values The local values, of the same size on all processes
+     * @return A vector of values of size getSize() * values.size(), ordered by
+     *         process rank
+     */
+    std::vector<uint64_t> gatherAll(const std::vector<uint64_t>& values) const;
+
+    /**
+     * Gather a variable number of values accross all the processes.
+     * @param values The local values
+     * @return the concatenation of the values of all processes, ordered by
+     *         process rank
+     */
+    std::vector<uint64_t> gatherAllVariable(
+        const std::vector<uint64_t>& values) const;
+
+    /**
+     * Gather a variable number of values accross all the processes, when all
+     * processes know the count of each one.
+     *
+     * Cheaper than exchanging the counts at each call.
+     *
+     * @param values The local values, counts[getRank()] of them
+     * @param counts The number of values of each process
+     * @param offsets The position of the values of each process in the result
+     * @return the values of all processes, each at its offset
+     */
+    std::vector<uint64_t> gatherAllVariable(
+        const std::vector<uint64_t>& values, const std::vector<int>& counts,
+        const std::vector<int>& offsets) const;
+
+    /**
+     * Gather a fixed number of values on a single process.
+     * @param values The local values, of the same size on all processes
+     * @param root The process which receives the values
+     * @return on root, a vector of size getSize() * values.size() ordered by
+     *         process rank; an empty vector on the other processes
+     */
+    std::vector<uint64_t> gather(const std::vector<uint64_t>& values,
+                                 int root) const;
+
+    /**
+     * Broadcast values from one process to all others.
+     * @param values The values to send on root, the buffer to receive them
+     *        on the other processes; of the same size on all processes
+     * @param root The process which sends the values
+     */
+    void broadcastValues(std::vector<uint64_t>& values, int root) const;
+
+    /**
+     * Broadcast a value from one process to all others.
+     * @param value The value to send, only used on root
+     * @param root The process which sends the value
+     * @return the value of root
+     */
+    int broadcastValue(int value, int root) const;
     //@}
 
 private:
-    std::shared_ptr<MPIContext> _mpiContext;
-    MPI_Comm _mpiComm{MPI_COMM_NULL};
-    int _mpiRank = -1;
-    int _mpiSize = -1;
+    std::unique_ptr<Transport> _transport;
+    size_t _segmentSize = 0;
+    size_t _segmentsInFlight = 1;
+    std::array<Waiter, 5> _waiters;
+    std::map<MessageType, Codec> _codecs;
+    size_t _compressionThreshold = 0;
+    MessageHeader _receivedHeader;
+
+    using Block = Transport::Block;
 
-    void _initRankAndSize();
+    Waiter& _getWaiter(WaitSite site);
     void _broadcast(const MessageHeader& mh);
-    void _broadcast(const char* data, const size_t size);
+    void _broadcast(MessageType type, const std::vector<Block>& blocks,
+                    size_t size);
+    void _broadcast(int root, const std::vector<Block>& blocks, size_t size,
+                    const SegmentCallback& callback);
     bool _isValidAndNotSelf(const int dest) const;
 };
 
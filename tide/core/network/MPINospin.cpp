@@ -44,55 +44,42 @@
 
 #include "MPINospin.h"
 
-#include <algorithm>
-#include <chrono>
-#include <thread>
+#include "Waiter.h"
 
 #define TIDE_DISABLE_MPI_NOSPIN 0 // switch for debugging purposes only
 
 namespace
 {
-const size_t nsec_start = 1000;
-const size_t nsec_max = 100000;
-
-int _waitForCompletion(MPI_Request req, MPI_Status* status)
+int _waitForCompletion(MPI_Request req, MPI_Status* status, Waiter& waiter)
 {
-    auto sleep_ns = nsec_start;
-    int flag = 0;
-    while (!flag)
-    {
-        std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
-        sleep_ns = std::min(size_t(sleep_ns << 1), nsec_max);
+    waiter.wait([&req, status] {
+        int flag = 0;
         MPI_Request_get_status(req, &flag, status);
-    }
+        return flag != 0;
+    });
     return MPI_Wait(&req, status);
 }
 }
 
 int MPI_Probe_Nospin(const int source, const int tag, MPI_Comm comm,
-                     MPI_Status* status)
+                     MPI_Status* status, Waiter& waiter)
 {
 #if TIDE_DISABLE_MPI_NOSPIN
     return MPI_Probe(source, tag, comm, status);
 #else
-    int flag = 0;
-    int ret = MPI_Iprobe(source, tag, comm, &flag, status);
-    if (ret != MPI_SUCCESS)
-        return ret;
-
-    timespec ts{0, nsec_start};
-    while (!flag)
-    {
-        nanosleep(&ts, nullptr);
-        ts.tv_nsec = std::min(size_t(ts.tv_nsec << 1), nsec_max);
+    int ret = MPI_SUCCESS;
+    waiter.wait([&] {
+        int flag = 0;
         ret = MPI_Iprobe(source, tag, comm, &flag, status);
-    }
+        return flag != 0 || ret != MPI_SUCCESS;
+    });
     return ret;
 #endif
 }
 
 int MPI_Send_Nospin(void* buff, const int count, MPI_Datatype datatype,
-                    const int dest, const int tag, MPI_Comm comm)
+                    const int dest, const int tag, MPI_Comm comm,
+                    Waiter& waiter)
 {
 #if TIDE_DISABLE_MPI_NOSPIN
     return MPI_Send(buff, count, datatype, dest, tag, comm);
@@ -102,13 +89,13 @@ int MPI_Send_Nospin(void* buff, const int count, MPI_Datatype datatype,
     if (ret != MPI_SUCCESS)
         return ret;
 
-    return _waitForCompletion(req, MPI_STATUS_IGNORE);
+    return _waitForCompletion(req, MPI_STATUS_IGNORE, waiter);
 #endif
 }
 
 int MPI_Recv_Nospin(void* buff, const int count, MPI_Datatype datatype,
                     const int from, const int tag, MPI_Comm comm,
-                    MPI_Status* status)
+                    MPI_Status* status, Waiter& waiter)
 {
 #if TIDE_DISABLE_MPI_NOSPIN
     return MPI_Recv(buff, count, datatype, from, tag, comm, status);
@@ -118,12 +105,12 @@ int MPI_Recv_Nospin(void* buff, const int count, MPI_Datatype datatype,
     if (ret != MPI_SUCCESS)
         return ret;
 
-    return _waitForCompletion(req, status);
+    return _waitForCompletion(req, status, waiter);
 #endif
 }
 
 int MPI_Bcast_Nospin(void* buff, const int count, MPI_Datatype datatype,
-                     const int root, MPI_Comm comm)
+                     const int root, MPI_Comm comm, Waiter& waiter)
 {
 #if TIDE_DISABLE_MPI_NOSPIN
     MPI_Bcast(buff, count, datatype, root, comm);
@@ -133,6 +120,6 @@ int MPI_Bcast_Nospin(void* buff, const int count, MPI_Datatype datatype,
     if (ret != MPI_SUCCESS)
         return ret;
 
-    return _waitForCompletion(req, MPI_STATUS_IGNORE);
+    return _waitForCompletion(req, MPI_STATUS_IGNORE, waiter);
 #endif
 }
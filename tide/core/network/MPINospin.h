@@ -42,31 +42,39 @@
 
 #include <mpi.h>
 
+class Waiter;
+
 /**
- * Implements a blocking, non-spinning MPI_Probe to minimize CPU usage.
+ * Implements a blocking MPI_Probe which waits according to the policy of the
+ * waiter, by default without spinning to minimize CPU usage.
  * @see MPI_Probe
  */
-int MPI_Probe_Nospin(int source, int tag, MPI_Comm comm, MPI_Status* status);
+int MPI_Probe_Nospin(int source, int tag, MPI_Comm comm, MPI_Status* status,
+                     Waiter& waiter);
 
 /**
- * Implements a blocking, non-spinning MPI_Send to minimize CPU usage.
+ * Implements a blocking MPI_Send which waits according to the policy of the
+ * waiter, by default without spinning to minimize CPU usage.
  * @see MPI_Send
  */
 int MPI_Send_Nospin(void* buff, int count, MPI_Datatype datatype, int dest,
-                    int tag, MPI_Comm comm);
+                    int tag, MPI_Comm comm, Waiter& waiter);
 
 /**
- * Implements a blocking, non-spinning MPI_Recv to minimize CPU usage.
+ * Implements a blocking MPI_Recv which waits according to the policy of the
+ * waiter, by default without spinning to minimize CPU usage.
  * @see MPI_Recv
  */
 int MPI_Recv_Nospin(void* buff, int count, MPI_Datatype datatype, int from,
-                    int tag, MPI_Comm comm, MPI_Status* status);
+                    int tag, MPI_Comm comm, MPI_Status* status,
+                    Waiter& waiter);
 
 /**
- * Implements a blocking, non-spinning MPI_Bcast to minimize CPU usage.
+ * Implements a blocking MPI_Bcast which waits according to the policy of the
+ * waiter, by default without spinning to minimize CPU usage.
  * @see MPI_Bcast
  */
 int MPI_Bcast_Nospin(void* buff, int count, MPI_Datatype datatype, int root,
-                     MPI_Comm comm);
+                     MPI_Comm comm, Waiter& waiter);
 
 #endif
@@ -0,0 +1,415 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "MPITransport.h"
+
+#include "MPIContext.h"
+#include "MPINospin.h"
+
+#include "utils/log.h"
+
+#include <algorithm>
+#include <deque>
+
+// WAR some deadlocks receiving MPI_IBcast with OpenMPI (version 1.10.2)
+#ifdef OPEN_MPI
+#define DISBALE_MPI_IBCAST
+#endif
+
+// #define instead of a function so that print_log prints the correct reference
+#define MPI_CHECK(func)                                                 \
+    {                                                                   \
+        const int err = (func);                                         \
+        if (err != MPI_SUCCESS)                                         \
+            print_log(LOG_ERROR, LOG_MPI, "Error detected! (%d)", err); \
+    }
+
+namespace
+{
+#ifdef DISBALE_MPI_IBCAST
+const bool nonBlockingSegments = false;
+#else
+const bool nonBlockingSegments = true;
+#endif
+
+using Block = Transport::Block;
+
+struct Segment
+{
+    size_t offset = 0;
+    size_t size = 0;
+    void* buffer = nullptr;
+    int count = 0;
+    MPI_Datatype datatype = MPI_BYTE;
+    MPI_Request request = MPI_REQUEST_NULL;
+};
+
+// Describe the bytes [offset, offset + size) of the concatenated blocks
+Segment _makeSegment(const std::vector<Block>& blocks, const size_t offset,
+                     const size_t size)
+{
+    std::vector<char*> pointers;
+    std::vector<int> lengths;
+    size_t blockBegin = 0;
+    for (const auto& block : blocks)
+    {
+        const auto blockEnd = blockBegin + block.second;
+        const auto begin = std::max(blockBegin, offset);
+        const auto end = std::min(blockEnd, offset + size);
+        if (begin < end)
+        {
+            pointers.push_back(block.first + (begin - blockBegin));
+            lengths.push_back(end - begin);
+        }
+        blockBegin = blockEnd;
+    }
+
+    Segment segment;
+    segment.offset = offset;
+    segment.size = size;
+    if (pointers.size() <= 1)
+    {
+        segment.buffer = pointers.empty() ? nullptr : pointers[0];
+        segment.count = lengths.empty() ? 0 : lengths[0];
+        return segment;
+    }
+
+    // Let MPI gather the blocks in place using absolute addresses
+    std::vector<MPI_Aint> addresses(pointers.size());
+    for (size_t i = 0; i < pointers.size(); ++i)
+        MPI_CHECK(MPI_Get_address(pointers[i], &addresses[i]));
+    MPI_CHECK(MPI_Type_create_hindexed(lengths.size(), lengths.data(),
+                                       addresses.data(), MPI_BYTE,
+                                       &segment.datatype));
+    MPI_CHECK(MPI_Type_commit(&segment.datatype));
+    segment.buffer = MPI_BOTTOM;
+    segment.count = 1;
+    return segment;
+}
+
+void _freeSegment(Segment& segment)
+{
+    if (segment.datatype != MPI_BYTE)
+        MPI_CHECK(MPI_Type_free(&segment.datatype));
+}
+
+size_t _size(const std::vector<Block>& blocks)
+{
+    size_t size = 0;
+    for (const auto& block : blocks)
+        size += block.second;
+    return size;
+}
+
+int _mpiSource(const int src)
+{
+    return src == Transport::anySource ? MPI_ANY_SOURCE : src;
+}
+
+int _mpiTag(const int tag)
+{
+    return tag == Transport::anyTag ? MPI_ANY_TAG : tag;
+}
+}
+
+MPITransport::MPITransport(int argc, char* argv[])
+    : _mpiContext{new MPIContext{argc, argv}}
+    , _mpiComm{MPI_COMM_WORLD}
+{
+    MPI_CHECK(MPI_Comm_rank(_mpiComm, &_mpiRank));
+    MPI_CHECK(MPI_Comm_size(_mpiComm, &_mpiSize));
+}
+
+MPITransport::MPITransport(std::shared_ptr<MPIContext> context,
+                           const MPI_Comm comm)
+    : _mpiContext{std::move(context)}
+    , _mpiComm{comm}
+{
+    MPI_CHECK(MPI_Comm_rank(_mpiComm, &_mpiRank));
+    MPI_CHECK(MPI_Comm_size(_mpiComm, &_mpiSize));
+}
+
+MPITransport::~MPITransport()
+{
+    if (_mpiComm != MPI_COMM_WORLD)
+        MPI_CHECK(MPI_Comm_disconnect(&_mpiComm));
+}
+
+int MPITransport::getRank() const
+{
+    return _mpiRank;
+}
+
+int MPITransport::getSize() const
+{
+    return _mpiSize;
+}
+
+std::unique_ptr<Transport> MPITransport::split(const int color) const
+{
+    MPI_Comm comm;
+    MPI_CHECK(MPI_Comm_split(_mpiComm, color, _mpiRank, &comm));
+    return std::unique_ptr<Transport>{new MPITransport{_mpiContext, comm}};
+}
+
+std::unique_ptr<Transport> MPITransport::splitByHost() const
+{
+    MPI_Comm comm;
+    MPI_CHECK(MPI_Comm_split_type(_mpiComm, MPI_COMM_TYPE_SHARED, _mpiRank,
+                                  MPI_INFO_NULL, &comm));
+    return std::unique_ptr<Transport>{new MPITransport{_mpiContext, comm}};
+}
+
+void MPITransport::send(const std::vector<Block>& blocks, const int dest,
+                        const int tag, Waiter& waiter)
+{
+    auto message = _makeSegment(blocks, 0, _size(blocks));
+    MPI_CHECK(MPI_Send_Nospin(message.buffer, message.count, message.datatype,
+                              dest, tag, _mpiComm, waiter));
+    _freeSegment(message);
+}
+
+ProbeResult MPITransport::probe(const int src, const int tag, Waiter& waiter)
+{
+    MPI_Status status;
+    MPI_CHECK(MPI_Probe_Nospin(_mpiSource(src), _mpiTag(tag), _mpiComm,
+                               &status, waiter));
+
+    int count = MPI_UNDEFINED;
+    MPI_CHECK(MPI_Get_count(&status, MPI_BYTE, &count));
+
+    return ProbeResult{status.MPI_SOURCE, count, MessageType(status.MPI_TAG)};
+}
+
+void MPITransport::receive(char* data, const size_t size, const int src,
+                           const int tag, Waiter& waiter)
+{
+    MPI_Status status;
+    MPI_CHECK(MPI_Recv_Nospin((void*)data, size, MPI_BYTE, src, tag, _mpiComm,
+                              &status, waiter));
+
+    // Validate the number of bytes received
+    int count = 0;
+    MPI_CHECK(MPI_Get_count(&status, MPI_BYTE, &count));
+    if (count != (int)size)
+        print_log(LOG_ERROR, LOG_MPI, "incorrect bytes count: %d / %d", count,
+                  size);
+}
+
+void MPITransport::broadcast(char* data, const size_t size, const int root,
+                             Waiter& waiter)
+{
+#ifdef DISBALE_MPI_IBCAST
+    if (_mpiRank != root)
+    {
+        MPI_CHECK(MPI_Recv_Nospin((void*)data, size, MPI_BYTE, root, 0,
+                                  _mpiComm, MPI_STATUS_IGNORE, waiter));
+        return;
+    }
+    for (auto i = 0; i < _mpiSize; ++i)
+    {
+        if (i != _mpiRank)
+        {
+            MPI_CHECK(MPI_Send_Nospin((void*)data, size, MPI_BYTE, i, 0,
+                                      _mpiComm, waiter));
+        }
+    }
+#else
+    MPI_CHECK(MPI_Bcast_Nospin((void*)data, size, MPI_BYTE, root, _mpiComm,
+                               waiter));
+#endif
+}
+
+void MPITransport::broadcast(const std::vector<Block>& blocks,
+                             const size_t size, const int root,
+                             size_t segmentSize, const size_t segmentsInFlight,
+                             const SegmentCallback& callback)
+{
+    if (size == 0)
+        return;
+
+    if (segmentSize == 0)
+        segmentSize = size;
+    const bool pipelined = nonBlockingSegments && size > segmentSize;
+
+    std::deque<Segment> pending;
+    const auto completeSegment = [&pending, &callback] {
+        auto& segment = pending.front();
+        MPI_CHECK(MPI_Wait(&segment.request, MPI_STATUS_IGNORE));
+        _freeSegment(segment);
+        if (callback)
+            callback(segment.offset, segment.size);
+        pending.pop_front();
+    };
+
+    for (size_t offset = 0; offset < size; offset += segmentSize)
+    {
+        if (pending.size() >= std::max(segmentsInFlight, size_t(1)))
+            completeSegment();
+
+        const auto count = std::min(segmentSize, size - offset);
+        pending.push_back(_makeSegment(blocks, offset, count));
+        auto& segment = pending.back();
+        if (pipelined)
+        {
+            MPI_CHECK(MPI_Ibcast(segment.buffer, segment.count,
+                                 segment.datatype, root, _mpiComm,
+                                 &segment.request));
+        }
+        else
+        {
+            MPI_CHECK(MPI_Bcast(segment.buffer, segment.count,
+                                segment.datatype, root, _mpiComm));
+            completeSegment();
+        }
+    }
+    while (!pending.empty())
+        completeSegment();
+}
+
+void MPITransport::scatter(const std::vector<std::vector<Block>>& messages)
+{
+    size_t totalSize = 0;
+    for (int i = 0; i < _mpiSize; ++i)
+        if (i != _mpiRank)
+            totalSize += _size(messages[i]);
+
+    // MPI_Scatterv needs a single send buffer
+    std::vector<int> counts(_mpiSize, 0);
+    std::vector<int> displacements(_mpiSize, 0);
+    std::vector<char> buffer;
+    buffer.reserve(totalSize);
+    for (int i = 0; i < _mpiSize; ++i)
+    {
+        if (i == _mpiRank)
+            continue;
+        displacements[i] = buffer.size();
+        for (const auto& block : messages[i])
+        {
+            const auto end = block.first + block.second;
+            buffer.insert(buffer.end(), block.first, end);
+        }
+        counts[i] = buffer.size() - displacements[i];
+    }
+
+    MPI_CHECK(MPI_Scatter((void*)counts.data(), 1, MPI_INT, MPI_IN_PLACE, 1,
+                          MPI_INT, _mpiRank, _mpiComm));
+    MPI_CHECK(MPI_Scatterv((void*)buffer.data(), counts.data(),
+                           displacements.data(), MPI_BYTE, MPI_IN_PLACE, 0,
+                           MPI_BYTE, _mpiRank, _mpiComm));
+}
+
+void MPITransport::receiveScatter(const int root, const Allocator& allocate)
+{
+    int size = 0;
+    MPI_CHECK(MPI_Scatter(nullptr, 1, MPI_INT, (void*)&size, 1, MPI_INT, root,
+                          _mpiComm));
+    const auto data = allocate(size);
+    MPI_CHECK(MPI_Scatterv(nullptr, nullptr, nullptr, MPI_BYTE, (void*)data,
+                           size, MPI_BYTE, root, _mpiComm));
+}
+
+void MPITransport::barrier() const
+{
+    MPI_CHECK(MPI_Barrier(_mpiComm));
+}
+
+int MPITransport::allreduce(int value, const Operation operation) const
+{
+    const auto op = operation == Operation::max ? MPI_MAX : MPI_SUM;
+    int result = 0;
+    MPI_CHECK(MPI_Allreduce((void*)&value, (void*)&result, 1, MPI_INT, op,
+                            _mpiComm));
+    return result;
+}
+
+std::vector<uint64_t> MPITransport::gather(
+    const std::vector<uint64_t>& values, const int root) const
+{
+    const int count = values.size();
+    std::vector<uint64_t> results;
+    if (_mpiRank == root)
+        results.resize(count * _mpiSize);
+    MPI_CHECK(MPI_Gather((void*)values.data(), count, MPI_LONG_LONG_INT,
+                         (void*)results.data(), count, MPI_LONG_LONG_INT, root,
+                         _mpiComm));
+    return results;
+}
+
+std::vector<uint64_t> MPITransport::allgather(
+    const std::vector<uint64_t>& values) const
+{
+    const int count = values.size();
+    std::vector<uint64_t> results(count * _mpiSize);
+    MPI_CHECK(MPI_Allgather((void*)values.data(), count, MPI_LONG_LONG_INT,
+                            (void*)results.data(), count, MPI_LONG_LONG_INT,
+                            _mpiComm));
+    return results;
+}
+
+std::vector<uint64_t> MPITransport::allgatherVariable(
+    const std::vector<uint64_t>& values) const
+{
+    const int count = values.size();
+    std::vector<int> counts(_mpiSize);
+    MPI_CHECK(MPI_Allgather((void*)&count, 1, MPI_INT, (void*)counts.data(), 1,
+                            MPI_INT, _mpiComm));
+
+    std::vector<int> displacements(_mpiSize, 0);
+    for (int i = 1; i < _mpiSize; ++i)
+        displacements[i] = displacements[i - 1] + counts[i - 1];
+
+    return allgatherVariable(values, counts, displacements);
+}
+
+std::vector<uint64_t> MPITransport::allgatherVariable(
+    const std::vector<uint64_t>& values, const std::vector<int>& counts,
+    const std::vector<int>& offsets) const
+{
+    size_t size = 0;
+    for (int i = 0; i < _mpiSize; ++i)
+        size = std::max(size, size_t(offsets[i] + counts[i]));
+
+    std::vector<uint64_t> results(size);
+    MPI_CHECK(MPI_Allgatherv((void*)values.data(), counts[_mpiRank],
+                             MPI_LONG_LONG_INT, (void*)results.data(),
+                             counts.data(), offsets.data(), MPI_LONG_LONG_INT,
+                             _mpiComm));
+    return results;
+}
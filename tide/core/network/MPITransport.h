@@ -0,0 +1,105 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef MPITRANSPORT_H
+#define MPITRANSPORT_H
+
+#include "network/Transport.h"
+
+#include <mpi.h>
+
+class MPIContext;
+
+/**
+ * Transport between processes started with mpiexec.
+ */
+class MPITransport : public Transport
+{
+public:
+    /**
+     * Create the transport of all processes, initializing the MPI context.
+     * @param argc main program arguments count
+     * @param argv main program arguments
+     * @throw std::runtime_error if MPI does not support multiple threads.
+     */
+    MPITransport(int argc, char* argv[]);
+
+    /** Destructor, closes the MPI communicator. */
+    ~MPITransport();
+
+    int getRank() const final;
+    int getSize() const final;
+
+    std::unique_ptr<Transport> split(int color) const final;
+    std::unique_ptr<Transport> splitByHost() const final;
+
+    void send(const std::vector<Block>& blocks, int dest, int tag,
+              Waiter& waiter) final;
+    ProbeResult probe(int src, int tag, Waiter& waiter) final;
+    void receive(char* data, size_t size, int src, int tag,
+                 Waiter& waiter) final;
+
+    void broadcast(char* data, size_t size, int root, Waiter& waiter) final;
+    void broadcast(const std::vector<Block>& blocks, size_t size, int root,
+                   size_t segmentSize, size_t segmentsInFlight,
+                   const SegmentCallback& callback) final;
+    void scatter(const std::vector<std::vector<Block>>& messages) final;
+    void receiveScatter(int root, const Allocator& allocate) final;
+    void barrier() const final;
+    int allreduce(int value, Operation operation) const final;
+    std::vector<uint64_t> gather(const std::vector<uint64_t>& values,
+                                 int root) const final;
+    std::vector<uint64_t> allgather(
+        const std::vector<uint64_t>& values) const final;
+    std::vector<uint64_t> allgatherVariable(
+        const std::vector<uint64_t>& values) const final;
+    std::vector<uint64_t> allgatherVariable(
+        const std::vector<uint64_t>& values, const std::vector<int>& counts,
+        const std::vector<int>& offsets) const final;
+
+private:
+    std::shared_ptr<MPIContext> _mpiContext;
+    MPI_Comm _mpiComm{MPI_COMM_NULL};
+    int _mpiRank = -1;
+    int _mpiSize = -1;
+
+    MPITransport(std::shared_ptr<MPIContext> context, MPI_Comm comm);
+};
+
+#endif
@@ -40,6 +40,8 @@
 #ifndef MESSAGEHEADER_H
 #define MESSAGEHEADER_H
 
+#include "types.h"
+
 #include <stdint.h>
 
 /** The type of network message. */
@@ -59,7 +61,11 @@ enum class MessageType
     COUNTDOWN_STATUS,
     PIXELSTREAM_CLOSE,
     LOCK,
-    CONFIG
+    CONFIG,
+    PIXELSTREAM_SCATTER,
+    PIXELSTREAM_HOST,
+    TRACE,
+    TELEMETRY
 };
 
 /** Fixed-size message header. */
@@ -70,6 +76,12 @@ struct MessageHeader
 
     /** Size of the message payload. */
     uint32_t size = 0u;
+
+    /** Compression codec of the payload. */
+    Codec codec = Codec::none;
+
+    /** Size of the compressed payload, if codec is not none. */
+    uint32_t wireSize = 0u;
 };
 
 #endif
@@ -0,0 +1,149 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef RECEIVEPROGRESS_H
+#define RECEIVEPROGRESS_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <streambuf>
+
+/**
+ * Progress of a message which is processed while it is being received.
+ *
+ * The receiving thread reports the size received so far, while the processing
+ * thread waits for the part of the message it needs next.
+ */
+class ReceiveProgress
+{
+public:
+    /**
+     * Start receiving a new message.
+     * @param size The size of the message.
+     */
+    void reset(const size_t size)
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        _size = size;
+        _receivedSize = 0;
+    }
+
+    /**
+     * Report that the beginning of the message has been received.
+     * @param receivedSize The size of the message received so far.
+     */
+    void setReceived(const size_t receivedSize)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _receivedSize = std::min(receivedSize, _size);
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * Wait until the beginning of the message has been received.
+     * @param size The size needed, limited to the size of the message.
+     * @return the size of the message received so far.
+     */
+    size_t waitFor(const size_t size) const
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this, size] {
+            return _receivedSize >= std::min(size, _size);
+        });
+        return _receivedSize;
+    }
+
+    /** Wait until the whole message has been received. */
+    void wait() const { waitFor(_getSize()); }
+
+private:
+    size_t _size = 0;
+    size_t _receivedSize = 0;
+
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _condition;
+
+    size_t _getSize() const
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        return _size;
+    }
+};
+
+/**
+ * Stream buffer for reading a message while it is being received.
+ *
+ * Reading blocks until the next bytes of the message have been received, and
+ * reaches the end of the stream at the end of the message.
+ */
+class ReceiveStreamBuffer : public std::streambuf
+{
+public:
+    /**
+     * @param data The buffer in which the message is received.
+     * @param progress The reception progress of the message.
+     */
+    ReceiveStreamBuffer(const char* data, const ReceiveProgress& progress)
+        : _data{const_cast<char*>(data)}
+        , _progress(progress)
+    {
+        setg(_data, _data, _data);
+    }
+
+protected:
+    int_type underflow() final
+    {
+        const auto offset = size_t(egptr() - _data);
+        const auto receivedSize = _progress.waitFor(offset + 1);
+        if (receivedSize <= offset)
+            return traits_type::eof();
+
+        setg(_data, gptr(), _data + receivedSize);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    char* _data;
+    const ReceiveProgress& _progress;
+};
+
+#endif
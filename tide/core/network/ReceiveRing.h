@@ -0,0 +1,174 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef RECEIVERING_H
+#define RECEIVERING_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ * Fixed ring of receive slots shared by a receiving and a processing thread.
+ *
+ * The receiving thread fills the next free slot while the processing thread
+ * consumes the previous ones in order, so that a slow processing step does not
+ * delay the next receive. The slots are reused to avoid reallocations.
+ *
+ * When all the slots are occupied, the receiving thread blocks until one is
+ * released (backpressure).
+ */
+template <typename T>
+class ReceiveRing
+{
+public:
+    /** Occupancy metrics of the ring. */
+    struct Metrics
+    {
+        /** Number of slots in the ring. */
+        size_t slotsCount = 0;
+
+        /** Number of slots currently received and not yet released. */
+        size_t occupiedSlots = 0;
+
+        /** Maximum number of slots occupied at the same time. */
+        size_t peakOccupiedSlots = 0;
+
+        /** Total number of slots received. */
+        size_t receivedCount = 0;
+
+        /** Number of times the receiving thread waited for a free slot. */
+        size_t stalledCount = 0;
+    };
+
+    /**
+     * Create a ring of slots.
+     * @param slotsCount The number of slots, at least one.
+     */
+    explicit ReceiveRing(const size_t slotsCount)
+        : _slots(std::max(slotsCount, size_t(1)))
+    {
+    }
+
+    /**
+     * Get the next free slot to receive into, blocking while the ring is full.
+     * @return the slot to fill then commit(), or nullptr if the ring is closed.
+     */
+    T* acquire()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_isFull())
+            ++_metrics.stalledCount;
+        _condition.wait(lock, [this] { return _closed || !_isFull(); });
+        return _closed ? nullptr : &_slots[_writeIndex];
+    }
+
+    /** Make the slot returned by acquire() available for processing. */
+    void commit()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _writeIndex = (_writeIndex + 1) % _slots.size();
+            ++_metrics.occupiedSlots;
+            ++_metrics.receivedCount;
+            _metrics.peakOccupiedSlots = std::max(_metrics.peakOccupiedSlots,
+                                                  _metrics.occupiedSlots);
+        }
+        _condition.notify_all();
+    }
+
+    /**
+     * Get the oldest received slot, blocking until there is one.
+     * @return the slot to process then release(), or nullptr if the ring is
+     *         closed and all the received slots have been released.
+     */
+    T* next()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this] {
+            return _closed || _metrics.occupiedSlots > 0;
+        });
+        return _metrics.occupiedSlots > 0 ? &_slots[_readIndex] : nullptr;
+    }
+
+    /** Release the slot returned by next() for receiving again. */
+    void release()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _readIndex = (_readIndex + 1) % _slots.size();
+            --_metrics.occupiedSlots;
+        }
+        _condition.notify_all();
+    }
+
+    /** Close the ring, unblocking both threads once the slots are drained. */
+    void close()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+        }
+        _condition.notify_all();
+    }
+
+    /** @return the current occupancy metrics. */
+    Metrics getMetrics() const
+    {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        auto metrics = _metrics;
+        metrics.slotsCount = _slots.size();
+        return metrics;
+    }
+
+private:
+    std::vector<T> _slots;
+    size_t _writeIndex = 0;
+    size_t _readIndex = 0;
+    bool _closed = false;
+    Metrics _metrics;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+
+    bool _isFull() const { return _metrics.occupiedSlots == _slots.size(); }
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "SharedMemory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+std::runtime_error _error(const std::string& what, const std::string& name)
+{
+    return std::runtime_error(what + " '" + name + "': " +
+                              std::strerror(errno));
+}
+
+char* _map(const int fd, const size_t size, const int protection)
+{
+    void* memory = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+    return memory == MAP_FAILED ? nullptr : static_cast<char*>(memory);
+}
+}
+
+std::shared_ptr<SharedMemory> SharedMemory::create(const std::string& name,
+                                                   const size_t size)
+{
+    if (size == 0)
+        throw std::runtime_error("empty shared memory segment " + name);
+
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        throw _error("could not create shared memory", name);
+
+    char* data = nullptr;
+    if (::ftruncate(fd, size) == 0)
+        data = _map(fd, size, PROT_READ | PROT_WRITE);
+    if (!data)
+    {
+        const auto error = _error("could not allocate shared memory", name);
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw error;
+    }
+    ::close(fd);
+    return std::shared_ptr<SharedMemory>{new SharedMemory{name, data, size}};
+}
+
+std::shared_ptr<const SharedMemory> SharedMemory::open(const std::string& name)
+{
+    return _open(name, false);
+}
+
+std::shared_ptr<SharedMemory> SharedMemory::openWritable(
+    const std::string& name)
+{
+    return _open(name, true);
+}
+
+std::shared_ptr<SharedMemory> SharedMemory::_open(const std::string& name,
+                                                  const bool writable)
+{
+    const int fd = ::shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+    if (fd < 0)
+        throw _error("could not open shared memory", name);
+
+    struct stat info;
+    char* data = nullptr;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0)
+        data = _map(fd, info.st_size,
+                    writable ? PROT_READ | PROT_WRITE : PROT_READ);
+    if (!data)
+    {
+        const auto error = _error("could not map shared memory", name);
+        ::close(fd);
+        throw error;
+    }
+    ::close(fd);
+    const auto size = size_t(info.st_size);
+    return std::shared_ptr<SharedMemory>{new SharedMemory{name, data, size}};
+}
+
+SharedMemory::SharedMemory(const std::string& name, char* data,
+                           const size_t size)
+    : _name{name}
+    , _data{data}
+    , _size{size}
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+    ::munmap(_data, _size);
+}
+
+void SharedMemory::unlink() const
+{
+    ::shm_unlink(_name.c_str());
+}
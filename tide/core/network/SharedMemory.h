@@ -0,0 +1,111 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SHAREDMEMORY_H
+#define SHAREDMEMORY_H
+
+#include <memory>
+#include <string>
+
+/**
+ * A named segment of POSIX shared memory, mapped in the process.
+ *
+ * The segment is created and written by one process, then mapped by the other
+ * processes of the same host which know its name. The memory is
+ * released once the name has been removed with unlink() and all processes
+ * have destroyed their SharedMemory.
+ */
+class SharedMemory
+{
+public:
+    /**
+     * Create a new segment, mapped for writing.
+     * @param name of the segment, starting with a '/'.
+     * @param size of the segment [bytes].
+     * @return the new segment.
+     * @throw std::runtime_error if the segment could not be created.
+     */
+    static std::shared_ptr<SharedMemory> create(const std::string& name,
+                                                size_t size);
+
+    /**
+     * Open an existing segment, mapped read-only.
+     * @param name of the segment.
+     * @return the segment.
+     * @throw std::runtime_error if the segment could not be opened.
+     */
+    static std::shared_ptr<const SharedMemory> open(const std::string& name);
+
+    /**
+     * Open an existing segment, mapped for writing.
+     * @param name of the segment.
+     * @return the segment.
+     * @throw std::runtime_error if the segment could not be opened.
+     */
+    static std::shared_ptr<SharedMemory> openWritable(const std::string& name);
+
+    /** Unmap the segment. */
+    ~SharedMemory();
+
+    /** @return the name of the segment. */
+    const std::string& getName() const { return _name; }
+
+    /** @return the mapped memory. */
+    char* getData() { return _data; }
+    const char* getData() const { return _data; }
+
+    /** @return the size of the segment [bytes]. */
+    size_t getSize() const { return _size; }
+
+    /** Remove the name of the segment, the memory stays mapped. */
+    void unlink() const;
+
+private:
+    std::string _name;
+    char* _data = nullptr;
+    size_t _size = 0;
+
+    SharedMemory(const std::string& name, char* data, size_t size);
+    static std::shared_ptr<SharedMemory> _open(const std::string& name,
+                                               bool writable);
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+};
+
+#endif
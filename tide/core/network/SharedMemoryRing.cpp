@@ -0,0 +1,216 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "SharedMemoryRing.h"
+
+#include "SharedMemory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "the readers count is shared between processes");
+
+using ReadersCount = std::atomic<uint32_t>;
+
+// Each readers count of the control segment is on its own cache line
+const size_t COUNT_STRIDE = 64;
+
+std::string _controlName(const std::string& prefix)
+{
+    return prefix + "-readers";
+}
+
+std::string _name(const std::string& prefix, const uint64_t index,
+                  const uint64_t generation)
+{
+    return prefix + "-" + std::to_string(index) + "-" +
+           std::to_string(generation);
+}
+
+size_t _countsCapacity(const SharedMemory& control)
+{
+    return control.getSize() / COUNT_STRIDE;
+}
+
+ReadersCount& _readers(SharedMemory& control, const size_t index)
+{
+    auto data = control.getData() + index * COUNT_STRIDE;
+    return *reinterpret_cast<ReadersCount*>(data);
+}
+}
+
+SharedMemoryRing::SharedMemoryRing(const std::string& prefix,
+                                   const size_t slotsCount)
+    : _prefix{prefix}
+    , _control{SharedMemory::create(_controlName(prefix),
+                                    std::max(slotsCount, size_t(1)) *
+                                        COUNT_STRIDE)}
+    , _segments(slotsCount)
+{
+    for (size_t i = 0; i < _countsCapacity(*_control); ++i)
+        new (&_readers(*_control, i)) ReadersCount{0};
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    _control->unlink();
+    for (const auto& segment : _segments)
+    {
+        if (segment.linked)
+            segment.memory->unlink();
+    }
+}
+
+bool SharedMemoryRing::write(const char* data, const size_t size,
+                             const uint32_t readersCount, Slot& slot)
+{
+    for (size_t i = 0; i < _segments.size(); ++i)
+    {
+        const auto index = (_next + i) % _segments.size();
+        if (!_isFree(index))
+            continue;
+
+        // All the readers are done with the segment, mapped or not
+        auto& segment = _segments[index];
+        if (segment.linked)
+        {
+            segment.memory->unlink();
+            segment.linked = false;
+        }
+        if (!segment.memory || segment.memory->getSize() < size)
+            _allocate(segment, index, size);
+
+        std::memcpy(segment.memory->getData(), data, size);
+        _readers(*_control, index).store(readersCount,
+                                         std::memory_order_release);
+
+        slot.index = index;
+        slot.generation = segment.generation;
+        slot.size = size;
+        _next = (index + 1) % _segments.size();
+        return true;
+    }
+    return false;
+}
+
+bool SharedMemoryRing::_isFree(const size_t index) const
+{
+    const auto& count = _readers(*_control, index);
+    return count.load(std::memory_order_acquire) == 0;
+}
+
+void SharedMemoryRing::_allocate(Segment& segment, const size_t index,
+                                 const size_t size)
+{
+    // Grow geometrically, payloads of slightly increasing sizes would
+    // otherwise recreate the segment each time
+    size_t capacity = std::max(size, size_t(1));
+    if (segment.memory)
+        capacity = std::max(size, 2 * segment.memory->getSize());
+
+    const auto generation = segment.memory ? segment.generation + 1 : 0;
+    segment.memory =
+        SharedMemory::create(_name(_prefix, index, generation), capacity);
+    segment.generation = generation;
+    segment.linked = true;
+}
+
+SharedMemoryRingReader::SharedMemoryRingReader(const std::string& prefix)
+    : _prefix{prefix}
+    , _control{SharedMemory::openWritable(_controlName(prefix))}
+{
+}
+
+std::shared_ptr<const char> SharedMemoryRingReader::read(
+    const SharedMemoryRing::Slot& slot)
+{
+    if (slot.index >= _countsCapacity(*_control))
+        throw std::runtime_error("invalid shared memory slot " +
+                                 std::to_string(slot.index));
+
+    auto control = _control;
+    const auto index = slot.index;
+    const auto release = [control, index](const char*) {
+        _readers(*control, index).fetch_sub(1, std::memory_order_release);
+    };
+
+    const SharedMemory* memory = nullptr;
+    try
+    {
+        memory = &_map(slot);
+    }
+    catch (...)
+    {
+        release(nullptr);
+        throw;
+    }
+
+    // The payload keeps its segment mapped until it is released
+    auto segment = _segments[index].memory;
+    return std::shared_ptr<const char>{memory->getData(),
+                                       [segment, release](const char* data) {
+                                           release(data);
+                                       }};
+}
+
+const SharedMemory& SharedMemoryRingReader::_map(
+    const SharedMemoryRing::Slot& slot)
+{
+    if (slot.index >= _segments.size())
+        _segments.resize(slot.index + 1);
+
+    auto& segment = _segments[slot.index];
+    if (!segment.memory || segment.generation != slot.generation)
+    {
+        segment.memory.reset();
+        segment.memory =
+            SharedMemory::open(_name(_prefix, slot.index, slot.generation));
+        segment.generation = slot.generation;
+    }
+    if (segment.memory->getSize() < slot.size)
+        throw std::runtime_error("shared memory slot too small " +
+                                 segment.memory->getName());
+    return *segment.memory;
+}
@@ -0,0 +1,151 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SHAREDMEMORYRING_H
+#define SHAREDMEMORYRING_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class SharedMemory;
+
+/**
+ * A ring of persistent shared memory segments, written by one process and
+ * read by the other processes of the same host.
+ *
+ * Each slot counts the readers which have not yet released its payload. The
+ * writer reuses a slot only once this count is back to zero, so payloads are
+ * passed without any synchronization between the processes beyond sending the
+ * Slot to the readers. The counts live in a control segment created with the
+ * ring, which the readers open before the first payload; a reader which fails
+ * to map a payload still releases it. The payload segments are created on
+ * first use, recreated larger when a payload does not fit, and unlinked as
+ * soon as all the readers have released them.
+ */
+class SharedMemoryRing
+{
+public:
+    /** Location of a payload in the ring, to send to the readers. */
+    struct Slot
+    {
+        uint64_t index = 0;
+        uint64_t generation = 0; // incremented when the segment is recreated
+        uint64_t size = 0;
+    };
+
+    /**
+     * Create the (empty) ring of the writer and its control segment.
+     * @param prefix of the names of the segments, starting with a '/'.
+     * @param slotsCount the maximum number of payloads being read at once.
+     * @throw std::runtime_error if the control segment could not be created.
+     */
+    SharedMemoryRing(const std::string& prefix, size_t slotsCount);
+
+    /** Unlink the control segment and the segments still being read. */
+    ~SharedMemoryRing();
+
+    /**
+     * Copy a payload into a free slot.
+     * @param data the payload.
+     * @param size of the payload [bytes].
+     * @param readersCount the number of readers which will read the slot.
+     * @param slot set to the location of the payload on success.
+     * @return false if all the slots are still being read.
+     * @throw std::runtime_error if a segment could not be created.
+     */
+    bool write(const char* data, size_t size, uint32_t readersCount,
+               Slot& slot);
+
+private:
+    struct Segment
+    {
+        std::shared_ptr<SharedMemory> memory;
+        uint64_t generation = 0;
+        bool linked = false;
+    };
+
+    const std::string _prefix;
+    std::shared_ptr<SharedMemory> _control;
+    std::vector<Segment> _segments;
+    size_t _next = 0;
+
+    bool _isFree(size_t index) const;
+    void _allocate(Segment& segment, size_t index, size_t size);
+};
+
+/**
+ * The side of a SharedMemoryRing which reads the payloads.
+ */
+class SharedMemoryRingReader
+{
+public:
+    /**
+     * Create the reader, once the writer has created the ring.
+     * @param prefix of the names of the segments given to the writer.
+     * @throw std::runtime_error if the control segment could not be opened.
+     */
+    SharedMemoryRingReader(const std::string& prefix);
+
+    /**
+     * Map the payload of a slot.
+     * @param slot location received from the writer.
+     * @return the payload, released to the writer when the last copy of the
+     *         pointer is destroyed.
+     * @throw std::runtime_error if the segment could not be opened, the
+     *        payload is released to the writer in this case.
+     */
+    std::shared_ptr<const char> read(const SharedMemoryRing::Slot& slot);
+
+private:
+    struct Segment
+    {
+        std::shared_ptr<const SharedMemory> memory;
+        uint64_t generation = 0;
+    };
+
+    const std::string _prefix;
+    std::shared_ptr<SharedMemory> _control;
+    std::vector<Segment> _segments;
+
+    const SharedMemory& _map(const SharedMemoryRing::Slot& slot);
+};
+
+#endif
@@ -0,0 +1,1246 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "SocketTransport.h"
+
+#include "Waiter.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <functional>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+// Tags of the messages of the collective operations, ignored by anyTag
+const int barrierTag = -2;
+const int broadcastTag = -3;
+const int gatherTag = -4;
+const int scatterTag = -5;
+
+// Signals to the reader thread on its wakeup pipe
+const char quitSignal = 0;
+const char resumeSignal = 1;
+
+const size_t hostNameSize = 64;
+const auto connectTimeout = std::chrono::seconds{60};
+
+// Waiting for the other side of a shared memory ring
+const size_t ringSpinCount = 1000;
+const auto ringBackoff = std::chrono::microseconds{100};
+
+using Block = Transport::Block;
+
+/** How to reach a process, sent to all processes by the process of rank 0. */
+struct Peer
+{
+    char address[hostNameSize]; // routable address or host name
+    uint16_t port;
+    char host[hostNameSize];
+};
+
+/** Registration of a process with the process of rank 0. */
+struct Hello
+{
+    int32_t rank;
+    Peer peer;
+};
+
+/** Sent on the socket before each message. */
+struct FrameHeader
+{
+    uint64_t context;
+    int32_t tag;
+    uint32_t inRing;
+    uint64_t size;
+};
+
+struct Message
+{
+    uint64_t context;
+    int src;
+    int tag;
+    std::vector<char> data;
+};
+
+std::runtime_error _error(const std::string& what)
+{
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void _writeAll(const int fd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto count = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw _error("socket send failed");
+        }
+        data += count;
+        size -= count;
+    }
+}
+
+bool _readAll(const int fd, char* data, size_t size)
+{
+    while (size > 0)
+    {
+        const auto count = ::recv(fd, data, size, 0);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+template <typename T>
+void _write(const int fd, const T& value)
+{
+    _writeAll(fd, reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void _read(const int fd, T& value)
+{
+    if (!_readAll(fd, reinterpret_cast<char*>(&value), sizeof(T)))
+        throw _error("socket receive failed");
+}
+
+void _setNoDelay(const int fd)
+{
+    const int on = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+int _listen(const uint16_t port, const int backlog)
+{
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        throw _error("could not create socket");
+
+    const int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(fd, (sockaddr*)&address, sizeof(address)) < 0 ||
+        ::listen(fd, backlog) < 0)
+    {
+        ::close(fd);
+        throw _error("could not listen on port " + std::to_string(port));
+    }
+    return fd;
+}
+
+uint16_t _getPort(const int fd)
+{
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    ::getsockname(fd, (sockaddr*)&address, &length);
+    return ntohs(address.sin_port);
+}
+
+std::string _getHostName()
+{
+    char name[hostNameSize] = {};
+    ::gethostname(name, hostNameSize - 1);
+    return name;
+}
+
+// The address of this process for the other ones: the local address of its
+// connection to the process of rank 0, unless that connection is local.
+std::string _getRoutableAddress(const int fd)
+{
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    ::getsockname(fd, (sockaddr*)&address, &length);
+    if ((ntohl(address.sin_addr.s_addr) >> 24) == IN_LOOPBACKNET)
+        return _getHostName();
+
+    char buffer[INET_ADDRSTRLEN] = {};
+    ::inet_ntop(AF_INET, &address.sin_addr, buffer, sizeof(buffer));
+    return buffer;
+}
+
+int _connect(const std::string& host, const uint16_t port)
+{
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    const auto service = std::to_string(port);
+
+    // The process may not be listening yet, retry until the timeout
+    const auto deadline = std::chrono::steady_clock::now() + connectTimeout;
+    while (true)
+    {
+        addrinfo* result = nullptr;
+        if (::getaddrinfo(host.c_str(), service.c_str(), &hints, &result) == 0)
+        {
+            const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            const bool connected =
+                fd >= 0 &&
+                ::connect(fd, result->ai_addr, result->ai_addrlen) == 0;
+            ::freeaddrinfo(result);
+            if (connected)
+            {
+                _setNoDelay(fd);
+                return fd;
+            }
+            if (fd >= 0)
+                ::close(fd);
+        }
+        if (std::chrono::steady_clock::now() > deadline)
+            throw std::runtime_error("could not connect to " + host + ":" +
+                                     service);
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+}
+
+int _accept(const int listener)
+{
+    while (true)
+    {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd >= 0)
+        {
+            _setNoDelay(fd);
+            return fd;
+        }
+        if (errno != EINTR)
+            throw _error("could not accept connection");
+    }
+}
+
+void _copyString(char* target, const std::string& source, const size_t size)
+{
+    std::strncpy(target, source.c_str(), size - 1);
+    target[size - 1] = '\0';
+}
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "atomics in shared memory must be lock-free");
+
+/** Shared between two processes, at the beginning of the ring memory. */
+struct RingHeader
+{
+    alignas(64) std::atomic<uint64_t> written;
+    alignas(64) std::atomic<uint64_t> consumed;
+};
+
+/**
+ * Single-producer, single-consumer ring buffer in POSIX shared memory.
+ *
+ * Messages larger than the ring are streamed through it, the reader copying
+ * the data out while the writer is still copying it in. The socket to the
+ * other process tells if it is still connected while waiting for it.
+ */
+class Ring
+{
+public:
+    Ring(const std::string& name, size_t capacity, const bool create,
+         const int peerSocket)
+        : _name(name)
+        , _peerSocket{peerSocket}
+    {
+        const int flags = create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR;
+        const int fd = ::shm_open(name.c_str(), flags, 0600);
+        if (fd < 0)
+            throw _error("could not open shared memory " + name);
+
+        struct stat info;
+        if (create && ::ftruncate(fd, sizeof(RingHeader) + capacity) < 0)
+        {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw _error("could not allocate shared memory " + name);
+        }
+        if (!create && ::fstat(fd, &info) == 0)
+            capacity = info.st_size - sizeof(RingHeader);
+
+        _capacity = capacity;
+        _mapSize = sizeof(RingHeader) + capacity;
+        void* memory = ::mmap(nullptr, _mapSize, PROT_READ | PROT_WRITE,
+                              MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED)
+            throw _error("could not map shared memory " + name);
+
+        _header = static_cast<RingHeader*>(memory);
+        _data = static_cast<char*>(memory) + sizeof(RingHeader);
+        if (create)
+        {
+            _header->written = 0;
+            _header->consumed = 0;
+        }
+    }
+
+    ~Ring() { ::munmap(_header, _mapSize); }
+
+    void unlink() { ::shm_unlink(_name.c_str()); }
+
+    void write(const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            size_t available = 0;
+            _wait([this, &available] {
+                const auto consumed = _header->consumed.load();
+                available = _capacity - (_position - consumed);
+                return available > 0;
+            });
+            const auto count = _copy(size, available);
+            std::memcpy(_data + _position % _capacity, data, count);
+            _position += count;
+            _header->written.store(_position);
+            data += count;
+            size -= count;
+        }
+    }
+
+    void read(char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            size_t available = 0;
+            _wait([this, &available] {
+                available = _header->written.load() - _position;
+                return available > 0;
+            });
+            const auto count = _copy(size, available);
+            std::memcpy(data, _data + _position % _capacity, count);
+            _position += count;
+            _header->consumed.store(_position);
+            data += count;
+            size -= count;
+        }
+    }
+
+private:
+    std::string _name;
+    int _peerSocket = -1;
+    size_t _capacity = 0;
+    size_t _mapSize = 0;
+    RingHeader* _header = nullptr;
+    char* _data = nullptr;
+    uint64_t _position = 0; // written (writer) or consumed (reader) bytes
+
+    size_t _copy(const size_t size, const size_t available) const
+    {
+        const auto untilEnd = _capacity - _position % _capacity;
+        return std::min(size, std::min(available, untilEnd));
+    }
+
+    // The other side is usually actively copying and the wait is short.
+    // Otherwise back off, and stop waiting once the other process is gone.
+    template <typename Test>
+    void _wait(const Test& test) const
+    {
+        for (size_t i = 0; !test(); ++i)
+        {
+            if (i < ringSpinCount)
+                std::this_thread::yield();
+            else if (_isPeerConnected())
+                std::this_thread::sleep_for(ringBackoff);
+            else
+                throw std::runtime_error("shared memory peer disconnected");
+        }
+    }
+
+    bool _isPeerConnected() const
+    {
+        pollfd fd{_peerSocket, POLLRDHUP, 0};
+        const auto hangup = POLLRDHUP | POLLHUP | POLLERR | POLLNVAL;
+        return ::poll(&fd, 1, 0) <= 0 || !(fd.revents & hangup);
+    }
+};
+
+/**
+ * The incoming messages of a process, until they are received.
+ *
+ * The size of the pending messages is counted per source, so that the reader
+ * can stop reading from the sources which reach the capacity.
+ */
+class Inbox
+{
+public:
+    Inbox(const size_t sourcesCount, const size_t capacity)
+        : _pendingBytes(sourcesCount, 0)
+        , _capacity{capacity}
+    {
+    }
+
+    /** Set the function called when a full source has room again. */
+    void setDrainedCallback(std::function<void()> callback)
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        _drained = std::move(callback);
+    }
+
+    bool isFull(const int src)
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        return _pendingBytes[src] >= _capacity;
+    }
+
+    void push(Message message)
+    {
+        {
+            const std::lock_guard<std::mutex> lock{_mutex};
+            _pendingBytes[message.src] += message.data.size();
+            _messages.push_back(std::move(message));
+        }
+        _condition.notify_all();
+    }
+
+    bool probe(const uint64_t context, const int src, const int tag,
+               int& source, size_t& size, int& messageTag)
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        const auto it = _find(context, src, tag);
+        if (it == _messages.end())
+            return false;
+        source = it->src;
+        size = it->data.size();
+        messageTag = it->tag;
+        return true;
+    }
+
+    bool tryTake(const uint64_t context, const int src, const int tag,
+                 std::vector<char>& data)
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        const auto it = _find(context, src, tag);
+        if (it == _messages.end())
+            return false;
+        data = _remove(it, lock);
+        return true;
+    }
+
+    std::vector<char> take(const uint64_t context, const int src,
+                           const int tag)
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        auto it = _messages.end();
+        _condition.wait(lock, [&] {
+            it = _find(context, src, tag);
+            return it != _messages.end();
+        });
+        return _remove(it, lock);
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::list<Message> _messages;
+    std::vector<size_t> _pendingBytes;
+    const size_t _capacity;
+    std::function<void()> _drained;
+
+    std::list<Message>::iterator _find(const uint64_t context, const int src,
+                                       const int tag)
+    {
+        return std::find_if(_messages.begin(), _messages.end(),
+                            [&](const Message& message) {
+                                return message.context == context &&
+                                       (src == Transport::anySource ||
+                                        message.src == src) &&
+                                       (tag == Transport::anyTag
+                                            ? message.tag >= 0
+                                            : message.tag == tag);
+                            });
+    }
+
+    std::vector<char> _remove(const std::list<Message>::iterator it,
+                              std::unique_lock<std::mutex>& lock)
+    {
+        auto& pending = _pendingBytes[it->src];
+        const bool wasFull = pending >= _capacity;
+        pending -= it->data.size();
+        const bool drained = wasFull && pending < _capacity;
+
+        auto data = std::move(it->data);
+        _messages.erase(it);
+        const auto callback = _drained;
+        lock.unlock();
+
+        if (drained && callback)
+            callback();
+        return data;
+    }
+};
+
+/** The parent and children of a process in a binomial broadcast tree. */
+struct TreeNode
+{
+    int parent = -1;
+    std::vector<int> children;
+};
+
+TreeNode _makeTree(const int rank, const int size, const int root)
+{
+    TreeNode node;
+    const int relativeRank = (rank - root + size) % size;
+    int mask = 1;
+    while (mask < size)
+    {
+        if (relativeRank & mask)
+        {
+            node.parent = (relativeRank - mask + root) % size;
+            break;
+        }
+        mask <<= 1;
+    }
+    for (mask >>= 1; mask > 0; mask >>= 1)
+    {
+        if (relativeRank + mask < size)
+            node.children.push_back((relativeRank + mask + root) % size);
+    }
+    return node;
+}
+
+// Select the bytes [offset, offset + size) of the concatenated blocks
+std::vector<Block> _slice(const std::vector<Block>& blocks,
+                          const size_t offset, const size_t size)
+{
+    std::vector<Block> slice;
+    size_t blockBegin = 0;
+    for (const auto& block : blocks)
+    {
+        const auto blockEnd = blockBegin + block.second;
+        const auto begin = std::max(blockBegin, offset);
+        const auto end = std::min(blockEnd, offset + size);
+        if (begin < end)
+            slice.emplace_back(block.first + (begin - blockBegin), end - begin);
+        blockBegin = blockEnd;
+    }
+    return slice;
+}
+
+void _copy(const std::vector<char>& data, const std::vector<Block>& blocks)
+{
+    size_t offset = 0;
+    for (const auto& block : blocks)
+    {
+        if (offset + block.second > data.size())
+            throw std::runtime_error("incorrect bytes count");
+        std::memcpy(block.first, data.data() + offset, block.second);
+        offset += block.second;
+    }
+    if (offset != data.size())
+        throw std::runtime_error("incorrect bytes count");
+}
+
+std::vector<int> _range(const int size)
+{
+    std::vector<int> values(size);
+    std::iota(values.begin(), values.end(), 0);
+    return values;
+}
+
+// Derive the context of a new group, identical on all its processes
+uint64_t _makeContext(const uint64_t parent, const uint64_t splitIndex)
+{
+    // splitmix64
+    auto z = parent + splitIndex * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+}
+
+/** The connections of a process to all the others, shared by all groups. */
+class SocketTransport::Network
+{
+public:
+    Network(const int rank_, const int size_, const std::string& rootHost,
+            const uint16_t rootPort, const int rootListener,
+            const Options& options)
+        : rank{rank_}
+        , size{size_}
+        , hosts(size)
+        , inbox(size, options.inboxCapacity)
+        , _sockets(size, -1)
+        , _sendMutexes(size)
+        , _sendRings(size)
+        , _receiveRings(size)
+    {
+        if (size < 1 || rank < 0 || rank >= size)
+            throw std::invalid_argument("invalid process rank or count");
+
+        for (auto& mutex : _sendMutexes)
+            mutex.reset(new std::mutex);
+
+        const auto hostName =
+            options.hostName.empty() ? _getHostName() : options.hostName;
+        const auto session =
+            _connectAll(rootHost, rootPort, rootListener, hostName);
+        if (options.ringSize > 0)
+            _createRings(session, options.ringSize);
+
+        if (::pipe(_wakeup) < 0)
+            throw _error("could not create pipe");
+        inbox.setDrainedCallback([this] {
+            if (::write(_wakeup[1], &resumeSignal, 1) != 1)
+                throw _error("could not wake up the reader thread");
+        });
+        _reader = std::thread{&Network::_readMessages, this};
+    }
+
+    ~Network()
+    {
+        inbox.setDrainedCallback({});
+        if (::write(_wakeup[1], &quitSignal, 1) == 1)
+            _reader.join();
+        else
+            _reader.detach();
+        for (auto fd : _sockets)
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+        ::close(_wakeup[0]);
+        ::close(_wakeup[1]);
+    }
+
+    const int rank;
+    const int size;
+    std::vector<std::string> hosts;
+    Inbox inbox;
+
+    void send(const int dest, const uint64_t context, const int tag,
+              const std::vector<Block>& blocks)
+    {
+        if (dest < 0 || dest >= size)
+            throw std::invalid_argument("invalid destination process");
+
+        size_t messageSize = 0;
+        for (const auto& block : blocks)
+            messageSize += block.second;
+
+        if (dest == rank)
+        {
+            Message message{context, rank, tag, {}};
+            message.data.reserve(messageSize);
+            for (const auto& block : blocks)
+                message.data.insert(message.data.end(), block.first,
+                                    block.first + block.second);
+            inbox.push(std::move(message));
+            return;
+        }
+
+        auto& ring = _sendRings[dest];
+        const bool inRing = ring && messageSize >= ringThreshold;
+        const auto header =
+            FrameHeader{context, tag, inRing ? 1u : 0u, messageSize};
+
+        const std::lock_guard<std::mutex> lock{*_sendMutexes[dest]};
+        _write(_sockets[dest], header);
+        for (const auto& block : blocks)
+        {
+            if (inRing)
+                ring->write(block.first, block.second);
+            else
+                _writeAll(_sockets[dest], block.first, block.second);
+        }
+    }
+
+private:
+    std::vector<int> _sockets;
+    std::vector<std::unique_ptr<std::mutex>> _sendMutexes;
+    std::vector<std::unique_ptr<Ring>> _sendRings;
+    std::vector<std::unique_ptr<Ring>> _receiveRings;
+    int _wakeup[2] = {-1, -1};
+    std::thread _reader;
+
+    // Connect to all the other processes, @return a session identifier
+    std::string _connectAll(const std::string& rootHost,
+                            const uint16_t rootPort, const int rootListener,
+                            const std::string& hostName)
+    {
+        const int listener =
+            rootListener >= 0 ? rootListener
+                              : _listen(rank == 0 ? rootPort : 0, size);
+        std::vector<Peer> peers(size);
+        uint32_t session = 0;
+
+        if (rank == 0)
+        {
+            session = ::getpid();
+            _copyString(peers[0].host, hostName, hostNameSize);
+            for (int i = 1; i < size; ++i)
+            {
+                const int fd = _accept(listener);
+                Hello hello;
+                _read(fd, hello);
+                if (hello.rank <= 0 || hello.rank >= size ||
+                    _sockets[hello.rank] >= 0)
+                {
+                    throw std::runtime_error("invalid process rank");
+                }
+                _sockets[hello.rank] = fd;
+                peers[hello.rank] = hello.peer;
+            }
+            for (int i = 1; i < size; ++i)
+            {
+                _write(_sockets[i], session);
+                _writeAll(_sockets[i], (const char*)peers.data(),
+                          peers.size() * sizeof(Peer));
+            }
+        }
+        else
+        {
+            const int fd = _connect(rootHost, rootPort);
+            Hello hello{};
+            hello.rank = rank;
+            _copyString(hello.peer.address, _getRoutableAddress(fd),
+                        hostNameSize);
+            hello.peer.port = _getPort(listener);
+            _copyString(hello.peer.host, hostName, hostNameSize);
+            _write(fd, hello);
+            _read(fd, session);
+            if (!_readAll(fd, (char*)peers.data(), size * sizeof(Peer)))
+                throw _error("could not receive the list of processes");
+            _sockets[0] = fd;
+
+            // Connect to the lower ranks, then accept the higher ones
+            for (int i = 1; i < rank; ++i)
+            {
+                const int peerFd = _connect(peers[i].address, peers[i].port);
+                _write(peerFd, int32_t(rank));
+                _sockets[i] = peerFd;
+            }
+            for (int i = rank + 1; i < size; ++i)
+            {
+                const int peerFd = _accept(listener);
+                int32_t peerRank = -1;
+                _read(peerFd, peerRank);
+                if (peerRank <= rank || peerRank >= size ||
+                    _sockets[peerRank] >= 0)
+                {
+                    throw std::runtime_error("invalid process rank");
+                }
+                _sockets[peerRank] = peerFd;
+            }
+        }
+        if (listener != rootListener)
+            ::close(listener);
+
+        for (int i = 0; i < size; ++i)
+            hosts[i] = peers[i].host;
+        return std::to_string(rootPort) + "-" + std::to_string(session);
+    }
+
+    void _createRings(const std::string& session, const size_t ringSize)
+    {
+        std::vector<int> localPeers;
+        for (int i = 0; i < size; ++i)
+        {
+            if (i != rank && hosts[i] == hosts[rank])
+                localPeers.push_back(i);
+        }
+        if (localPeers.empty())
+            return;
+
+        const auto name = [&session](const int src, const int dest) {
+            return "/tide-" + session + "-" + std::to_string(src) + "-" +
+                   std::to_string(dest);
+        };
+        // Each process creates the rings it reads from, then opens the rings
+        // it writes to. The names are removed once both sides have mapped them.
+        for (auto peer : localPeers)
+        {
+            const auto ringName = name(peer, rank);
+            _receiveRings[peer].reset(
+                new Ring{ringName, ringSize, true, _sockets[peer]});
+        }
+        _synchronize(localPeers);
+        for (auto peer : localPeers)
+        {
+            const auto ringName = name(rank, peer);
+            _sendRings[peer].reset(
+                new Ring{ringName, ringSize, false, _sockets[peer]});
+        }
+        _synchronize(localPeers);
+        for (auto peer : localPeers)
+            _receiveRings[peer]->unlink();
+    }
+
+    void _synchronize(const std::vector<int>& peers)
+    {
+        const char ready = 1;
+        for (auto peer : peers)
+            _write(_sockets[peer], ready);
+        char signal = 0;
+        for (auto peer : peers)
+            _read(_sockets[peer], signal);
+    }
+
+    void _readMessages()
+    {
+        std::vector<int> sources;
+        for (int i = 0; i < size; ++i)
+        {
+            if (_sockets[i] >= 0)
+                sources.push_back(i);
+        }
+        std::vector<char> closed(sources.size(), false);
+        std::vector<pollfd> fds(sources.size() + 1);
+
+        while (true)
+        {
+            // Sources closed by their peer or with too many pending messages
+            // are ignored by poll, so the peers block once their socket
+            // buffers are full.
+            fds[0] = {_wakeup[0], POLLIN, 0};
+            for (size_t i = 0; i < sources.size(); ++i)
+            {
+                const auto src = sources[i];
+                const bool paused = closed[i] || inbox.isFull(src);
+                fds[i + 1] = {paused ? -1 : _sockets[src], POLLIN, 0};
+            }
+
+            if (::poll(fds.data(), fds.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return;
+            }
+            if (fds[0].revents)
+            {
+                char signal = quitSignal;
+                if (::read(_wakeup[0], &signal, 1) == 1 &&
+                    signal == resumeSignal)
+                {
+                    continue;
+                }
+                return;
+            }
+            for (size_t i = 0; i < sources.size(); ++i)
+            {
+                if (fds[i + 1].revents && !_readMessage(sources[i]))
+                    closed[i] = true;
+            }
+        }
+    }
+
+    bool _readMessage(const int src)
+    {
+        FrameHeader header;
+        const auto fd = _sockets[src];
+        if (!_readAll(fd, (char*)&header, sizeof(header)))
+            return false;
+
+        Message message{header.context, src, header.tag,
+                        std::vector<char>(header.size)};
+        if (header.inRing)
+        {
+            if (!_receiveRings[src])
+                return false;
+            try
+            {
+                _receiveRings[src]->read(message.data.data(), header.size);
+            }
+            catch (const std::runtime_error&)
+            {
+                return false; // the writer is gone
+            }
+        }
+        else if (!_readAll(fd, message.data.data(), header.size))
+            return false;
+
+        inbox.push(std::move(message));
+        return true;
+    }
+};
+
+SocketTransport::SocketTransport(const int rank, const int size,
+                                 const std::string& rootHost,
+                                 const uint16_t rootPort)
+    : SocketTransport{rank, size, rootHost, rootPort, Options()}
+{
+}
+
+SocketTransport::SocketTransport(const int rank, const int size,
+                                 const std::string& rootHost,
+                                 const uint16_t rootPort,
+                                 const Options& options)
+    : SocketTransport{std::make_shared<Network>(rank, size, rootHost, rootPort,
+                                                -1, options),
+                      0, _range(size)}
+{
+}
+
+SocketTransport::SocketTransport(Listener listener, const int size,
+                                 const Options& options)
+    : SocketTransport{std::make_shared<Network>(0, size, "",
+                                                listener.getPort(),
+                                                listener._fd, options),
+                      0, _range(size)}
+{
+}
+
+SocketTransport::Listener::Listener(const uint16_t port)
+    : _fd{_listen(port, SOMAXCONN)}
+{
+}
+
+SocketTransport::Listener::Listener(Listener&& other)
+    : _fd{other._fd}
+{
+    other._fd = -1;
+}
+
+SocketTransport::Listener::~Listener()
+{
+    if (_fd >= 0)
+        ::close(_fd);
+}
+
+uint16_t SocketTransport::Listener::getPort() const
+{
+    return _getPort(_fd);
+}
+
+SocketTransport::SocketTransport(std::shared_ptr<Network> network,
+                                 const uint64_t context,
+                                 std::vector<int> members)
+    : _network{std::move(network)}
+    , _context{context}
+    , _members{std::move(members)}
+    , _rank{_getGroupRank(_network->rank)}
+{
+}
+
+SocketTransport::~SocketTransport() = default;
+
+int SocketTransport::getRank() const
+{
+    return _rank;
+}
+
+int SocketTransport::getSize() const
+{
+    return _members.size();
+}
+
+std::unique_ptr<Transport> SocketTransport::split(const int color) const
+{
+    return _split(color);
+}
+
+std::unique_ptr<Transport> SocketTransport::splitByHost() const
+{
+    // The color is the lowest rank on the host
+    const auto& hosts = _network->hosts;
+    const auto& host = hosts[_network->rank];
+    int color = 0;
+    while (hosts[_members[color]] != host)
+        ++color;
+    return _split(color);
+}
+
+void SocketTransport::send(const std::vector<Block>& blocks, const int dest,
+                           const int tag, Waiter&)
+{
+    // Sockets block in the kernel until the data is buffered
+    _send(blocks, dest, tag);
+}
+
+ProbeResult SocketTransport::probe(const int src, const int tag,
+                                   Waiter& waiter)
+{
+    const auto source = src == anySource ? anySource : _members.at(src);
+    int messageSource = -1;
+    size_t size = 0;
+    int messageTag = 0;
+    waiter.wait([&] {
+        return _network->inbox.probe(_context, source, tag, messageSource,
+                                     size, messageTag);
+    });
+    return ProbeResult{_getGroupRank(messageSource), int(size),
+                       MessageType(messageTag)};
+}
+
+void SocketTransport::receive(char* data, const size_t size, const int src,
+                              const int tag, Waiter& waiter)
+{
+    _copy(_receive(src, tag, &waiter), {Block{data, size}});
+}
+
+void SocketTransport::broadcast(char* data, const size_t size, const int root,
+                                Waiter& waiter)
+{
+    const auto tree = _makeTree(_rank, getSize(), root);
+    if (tree.parent >= 0)
+        _copy(_receive(tree.parent, broadcastTag, &waiter), {{data, size}});
+    for (auto child : tree.children)
+        _send({Block{data, size}}, child, broadcastTag);
+}
+
+void SocketTransport::broadcast(const std::vector<Block>& blocks,
+                                const size_t size, const int root,
+                                size_t segmentSize, size_t,
+                                const SegmentCallback& callback)
+{
+    // The segments are forwarded down the tree as soon as they are received.
+    // Sending does not wait for the receivers, so there is no limit on the
+    // number of segments in flight.
+    if (segmentSize == 0)
+        segmentSize = size;
+
+    const auto tree = _makeTree(_rank, getSize(), root);
+    for (size_t offset = 0; offset < size; offset += segmentSize)
+    {
+        const auto count = std::min(segmentSize, size - offset);
+        const auto segment = _slice(blocks, offset, count);
+        if (tree.parent >= 0)
+            _copy(_receive(tree.parent, broadcastTag, nullptr), segment);
+        for (auto child : tree.children)
+            _send(segment, child, broadcastTag);
+        if (callback)
+            callback(offset, count);
+    }
+}
+
+void SocketTransport::scatter(
+    const std::vector<std::vector<Block>>& messages)
+{
+    for (int i = 0; i < getSize(); ++i)
+    {
+        if (i != _rank)
+            _send(messages[i], i, scatterTag);
+    }
+}
+
+void SocketTransport::receiveScatter(const int root, const Allocator& allocate)
+{
+    const auto message = _receive(root, scatterTag, nullptr);
+    const auto data = allocate(message.size());
+    if (!message.empty())
+        std::memcpy(data, message.data(), message.size());
+}
+
+void SocketTransport::barrier() const
+{
+    const auto size = getSize();
+    if (_rank == 0)
+    {
+        for (int i = 1; i < size; ++i)
+            _receive(i, barrierTag, nullptr);
+        for (int i = 1; i < size; ++i)
+            _send({}, i, barrierTag);
+    }
+    else
+    {
+        _send({}, 0, barrierTag);
+        _receive(0, barrierTag, nullptr);
+    }
+}
+
+int SocketTransport::allreduce(const int value,
+                               const Operation operation) const
+{
+    const auto values = allgather({uint64_t(int64_t(value))});
+    int result = int(int64_t(values[0]));
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        const auto other = int(int64_t(values[i]));
+        if (operation == Operation::max)
+            result = std::max(result, other);
+        else
+            result += other;
+    }
+    return result;
+}
+
+std::vector<uint64_t> SocketTransport::gather(
+    const std::vector<uint64_t>& values, const int root) const
+{
+    const auto bytes = values.size() * sizeof(uint64_t);
+    if (_rank != root)
+    {
+        _send({Block{(char*)values.data(), bytes}}, root, gatherTag);
+        return {};
+    }
+
+    std::vector<uint64_t> results(values.size() * getSize());
+    for (int i = 0; i < getSize(); ++i)
+    {
+        const auto target = (char*)(results.data() + i * values.size());
+        if (i == _rank)
+            std::memcpy(target, values.data(), bytes);
+        else
+            _copy(_receive(i, gatherTag, nullptr), {Block{target, bytes}});
+    }
+    return results;
+}
+
+std::vector<uint64_t> SocketTransport::allgather(
+    const std::vector<uint64_t>& values) const
+{
+    return allgatherVariable(values);
+}
+
+std::vector<uint64_t> SocketTransport::allgatherVariable(
+    const std::vector<uint64_t>& values) const
+{
+    const auto bytes = values.size() * sizeof(uint64_t);
+    const auto local = Block{(char*)values.data(), bytes};
+
+    // Gather on the first process, which broadcasts the result
+    std::vector<char> message;
+    if (_rank == 0)
+    {
+        message.assign(local.first, local.first + local.second);
+        for (int i = 1; i < getSize(); ++i)
+        {
+            const auto data = _receive(i, gatherTag, nullptr);
+            message.insert(message.end(), data.begin(), data.end());
+        }
+    }
+    else
+        _send({local}, 0, gatherTag);
+
+    message = _broadcastMessage(std::move(message));
+
+    std::vector<uint64_t> results(message.size() / sizeof(uint64_t));
+    std::memcpy(results.data(), message.data(), message.size());
+    return results;
+}
+
+std::vector<uint64_t> SocketTransport::allgatherVariable(
+    const std::vector<uint64_t>& values, const std::vector<int>& counts,
+    const std::vector<int>& offsets) const
+{
+    // The messages carry their size, so the counts are only used to place
+    // the values of each process
+    const auto gathered = allgatherVariable(values);
+
+    size_t size = 0;
+    for (int i = 0; i < getSize(); ++i)
+        size = std::max(size, size_t(offsets[i] + counts[i]));
+
+    std::vector<uint64_t> results(size);
+    auto source = gathered.begin();
+    for (int i = 0; i < getSize(); ++i)
+    {
+        if (source + counts[i] > gathered.end())
+            throw std::runtime_error("incorrect values count");
+        std::copy_n(source, counts[i], results.begin() + offsets[i]);
+        source += counts[i];
+    }
+    return results;
+}
+
+std::unique_ptr<Transport> SocketTransport::_split(const int color) const
+{
+    const auto colors = allgather({uint64_t(int64_t(color))});
+
+    std::vector<int> members;
+    for (size_t i = 0; i < colors.size(); ++i)
+    {
+        if (int64_t(colors[i]) == color)
+            members.push_back(_members[i]);
+    }
+    const auto context = _makeContext(_context, ++_splitCount);
+    return std::unique_ptr<Transport>{
+        new SocketTransport{_network, context, std::move(members)}};
+}
+
+void SocketTransport::_send(const std::vector<Block>& blocks, const int dest,
+                            const int tag) const
+{
+    _network->send(_members.at(dest), _context, tag, blocks);
+}
+
+std::vector<char> SocketTransport::_receive(const int src, const int tag,
+                                            Waiter* waiter) const
+{
+    const auto source = _members.at(src);
+    auto& inbox = _network->inbox;
+    if (!waiter)
+        return inbox.take(_context, source, tag);
+
+    std::vector<char> data;
+    waiter->wait([&] { return inbox.tryTake(_context, source, tag, data); });
+    return data;
+}
+
+std::vector<char> SocketTransport::_broadcastMessage(
+    std::vector<char> message) const
+{
+    const auto tree = _makeTree(_rank, getSize(), 0);
+    if (tree.parent >= 0)
+        message = _receive(tree.parent, broadcastTag, nullptr);
+    for (auto child : tree.children)
+        _send({Block{message.data(), message.size()}}, child, broadcastTag);
+    return message;
+}
+
+int SocketTransport::_getGroupRank(const int globalRank) const
+{
+    const auto it = std::find(_members.begin(), _members.end(), globalRank);
+    return it != _members.end() ? int(it - _members.begin()) : -1;
+}
@@ -0,0 +1,216 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SOCKETTRANSPORT_H
+#define SOCKETTRANSPORT_H
+
+#include "network/Transport.h"
+
+#include <string>
+
+/**
+ * Transport over TCP sockets, for processes started without MPI.
+ *
+ * All processes are connected to each other, after registering with the
+ * process of rank 0 which listens on a known address. A background thread
+ * receives the incoming messages and queues them until they are probed or
+ * received, up to a limit per process (see Options::inboxCapacity).
+ * Collective operations are built on point-to-point messages.
+ *
+ * Large messages between processes on the same host are copied through a ring
+ * buffer in POSIX shared memory, and only announced on the socket.
+ */
+class SocketTransport : public Transport
+{
+public:
+    /** Default size of the shared memory ring to each local peer [bytes]. */
+    static constexpr size_t defaultRingSize = 4 * 1024 * 1024;
+
+    /** Minimum size of a message to send it through shared memory [bytes]. */
+    static constexpr size_t ringThreshold = 64 * 1024;
+
+    /** Default limit of the pending messages from each process [bytes]. */
+    static constexpr size_t defaultInboxCapacity = 256 * 1024 * 1024;
+
+    /** Optional settings of the transport. */
+    struct Options
+    {
+        /**
+         * Size of the shared memory ring to each process on the same host,
+         * 0 to use only the sockets.
+         */
+        size_t ringSize = defaultRingSize;
+
+        /**
+         * Size of the messages from one process which can wait to be
+         * received. Above it, no more messages are read from that process
+         * until some of them are received, which eventually blocks it in
+         * send() like a standard mode MPI send. The last message read may
+         * exceed the limit.
+         */
+        size_t inboxCapacity = defaultInboxCapacity;
+
+        /**
+         * Name of the host of this process, which groups the processes in
+         * splitByHost() and for the shared memory rings. Empty to use the
+         * name of the system.
+         */
+        std::string hostName;
+    };
+
+    /**
+     * The socket on which the process of rank 0 accepts the other processes.
+     *
+     * Opening it before the transport lets the system choose a free port,
+     * which can then be passed to the other processes.
+     */
+    class Listener
+    {
+    public:
+        /**
+         * Listen for the other processes.
+         * @param port The port to listen on, 0 to let the system choose one.
+         * @throw std::runtime_error if the port could not be opened.
+         */
+        explicit Listener(uint16_t port = 0);
+
+        Listener(Listener&& other);
+        Listener(const Listener&) = delete;
+        Listener& operator=(const Listener&) = delete;
+
+        /** Close the socket. */
+        ~Listener();
+
+        /** @return the port on which the other processes can connect. */
+        uint16_t getPort() const;
+
+    private:
+        friend class SocketTransport;
+        int _fd = -1;
+    };
+
+    /**
+     * Connect all the processes of the program (blocking).
+     *
+     * @param rank The rank of this process.
+     * @param size The number of processes.
+     * @param rootHost The host of the process of rank 0, reachable by all.
+     * @param rootPort The port on which the process of rank 0 listens.
+     * @throw std::runtime_error if the processes could not be connected.
+     */
+    SocketTransport(int rank, int size, const std::string& rootHost,
+                    uint16_t rootPort);
+
+    /**
+     * Connect all the processes of the program (blocking).
+     *
+     * @param rank The rank of this process.
+     * @param size The number of processes.
+     * @param rootHost The host of the process of rank 0, reachable by all.
+     * @param rootPort The port on which the process of rank 0 listens.
+     * @param options The settings of the transport, identical on all
+     *        processes.
+     * @throw std::runtime_error if the processes could not be connected.
+     */
+    SocketTransport(int rank, int size, const std::string& rootHost,
+                    uint16_t rootPort, const Options& options);
+
+    /**
+     * Connect all the processes of the program as the process of rank 0
+     * (blocking).
+     *
+     * @param listener The socket on which the other processes connect.
+     * @param size The number of processes.
+     * @param options The settings of the transport, identical on all
+     *        processes.
+     * @throw std::runtime_error if the processes could not be connected.
+     */
+    SocketTransport(Listener listener, int size, const Options& options);
+
+    ~SocketTransport();
+
+    int getRank() const final;
+    int getSize() const final;
+
+    std::unique_ptr<Transport> split(int color) const final;
+    std::unique_ptr<Transport> splitByHost() const final;
+
+    void send(const std::vector<Block>& blocks, int dest, int tag,
+              Waiter& waiter) final;
+    ProbeResult probe(int src, int tag, Waiter& waiter) final;
+    void receive(char* data, size_t size, int src, int tag,
+                 Waiter& waiter) final;
+
+    void broadcast(char* data, size_t size, int root, Waiter& waiter) final;
+    void broadcast(const std::vector<Block>& blocks, size_t size, int root,
+                   size_t segmentSize, size_t segmentsInFlight,
+                   const SegmentCallback& callback) final;
+    void scatter(const std::vector<std::vector<Block>>& messages) final;
+    void receiveScatter(int root, const Allocator& allocate) final;
+    void barrier() const final;
+    int allreduce(int value, Operation operation) const final;
+    std::vector<uint64_t> gather(const std::vector<uint64_t>& values,
+                                 int root) const final;
+    std::vector<uint64_t> allgather(
+        const std::vector<uint64_t>& values) const final;
+    std::vector<uint64_t> allgatherVariable(
+        const std::vector<uint64_t>& values) const final;
+    std::vector<uint64_t> allgatherVariable(
+        const std::vector<uint64_t>& values, const std::vector<int>& counts,
+        const std::vector<int>& offsets) const final;
+
+private:
+    class Network;
+    std::shared_ptr<Network> _network;
+    uint64_t _context = 0;
+    std::vector<int> _members; // global rank of each process of the group
+    int _rank = -1;
+    mutable uint64_t _splitCount = 0;
+
+    SocketTransport(std::shared_ptr<Network> network, uint64_t context,
+                    std::vector<int> members);
+
+    std::unique_ptr<Transport> _split(int color) const;
+    void _send(const std::vector<Block>& blocks, int dest, int tag) const;
+    std::vector<char> _receive(int src, int tag, Waiter* waiter) const;
+    std::vector<char> _broadcastMessage(std::vector<char> message) const;
+    int _getGroupRank(int globalRank) const;
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "Transport.h"
+
+#include "MPITransport.h"
+#include "SocketTransport.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+const uint16_t defaultRootPort = 1701;
+
+std::string _getEnv(const char* name, const std::string& defaultValue = {})
+{
+    const auto value = std::getenv(name);
+    return value ? std::string{value} : defaultValue;
+}
+
+int _getEnvInt(const char* name)
+{
+    const auto value = _getEnv(name);
+    if (value.empty())
+        throw std::runtime_error(std::string{name} + " is not set");
+    return std::stoi(value);
+}
+}
+
+std::unique_ptr<Transport> Transport::create(int argc, char* argv[])
+{
+    const auto type = _getEnv("TIDE_TRANSPORT", "mpi");
+    if (type == "mpi")
+        return std::unique_ptr<Transport>{new MPITransport{argc, argv}};
+
+    if (type == "tcp")
+    {
+        const auto rank = _getEnvInt("TIDE_RANK");
+        const auto size = _getEnvInt("TIDE_SIZE");
+
+        auto host = _getEnv("TIDE_ROOT", "localhost");
+        auto port = defaultRootPort;
+        const auto separator = host.rfind(':');
+        if (separator != std::string::npos)
+        {
+            port = std::stoi(host.substr(separator + 1));
+            host = host.substr(0, separator);
+        }
+        return std::unique_ptr<Transport>{
+            new SocketTransport{rank, size, host, port}};
+    }
+    throw std::runtime_error("unknown TIDE_TRANSPORT: " + type);
+}
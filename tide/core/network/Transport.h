@@ -0,0 +1,271 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include "network/MessageHeader.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class Waiter;
+
+/**
+ * The result of a probe operation on the network communicator.
+ */
+struct ProbeResult
+{
+    /** The source process that has sent a message */
+    const int src;
+
+    /** The size of the message */
+    const int size;
+
+    /** The type of the message */
+    const MessageType messageType;
+
+    /** @return True if the probe was successful and receive() is safe */
+    bool isValid() const { return size >= 0; }
+};
+
+/**
+ * Point-to-point and collective communication between a group of processes.
+ *
+ * This is the interface between the MPICommunicator and the underlying network
+ * library. Point-to-point operations may be called concurrently from different
+ * threads; collective operations must be called in the same order by all the
+ * processes of the group, from one thread at a time.
+ */
+class Transport
+{
+public:
+    /** A contiguous part of a message. */
+    using Block = std::pair<char*, size_t>;
+
+    /** @return the buffer in which to receive a message of the given size. */
+    using Allocator = std::function<char*(size_t size)>;
+
+    /**
+     * Callback for a received segment of a broadcast payload.
+     * @param offset The offset of the segment in the payload
+     * @param size The size of the segment
+     */
+    using SegmentCallback = std::function<void(size_t offset, size_t size)>;
+
+    /** Reduction operations of allreduce(). */
+    enum class Operation
+    {
+        sum,
+        max
+    };
+
+    /** Match messages from any source process in probe(). */
+    static constexpr int anySource = -1;
+
+    /** Match messages with any (non-negative) tag in probe(). */
+    static constexpr int anyTag = -1;
+
+    /**
+     * Create the transport between all the processes of the program.
+     *
+     * The implementation is selected at launch with the TIDE_TRANSPORT
+     * environment variable:
+     * - "mpi" (default): MPI, for processes started with mpiexec.
+     * - "tcp": TCP sockets and shared memory between processes on the same
+     *   host, for processes started individually with TIDE_RANK, TIDE_SIZE
+     *   and TIDE_ROOT ("host:port" where the process of rank 0 listens).
+     *
+     * This function should only be called once per program.
+     * @param argc main program arguments count
+     * @param argv main program arguments
+     * @throw std::runtime_error if the transport could not be initialized.
+     */
+    static std::unique_ptr<Transport> create(int argc, char* argv[]);
+
+    virtual ~Transport() = default;
+
+    /** @return the rank of this process in the group. */
+    virtual int getRank() const = 0;
+
+    /** @return the number of processes in the group. */
+    virtual int getSize() const = 0;
+
+    /**
+     * Split the group (collective).
+     * @param color All processes with the same color belong to the same group,
+     *        ordered according to their rank in this group.
+     * @return the new group of this process.
+     */
+    virtual std::unique_ptr<Transport> split(int color) const = 0;
+
+    /**
+     * Split the group by host (collective).
+     * @return the group of the processes running on the same host as this one.
+     */
+    virtual std::unique_ptr<Transport> splitByHost() const = 0;
+
+    /** @name Point-to-point communication. */
+    //@{
+    /**
+     * Send a message to another process.
+     * @param blocks The parts of the message, sent in order.
+     * @param dest The destination process.
+     * @param tag The tag of the message (non-negative).
+     * @param waiter Used to wait for the completion of the send.
+     */
+    virtual void send(const std::vector<Block>& blocks, int dest, int tag,
+                      Waiter& waiter) = 0;
+
+    /**
+     * Wait for a message.
+     * @param src The source process, or anySource.
+     * @param tag The tag of the message, or anyTag.
+     * @param waiter Used to wait for an incoming message.
+     * @return the source, size and tag of the first matching message.
+     */
+    virtual ProbeResult probe(int src, int tag, Waiter& waiter) = 0;
+
+    /**
+     * Receive a message.
+     * @param data The target buffer.
+     * @param size The size of the message.
+     * @param src The source process.
+     * @param tag The tag of the message.
+     * @param waiter Used to wait for the message.
+     */
+    virtual void receive(char* data, size_t size, int src, int tag,
+                         Waiter& waiter) = 0;
+    //@}
+
+    /** @name Collective communication. */
+    //@{
+    /**
+     * Broadcast a small message, waiting for it without blocking a core.
+     * @param data The message on the root, the target buffer on the others.
+     * @param size The size of the message.
+     * @param root The process which sends the message.
+     * @param waiter Used to wait for the completion of the broadcast.
+     */
+    virtual void broadcast(char* data, size_t size, int root,
+                           Waiter& waiter) = 0;
+
+    /**
+     * Broadcast a large message in place.
+     * @param blocks The parts of the message on the root, the target buffers
+     *        on the others.
+     * @param size The total size of the message.
+     * @param root The process which sends the message.
+     * @param segmentSize Pipeline the message in segments of this size,
+     *        0 to send it at once.
+     * @param segmentsInFlight The maximum number of pending segments.
+     * @param callback Called in order for each segment once it is received,
+     *        may be empty.
+     */
+    virtual void broadcast(const std::vector<Block>& blocks, size_t size,
+                           int root, size_t segmentSize,
+                           size_t segmentsInFlight,
+                           const SegmentCallback& callback) = 0;
+
+    /**
+     * Send a different message to each of the other processes.
+     *
+     * Called by the root process, the others call receiveScatter().
+     * @param messages The parts of the message to each process, ordered by
+     *        rank. The message to the calling process is ignored.
+     */
+    virtual void scatter(const std::vector<std::vector<Block>>& messages) = 0;
+
+    /**
+     * Receive the message scattered by the root process.
+     * @param root The process which calls scatter().
+     * @param allocate Called once with the size of the message to get the
+     *        buffer in which to receive it.
+     */
+    virtual void receiveScatter(int root, const Allocator& allocate) = 0;
+
+    /** Block until all the processes have reached the barrier. */
+    virtual void barrier() const = 0;
+
+    /** @return the reduction of the values of all processes. */
+    virtual int allreduce(int value, Operation operation) const = 0;
+
+    /**
+     * Gather the values of all processes on one process.
+     * @param values The local values, the same count on all processes.
+     * @param root The process which receives the values.
+     * @return on root, the values of all processes ordered by rank; an empty
+     *         vector on the other processes.
+     */
+    virtual std::vector<uint64_t> gather(const std::vector<uint64_t>& values,
+                                         int root) const = 0;
+
+    /**
+     * Gather the values of all processes on all processes.
+     * @param values The local values, the same count on all processes.
+     * @return the values of all processes, ordered by rank.
+     */
+    virtual std::vector<uint64_t> allgather(
+        const std::vector<uint64_t>& values) const = 0;
+
+    /**
+     * Gather a variable number of values of all processes on all processes.
+     * @param values The local values, the count may differ between processes.
+     * @return the values of all processes, concatenated in rank order.
+     */
+    virtual std::vector<uint64_t> allgatherVariable(
+        const std::vector<uint64_t>& values) const = 0;
+
+    /**
+     * Gather a variable number of values of all processes on all processes,
+     * when all processes know the count of each one.
+     * @param values The local values, counts[getRank()] of them.
+     * @param counts The number of values of each process.
+     * @param offsets The position of the values of each process in the
+     *        result.
+     * @return the values of all processes, each at its offset.
+     */
+    virtual std::vector<uint64_t> allgatherVariable(
+        const std::vector<uint64_t>& values, const std::vector<int>& counts,
+        const std::vector<int>& offsets) const = 0;
+    //@}
+};
+
+#endif
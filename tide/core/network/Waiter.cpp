@@ -0,0 +1,195 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "Waiter.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+const std::chrono::nanoseconds backoffStart{1000};
+const std::chrono::nanoseconds backoffMax{100000};
+
+// Time spent spinning before yielding with WaitPolicy::spinThenYield.
+const std::chrono::nanoseconds spinBeforeYield{20000};
+
+// Bounds of the spinning time of WaitPolicy::adaptive; long waits (such as
+// waiting for the next message while idle) should sleep rather than spin.
+const std::chrono::nanoseconds adaptiveSpinMin{2000};
+const std::chrono::nanoseconds adaptiveSpinMax{200000};
+
+// Inverse weight of a new wait in the moving average of WaitPolicy::adaptive
+const int64_t adaptiveAverageWeight = 8;
+}
+
+constexpr size_t WaitHistogram::bucketsCount;
+
+void WaitHistogram::add(const std::chrono::nanoseconds duration)
+{
+    ++_buckets[getBucket(duration)];
+}
+
+size_t WaitHistogram::getCount() const
+{
+    size_t count = 0;
+    for (const auto& bucket : _buckets)
+        count += bucket;
+    return count;
+}
+
+size_t WaitHistogram::getCount(const size_t bucket) const
+{
+    return bucket < bucketsCount ? _buckets[bucket].load() : 0;
+}
+
+size_t WaitHistogram::getBucket(const std::chrono::nanoseconds duration)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration)
+                  .count();
+    size_t bucket = 0;
+    while (us > 0 && bucket < bucketsCount - 1)
+    {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+std::string WaitHistogram::toString() const
+{
+    std::ostringstream stream;
+    for (size_t i = 0; i < bucketsCount; ++i)
+    {
+        const auto count = _buckets[i].load();
+        if (count == 0)
+            continue;
+        if (stream.tellp() > 0)
+            stream << " ";
+        if (i == bucketsCount - 1)
+            stream << ">";
+        stream << (size_t(1) << (i == bucketsCount - 1 ? i - 1 : i)) << "us:"
+               << count;
+    }
+    return stream.str();
+}
+
+Waiter::TimeSource Waiter::TimeSource::system()
+{
+    return {&clock::now,
+            [](const std::chrono::nanoseconds duration) {
+                std::this_thread::sleep_for(duration);
+            },
+            &std::this_thread::yield};
+}
+
+Waiter::Waiter(const WaitPolicy policy, TimeSource time)
+    : _time{std::move(time)}
+    , _policy{policy}
+{
+}
+
+void Waiter::setPolicy(const WaitPolicy policy)
+{
+    _policy = policy;
+}
+
+WaitPolicy Waiter::getPolicy() const
+{
+    return _policy;
+}
+
+const WaitHistogram& Waiter::getHistogram() const
+{
+    return _histogram;
+}
+
+std::chrono::nanoseconds Waiter::getExpectedWait() const
+{
+    return std::chrono::nanoseconds{_expectedWaitNs.load()};
+}
+
+std::chrono::nanoseconds Waiter::_getSpinDuration() const
+{
+    switch (_policy)
+    {
+    case WaitPolicy::spinThenYield:
+        return spinBeforeYield;
+    case WaitPolicy::adaptive:
+        // Spin a bit longer than the typical wait to catch most completions
+        return std::min(std::max(2 * getExpectedWait(), adaptiveSpinMin),
+                        adaptiveSpinMax);
+    default:
+        return std::chrono::nanoseconds{0};
+    }
+}
+
+void Waiter::_pause(State& state) const
+{
+    switch (state.policy)
+    {
+    case WaitPolicy::spin:
+        return;
+    case WaitPolicy::spinThenYield:
+        if (_time.now() - state.start >= state.spinDuration)
+            _time.yield();
+        return;
+    case WaitPolicy::adaptive:
+        if (_time.now() - state.start < state.spinDuration)
+            return;
+    // fall through
+    case WaitPolicy::backoff:
+    default:
+        state.sleep = std::min(std::max(2 * state.sleep, backoffStart),
+                               backoffMax);
+        _time.sleep(state.sleep);
+        return;
+    }
+}
+
+void Waiter::_record(const std::chrono::nanoseconds duration)
+{
+    _histogram.add(duration);
+
+    // Exponential moving average, updated by a single thread per call site
+    const auto expected = _expectedWaitNs.load();
+    const auto delta = duration.count() - expected;
+    _expectedWaitNs = expected + delta / adaptiveAverageWeight;
+}
@@ -0,0 +1,151 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef WAITER_H
+#define WAITER_H
+
+#include "types.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+
+/**
+ * Histogram of wait durations, in power-of-two microsecond buckets.
+ *
+ * Bucket 0 counts waits below 1 us, bucket i counts waits in [2^(i-1), 2^i) us
+ * and the last bucket all the longer waits.
+ */
+class WaitHistogram
+{
+public:
+    static constexpr size_t bucketsCount = 20;
+
+    /** Add a wait duration to the histogram. */
+    void add(std::chrono::nanoseconds duration);
+
+    /** @return the total number of waits. */
+    size_t getCount() const;
+
+    /** @return the number of waits in a bucket. */
+    size_t getCount(size_t bucket) const;
+
+    /** @return the bucket of a given wait duration. */
+    static size_t getBucket(std::chrono::nanoseconds duration);
+
+    /** @return the non-empty buckets as "<upper bound>us:<count>" strings. */
+    std::string toString() const;
+
+private:
+    std::array<std::atomic<size_t>, bucketsCount> _buckets{};
+};
+
+/**
+ * Wait for the completion of an operation according to a WaitPolicy.
+ *
+ * One waiter should be used per call site, so that the wait histogram and the
+ * completion time learned by the adaptive policy are specific to it.
+ */
+class Waiter
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /** The time functions used to wait, replaceable for testing. */
+    struct TimeSource
+    {
+        std::function<clock::time_point()> now;
+        std::function<void(std::chrono::nanoseconds)> sleep;
+        std::function<void()> yield;
+
+        /** @return the functions of the system clock and scheduler. */
+        static TimeSource system();
+    };
+
+    /** Create a waiter with an initial policy. */
+    explicit Waiter(WaitPolicy policy = WaitPolicy::backoff,
+                    TimeSource time = TimeSource::system());
+
+    /** Change the wait policy; safe to call during a wait. */
+    void setPolicy(WaitPolicy policy);
+
+    /** @return the current wait policy. */
+    WaitPolicy getPolicy() const;
+
+    /**
+     * Wait until an operation is complete.
+     * @param isComplete test for the completion of the operation.
+     */
+    template <typename Test>
+    void wait(const Test& isComplete)
+    {
+        State state{_policy.load(), _time.now(), _getSpinDuration()};
+        while (!isComplete())
+            _pause(state);
+        _record(_time.now() - state.start);
+    }
+
+    /** @return the histogram of the recorded waits. */
+    const WaitHistogram& getHistogram() const;
+
+    /** @return the typical completion time, learned from previous waits. */
+    std::chrono::nanoseconds getExpectedWait() const;
+
+private:
+    struct State
+    {
+        WaitPolicy policy;
+        clock::time_point start;
+        std::chrono::nanoseconds spinDuration;
+        std::chrono::nanoseconds sleep{0};
+    };
+
+    const TimeSource _time;
+    std::atomic<WaitPolicy> _policy;
+    std::atomic<int64_t> _expectedWaitNs{0};
+    WaitHistogram _histogram;
+
+    std::chrono::nanoseconds _getSpinDuration() const;
+    void _pause(State& state) const;
+    void _record(std::chrono::nanoseconds duration);
+};
+
+#endif
@@ -0,0 +1,132 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef WALLTELEMETRY_H
+#define WALLTELEMETRY_H
+
+#include "serialization/includes.h"
+
+#include <cstdint>
+
+/**
+ * Performance counters of a wall process over a reporting period.
+ *
+ * Sent periodically by each wall process to the master application. All
+ * durations are in milliseconds.
+ */
+struct WallTelemetry
+{
+    /** Index of the wall process. */
+    int32_t rank = -1;
+
+    /** Duration of the reporting period. */
+    float period = 0.f;
+
+    /** Number of frames rendered during the period. */
+    uint32_t frames = 0;
+
+    /** @name Time to synchronize and render a frame. */
+    //@{
+    float frameTimeMean = 0.f;
+    float frameTimeP50 = 0.f;
+    float frameTimeP90 = 0.f;
+    float frameTimeP99 = 0.f;
+    float frameTimeMax = 0.f;
+    //@}
+
+    /** @name Time spent in the frame synchronization with other processes. */
+    //@{
+    float syncWaitMean = 0.f;
+    float syncWaitMax = 0.f;
+    //@}
+
+    /** @name Time spent in the swap barrier by the render threads. */
+    //@{
+    float swapWaitMean = 0.f;
+    float swapWaitMax = 0.f;
+    //@}
+
+    /** @name Tile images loaded (decoded) during the period. */
+    //@{
+    uint32_t tilesLoaded = 0;
+    float decodeTimeMean = 0.f;
+    float decodeTimeMax = 0.f;
+    //@}
+
+    /** Number of tile images waiting to be loaded at the end of the period. */
+    uint32_t tileQueueDepth = 0;
+
+    /** Memory used by the tile cache at the end of the period [bytes]. */
+    uint64_t cacheBytes = 0;
+
+    /** @return the frames per second over the period. */
+    float getFps() const
+    {
+        return period > 0.f ? frames * 1000.f / period : 0.f;
+    }
+
+    /** @return the mean time of a frame not spent waiting for the others. */
+    float getWorkTimeMean() const { return frameTimeMean - syncWaitMean; }
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        // clang-format off
+        ar & rank;
+        ar & period;
+        ar & frames;
+        ar & frameTimeMean;
+        ar & frameTimeP50;
+        ar & frameTimeP90;
+        ar & frameTimeP99;
+        ar & frameTimeMax;
+        ar & syncWaitMean;
+        ar & syncWaitMax;
+        ar & swapWaitMean;
+        ar & swapWaitMax;
+        ar & tilesLoaded;
+        ar & decodeTimeMean;
+        ar & decodeTimeMax;
+        ar & tileQueueDepth;
+        ar & cacheBytes;
+        // clang-format on
+    }
+};
+
+#endif
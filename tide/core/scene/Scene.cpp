@@ -62,6 +62,11 @@ ScenePtr Scene::create(DisplayGroupPtr group)
     return ScenePtr{new Scene{{std::move(group)}}};
 }
 
+ScenePtr Scene::create(std::vector<SurfacePtr> surfaces)
+{
+    return ScenePtr{new Scene{std::move(surfaces)}};
+}
+
 Scene::Scene(const std::vector<SurfaceConfig>& surfaces)
 {
     size_t index = 0;
@@ -82,6 +87,12 @@ Scene::Scene(const std::vector<DisplayGroupPtr>& groups)
     _forwardSignals();
 }
 
+Scene::Scene(std::vector<SurfacePtr> surfaces)
+    : _surfaces{std::move(surfaces)}
+{
+    _forwardSignals();
+}
+
 Scene::~Scene()
 {
     for (auto&& surface : _surfaces)
@@ -67,6 +67,7 @@ public:
     static ScenePtr create(const std::vector<SurfaceConfig>& surfaces);
     static ScenePtr create(const std::vector<DisplayGroupPtr>& groups);
     static ScenePtr create(DisplayGroupPtr group);
+    static ScenePtr create(std::vector<SurfacePtr> surfaces);
 
     /** Destructor. */
     ~Scene();
@@ -140,6 +141,7 @@ private:
     Scene() = default;
     Scene(const std::vector<SurfaceConfig>& surfaces);
     Scene(const std::vector<DisplayGroupPtr>& groups);
+    Scene(std::vector<SurfacePtr> surfaces);
 
     void _forwardSignals();
     void _forwardSceneModifiedSignals();
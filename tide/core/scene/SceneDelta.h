@@ -0,0 +1,122 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SCENEDELTA_H
+#define SCENEDELTA_H
+
+#include "scene/Background.h"
+#include "scene/ContextMenu.h"
+#include "scene/Scene.h"
+#include "scene/Window.h"
+#include "serialization/includes.h"
+#include "types.h"
+
+/**
+ * The layout of a Surface in a SceneDelta, referencing windows by id.
+ */
+struct SurfaceDelta
+{
+    /** Coordinates of the surface's DisplayGroup. */
+    QRectF groupCoordinates;
+
+    /** The background of the surface. */
+    BackgroundPtr background;
+
+    /** The context menu of the surface. */
+    ContextMenuPtr contextMenu;
+
+    /** The ids of the windows in the DisplayGroup, ordered by z-index. */
+    std::vector<QUuid> windowIds;
+
+    /** The id of the fullscreen window, null if there is none. */
+    QUuid fullscreenWindowId;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        // clang-format off
+        ar & groupCoordinates;
+        ar & background;
+        ar & contextMenu;
+        ar & windowIds;
+        ar & fullscreenWindowId;
+        // clang-format on
+    }
+};
+
+/**
+ * Versioned update of the Scene, sent from the master to the wall processes.
+ *
+ * A keyframe carries the full Scene. A patch only carries the layout of each
+ * surface plus the windows which have changed since the baseVersion; the wall
+ * processes reuse their copy of all the other windows.
+ */
+struct SceneDelta
+{
+    /** Version of the scene after applying this delta. */
+    uint64_t version = 0;
+
+    /** Version of the scene that a patch applies to (unused by keyframes). */
+    uint64_t baseVersion = 0;
+
+    /** The full scene, only set for keyframes. */
+    ScenePtr keyframe;
+
+    /** The layout of each surface, only set for patches. */
+    std::vector<SurfaceDelta> surfaces;
+
+    /** The windows that were added or modified, only set for patches. */
+    WindowPtrs windows;
+
+    /** @return true if this delta is a keyframe. */
+    bool isKeyframe() const { return static_cast<bool>(keyframe); }
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int)
+    {
+        // clang-format off
+        ar & version;
+        ar & baseVersion;
+        ar & keyframe;
+        ar & surfaces;
+        ar & windows;
+        // clang-format on
+    }
+};
+
+#endif
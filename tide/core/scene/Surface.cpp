@@ -59,6 +59,16 @@ Surface::Surface(const size_t index, DisplayGroupPtr group,
     _forwardModifiedSignals();
 }
 
+Surface::Surface(const size_t index, DisplayGroupPtr group,
+                 BackgroundPtr background, ContextMenuPtr contextMenu)
+    : _index{index}
+    , _group{group}
+    , _background{background}
+    , _contextMenu{contextMenu}
+{
+    _forwardModifiedSignals();
+}
+
 size_t Surface::getIndex() const
 {
     return _index;
@@ -99,6 +109,11 @@ ContextMenu& Surface::getContextMenu()
     return *_contextMenu;
 }
 
+ContextMenuPtr Surface::getContextMenuPtr() const
+{
+    return _contextMenu;
+}
+
 TIDE_DISABLE_WARNING_SHADOW
 void Surface::moveToThread(QThread* thread)
 {
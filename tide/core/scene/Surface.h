@@ -57,6 +57,8 @@ class Surface : public QObject
 public:
     Surface(size_t index, DisplayGroupPtr group);
     Surface(size_t index, DisplayGroupPtr group, BackgroundPtr background);
+    Surface(size_t index, DisplayGroupPtr group, BackgroundPtr background,
+            ContextMenuPtr contextMenu);
 
     size_t getIndex() const;
 
@@ -69,6 +71,7 @@ public:
     BackgroundPtr getBackgroundPtr() const;
 
     ContextMenu& getContextMenu();
+    ContextMenuPtr getContextMenuPtr() const;
 
     /**
      * Move this object and its member QObjects to the given QThread.
@@ -104,6 +104,7 @@ void Window::setContent(ContentPtr content)
     setResizePolicy(_content->hasFixedAspectRatio() ? KEEP_ASPECT_RATIO
                                                     : ADJUST_CONTENT);
     _initContentConnections();
+    ++_version; // a new content must be distributed to the wall processes
 }
 
 void Window::setCoordinates(const QRectF& coordinates)
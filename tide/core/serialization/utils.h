@@ -102,6 +102,20 @@ T get(const Container& container)
     return object;
 }
 
+/**
+ * Get an object of type T, read in binary serialized form from a stream.
+ */
+template <typename T>
+T get(std::istream& stream)
+{
+    T object;
+    {
+        boost::archive::binary_iarchive ia{stream};
+        ia >> object;
+    }
+    return object;
+}
+
 /**
  * Deserialize object(s) from a string of binary serialized data.
  */
@@ -94,6 +94,27 @@ enum class SwapSync
     hardware
 };
 
+/**
+ * How to wait for the completion of a blocking network operation.
+ */
+enum class WaitPolicy
+{
+    spin,          /**< Busy loop, lowest latency but uses a full core. */
+    spinThenYield, /**< Busy loop for a short time, then yield the thread. */
+    backoff,       /**< Sleep with exponential backoff, lowest CPU usage. */
+    adaptive       /**< Spin for the typical completion time, then backoff. */
+};
+
+/**
+ * The compression codecs for network messages.
+ */
+enum class Codec
+{
+    none,
+    lz4, /**< Fastest, for low-latency messages. */
+    zstd /**< Better compression ratio, for slow links. */
+};
+
 /**
  * The different texture update policies.
  */
@@ -121,6 +142,8 @@ class FFMPEGMovie;
 class FFMPEGPicture;
 class FFMPEGVideoFrameConverter;
 class FFMPEGVideoStream;
+class FramePacer;
+class FrameSync;
 class Image;
 class ImageReader;
 class ImageSource;
@@ -139,19 +162,27 @@ class PixelStreamContent;
 class PixelStreamUpdater;
 class PixelStreamWindowManager;
 struct Process;
+class RectangleSet;
 class Scene;
 class Session;
 struct SessionInfo;
 class ScreenLock;
+struct ScreenshotRequest;
 class SharedNetworkBarrier;
 class SideController;
 class Surface;
 struct SurfaceConfig;
 class SwapSynchronizer;
+class TelemetryAggregator;
+class TelemetryCollector;
 class TestPattern;
 class Tile;
+class TileCache;
+struct TraceReply;
+struct TraceRequest;
 struct WallConfiguration;
 class WallSurfaceRenderer;
+struct WallTelemetry;
 class WallToWallChannel;
 class WallWindow;
 class WebbrowserContent;
@@ -0,0 +1,261 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace trace
+{
+namespace detail
+{
+std::atomic<bool> enabled{false};
+}
+
+namespace
+{
+const size_t maxTerminatedThreads = 32;
+
+struct Buffer
+{
+    int id = 0;
+    std::string name;
+
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t next = 0; // write position once the ring is full
+};
+using BufferPtr = std::shared_ptr<Buffer>;
+
+std::mutex _registryMutex;
+std::vector<BufferPtr> _buffers;
+int _nextThreadId = 1;
+
+bool _isTerminated(const BufferPtr& buffer)
+{
+    // Only the registry still references buffers of terminated threads
+    return buffer.use_count() == 1;
+}
+
+void _removeTerminatedThreads(const size_t keep)
+{
+    auto count = std::count_if(_buffers.begin(), _buffers.end(),
+                               _isTerminated);
+    auto it = _buffers.begin();
+    while (count > (long)keep && it != _buffers.end())
+    {
+        if (_isTerminated(*it))
+        {
+            it = _buffers.erase(it);
+            --count;
+        }
+        else
+            ++it;
+    }
+}
+
+std::string _getCurrentThreadName(const int id)
+{
+    const auto thread = QThread::currentThread();
+    if (thread && !thread->objectName().isEmpty())
+        return thread->objectName().toStdString();
+    const auto app = QCoreApplication::instance();
+    if (app && thread == app->thread())
+        return "Main";
+    return "Thread #" + std::to_string(id);
+}
+
+BufferPtr _createBuffer()
+{
+    auto buffer = std::make_shared<Buffer>();
+    buffer->events.reserve(bufferCapacity);
+
+    std::lock_guard<std::mutex> lock{_registryMutex};
+    // Thread pools may create and expire threads indefinitely
+    _removeTerminatedThreads(maxTerminatedThreads);
+    buffer->id = _nextThreadId++;
+    buffer->name = _getCurrentThreadName(buffer->id);
+    _buffers.push_back(buffer);
+    return buffer;
+}
+
+Buffer& _getThreadBuffer()
+{
+    thread_local BufferPtr buffer = _createBuffer();
+    return *buffer;
+}
+
+void _appendEscaped(std::string& out, const std::string& str)
+{
+    for (const auto c : str)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out += c;
+    }
+}
+
+void _appendMicroseconds(std::string& out, const int64_t ns)
+{
+    // Exact decimal representation, doubles would round absolute timestamps
+    char str[32];
+    const auto sign = ns < 0 ? "-" : "";
+    const auto value = ns < 0 ? -ns : ns;
+    snprintf(str, sizeof(str), "%s%" PRId64 ".%03" PRId64, sign,
+             value / 1000, value % 1000);
+    out += str;
+}
+
+void _appendMetadata(std::string& out, const char* type, const int pid,
+                     const int tid, const std::string& name)
+{
+    if (!out.empty())
+        out += ',';
+    out += "{\"ph\":\"M\",\"name\":\"";
+    out += type;
+    out += "\",\"pid\":" + std::to_string(pid);
+    out += ",\"tid\":" + std::to_string(tid);
+    out += ",\"args\":{\"name\":\"";
+    _appendEscaped(out, name);
+    out += "\"}}";
+}
+}
+
+void setEnabled(const bool enabled)
+{
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void record(const char* name, const clock::time_point begin,
+            const clock::time_point end)
+{
+    auto& buffer = _getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock{buffer.mutex};
+    const auto event = Event{name, begin, end - begin};
+    if (buffer.events.size() < bufferCapacity)
+        buffer.events.push_back(event);
+    else
+    {
+        buffer.events[buffer.next] = event;
+        buffer.next = (buffer.next + 1) % bufferCapacity;
+    }
+}
+
+std::vector<ThreadEvents> getEvents()
+{
+    std::vector<BufferPtr> buffers;
+    {
+        std::lock_guard<std::mutex> lock{_registryMutex};
+        buffers = _buffers;
+    }
+
+    std::vector<ThreadEvents> threads;
+    threads.reserve(buffers.size());
+    for (const auto& buffer : buffers)
+    {
+        std::lock_guard<std::mutex> lock{buffer->mutex};
+        if (buffer->events.empty())
+            continue;
+
+        const auto& events = buffer->events;
+        const auto next = events.begin() + buffer->next;
+        auto thread = ThreadEvents{buffer->id, buffer->name, {}};
+        thread.events.reserve(events.size());
+        thread.events.insert(thread.events.end(), next, events.end());
+        thread.events.insert(thread.events.end(), events.begin(), next);
+        threads.push_back(std::move(thread));
+    }
+    return threads;
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> lock{_registryMutex};
+    _removeTerminatedThreads(0);
+    for (const auto& buffer : _buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock{buffer->mutex};
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
+
+std::string toChromeEvents(const std::vector<ThreadEvents>& threads,
+                           const int pid, const std::string& processName,
+                           const clock::duration offset)
+{
+    using namespace std::chrono;
+
+    std::string out;
+    _appendMetadata(out, "process_name", pid, 0, processName);
+
+    for (const auto& thread : threads)
+    {
+        _appendMetadata(out, "thread_name", pid, thread.id, thread.name);
+
+        const auto prefix = ",\"pid\":" + std::to_string(pid) +
+                            ",\"tid\":" + std::to_string(thread.id) +
+                            ",\"ts\":";
+        for (const auto& event : thread.events)
+        {
+            const auto ts = toNanoseconds(event.begin + offset);
+            const auto dur = duration_cast<nanoseconds>(event.duration);
+
+            out += ",{\"ph\":\"X\",\"name\":\"";
+            _appendEscaped(out, event.name);
+            out += '"';
+            out += prefix;
+            _appendMicroseconds(out, ts);
+            out += ",\"dur\":";
+            _appendMicroseconds(out, dur.count());
+            out += '}';
+        }
+    }
+    return out;
+}
+}
@@ -0,0 +1,164 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Lightweight scoped trace points recorded in per-thread ring buffers.
+ *
+ * Recording is disabled by default, in which case a trace point costs a single
+ * relaxed atomic load. When enabled, each thread writes into its own buffer of
+ * fixed capacity, keeping only the most recent events.
+ */
+namespace trace
+{
+using clock = std::chrono::high_resolution_clock;
+
+/** @return a time in nanoseconds since the epoch of the clock. */
+inline int64_t toNanoseconds(const clock::time_point time)
+{
+    using ns = std::chrono::nanoseconds;
+    return std::chrono::duration_cast<ns>(time.time_since_epoch()).count();
+}
+
+/** Maximum number of events kept per thread. */
+const size_t bufferCapacity = 16384;
+
+/** A completed trace scope. */
+struct Event
+{
+    /** Name of the scope, must be a string literal (not copied). */
+    const char* name;
+    clock::time_point begin;
+    clock::duration duration;
+};
+
+/** The events recorded by a thread, oldest first. */
+struct ThreadEvents
+{
+    int id;
+    std::string name;
+    std::vector<Event> events;
+};
+
+namespace detail
+{
+extern std::atomic<bool> enabled;
+}
+
+/** @return true if trace events are currently being recorded. */
+inline bool isEnabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/** Start or stop recording trace events. */
+void setEnabled(bool enabled);
+
+/**
+ * Record an event for the calling thread.
+ *
+ * The buffer of a thread is allocated on its first event and named after the
+ * QThread's objectName, if any.
+ */
+void record(const char* name, clock::time_point begin, clock::time_point end);
+
+/** @return a copy of the events recorded by all threads. */
+std::vector<ThreadEvents> getEvents();
+
+/** Discard all recorded events and the buffers of terminated threads. */
+void clear();
+
+/**
+ * Format events as a comma-separated list of Chrome trace events.
+ *
+ * @param threads the events to format
+ * @param pid the process id to use in the trace (e.g. the MPI rank)
+ * @param processName the name displayed for the process
+ * @param offset added to all times to align them on a reference clock
+ * @return the events ("X" and "M" phases), to be placed in a JSON array
+ */
+std::string toChromeEvents(const std::vector<ThreadEvents>& threads, int pid,
+                           const std::string& processName,
+                           clock::duration offset = clock::duration::zero());
+
+/**
+ * Record the duration of the enclosing scope, if tracing is enabled when
+ * entering it.
+ */
+class Scope
+{
+public:
+    explicit Scope(const char* name)
+        : _name{isEnabled() ? name : nullptr}
+    {
+        if (_name)
+            _begin = clock::now();
+    }
+
+    ~Scope()
+    {
+        if (_name)
+            record(_name, _begin, clock::now());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* _name;
+    clock::time_point _begin;
+};
+}
+
+#define TIDE_TRACE_CONCAT_IMPL(a, b) a##b
+#define TIDE_TRACE_CONCAT(a, b) TIDE_TRACE_CONCAT_IMPL(a, b)
+
+/** Trace the enclosing scope under the given (string literal) name. */
+#define TIDE_TRACE_SCOPE(name) \
+    trace::Scope TIDE_TRACE_CONCAT(_traceScope, __LINE__) { name }
+
+#endif
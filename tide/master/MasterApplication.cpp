@@ -49,6 +49,8 @@
 #include "network/MasterFromWallChannel.h"
 #include "network/MasterToForkerChannel.h"
 #include "network/MasterToWallChannel.h"
+#include "network/ScreenshotRequest.h"
+#include "network/TraceRequest.h"
 #include "qml/MasterSurfaceRenderer.h"
 #include "scene/Background.h"
 #include "scene/ContentFactory.h"
@@ -60,23 +62,36 @@
 #include "scene/VectorialContent.h"
 #include "tools/MarkersUpdater.h"
 #include "tools/ScreenshotAssembler.h"
+#include "tools/TelemetryAggregator.h"
+#include "tools/TraceAssembler.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 
 #if TIDE_ENABLE_REST_INTERFACE
 #include "rest/RestInterface.h"
 #include "tools/ActivityLogger.h"
 #endif
 
+#if TIDE_USE_TIFF
+#include "data/TiffTileWriter.h"
+#endif
+
 #include <deflect/qt/QuickRenderer.h>
 #include <deflect/server/Server.h>
 
+#include <QFile>
+#include <QFileInfo>
 #include <QQuickRenderControl>
+#include <QStringList>
 #include <stdexcept>
 
 namespace
 {
 const QUrl QML_OFFSCREEN_ROOT_COMPONENT("qrc:/qml/master/OffscreenRoot.qml");
 
+// Time after which a trace is saved without the wall processes not replying
+const std::chrono::seconds TRACE_REPLY_TIMEOUT{10};
+
 std::unique_ptr<deflect::server::Server> _createDeflectServer()
 {
     try
@@ -89,6 +104,23 @@ std::unique_ptr<deflect::server::Server> _createDeflectServer()
                                  e.what());
     }
 }
+
+std::chrono::milliseconds _getWallUpdateInterval(const Configuration& config)
+{
+    const auto rate = config.master.wallUpdateRate;
+    return std::chrono::milliseconds{rate > 0 ? 1000 / rate : 0};
+}
+
+void _sendTraceRequest(MasterToWallChannel& channel,
+                       const TraceRequest::Action action)
+{
+    TraceRequest request;
+    request.action = action;
+    // The channel lives in the send thread, where the send time is set
+    QMetaObject::invokeMethod(&channel, "sendTraceRequest",
+                              Qt::QueuedConnection,
+                              Q_ARG(TraceRequest, request));
+}
 }
 
 MasterApplication::MasterApplication(int& argc_, char** argv_,
@@ -99,7 +131,9 @@ MasterApplication::MasterApplication(int& argc_, char** argv_,
     : QApplication{argc_, argv_}
     , _config{new Configuration{config}}
     , _masterToForkerChannel{new MasterToForkerChannel{forkerSendComm}}
-    , _masterToWallChannel{new MasterToWallChannel{wallSendComm}}
+    , _masterToWallChannel{
+          new MasterToWallChannel{wallSendComm, *_config,
+                                  _getWallUpdateInterval(*_config)}}
     , _masterFromWallChannel{new MasterFromWallChannel{wallRecvComm}}
     , _scene{Scene::create(_config->surfaces)}
     , _session{_scene}
@@ -116,9 +150,14 @@ MasterApplication::MasterApplication(int& argc_, char** argv_,
                                        *_options, *_config}}
     , _markersUpdater{new MarkersUpdater{*_markers,
                                          _config->surfaces[0].getTotalSize()}}
+    , _telemetryAggregator{new TelemetryAggregator{*_config}}
 // clang-format on
 {
     qml::registerTypes();
+    wallSendComm.setWaitPolicies(*_config);
+    wallRecvComm.setWaitPolicies(*_config);
+    forkerSendComm.setWaitPolicies(*_config);
+    wallSendComm.setCompression(*_config);
     Content::setMaxScale(_config->settings.contentMaxScale);
     VectorialContent::setMaxScale(_config->settings.contentMaxScaleVectorial);
 
@@ -139,6 +178,9 @@ MasterApplication::~MasterApplication()
 {
     _deflectServer.reset();
 
+    // Wait for the screenshot being written, before its writer is destroyed
+    _screenshotAssembler.reset();
+
     // Make sure the send quit happens after any pending send operation;
     // If a send operation is not matched by a receive, the MPI connection
     // will block indefintely when trying to disconnect.
@@ -267,6 +309,7 @@ void MasterApplication::_connectRestInterface()
 {
     _logger->monitor(*_scene);
     _restInterface->exposeStatistics(*_logger);
+    _restInterface->exposeTelemetry(*_telemetryAggregator);
 
     connect(_lock.get(), &ScreenLock::lockChanged,
             [this](const bool locked) { _restInterface->lock(locked); });
@@ -294,6 +337,15 @@ void MasterApplication::_connectRestInterface()
     connect(&appRemoteController, &AppRemoteController::takeScreenshot, this,
             &MasterApplication::_takeScreenshot);
 
+    connect(&appRemoteController, &AppRemoteController::startTrace, this,
+            &MasterApplication::_startTrace);
+
+    connect(&appRemoteController, &AppRemoteController::stopTrace, this,
+            &MasterApplication::_stopTrace);
+
+    connect(&appRemoteController, &AppRemoteController::saveTrace, this,
+            &MasterApplication::_saveTrace);
+
     connect(&appRemoteController, &AppRemoteController::powerOff,
             _appController.get(), &AppController::suspend);
 
@@ -357,6 +409,13 @@ void MasterApplication::_setupMPIConnections()
             &MasterFromWallChannel::pixelStreamClose, _appController.get(),
             &AppController::terminateStream);
 
+    connect(_masterFromWallChannel.get(),
+            &MasterFromWallChannel::receivedTelemetry, this,
+            [this](const WallTelemetry telemetry) {
+                _telemetryAggregator->add(telemetry,
+                                          TelemetryAggregator::clock::now());
+            });
+
     connect(&_mpiReceiveThread, &QThread::started, _masterFromWallChannel.get(),
             &MasterFromWallChannel::processMessages);
 
@@ -365,7 +424,8 @@ void MasterApplication::_setupMPIConnections()
 }
 
 void MasterApplication::_takeScreenshot(const uint surfaceIndex,
-                                        const QString filename)
+                                        const QString filename,
+                                        const double scale, const int quality)
 {
     // Don't interrupt an ongoing screenshot operation
     if (_screenshotAssembler && !_screenshotAssembler->isComplete())
@@ -374,18 +434,149 @@ void MasterApplication::_takeScreenshot(const uint surfaceIndex,
     if (surfaceIndex >= _config->surfaces.size())
         return;
 
+    // Very large screenshots are streamed to a tiled TIFF file by bands, the
+    // other formats need the whole image in memory.
+    const auto suffix = QFileInfo{filename}.suffix().toLower();
+    const auto tiled = suffix == "tif" || suffix == "tiff";
+#if !TIDE_USE_TIFF
+    if (tiled)
+    {
+        print_log(LOG_ERROR, LOG_GENERAL,
+                  "Can't save screenshot '%s', TIFF support is disabled",
+                  filename.toLocal8Bit().constData());
+        return;
+    }
+#endif
+
+    using Output = ScreenshotAssembler::Output;
     _screenshotAssembler.reset(
-        new ScreenshotAssembler(_config->surfaces[surfaceIndex]));
+        new ScreenshotAssembler(_config->surfaces[surfaceIndex], scale,
+                                tiled ? Output::bands : Output::image));
 
     connect(_masterFromWallChannel.get(),
             &MasterFromWallChannel::receivedScreenshot,
-            _screenshotAssembler.get(), &ScreenshotAssembler::addImage);
+            _screenshotAssembler.get(),
+            &ScreenshotAssembler::addEncodedImage);
+
+    // The screenshot is saved on the worker thread of the assembler, not to
+    // block the GUI with the encoding of a large image
+#if TIDE_USE_TIFF
+    if (tiled)
+        _streamScreenshotToTiff(filename);
+    else
+#endif
+        connect(_screenshotAssembler.get(),
+                &ScreenshotAssembler::screenshotComplete,
+                [filename, quality](const QImage screenshot) {
+                    screenshot.save(filename, nullptr, quality);
+                });
+
+    // Walls encode their images losslessly unless the output is lossy anyway
+    ScreenshotRequest request;
+    request.scale = scale;
+    request.format = (suffix == "jpg" || suffix == "jpeg") ? "jpg" : "png";
+    request.quality = quality;
+    _masterToWallChannel->sendRequestScreenshot(request);
+}
 
+#if TIDE_USE_TIFF
+void MasterApplication::_streamScreenshotToTiff(const QString& filename)
+{
+    try
+    {
+        const auto size = _screenshotAssembler->getSize();
+        _screenshotWriter.reset(new TiffTileWriter(filename, size));
+    }
+    catch (const std::exception& e)
+    {
+        print_log(LOG_ERROR, LOG_GENERAL, "Can't save screenshot '%s': %s",
+                  filename.toLocal8Bit().constData(), e.what());
+    }
+
+    // Called on the worker thread of the assembler, one band after the other
+    connect(_screenshotAssembler.get(), &ScreenshotAssembler::bandComplete,
+            [this](const QImage band) {
+                if (!_screenshotWriter)
+                    return;
+                try
+                {
+                    _screenshotWriter->write(band);
+                }
+                catch (const std::runtime_error& e)
+                {
+                    print_log(LOG_ERROR, LOG_GENERAL, "%s", e.what());
+                    _screenshotWriter.reset();
+                }
+            });
     connect(_screenshotAssembler.get(),
             &ScreenshotAssembler::screenshotComplete,
-            [filename](const QImage screenshot) { screenshot.save(filename); });
+            [this] { _screenshotWriter.reset(); });
+}
+#endif
+
+void MasterApplication::_startTrace()
+{
+    print_log(LOG_INFO, LOG_GENERAL, "Recording trace events");
+    trace::clear();
+    trace::setEnabled(true);
+    _sendTraceRequest(*_masterToWallChannel, TraceRequest::Action::start);
+}
+
+void MasterApplication::_stopTrace()
+{
+    trace::setEnabled(false);
+    _sendTraceRequest(*_masterToWallChannel, TraceRequest::Action::stop);
+}
+
+void MasterApplication::_saveTrace(const QString filename,
+                                   BoolMsgCallback callback)
+{
+    // Don't interrupt an ongoing trace collection, it ends after a timeout
+    if (_traceAssembler && !_traceAssembler->isFinished())
+    {
+        if (callback)
+            callback(false, "a trace is already being collected");
+        return;
+    }
 
-    _masterToWallChannel->sendRequestScreenshot();
+    _traceAssembler.reset(new TraceAssembler(trace::getEvents(),
+                                             _config->processes.size(),
+                                             TRACE_REPLY_TIMEOUT));
+
+    connect(_masterFromWallChannel.get(), &MasterFromWallChannel::receivedTrace,
+            _traceAssembler.get(), &TraceAssembler::addReply);
+
+    connect(_traceAssembler.get(), &TraceAssembler::traceComplete,
+            [filename, callback](const QByteArray json,
+                                 const std::vector<int> missingRanks) {
+                QFile file{filename};
+                if (!file.open(QIODevice::WriteOnly) ||
+                    file.write(json) != json.size())
+                {
+                    print_log(LOG_ERROR, LOG_GENERAL, "Can't save trace '%s'",
+                              filename.toLocal8Bit().constData());
+                    if (callback)
+                        callback(false, "can't save trace to " + filename);
+                    return;
+                }
+                print_log(LOG_INFO, LOG_GENERAL, "Trace saved to '%s'",
+                          filename.toLocal8Bit().constData());
+                if (!callback)
+                    return;
+
+                QString message;
+                if (!missingRanks.empty())
+                {
+                    QStringList ranks;
+                    for (const auto rank : missingRanks)
+                        ranks.append(QString::number(rank));
+                    message = "\"trace saved without wall processes: " +
+                              ranks.join(' ') + "\"";
+                }
+                callback(true, message);
+            });
+
+    _sendTraceRequest(*_masterToWallChannel, TraceRequest::Action::dump);
 }
 
 bool MasterApplication::notify(QObject* receiver, QEvent* event)
@@ -59,6 +59,8 @@ class MasterFromWallChannel;
 class MasterWindow;
 class RestInterface;
 class ScreenshotAssembler;
+class TiffTileWriter;
+class TraceAssembler;
 
 /**
  * The main application for the Master process.
@@ -118,7 +120,12 @@ private:
 #endif
     std::unique_ptr<AppController> _appController;
     std::unique_ptr<ScreenshotAssembler> _screenshotAssembler;
+    std::unique_ptr<TraceAssembler> _traceAssembler;
+#if TIDE_USE_TIFF
+    std::unique_ptr<TiffTileWriter> _screenshotWriter;
+#endif
     std::unique_ptr<MarkersUpdater> _markersUpdater;
+    std::unique_ptr<TelemetryAggregator> _telemetryAggregator;
 
     void _validateConfig();
     void _initView();
@@ -134,7 +141,14 @@ private:
 #endif
     void _setupMPIConnections();
 
-    void _takeScreenshot(uint surfaceIndex, QString filename);
+    void _takeScreenshot(uint surfaceIndex, QString filename, double scale,
+                         int quality);
+#if TIDE_USE_TIFF
+    void _streamScreenshotToTiff(const QString& filename);
+#endif
+    void _startTrace();
+    void _stopTrace();
+    void _saveTrace(QString filename, BoolMsgCallback callback);
 
     bool notify(QObject* receiver, QEvent* event) final;
     void _handle(const QTouchEvent* event);
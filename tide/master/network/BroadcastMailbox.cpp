@@ -0,0 +1,111 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "BroadcastMailbox.h"
+
+#include <algorithm>
+
+BroadcastMailbox::BroadcastMailbox(Sender sender,
+                                   const std::chrono::milliseconds interval)
+    : _sender{std::move(sender)}
+    , _flushInterval{interval}
+{
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&_flushTimer, &QTimer::timeout, [this] { flush(); });
+}
+
+void BroadcastMailbox::post(const MessageType type, Serializer serializer)
+{
+    auto it =
+        std::find_if(_pending.begin(), _pending.end(),
+                     [type](const auto& msg) { return msg.first == type; });
+    if (it != _pending.end())
+    {
+        it->second = std::move(serializer);
+        ++_dropped[type];
+    }
+    else
+        _pending.emplace_back(type, std::move(serializer));
+
+    _scheduleFlush();
+}
+
+void BroadcastMailbox::flush()
+{
+    _flushTimer.stop();
+    _lastFlush = clock::now();
+
+    // Swap first: a serializer may indirectly post new messages
+    auto messages = decltype(_pending)();
+    std::swap(messages, _pending);
+
+    for (const auto& message : messages)
+        _sender(message.first, message.second());
+}
+
+size_t BroadcastMailbox::getPendingCount() const
+{
+    return _pending.size();
+}
+
+size_t BroadcastMailbox::getDroppedCount(const MessageType type) const
+{
+    const auto it = _dropped.find(type);
+    return it != _dropped.end() ? it->second : 0;
+}
+
+size_t BroadcastMailbox::getDroppedCount() const
+{
+    size_t count = 0;
+    for (const auto& dropped : _dropped)
+        count += dropped.second;
+    return count;
+}
+
+void BroadcastMailbox::_scheduleFlush()
+{
+    if (_flushTimer.isActive())
+        return;
+
+    using namespace std::chrono;
+    const auto elapsed = duration_cast<milliseconds>(clock::now() - _lastFlush);
+    const auto delay = std::max(_flushInterval - elapsed, milliseconds{0});
+    _flushTimer.start(static_cast<int>(delay.count()));
+}
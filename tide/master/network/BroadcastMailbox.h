@@ -0,0 +1,112 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef BROADCASTMAILBOX_H
+#define BROADCASTMAILBOX_H
+
+#include "network/MessageHeader.h"
+
+#include <QTimer>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Latest-value-wins mailbox for the messages broadcast to the wall processes.
+ *
+ * A message posted for a given MessageType replaces any pending message of the
+ * same type. Pending messages are serialized only when the mailbox is flushed,
+ * which happens at most once per flush interval (or on demand), so that rapid
+ * interactions do not pile up stale snapshots on the send thread.
+ *
+ * The mailbox must be created and used in the thread which owns the objects
+ * to serialize (the main thread).
+ */
+class BroadcastMailbox
+{
+public:
+    using Serializer = std::function<std::string()>;
+    using Sender = std::function<void(MessageType, std::string)>;
+
+    /**
+     * Create a mailbox.
+     * @param sender function called for each serialized message on flush.
+     * @param flushInterval minimum time between two flushes. With a value of
+     *        zero, messages posted during the same event loop iteration are
+     *        still coalesced.
+     */
+    BroadcastMailbox(Sender sender, std::chrono::milliseconds flushInterval);
+
+    /**
+     * Post a message, replacing any pending message of the same type.
+     * @param type the type of message.
+     * @param serializer function called when the message is actually sent.
+     */
+    void post(MessageType type, Serializer serializer);
+
+    /** Serialize and send all pending messages immediately. */
+    void flush();
+
+    /** @return the number of messages currently pending. */
+    size_t getPendingCount() const;
+
+    /** @return the number of messages of a type replaced before being sent. */
+    size_t getDroppedCount(MessageType type) const;
+
+    /** @return the total number of messages replaced before being sent. */
+    size_t getDroppedCount() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    Sender _sender;
+    const std::chrono::milliseconds _flushInterval;
+    clock::time_point _lastFlush;
+    QTimer _flushTimer;
+
+    std::vector<std::pair<MessageType, Serializer>> _pending;
+    std::map<MessageType, size_t> _dropped;
+
+    void _scheduleFlush();
+};
+
+#endif
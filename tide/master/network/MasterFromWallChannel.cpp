@@ -43,6 +43,7 @@
 #include "network/MPICommunicator.h"
 #include "serialization/utils.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 
 MasterFromWallChannel::MasterFromWallChannel(MPICommunicator& communicator)
     : _communicator{communicator}
@@ -59,6 +60,7 @@ void MasterFromWallChannel::processMessages()
     while (_processMessages)
     {
         const auto result = _communicator.probe();
+        const auto probeTime = trace::clock::now();
         if (!result.isValid())
         {
             print_log(LOG_ERROR, LOG_MPI, "Invalid probe result size: %d",
@@ -79,12 +81,23 @@ void MasterFromWallChannel::processMessages()
         }
         case MessageType::IMAGE:
         {
-            QImage image;
+            QByteArray image;
             QPoint index;
             serialization::fromBinary(_buffer, image, index);
             emit receivedScreenshot(image, index);
             break;
         }
+        case MessageType::TRACE:
+        {
+            auto reply = serialization::get<TraceReply>(_buffer);
+            // Time of the probe, before receiving the (possibly large) payload
+            reply.receiveTime = trace::toNanoseconds(probeTime);
+            emit receivedTrace(reply);
+            break;
+        }
+        case MessageType::TELEMETRY:
+            emit receivedTelemetry(serialization::get<WallTelemetry>(_buffer));
+            break;
         case MessageType::PIXELSTREAM_CLOSE:
             emit pixelStreamClose(serialization::get<QString>(_buffer));
             break;
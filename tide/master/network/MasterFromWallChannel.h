@@ -43,6 +43,8 @@
 
 #include "network/MessageHeader.h"
 #include "network/ReceiveBuffer.h"
+#include "network/TraceReply.h"
+#include "network/WallTelemetry.h"
 #include "types.h"
 
 #include <QImage> // needed by moc compiler on Travis OSX
@@ -75,10 +77,22 @@ signals:
 
     /**
      * Emitted after each wall process has rendered a screenshot
-     * @param image The rendered image
+     * @param image The rendered image, encoded as requested
      * @param index The global index of the window that sent the image
      */
-    void receivedScreenshot(QImage image, QPoint index);
+    void receivedScreenshot(QByteArray image, QPoint index);
+
+    /**
+     * Emitted when a wall process sent its trace events.
+     * @param reply the events, with the reception time set.
+     */
+    void receivedTrace(TraceReply reply);
+
+    /**
+     * Emitted when a wall process sent its performance counters.
+     * @param telemetry the counters of its last reporting period.
+     */
+    void receivedTelemetry(WallTelemetry telemetry);
 
     /**
      * Emitted when the given pixel stream was requested to be closed, e.g.
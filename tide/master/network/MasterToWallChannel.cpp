@@ -39,7 +39,10 @@
 
 #include "MasterToWallChannel.h"
 
+#include "configuration/Configuration.h"
+#include "network/FrameWireFormat.h"
 #include "network/MPICommunicator.h"
+#include "network/ScreenshotRequest.h"
 #include "scene/CountdownStatus.h"
 #include "scene/Markers.h"
 #include "scene/Options.h"
@@ -47,36 +50,101 @@
 #include "scene/ScreenLock.h"
 #include "scene/Window.h"
 #include "serialization/utils.h"
+#include "utils/log.h"
+#include "utils/trace.h"
 #include "json/serialization.h"
 #include "json/templates.h"
 
 #include <deflect/server/Frame.h>
 
-MasterToWallChannel::MasterToWallChannel(MPICommunicator& communicator)
+#include <map>
+
+namespace
+{
+// Delay before splitting the frames of a stream after its layout has changed;
+// long enough for the scene update to be applied on all the wall processes.
+const std::chrono::milliseconds streamLayoutSettleTime{500};
+
+// @return the index of the first process on the same host, for each process;
+// or an empty vector if each host runs a single process.
+std::vector<size_t> _getHostLeaders(const Configuration& config)
+{
+    std::vector<size_t> leaders;
+    bool shared = false;
+    for (const auto& process : config.processes)
+    {
+        size_t leader = 0;
+        while (config.processes[leader].host != process.host)
+            ++leader;
+        shared = shared || leader != leaders.size();
+        leaders.push_back(leader);
+    }
+    return shared ? leaders : std::vector<size_t>();
+}
+
+// Keep the image data of the tiles needed by any of the given processes
+deflect::server::Frame _mergeFrames(
+    const std::vector<deflect::server::FramePtr>& processFrames,
+    const std::vector<size_t>& processes)
+{
+    auto frame = *processFrames[processes[0]];
+    for (size_t i = 1; i < processes.size(); ++i)
+    {
+        const auto& tiles = processFrames[processes[i]]->tiles;
+        for (size_t tile = 0; tile < tiles.size(); ++tile)
+        {
+            if (frame.tiles[tile].imageData.isEmpty())
+                frame.tiles[tile].imageData = tiles[tile].imageData;
+        }
+    }
+    return frame;
+}
+}
+
+MasterToWallChannel::MasterToWallChannel(
+    MPICommunicator& communicator, const Configuration& config,
+    const std::chrono::milliseconds flushInterval)
     : _communicator{communicator}
+    , _streamRouter{config, streamLayoutSettleTime}
+    , _hostLeaders{config.global.shareFramesOnHost ? _getHostLeaders(config)
+                                                   : std::vector<size_t>()}
+    , _mailbox{[this](const MessageType type, std::string data) {
+                   QMetaObject::invokeMethod(this, "_broadcast",
+                                             Qt::QueuedConnection,
+                                             Q_ARG(MessageType, type),
+                                             Q_ARG(std::string, data));
+               },
+               flushInterval}
 {
 }
 
-template <typename T>
-void MasterToWallChannel::broadcast(const T& object, const MessageType type)
+MasterToWallChannel::~MasterToWallChannel()
 {
-    _communicator.broadcast(type, serialization::toBinary(object));
+    print_log(LOG_DEBUG, LOG_MPI, "updates dropped by coalescing: %zu",
+              _mailbox.getDroppedCount());
+}
+
+size_t MasterToWallChannel::getDroppedCount(const MessageType type) const
+{
+    return _mailbox.getDroppedCount(type);
 }
 
 template <typename T>
 void MasterToWallChannel::broadcastAsync(const T& object,
                                          const MessageType type)
 {
-    const auto data = serialization::toBinary(object);
-
-    QMetaObject::invokeMethod(this, "_broadcast", Qt::QueuedConnection,
-                              Q_ARG(MessageType, type),
-                              Q_ARG(std::string, data));
+    _mailbox.post(type, [object] { return serialization::toBinary(object); });
 }
 
 void MasterToWallChannel::sendAsync(ScenePtr scene)
 {
-    broadcastAsync(scene, MessageType::SCENE);
+    // Encode on flush only, the walls must receive all the deltas
+    _mailbox.post(MessageType::SCENE, [this, scene] {
+        TIDE_TRACE_SCOPE("encodeScene");
+        _streamRouter.update(*scene);
+        const auto delta = _sceneEncoder.encode(scene);
+        return serialization::toBinary(delta);
+    });
 }
 
 void MasterToWallChannel::sendAsync(OptionsPtr options)
@@ -102,22 +170,75 @@ void MasterToWallChannel::sendAsync(MarkersPtr markers)
 void MasterToWallChannel::sendFrame(deflect::server::FramePtr frame)
 {
     assert(!frame->tiles.empty() && "received an empty frame");
-#if BOOST_VERSION >= 106000
-    broadcast(frame, MessageType::PIXELSTREAM);
-#else
-    // WAR missing support for std::shared_ptr
-    broadcast(*frame, MessageType::PIXELSTREAM);
-#endif
+    TIDE_TRACE_SCOPE("sendFrame");
+
+    const auto processFrames = _streamRouter.split(*frame);
+    if (!_hostLeaders.empty())
+    {
+        _sendFrameToHosts(*frame, processFrames);
+        return;
+    }
+
+    if (processFrames.empty())
+    {
+        _communicator.broadcast(MessageType::PIXELSTREAM,
+                                wireformat::encode(*frame));
+        return;
+    }
+
+    // The master process is rank 0, followed by the wall processes
+    std::vector<std::vector<QByteArray>> data(1);
+    for (const auto& processFrame : processFrames)
+        data.push_back(wireformat::encode(*processFrame));
+    _communicator.scatter(MessageType::PIXELSTREAM_SCATTER, data);
+}
+
+void MasterToWallChannel::_sendFrameToHosts(
+    const deflect::server::Frame& frame,
+    const std::vector<deflect::server::FramePtr>& processFrames)
+{
+    std::map<size_t, std::vector<size_t>> hosts;
+    for (size_t process = 0; process < _hostLeaders.size(); ++process)
+        hosts[_hostLeaders[process]].push_back(process);
+
+    // The first process of each host receives the tiles needed by all the
+    // processes of the host, the others an empty message.
+    std::vector<std::vector<QByteArray>> data(1 + _hostLeaders.size());
+    const auto fullFrame =
+        processFrames.empty() ? wireformat::encode(frame)
+                              : std::vector<QByteArray>();
+    for (const auto& host : hosts)
+    {
+        auto& message = data[1 + host.first];
+        if (processFrames.empty())
+            message = fullFrame;
+        else
+            message = wireformat::encode(_mergeFrames(processFrames,
+                                                      host.second));
+    }
+    _communicator.scatter(MessageType::PIXELSTREAM_HOST, data);
 }
 
 void MasterToWallChannel::send(const Configuration& config)
 {
     _communicator.broadcast(MessageType::CONFIG, json::pack(config));
+    // The walls apply the same settings once they have received them
+    _communicator.setBroadcastPipeline(config.global.broadcastSegmentSize,
+                                       config.global.broadcastSegmentsInFlight);
+}
+
+void MasterToWallChannel::sendRequestScreenshot(
+    const ScreenshotRequest& request)
+{
+    _communicator.broadcast(MessageType::IMAGE,
+                            serialization::toBinary(request));
 }
 
-void MasterToWallChannel::sendRequestScreenshot()
+void MasterToWallChannel::sendTraceRequest(TraceRequest request)
 {
-    _communicator.broadcast(MessageType::IMAGE);
+    request.sendTime = trace::toNanoseconds(trace::clock::now());
+    _communicator.broadcast(MessageType::TRACE,
+                            serialization::toBinary(request));
 }
 
 void MasterToWallChannel::sendQuit()
@@ -129,5 +250,6 @@ void MasterToWallChannel::sendQuit()
 void MasterToWallChannel::_broadcast(const MessageType type,
                                      const std::string data)
 {
+    TIDE_TRACE_SCOPE("broadcast");
     _communicator.broadcast(type, data);
 }
@@ -40,7 +40,11 @@
 #ifndef MASTERTOWALLCHANNEL_H
 #define MASTERTOWALLCHANNEL_H
 
+#include "network/BroadcastMailbox.h"
 #include "network/MessageHeader.h"
+#include "network/PixelStreamRouter.h"
+#include "network/SceneDeltaEncoder.h"
+#include "network/TraceRequest.h"
 #include "types.h"
 
 #include <QObject>
@@ -58,9 +62,10 @@
  * The sendAsync() functions are a workaround for objects that cannot be passed
  * by copy and also cannot provide a thread-safe serialize() function.
  * They can be called directly from the main thread (Qt::DirectConnection).
- * The given object is serialized synchronously (in the calling thread), then
- * the serialized data is sent asynchronously in the MasterToWallChannel's
- * thread.
+ * The given object is posted to a latest-value-wins mailbox which replaces any
+ * pending object of the same type. The mailbox is flushed at most once per
+ * flush interval: the objects are serialized in the main thread, then the
+ * serialized data is sent asynchronously in the MasterToWallChannel's thread.
  */
 class MasterToWallChannel : public QObject
 {
@@ -68,12 +73,28 @@ class MasterToWallChannel : public QObject
     Q_DISABLE_COPY(MasterToWallChannel)
 
 public:
-    /** Constructor */
-    MasterToWallChannel(MPICommunicator& communicator);
+    /**
+     * Constructor
+     * @param communicator to broadcast messages to the wall processes.
+     * @param config describing the screens of the wall processes.
+     * @param flushInterval minimum time between two sendAsync() flushes.
+     */
+    MasterToWallChannel(MPICommunicator& communicator,
+                        const Configuration& config,
+                        std::chrono::milliseconds flushInterval);
+
+    /** Destructor */
+    ~MasterToWallChannel();
+
+    /** @return the number of sendAsync() objects replaced before being sent. */
+    size_t getDroppedCount(MessageType type) const;
 
 public slots:
     /**
      * Send the given Scene to the wall processes.
+     *
+     * Only the windows modified since the previous call are sent, except for
+     * periodic keyframes containing the full scene.
      * @param scene The Scene to send
      */
     void sendAsync(ScenePtr scene);
@@ -104,6 +125,11 @@ public slots:
 
     /**
      * Send pixel stream frame to the wall processes.
+     *
+     * Each process only receives the image data of the tiles that it displays,
+     * unless the layout of the stream is unknown or has changed recently.
+     * With config.global.shareFramesOnHost, the frame is instead sent once to
+     * each host, with the tiles needed by all its processes.
      * @param frame The frame to send
      */
     void sendFrame(deflect::server::FramePtr frame);
@@ -116,8 +142,15 @@ public slots:
 
     /**
      * Send a screenshot request to the wall processes.
+     * @param request the scale and encoding of the images of the screens.
      */
-    void sendRequestScreenshot();
+    void sendRequestScreenshot(const ScreenshotRequest& request);
+
+    /**
+     * Send a trace request to the wall processes.
+     * @param request the action to perform, its send time is set here.
+     */
+    void sendTraceRequest(TraceRequest request);
 
     /**
      * Send quit message to the wall processes, terminating the application.
@@ -126,12 +159,18 @@ public slots:
 
 private:
     MPICommunicator& _communicator;
+    SceneDeltaEncoder _sceneEncoder;
+    PixelStreamRouter _streamRouter;
+    std::vector<size_t> _hostLeaders;
+    BroadcastMailbox _mailbox;
 
-    template <typename T>
-    void broadcast(const T& object, const MessageType type);
     template <typename T>
     void broadcastAsync(const T& object, const MessageType type);
 
+    void _sendFrameToHosts(
+        const deflect::server::Frame& frame,
+        const std::vector<deflect::server::FramePtr>& processFrames);
+
 private slots:
     void _broadcast(MessageType type, std::string data);
 };
@@ -0,0 +1,223 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "PixelStreamRouter.h"
+
+#include "configuration/Configuration.h"
+#include "scene/Background.h"
+#include "scene/DisplayGroup.h"
+#include "scene/PixelStreamContent.h"
+#include "scene/Scene.h"
+#include "scene/Window.h"
+#include "scene/ZoomHelper.h"
+
+#include <deflect/server/Frame.h>
+
+#include <cmath>
+#include <set>
+
+namespace
+{
+// Size of the tiles assembled on the walls, see PixelStreamChannelAssembler
+const qreal assembledTileSize = 512.0;
+
+qreal _floor(const qreal value)
+{
+    return std::floor(value / assembledTileSize) * assembledTileSize;
+}
+
+qreal _ceil(const qreal value)
+{
+    return std::ceil(value / assembledTileSize) * assembledTileSize;
+}
+
+QRectF _alignToAssembledTiles(const QRectF& area)
+{
+    if (area.isEmpty())
+        return QRectF();
+
+    return QRectF{QPointF{_floor(area.left()), _floor(area.top())},
+                  QPointF{_ceil(area.right()), _ceil(area.bottom())}};
+}
+
+QRectF _toRect(const deflect::server::Tile& tile)
+{
+    return QRectF(tile.x, tile.y, tile.width, tile.height);
+}
+
+bool _isStream(const Content& content)
+{
+    return dynamic_cast<const PixelStreamContent*>(&content) != nullptr;
+}
+}
+
+PixelStreamRouter::PixelStreamRouter(const Configuration& config,
+                                     const std::chrono::milliseconds settleTime)
+    : _settleTime{settleTime}
+{
+    for (const auto& process : config.processes)
+    {
+        std::vector<ScreenArea> screens;
+        for (const auto& screen : process.screens)
+        {
+            const auto& surface = config.surfaces.at(screen.surfaceIndex);
+            screens.push_back({screen.surfaceIndex,
+                               surface.getScreenRect(screen.globalIndex)});
+        }
+        _processScreens.push_back(std::move(screens));
+    }
+}
+
+void PixelStreamRouter::update(const Scene& scene)
+{
+    auto tilesAreas = _computeTilesAreas(scene);
+    const auto now = clock::now();
+
+    const std::lock_guard<std::mutex> lock{_mutex};
+
+    std::map<QUuid, StreamLayout> layouts;
+    for (auto& areas : tilesAreas)
+    {
+        const auto it = _layouts.find(areas.first);
+        const auto changed =
+            it == _layouts.end() || it->second.tilesAreas != areas.second;
+        const auto lastChange = changed ? now : it->second.lastChange;
+        layouts[areas.first] = StreamLayout{std::move(areas.second),
+                                            lastChange};
+    }
+    _layouts = std::move(layouts);
+}
+
+std::vector<deflect::server::FramePtr> PixelStreamRouter::split(
+    const deflect::server::Frame& frame) const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+
+    const auto it = _layouts.find(PixelStreamContent::getStreamId(frame.uri));
+    if (it == _layouts.end() ||
+        clock::now() - it->second.lastChange < _settleTime)
+    {
+        return {};
+    }
+
+    std::vector<deflect::server::FramePtr> frames;
+    size_t strippedTiles = 0;
+    for (const auto& area : it->second.tilesAreas)
+    {
+        // Tiles share their image data with the original frame (QByteArray)
+        auto processFrame = std::make_shared<deflect::server::Frame>(frame);
+        for (auto& tile : processFrame->tiles)
+        {
+            if (!area.intersects(_toRect(tile)))
+            {
+                tile.imageData.clear();
+                ++strippedTiles;
+            }
+        }
+        frames.push_back(std::move(processFrame));
+    }
+
+    // A broadcast is more efficient if all processes need the full frame
+    if (strippedTiles == 0)
+        return {};
+
+    return frames;
+}
+
+std::map<QUuid, std::vector<QRectF>> PixelStreamRouter::_computeTilesAreas(
+    const Scene& scene) const
+{
+    std::map<QUuid, std::vector<QRectF>> streams;
+    std::set<QUuid> backgroundStreams;
+
+    for (const auto& surface : scene.getSurfaces())
+    {
+        const auto background = surface.getBackground().getContent();
+        if (background && _isStream(*background))
+            backgroundStreams.insert(background->getId());
+
+        for (const auto& window : surface.getGroup().getWindows())
+        {
+            if (!_isStream(window->getContent()))
+                continue;
+
+            auto& areas = streams[window->getContent().getId()];
+            areas.resize(_processScreens.size());
+            for (size_t process = 0; process < areas.size(); ++process)
+            {
+                const auto area =
+                    _computeTilesArea(*window, surface.getIndex(), process);
+                if (!area.isEmpty())
+                    areas[process] |= area;
+            }
+        }
+    }
+
+    // Backgrounds are always fully visible, their frames are not split
+    for (const auto& id : backgroundStreams)
+        streams.erase(id);
+
+    return streams;
+}
+
+QRectF PixelStreamRouter::_computeTilesArea(const Window& window,
+                                            const uint surfaceIndex,
+                                            const size_t process) const
+{
+    // Same computation as the PixelStreamSynchronizer on the walls, without
+    // considering the occlusions by other windows.
+    const auto& windowCoords = window.getDisplayCoordinates();
+    const auto tilesSurface = window.getContent().getDimensions();
+
+    QRectF tilesArea;
+    for (const auto& screen : _processScreens[process])
+    {
+        if (screen.surfaceIndex != surfaceIndex)
+            continue;
+
+        const auto area = windowCoords.intersected(screen.rect);
+        if (area.isEmpty())
+            continue;
+
+        const auto windowArea =
+            area.translated(-windowCoords.x(), -windowCoords.y());
+        tilesArea |= ZoomHelper{window}.toTilesArea(windowArea, tilesSurface);
+    }
+    return _alignToAssembledTiles(tilesArea);
+}
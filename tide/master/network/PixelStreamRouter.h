@@ -0,0 +1,116 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef PIXELSTREAMROUTER_H
+#define PIXELSTREAMROUTER_H
+
+#include "types.h"
+
+#include <QRectF>
+#include <QUuid>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Split pixel stream frames into the tiles needed by each wall process.
+ *
+ * The router keeps track of the area of each stream which is visible on the
+ * screens of every wall process, based on the last scene sent to the walls.
+ * The tiles of a frame which are not needed by a process are sent to it
+ * without their image data. While the layout of a stream is changing, its
+ * frames are not split so that the walls always have the tiles they need even
+ * if they are still rendering a slightly older scene.
+ *
+ * The update() and split() methods are thread-safe.
+ */
+class PixelStreamRouter
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * Create a router for the wall processes of a configuration.
+     * @param config which describes the screens of each wall process.
+     * @param settleTime delay after a layout change before splitting frames.
+     */
+    PixelStreamRouter(const Configuration& config,
+                      std::chrono::milliseconds settleTime);
+
+    /**
+     * Update the layout of the streams after a scene update.
+     * @param scene the scene which is sent to the wall processes.
+     */
+    void update(const Scene& scene);
+
+    /**
+     * Split a frame into the tiles needed by each wall process.
+     * @param frame to split.
+     * @return one frame per wall process (in process order), or an empty
+     *         vector if the full frame must be broadcast to all processes.
+     */
+    std::vector<deflect::server::FramePtr> split(
+        const deflect::server::Frame& frame) const;
+
+private:
+    struct ScreenArea
+    {
+        uint surfaceIndex;
+        QRect rect;
+    };
+    std::vector<std::vector<ScreenArea>> _processScreens;
+
+    struct StreamLayout
+    {
+        std::vector<QRectF> tilesAreas; // visible area for each process
+        clock::time_point lastChange;
+    };
+    std::map<QUuid, StreamLayout> _layouts;
+    std::chrono::milliseconds _settleTime;
+    mutable std::mutex _mutex;
+
+    std::map<QUuid, std::vector<QRectF>> _computeTilesAreas(
+        const Scene& scene) const;
+    QRectF _computeTilesArea(const Window& window, uint surfaceIndex,
+                             size_t process) const;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "SceneDeltaEncoder.h"
+
+SceneDeltaEncoder::SceneDeltaEncoder(const uint keyframeInterval)
+    : _keyframeInterval{keyframeInterval}
+{
+}
+
+SceneDelta SceneDeltaEncoder::encode(ScenePtr scene)
+{
+    const auto keyframe = _needsKeyframe();
+
+    auto delta = keyframe ? _makeKeyframe(scene) : _makePatch(*scene);
+    delta.baseVersion = _version;
+    delta.version = ++_version;
+
+    _updatesSinceKeyframe = keyframe ? 0 : _updatesSinceKeyframe + 1;
+    _keyframeRequested = false;
+    _updateWindowVersions(*scene);
+
+    return delta;
+}
+
+void SceneDeltaEncoder::requestKeyframe()
+{
+    _keyframeRequested = true;
+}
+
+bool SceneDeltaEncoder::_needsKeyframe() const
+{
+    return _keyframeRequested || _updatesSinceKeyframe >= _keyframeInterval;
+}
+
+SceneDelta SceneDeltaEncoder::_makeKeyframe(ScenePtr scene) const
+{
+    auto delta = SceneDelta();
+    delta.keyframe = std::move(scene);
+    return delta;
+}
+
+SceneDelta SceneDeltaEncoder::_makePatch(const Scene& scene) const
+{
+    auto delta = SceneDelta();
+    for (const auto& surface : scene.getSurfaces())
+    {
+        const auto& group = surface.getGroup();
+
+        auto surfaceDelta = SurfaceDelta();
+        surfaceDelta.groupCoordinates = group.getCoordinates();
+        surfaceDelta.background = surface.getBackgroundPtr();
+        surfaceDelta.contextMenu = surface.getContextMenuPtr();
+        if (const auto fullscreenWindow = group.getFullscreenWindow())
+            surfaceDelta.fullscreenWindowId = fullscreenWindow->getID();
+
+        for (const auto& window : group.getWindows())
+        {
+            surfaceDelta.windowIds.push_back(window->getID());
+
+            const auto it = _windowVersions.find(window->getID());
+            if (it == _windowVersions.end() ||
+                it->second != window->getVersion())
+            {
+                delta.windows.push_back(window);
+            }
+        }
+        delta.surfaces.push_back(std::move(surfaceDelta));
+    }
+    return delta;
+}
+
+void SceneDeltaEncoder::_updateWindowVersions(const Scene& scene)
+{
+    _windowVersions.clear();
+    for (const auto& window : scene.getWindows())
+        _windowVersions[window->getID()] = window->getVersion();
+}
@@ -0,0 +1,88 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SCENEDELTAENCODER_H
+#define SCENEDELTAENCODER_H
+
+#include "scene/SceneDelta.h"
+#include "types.h"
+
+#include <map>
+
+/**
+ * Encode successive Scene updates into SceneDeltas for the wall processes.
+ *
+ * Only the windows whose version has changed since the previous update are
+ * included in a patch. A full keyframe is emitted periodically so that wall
+ * processes which are out of step can resynchronize.
+ */
+class SceneDeltaEncoder
+{
+public:
+    /**
+     * Create an encoder.
+     * @param keyframeInterval number of updates between two keyframes
+     *        (the first update is always a keyframe).
+     */
+    explicit SceneDeltaEncoder(uint keyframeInterval = 100);
+
+    /**
+     * Encode the next update for the given scene.
+     * @param scene the current scene.
+     * @return a keyframe or a patch relative to the previous update.
+     */
+    SceneDelta encode(ScenePtr scene);
+
+    /** Force the next update to be a keyframe. */
+    void requestKeyframe();
+
+private:
+    const uint _keyframeInterval;
+    uint _updatesSinceKeyframe = 0;
+    uint64_t _version = 0;
+    bool _keyframeRequested = true;
+    std::map<QUuid, size_t> _windowVersions;
+
+    bool _needsKeyframe() const;
+    SceneDelta _makeKeyframe(ScenePtr scene) const;
+    SceneDelta _makePatch(const Scene& scene) const;
+    void _updateWindowVersions(const Scene& scene);
+};
+
+#endif
@@ -98,6 +98,19 @@ struct UriAndSurface : Uri, SurfaceIndex
     }
 };
 
+struct ScreenshotParams : UriAndSurface
+{
+    double scale = 1.0;
+    int quality = -1;
+
+    bool fromJson(const QJsonObject& object)
+    {
+        json::deserialize(object["scale"], scale);
+        json::deserialize(object["quality"], quality);
+        return UriAndSurface::fromJson(object) && scale > 0.0 && scale <= 1.0;
+    }
+};
+
 struct BrowseParams : UriAndSurface
 {
     bool fromJson(const QJsonObject& object)
@@ -154,6 +167,15 @@ AppRemoteController::AppRemoteController(const Configuration& config)
         emit this->save(_makeAbsPath(sessionsDir, params.uri), boolCallback);
     });
 
+    bindAsync<Uri>("savetrace", [this](const auto params,
+                                       jsonrpc::AsyncResponse respond) {
+        auto boolCallback = [respond](const bool result,
+                                      const QString message) {
+            respond(makeJsonRpcResponse(result, message));
+        };
+        emit this->saveTrace(params.uri, boolCallback);
+    });
+
     using rpc = jsonrpc::Receiver; // Disambiguating from QObject::connect
     rpc::connect<BrowseParams>("browse", [this, defaultUrl](auto params) {
         if (params.uri.isEmpty())
@@ -161,12 +183,15 @@ AppRemoteController::AppRemoteController(const Configuration& config)
         emit this->browse(params.surfaceIndex, params.uri, QSize(), QPointF(),
                           0);
     });
-    rpc::connect<UriAndSurface>("screenshot", [this](const auto params) {
-        emit this->takeScreenshot(params.surfaceIndex, params.uri);
+    rpc::connect<ScreenshotParams>("screenshot", [this](const auto params) {
+        emit this->takeScreenshot(params.surfaceIndex, params.uri, params.scale,
+                                  params.quality);
     });
     rpc::connect<SurfaceIndex>("whiteboard", [this](const auto params) {
         emit this->openWhiteboard(params.surfaceIndex);
     });
+    rpc::connect("starttrace", [this] { emit this->startTrace(); });
+    rpc::connect("stoptrace", [this] { emit this->stopTrace(); });
     rpc::connect("exit", [this] { emit this->exit(); });
 #if TIDE_ENABLE_PLANAR_CONTROLLER
     bindAsync("poweroff",
@@ -83,8 +83,28 @@ signals:
     /** Open a whiteboard. */
     void openWhiteboard(uint surfaceIndex);
 
-    /** Take a screenshot. */
-    void takeScreenshot(uint surfaceIndex, QString filename);
+    /**
+     * Take a screenshot.
+     * @param surfaceIndex the surface to capture.
+     * @param filename the output file, its extension selects the format.
+     * @param scale the scale of the screenshot, in ]0, 1].
+     * @param quality the encoding quality [0-100], -1 for the default.
+     */
+    void takeScreenshot(uint surfaceIndex, QString filename, double scale,
+                        int quality);
+
+    /** Start recording trace events on all processes. */
+    void startTrace();
+
+    /** Stop recording trace events on all processes. */
+    void stopTrace();
+
+    /**
+     * Save the recorded trace events of all processes.
+     * @param filename the output file, in Chrome trace format (JSON).
+     * @param callback called once the trace is saved, or refused.
+     */
+    void saveTrace(QString filename, BoolMsgCallback callback);
 
     /** Power off the screens. */
     void powerOff(BoolCallback callback);
@@ -51,6 +51,7 @@
 #include "scene/Scene.h"
 #include "session/Session.h"
 #include "tools/ActivityLogger.h"
+#include "tools/TelemetryAggregator.h"
 #include "utils/log.h"
 #include "json/serialization.h"
 // include last
@@ -191,6 +192,11 @@ void RestInterface::exposeStatistics(const ActivityLogger& logger) const
     _impl->server.handleGET("tide/stats", logger);
 }
 
+void RestInterface::exposeTelemetry(const TelemetryAggregator& aggregator) const
+{
+    _impl->server.handleGET("tide/telemetry", aggregator);
+}
+
 const AppRemoteController& RestInterface::getAppRemoteController() const
 {
     return _impl->appRemoteController;
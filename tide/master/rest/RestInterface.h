@@ -76,6 +76,9 @@ public:
     /** Expose the statistics gathered by the given activity logger. */
     void exposeStatistics(const ActivityLogger& logger) const;
 
+    /** Expose the performance of the wall processes. */
+    void exposeTelemetry(const TelemetryAggregator& aggregator) const;
+
     const AppRemoteController& getAppRemoteController() const;
 
     /** Prevent modifying the wall via the interface. */
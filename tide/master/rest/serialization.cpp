@@ -47,6 +47,7 @@
 #include "scene/Scene.h"
 #include "session/Session.h"
 #include "tools/ActivityLogger.h"
+#include "tools/TelemetryAggregator.h"
 #include "json/json.h"
 #include "json/serialization.h"
 #include "json/templates.h"
@@ -150,6 +151,72 @@ QJsonObject serialize(const ActivityLogger& logger)
                        {"screens", screens}};
 }
 
+QJsonObject serialize(const TelemetryAggregator& aggregator)
+{
+    const auto now = TelemetryAggregator::clock::now();
+
+    QJsonArray ranks;
+    for (const auto& rank : aggregator.getRanks(now))
+    {
+        QJsonArray surfaces;
+        for (const auto index : rank.surfaces)
+            surfaces.append(int(index));
+
+        const auto& t = rank.telemetry;
+        const QJsonObject frameTime{{"mean", t.frameTimeMean},
+                                    {"p50", t.frameTimeP50},
+                                    {"p90", t.frameTimeP90},
+                                    {"p99", t.frameTimeP99},
+                                    {"max", t.frameTimeMax}};
+        const QJsonObject syncWait{{"mean", t.syncWaitMean},
+                                   {"max", t.syncWaitMax}};
+        const QJsonObject swapWait{{"mean", t.swapWaitMean},
+                                   {"max", t.swapWaitMax}};
+        const QJsonObject tiles{{"loaded", int(t.tilesLoaded)},
+                                {"decode_mean", t.decodeTimeMean},
+                                {"decode_max", t.decodeTimeMax},
+                                {"queue_depth", int(t.tileQueueDepth)},
+                                {"cache_bytes", double(t.cacheBytes)}};
+        ranks.append(QJsonObject{{"rank", rank.rank},
+                                 {"host", rank.host},
+                                 {"surfaces", surfaces},
+                                 {"received", rank.received},
+                                 {"age", rank.age},
+                                 {"stale", rank.stale},
+                                 {"straggler", rank.straggler},
+                                 {"fps", t.getFps()},
+                                 {"frames", int(t.frames)},
+                                 {"frame_time", frameTime},
+                                 {"work_time_mean", t.getWorkTimeMean()},
+                                 {"sync_wait", syncWait},
+                                 {"swap_wait", swapWait},
+                                 {"tiles", tiles}});
+    }
+
+    QJsonArray surfaces;
+    for (const auto& surface : aggregator.getSurfaces(now))
+    {
+        QJsonArray stragglers;
+        for (const auto rank : surface.stragglers)
+            stragglers.append(rank);
+
+        surfaces.append(
+            QJsonObject{{"index", int(surface.index)},
+                        {"processes", int(surface.processes)},
+                        {"reporting", int(surface.reporting)},
+                        {"min_fps", surface.minFps},
+                        {"max_frame_time_p99", surface.maxFrameTimeP99},
+                        {"tile_queue_depth", double(surface.tileQueueDepth)},
+                        {"cache_bytes", double(surface.cacheBytes)},
+                        {"stragglers", stragglers}});
+    }
+
+    const auto interval = int(aggregator.getInterval().count());
+    return QJsonObject{{"interval", interval},
+                       {"ranks", ranks},
+                       {"surfaces", surfaces}};
+}
+
 QJsonObject serialize(const SessionInfo& info)
 {
     return QJsonObject{{"filename", QFileInfo{info.filepath}.baseName()},
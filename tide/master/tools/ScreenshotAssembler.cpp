@@ -39,14 +39,40 @@
 
 #include "ScreenshotAssembler.h"
 
+#include "utils/log.h"
+
 #include <QPainter>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
 
-ScreenshotAssembler::ScreenshotAssembler(const SurfaceConfig& surface)
+ScreenshotAssembler::ScreenshotAssembler(const SurfaceConfig& surface,
+                                         const qreal scale,
+                                         const Output output)
     : _surface(surface)
-    , _screenshot{_surface.getTotalSize(), QImage::Format_RGB32}
+    , _scale{scale}
+    , _output{output}
+    , _size{_scaled(QRect{QPoint(), _surface.getTotalSize()}).size()}
 {
+    if (_output == Output::image)
+        _screenshot = QImage{_size, QImage::Format_RGB32};
+
     const auto count = _surface.screenCountX * _surface.screenCountY;
-    _imagesReceived.resize(count, false);
+    _images.resize(count);
+
+    // A single thread emits the bands in order
+    _worker.setMaxThreadCount(1);
+}
+
+ScreenshotAssembler::~ScreenshotAssembler()
+{
+    _worker.waitForDone();
+}
+
+QSize ScreenshotAssembler::getSize() const
+{
+    return _size;
 }
 
 bool ScreenshotAssembler::isComplete() const
@@ -56,26 +82,116 @@ bool ScreenshotAssembler::isComplete() const
 
 void ScreenshotAssembler::addImage(const QImage image, const QPoint index)
 {
+    auto& screen = _getScreenImage(index);
+    screen.image = image;
+    screen.received = true;
+    _assembleCompleteRows();
+}
+
+void ScreenshotAssembler::addEncodedImage(const QByteArray data,
+                                          const QPoint index)
+{
+    auto& screen = _getScreenImage(index);
+    screen.data = data;
+    screen.received = true;
+    _assembleCompleteRows();
+}
+
+ScreenshotAssembler::ScreenImage& ScreenshotAssembler::_getScreenImage(
+    const QPoint& index)
+{
+    _surface.getScreenRect(index); // validate index
+    _complete = false;
+    return _images[index.x() + index.y() * _surface.screenCountX];
+}
+
+bool ScreenshotAssembler::_isRowComplete(const uint row) const
+{
+    const auto begin = _images.begin() + row * _surface.screenCountX;
+    const auto end = begin + _surface.screenCountX;
+    return std::all_of(begin, end, [](const ScreenImage& screen) {
+        return screen.received;
+    });
+}
+
+void ScreenshotAssembler::_assembleCompleteRows()
+{
+    while (_nextRow < _surface.screenCountY && _isRowComplete(_nextRow))
+        _assembleRowAsync(_nextRow++);
+
+    if (_nextRow == _surface.screenCountY)
     {
-        QPainter{&_screenshot}.drawImage(_surface.getScreenRect(index), image);
+        _nextRow = 0;
+        QtConcurrent::run(&_worker, [this] {
+            _complete = true;
+            emit screenshotComplete(_screenshot);
+        });
     }
+}
 
-    const auto source = index.x() + index.y() * _surface.screenCountX;
-    _imagesReceived[source] = true;
-    _complete = false;
+void ScreenshotAssembler::_assembleRowAsync(const uint row)
+{
+    // The worker takes the images of the row, ready for the next screenshot
+    const auto begin = _images.begin() + row * _surface.screenCountX;
+    const auto end = begin + _surface.screenCountX;
+    auto screens = std::vector<ScreenImage>(begin, end);
+    std::fill(begin, end, ScreenImage());
 
-    if (_hasReceivedAllImages())
+    QtConcurrent::run(&_worker, [this, row, screens]() mutable {
+        const auto band = _assembleRow(row, screens);
+        if (_output == Output::image)
+            QPainter{&_screenshot}.drawImage(0, _getBandTop(row), band);
+        emit bandComplete(band);
+    });
+}
+
+QImage ScreenshotAssembler::_assembleRow(
+    const uint row, std::vector<ScreenImage>& screens) const
+{
+    // Decoding is the most expensive step, do it for all screens in parallel
+    QtConcurrent::blockingMap(screens, [](ScreenImage& screen) {
+        if (screen.image.isNull())
+            screen.image = QImage::fromData(screen.data);
+    });
+
+    const auto top = _getBandTop(row);
+    auto band = QImage{_size.width(), _getBandTop(row + 1) - top,
+                       QImage::Format_RGB32};
+    band.fill(Qt::black);
+
+    QPainter painter{&band};
+    for (auto x = 0u; x < _surface.screenCountX; ++x)
     {
-        _complete = true;
-        std::fill(_imagesReceived.begin(), _imagesReceived.end(), false);
-        emit screenshotComplete(_screenshot);
+        const auto& screen = screens[x];
+        if (screen.image.isNull())
+            print_log(LOG_WARN, LOG_GENERAL,
+                      "screenshot is missing the image of screen (%u, %u)", x,
+                      row);
+
+        const auto index = QPoint(x, row);
+        const auto rect = _scaled(_surface.getScreenRect(index));
+        painter.drawImage(rect.translated(0, -top), screen.image);
     }
+    return band;
+}
+
+int ScreenshotAssembler::_getBandTop(const uint row) const
+{
+    if (row == 0)
+        return 0;
+    if (row == _surface.screenCountY)
+        return _size.height();
+    return _scaled(_surface.getScreenRect(QPoint(0, row))).top();
 }
 
-bool ScreenshotAssembler::_hasReceivedAllImages() const
+QRect ScreenshotAssembler::_scaled(const QRect& rect) const
 {
-    for (const auto& received : _imagesReceived)
-        if (!received)
-            return false;
-    return true;
+    // Round the edges rather than the sizes so that adjacent screens still
+    // share the same edges after scaling.
+    const auto round = [this](const int value) {
+        return int(std::round(value * _scale));
+    };
+    return QRect{QPoint{round(rect.left()), round(rect.top())},
+                 QPoint{round(rect.right() + 1) - 1,
+                        round(rect.bottom() + 1) - 1}};
 }
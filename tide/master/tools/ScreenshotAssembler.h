@@ -44,23 +44,53 @@
 
 #include <QImage>
 #include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
 
 /**
- * Assemble screenshots from the wall processes into a single image.
+ * Assemble screenshots from the wall processes.
+ *
+ * The images of the screens are assembled one row of screens at a time, from
+ * top to bottom, so that the screenshot can be streamed to disk by bands
+ * instead of being held in memory as a single image. Encoded images are only
+ * decoded once the band they belong to is complete.
+ *
+ * The images are added from the thread of the assembler, but the bands are
+ * decoded and assembled on a worker thread, one after the other. The signals
+ * are emitted from the worker thread: receivers connected directly, such as a
+ * writer of the bands, also run there.
  */
 class ScreenshotAssembler : public QObject
 {
     Q_OBJECT
 
 public:
+    /** The output of the assembler. */
+    enum class Output
+    {
+        image, // assemble a single image, see screenshotComplete()
+        bands  // only emit the bands of the image, see bandComplete()
+    };
+
     /**
      * Construct a screenshot assembler for a certain surface.
      *
      * @param config the configuration of the surface.
+     * @param scale the scale of the images sent by the wall processes.
+     * @param output the type of output of the assembler.
      */
-    explicit ScreenshotAssembler(const SurfaceConfig& config);
+    explicit ScreenshotAssembler(const SurfaceConfig& config,
+                                 qreal scale = 1.0,
+                                 Output output = Output::image);
+
+    /** Destructor, waits for the bands being assembled. */
+    ~ScreenshotAssembler();
+
+    /** @return the size of the screenshot in pixels. */
+    QSize getSize() const;
 
-    /** @return true once the screenshot is complete. */
+    /** @return true once screenshotComplete() has been emitted. */
     bool isComplete() const;
 
 public slots:
@@ -71,17 +101,52 @@ public slots:
      */
     void addImage(QImage image, QPoint index);
 
+    /**
+     * Add an encoded image to the current screenshot.
+     * @param data the image encoded in a format supported by QImage.
+     * @param index the index of the wall process that sent the image.
+     */
+    void addEncodedImage(QByteArray data, QPoint index);
+
 signals:
-    /** Emitted when the last image forming the screenshot has been added. */
+    /**
+     * Emitted, from top to bottom, for each band of the screenshot covered by
+     * a row of screens once all of its images have been added and assembled.
+     * Emitted from the worker thread.
+     */
+    void bandComplete(QImage band);
+
+    /**
+     * Emitted after the last band of the screenshot, from the worker thread.
+     * The image is null if the output of the assembler is Output::bands.
+     */
     void screenshotComplete(QImage image);
 
 private:
+    struct ScreenImage
+    {
+        QImage image;
+        QByteArray data;
+        bool received = false;
+    };
+
     const SurfaceConfig& _surface;
-    QImage _screenshot;
-    std::vector<bool> _imagesReceived;
-    bool _complete = false;
+    const qreal _scale;
+    const Output _output;
+    const QSize _size;
+    QImage _screenshot; // only used by the worker thread
+    std::vector<ScreenImage> _images;
+    uint _nextRow = 0;
+    std::atomic<bool> _complete{false};
+    QThreadPool _worker;
 
-    bool _hasReceivedAllImages() const;
+    ScreenImage& _getScreenImage(const QPoint& index);
+    bool _isRowComplete(uint row) const;
+    void _assembleCompleteRows();
+    void _assembleRowAsync(uint row);
+    QImage _assembleRow(uint row, std::vector<ScreenImage>& screens) const;
+    int _getBandTop(uint row) const;
+    QRect _scaled(const QRect& rect) const;
 };
 
 #endif
@@ -0,0 +1,220 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TelemetryAggregator.h"
+
+#include "configuration/Configuration.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+namespace
+{
+float _toMs(const TelemetryAggregator::clock::duration duration)
+{
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+
+float _getMedian(std::vector<float> values)
+{
+    std::sort(values.begin(), values.end());
+    const auto middle = values.size() / 2;
+    if (values.size() % 2 == 1)
+        return values[middle];
+    return 0.5f * (values[middle - 1] + values[middle]);
+}
+}
+
+constexpr float TelemetryAggregator::stragglerRatio;
+constexpr float TelemetryAggregator::stragglerMargin;
+constexpr int TelemetryAggregator::staleIntervals;
+
+TelemetryAggregator::TelemetryAggregator(const Configuration& config)
+    : _interval{config.global.telemetryInterval}
+    , _surfaceCount{config.surfaces.size()}
+    , _ranks(config.processes.size())
+    , _stragglers(config.processes.size(), false)
+{
+    for (size_t i = 0; i < config.processes.size(); ++i)
+    {
+        const auto& process = config.processes[i];
+        _ranks[i].host = process.host;
+        for (const auto& screen : process.screens)
+        {
+            auto& surfaces = _ranks[i].surfaces;
+            if (std::find(surfaces.begin(), surfaces.end(),
+                          screen.surfaceIndex) == surfaces.end())
+            {
+                surfaces.push_back(screen.surfaceIndex);
+            }
+        }
+    }
+}
+
+std::chrono::milliseconds TelemetryAggregator::getInterval() const
+{
+    return _interval;
+}
+
+void TelemetryAggregator::add(const WallTelemetry& telemetry,
+                              const clock::time_point time)
+{
+    if (telemetry.rank < 0 || size_t(telemetry.rank) >= _ranks.size())
+    {
+        print_log(LOG_DEBUG, LOG_GENERAL, "telemetry from unknown rank: %d",
+                  telemetry.rank);
+        return;
+    }
+
+    auto& rank = _ranks[telemetry.rank];
+    rank.received = true;
+    rank.telemetry = telemetry;
+    rank.time = time;
+
+    const auto stragglers = _findStragglers(time);
+    for (size_t i = 0; i < stragglers.size(); ++i)
+    {
+        if (stragglers[i] && !_stragglers[i])
+        {
+            print_log(LOG_WARN, LOG_GENERAL,
+                      "wall process %d (%s) is a straggler: %.2f ms of work "
+                      "per frame",
+                      int(i), _ranks[i].host.toLocal8Bit().constData(),
+                      _ranks[i].telemetry.getWorkTimeMean());
+        }
+    }
+    _stragglers = stragglers;
+}
+
+std::vector<TelemetryAggregator::RankStatus> TelemetryAggregator::getRanks(
+    const clock::time_point now) const
+{
+    const auto stragglers = _findStragglers(now);
+
+    auto ranks = std::vector<RankStatus>();
+    ranks.reserve(_ranks.size());
+    for (size_t i = 0; i < _ranks.size(); ++i)
+    {
+        const auto& rank = _ranks[i];
+        RankStatus status;
+        status.rank = int(i);
+        status.host = rank.host;
+        status.surfaces = rank.surfaces;
+        status.received = rank.received;
+        status.straggler = stragglers[i];
+        if (rank.received)
+        {
+            status.telemetry = rank.telemetry;
+            status.age = _toMs(now - rank.time);
+            status.stale = _isStale(rank, now);
+        }
+        ranks.push_back(status);
+    }
+    return ranks;
+}
+
+std::vector<TelemetryAggregator::SurfaceStatus>
+    TelemetryAggregator::getSurfaces(const clock::time_point now) const
+{
+    auto surfaces = std::vector<SurfaceStatus>(_surfaceCount);
+    for (size_t i = 0; i < surfaces.size(); ++i)
+        surfaces[i].index = uint(i);
+
+    for (const auto& status : getRanks(now))
+    {
+        for (const auto index : status.surfaces)
+        {
+            if (index >= surfaces.size())
+                continue;
+
+            auto& surface = surfaces[index];
+            ++surface.processes;
+            if (status.straggler)
+                surface.stragglers.push_back(status.rank);
+            if (!status.received || status.stale)
+                continue;
+
+            const auto& telemetry = status.telemetry;
+            const auto fps = telemetry.getFps();
+            surface.minFps =
+                surface.reporting == 0 ? fps : std::min(surface.minFps, fps);
+            surface.maxFrameTimeP99 =
+                std::max(surface.maxFrameTimeP99, telemetry.frameTimeP99);
+            surface.tileQueueDepth += telemetry.tileQueueDepth;
+            surface.cacheBytes += telemetry.cacheBytes;
+            ++surface.reporting;
+        }
+    }
+    return surfaces;
+}
+
+bool TelemetryAggregator::_isStale(const Rank& rank,
+                                   const clock::time_point now) const
+{
+    return !rank.received || now - rank.time > staleIntervals * _interval;
+}
+
+std::vector<bool> TelemetryAggregator::_findStragglers(
+    const clock::time_point now) const
+{
+    auto stragglers = std::vector<bool>(_ranks.size(), false);
+
+    // Only the processes which are currently rendering can be compared
+    auto workTimes = std::vector<float>();
+    for (const auto& rank : _ranks)
+    {
+        if (!_isStale(rank, now) && rank.telemetry.frames > 0)
+            workTimes.push_back(rank.telemetry.getWorkTimeMean());
+    }
+    if (workTimes.size() < 2)
+        return stragglers;
+
+    const auto median = _getMedian(workTimes);
+    for (size_t i = 0; i < _ranks.size(); ++i)
+    {
+        const auto& rank = _ranks[i];
+        if (_isStale(rank, now) || rank.telemetry.frames == 0)
+            continue;
+
+        const auto workTime = rank.telemetry.getWorkTimeMean();
+        stragglers[i] = workTime > stragglerRatio * median &&
+                        workTime > median + stragglerMargin;
+    }
+    return stragglers;
+}
@@ -0,0 +1,142 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TELEMETRYAGGREGATOR_H
+#define TELEMETRYAGGREGATOR_H
+
+#include "network/WallTelemetry.h"
+#include "types.h"
+
+#include <QString>
+
+#include <chrono>
+#include <vector>
+
+/**
+ * Aggregate the telemetry reported by the wall processes, per process and per
+ * surface.
+ *
+ * Since the frames of all the wall processes are synchronized, their frame
+ * times are equal and do not reveal which process is slowing down the others.
+ * Stragglers are instead detected from the time of a frame not spent waiting
+ * for the other processes, which is only high for the slowest processes.
+ */
+class TelemetryAggregator
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /** Minimum ratio of the work time of a straggler to the median. */
+    static constexpr float stragglerRatio = 1.5f;
+
+    /** Minimum difference of the work time of a straggler to the median. */
+    static constexpr float stragglerMargin = 1.f; // [ms]
+
+    /** Reports older than this number of intervals are stale. */
+    static constexpr int staleIntervals = 3;
+
+    /** The last known state of a wall process. */
+    struct RankStatus
+    {
+        int rank = 0;
+        QString host;
+        std::vector<uint> surfaces;
+        bool received = false;  // at least one report was received
+        WallTelemetry telemetry;
+        float age = 0.f;        // time since the last report [ms]
+        bool stale = false;     // no report for staleIntervals
+        bool straggler = false; // slower than the other processes
+    };
+
+    /** The state of a surface, aggregated over its (non-stale) processes. */
+    struct SurfaceStatus
+    {
+        uint index = 0;
+        size_t processes = 0;
+        size_t reporting = 0;
+        float minFps = 0.f;
+        float maxFrameTimeP99 = 0.f;
+        uint64_t tileQueueDepth = 0;
+        uint64_t cacheBytes = 0;
+        std::vector<int> stragglers;
+    };
+
+    /**
+     * Construct an aggregator for the wall processes of a configuration.
+     * @param config with the processes, their surfaces and the interval.
+     */
+    explicit TelemetryAggregator(const Configuration& config);
+
+    /** @return the reporting interval of the wall processes. */
+    std::chrono::milliseconds getInterval() const;
+
+    /**
+     * Add the telemetry of a wall process; reports of unknown ranks are
+     * ignored. Logs a warning when a process becomes a straggler.
+     * @param telemetry reported by a wall process.
+     * @param time of reception.
+     */
+    void add(const WallTelemetry& telemetry, clock::time_point time);
+
+    /** @return the state of all the wall processes at a given time. */
+    std::vector<RankStatus> getRanks(clock::time_point now) const;
+
+    /** @return the state of all the surfaces at a given time. */
+    std::vector<SurfaceStatus> getSurfaces(clock::time_point now) const;
+
+private:
+    struct Rank
+    {
+        QString host;
+        std::vector<uint> surfaces;
+        bool received = false;
+        WallTelemetry telemetry;
+        clock::time_point time;
+    };
+
+    const std::chrono::milliseconds _interval;
+    const size_t _surfaceCount;
+    std::vector<Rank> _ranks;
+    std::vector<bool> _stragglers;
+
+    bool _isStale(const Rank& rank, clock::time_point now) const;
+    std::vector<bool> _findStragglers(clock::time_point now) const;
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TraceAssembler.h"
+
+#include "utils/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+const int masterPid = 0;
+}
+
+TraceAssembler::TraceAssembler(std::vector<trace::ThreadEvents> masterEvents,
+                               const size_t wallCount,
+                               const std::chrono::milliseconds timeout)
+    : _masterEvents(std::move(masterEvents))
+    , _wallCount{wallCount}
+{
+    _timeout.setSingleShot(true);
+    connect(&_timeout, &QTimer::timeout, this, &TraceAssembler::finish);
+    _timeout.start(int(timeout.count()));
+}
+
+bool TraceAssembler::isComplete() const
+{
+    return _replies.size() == _wallCount;
+}
+
+bool TraceAssembler::isFinished() const
+{
+    return _finished;
+}
+
+std::vector<int> TraceAssembler::getMissingRanks() const
+{
+    std::vector<int> missing;
+    for (int rank = 0; rank < int(_wallCount); ++rank)
+    {
+        const auto hasReplied = [rank](const TraceReply& reply) {
+            return reply.rank == rank;
+        };
+        if (std::none_of(_replies.begin(), _replies.end(), hasReplied))
+            missing.push_back(rank);
+    }
+    return missing;
+}
+
+trace::clock::duration TraceAssembler::estimateClockOffset(
+    const std::vector<TraceReply>& replies)
+{
+    auto offset = trace::clock::duration::zero();
+    auto minRoundTrip = std::numeric_limits<int64_t>::max();
+    for (const auto& reply : replies)
+    {
+        const auto roundTrip = (reply.receiveTime - reply.requestSendTime) -
+                               (reply.sendTime - reply.requestReceiveTime);
+        if (roundTrip >= minRoundTrip)
+            continue;
+
+        minRoundTrip = roundTrip;
+        const auto ns = ((reply.requestReceiveTime - reply.requestSendTime) +
+                         (reply.sendTime - reply.receiveTime)) /
+                        2;
+        offset = std::chrono::duration_cast<trace::clock::duration>(
+            std::chrono::nanoseconds{ns});
+    }
+    return offset;
+}
+
+void TraceAssembler::addReply(TraceReply reply)
+{
+    const auto isDuplicate = [&reply](const TraceReply& other) {
+        return other.rank == reply.rank;
+    };
+    if (_finished || reply.rank < 0 || reply.rank >= int(_wallCount) ||
+        std::any_of(_replies.begin(), _replies.end(), isDuplicate))
+    {
+        return;
+    }
+
+    _replies.push_back(std::move(reply));
+    if (isComplete())
+        finish();
+}
+
+void TraceAssembler::finish()
+{
+    if (_finished)
+        return;
+
+    _finished = true;
+    _timeout.stop();
+
+    const auto missingRanks = getMissingRanks();
+    if (!missingRanks.empty())
+    {
+        std::ostringstream ranks;
+        for (const auto rank : missingRanks)
+            ranks << " " << rank;
+        print_log(LOG_WARN, LOG_GENERAL,
+                  "Trace assembled without the wall processes:%s",
+                  ranks.str().c_str());
+    }
+    emit traceComplete(_assemble(), missingRanks);
+}
+
+QByteArray TraceAssembler::_assemble() const
+{
+    const auto offset = estimateClockOffset(_replies);
+
+    QByteArray json{"{\"traceEvents\":["};
+    json.append(trace::toChromeEvents(_masterEvents, masterPid, "Master",
+                                      offset)
+                    .c_str());
+    for (const auto& reply : _replies)
+    {
+        if (reply.events.empty())
+            continue;
+        json.append(',');
+        json.append(reply.events.data(), int(reply.events.size()));
+    }
+    json.append("],\"displayTimeUnit\":\"ms\"}");
+    return json;
+}
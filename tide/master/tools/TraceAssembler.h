@@ -0,0 +1,124 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TRACEASSEMBLER_H
+#define TRACEASSEMBLER_H
+
+#include "network/TraceReply.h"
+#include "utils/trace.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+
+/**
+ * Assemble the trace events of the master and the wall processes into a
+ * single Chrome trace (JSON), viewable in chrome://tracing.
+ *
+ * The wall processes align their events on the clock of the first wall
+ * process. The events of the master are shifted by the offset of its clock,
+ * estimated from the timestamps of the replies.
+ *
+ * A wall process which does not reply in time (crashed, or busy) does not
+ * block the collection: the trace is then assembled with the replies received
+ * so far.
+ */
+class TraceAssembler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Construct a trace assembler.
+     *
+     * @param masterEvents the events recorded by the master process.
+     * @param wallCount the number of wall processes expected to reply.
+     * @param timeout after which finish() is called.
+     */
+    TraceAssembler(std::vector<trace::ThreadEvents> masterEvents,
+                   size_t wallCount, std::chrono::milliseconds timeout);
+
+    /** @return true once the replies of all wall processes were added. */
+    bool isComplete() const;
+
+    /** @return true once the trace was assembled, complete or not. */
+    bool isFinished() const;
+
+    /** @return the ranks of the wall processes which did not reply yet. */
+    std::vector<int> getMissingRanks() const;
+
+    /**
+     * Estimate the offset of the master clock relative to the wall processes.
+     *
+     * The reply with the shortest round trip gives the best estimate, assuming
+     * that the network delay is the same in both directions.
+     * @param replies with all their times set.
+     * @return the duration to add to master times to align them on the walls.
+     */
+    static trace::clock::duration estimateClockOffset(
+        const std::vector<TraceReply>& replies);
+
+public slots:
+    /** Add the reply of a wall process; ignored once finished. */
+    void addReply(TraceReply reply);
+
+    /** Assemble the trace with the replies received so far, if not done. */
+    void finish();
+
+signals:
+    /**
+     * Emitted with the trace once all replies were added, or on finish().
+     * @param json the trace.
+     * @param missingRanks the wall processes which did not reply.
+     */
+    void traceComplete(QByteArray json, std::vector<int> missingRanks);
+
+private:
+    const std::vector<trace::ThreadEvents> _masterEvents;
+    const size_t _wallCount;
+    std::vector<TraceReply> _replies;
+    bool _finished = false;
+    QTimer _timeout;
+
+    QByteArray _assemble() const;
+};
+
+#endif
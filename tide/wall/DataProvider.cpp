@@ -42,18 +42,20 @@
 #include "config.h"
 #include "datasources/DataSourceFactory.h"
 #include "datasources/PixelStreamUpdater.h"
-#include "network/WallToWallChannel.h"
+#include "network/FrameSync.h"
 #include "qml/Tile.h"
 #include "scene/Background.h"
 #include "scene/PixelStreamContent.h"
 #include "scene/Scene.h"
 #include "scene/Window.h"
 #include "synchronizers/ContentSynchronizerFactory.h"
+#include "tools/TelemetryCollector.h"
 #include "utils/log.h"
+#include "utils/trace.h"
 
 #include <deflect/server/Frame.h>
 
-#include <QtConcurrent>
+#include <algorithm>
 
 namespace
 {
@@ -74,20 +76,69 @@ inline auto cast_to_stream_source(DataSourceSharedPtr source)
 {
     return std::dynamic_pointer_cast<PixelStreamUpdater>(source);
 }
+
+TileLoadScheduler::SourceType _getSourceType(DataSourceSharedPtr source)
+{
+    using SourceType = TileLoadScheduler::SourceType;
+    if (cast_to_stream_source(source))
+        return SourceType::stream;
+    if (source->isDynamic())
+        return SourceType::movie;
+    return SourceType::static_;
+}
+}
+
+DataProvider::DataProvider(const size_t loadThreadCount,
+                           const size_t tileCacheSize,
+                           std::unique_ptr<DiskTileCache> diskTileCache)
+    : _tileCache{tileCacheSize, std::move(diskTileCache)}
+    , _scheduler{loadThreadCount}
+{
 }
 
 DataProvider::~DataProvider()
 {
-    for (auto watcher : _watchers)
+    const auto stats = _tileCache.getStats();
+    print_log(LOG_INFO, LOG_GENERAL,
+              "tile cache: %llu hits, %llu misses, %llu evictions",
+              (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+              (unsigned long long)stats.evictions);
+
+    if (const auto diskCache = _tileCache.getDiskCache())
     {
-        watcher->disconnect(this);
-        watcher->waitForFinished();
-        delete watcher;
+        const auto diskStats = diskCache->getStats();
+        print_log(LOG_INFO, LOG_GENERAL,
+                  "disk tile cache: %llu hits, %llu misses, %llu writes",
+                  (unsigned long long)diskStats.hits,
+                  (unsigned long long)diskStats.misses,
+                  (unsigned long long)diskStats.writes);
     }
 }
 
+TileCache::Stats DataProvider::getTileCacheStats() const
+{
+    return _tileCache.getStats();
+}
+
+void DataProvider::setTextureCompression(const std::set<ContentType>& types)
+{
+    _compressedTypes = types;
+}
+
+void DataProvider::setTelemetryCollector(TelemetryCollector* telemetry)
+{
+    _telemetry = telemetry;
+}
+
+size_t DataProvider::getPendingTileLoadCount() const
+{
+    return _scheduler.getPendingCount();
+}
+
 void DataProvider::updateDataSources(const Scene& scene)
 {
+    TIDE_TRACE_SCOPE("updateDataSources");
+
     // Synchronized contents (such as streams and movies) must be added and
     // removed synchronously here. Otherwise, in synchronizeTilesSwap() locking
     // the weak pointer may succeed on processes that are asynchronously getting
@@ -124,30 +175,49 @@ std::unique_ptr<ContentSynchronizer> DataProvider::createSynchronizer(
 
     connect(synchronizer.get(), &ContentSynchronizer::requestTileUpdate, this,
             &DataProvider::loadAsync);
+    connect(synchronizer.get(), &ContentSynchronizer::requestTilesPrefetch,
+            this, [this, source](const Indices& tileIds, deflect::View view) {
+                _prefetch(source, tileIds, view);
+            });
 
     return synchronizer;
 }
 
-void DataProvider::synchronizeTilesSwap(WallToWallChannel& channel)
+void DataProvider::prepareFrameSync(FrameSync& frame)
 {
+    _swapTilesKeys.clear();
     for (auto dataSource : _dataSources)
     {
         auto& source = *dataSource.second;
         if (source.isDynamic()) // movies and pixelstreams
         {
-            if (channel.allReady(source.synchronizers.canSwapTiles()))
-            {
-                source.synchronizers.swapTiles();
-                source.allowNextFrame();
-            }
+            const bool canSwap = source.synchronizers.canSwapTiles();
+            _swapTilesKeys[dataSource.first] = frame.addFlag(canSwap);
+        }
+        source.prepareFrameSync(frame);
+    }
+}
+
+void DataProvider::synchronizeTilesSwap(const FrameSync& frame)
+{
+    TIDE_TRACE_SCOPE("synchronizeTilesSwap");
+    for (const auto& key : _swapTilesKeys)
+    {
+        if (frame.allTrue(key.second))
+        {
+            auto& source = *_dataSources.at(key.first);
+            source.synchronizers.swapTiles();
+            source.allowNextFrame();
         }
     }
 }
 
-void DataProvider::synchronizeTilesUpdate(WallToWallChannel& channel)
+void DataProvider::synchronizeTilesUpdate(const FrameSync& frame,
+                                          const WallToWallChannel& channel)
 {
+    TIDE_TRACE_SCOPE("synchronizeTilesUpdate");
     for (auto dataSource : _dataSources)
-        dataSource.second->synchronizeFrameAdvance(channel);
+        dataSource.second->synchronizeFrameAdvance(frame, channel);
     _updateTiles();
 }
 
@@ -156,7 +226,8 @@ void DataProvider::loadAsync(TilePtr tile, deflect::View view)
     // Group the requests for a single tile from multiple WallWindows for the
     // data source currently being processed.
     // This ensures that getTileImage is never called more than once per Tile.
-    _tileImageRequests[tile->getId()].push_back({tile, view});
+    _tileImageRequests[tile->getId()].push_back(
+        {tile, view, tile->getVisibleArea()});
 }
 
 void DataProvider::setNewFrame(deflect::server::FramePtr frame)
@@ -179,7 +250,9 @@ DataSourceSharedPtr DataProvider::_getOrCreateDataSource(const Content& content)
     const auto& id = content.getId();
     if (!_dataSources.count(id))
     {
-        _dataSources[id] = DataSourceFactory::create(content);
+        const auto compress = _compressedTypes.count(content.getType()) > 0;
+        _dataSources[id] =
+            DataSourceFactory::create(content, _tileCache, compress);
         if (auto stream = cast_to_stream_source(_dataSources[id]))
         {
             connect(stream.get(), &PixelStreamUpdater::requestFrame, this,
@@ -195,6 +268,8 @@ DataSourceSharedPtr DataProvider::_getOrCreateDataSource(const Content& content)
 
 void DataProvider::_updateTiles()
 {
+    _scheduler.cancelObsoleteRequests();
+
     auto it = _dataSources.begin();
     while (it != _dataSources.end())
     {
@@ -227,14 +302,23 @@ void DataProvider::_startAsyncTileImageRequests(DataSourceSharedPtr source)
 {
     for (const auto& tileRequest : _tileImageRequests)
     {
-        auto watcher = new Watcher;
-        _watchers.append(watcher);
-        connect(watcher, &Watcher::finished, this,
-                &DataProvider::_handleFinished);
-        watcher->setFuture(QtConcurrent::run(
-            [ this, source, tilesToUpdate = tileRequest.second ] {
-                _load(std::move(source), tilesToUpdate);
-            }));
+        const auto& tiles = tileRequest.second;
+
+        TileLoadScheduler::Request request;
+        request.sourceType = _getSourceType(source);
+        request.lod = source->getTileLod(tileRequest.first);
+        for (const auto& tile : tiles)
+            request.area = std::max(request.area, tile.visibleArea);
+
+        // The tiles expire when they are removed from the visible set
+        request.isObsolete = [tiles] {
+            return std::all_of(tiles.begin(), tiles.end(),
+                               [](const TileUpdateInfo& info) {
+                                   return info.tile.expired();
+                               });
+        };
+        request.load = [this, source, tiles] { _load(source, tiles); };
+        _scheduler.submit(std::move(request));
     }
 }
 
@@ -261,7 +345,12 @@ void DataProvider::_load(DataSourceSharedPtr source,
             {
                 if (!image.count(view))
                 {
+                    TIDE_TRACE_SCOPE("loadTileImage");
+                    const auto start = TelemetryCollector::clock::now();
                     image[view] = source->getTileImage(id, view);
+                    if (_telemetry)
+                        _telemetry->addTileLoad(
+                            TelemetryCollector::clock::now() - start);
                     if (!image[view])
                         throw std::logic_error("Unexpected empty image");
                 }
@@ -286,9 +375,35 @@ void DataProvider::_load(DataSourceSharedPtr source,
     }
 }
 
-void DataProvider::_handleFinished()
+void DataProvider::_prefetch(DataSourceSharedPtr source, const Indices& tileIds,
+                             const deflect::View view)
 {
-    auto watcher = static_cast<Watcher*>(sender());
-    _watchers.removeOne(watcher);
-    watcher->deleteLater();
+    // Prefetching must not keep a closed data source alive
+    const auto weakSource = std::weak_ptr<DataSource>{source};
+    for (const uint tileId : tileIds)
+    {
+        TileLoadScheduler::Request request;
+        request.sourceType = TileLoadScheduler::SourceType::prefetch;
+        request.lod = source->getTileLod(tileId);
+        request.isObsolete = [weakSource] { return weakSource.expired(); };
+        request.load = [weakSource, tileId, view] {
+            const auto dataSource = weakSource.lock();
+            if (!dataSource)
+                return;
+            TIDE_TRACE_SCOPE("prefetchTile");
+            try
+            {
+                dataSource->prefetchTile(tileId, view);
+            }
+            catch (const std::exception& e)
+            {
+                print_log(LOG_DEBUG, LOG_GENERAL,
+                          "Could not prefetch tile %d of content '%s': %s",
+                          tileId,
+                          dataSource->getUri().toLocal8Bit().constData(),
+                          e.what());
+            }
+        };
+        _scheduler.submit(std::move(request));
+    }
 }
@@ -40,15 +40,24 @@
 #ifndef DATAPROVIDER_H
 #define DATAPROVIDER_H
 
+#include "network/FrameSync.h"
+#include "scene/ContentType.h"
 #include "synchronizers/ContentSynchronizer.h"
+#include "tools/TileCache.h"
+#include "tools/TileLoadScheduler.h"
 #include "types.h"
 
-#include <QFutureWatcher>
-#include <QList>
 #include <QObject>
 
+#include <set>
+
 /**
  * Load tile images in parallel, synchronizing tiles swap and frame advance.
+ *
+ * Tile images are loaded by a TileLoadScheduler, which gives priority to the
+ * tiles that matter most on screen and drops requests for tiles which have
+ * been removed in the meantime. The images of static contents are kept in a
+ * TileCache shared by all the data sources.
  */
 class DataProvider : public QObject
 {
@@ -56,12 +65,40 @@ class DataProvider : public QObject
     Q_DISABLE_COPY(DataProvider)
 
 public:
-    /** Construct a data provider. */
-    DataProvider() = default;
+    /**
+     * Construct a data provider.
+     * @param loadThreadCount the number of threads for loading tile images.
+     * @param tileCacheSize the memory budget of the tile cache [bytes].
+     * @param diskTileCache optional persistent tile cache.
+     */
+    DataProvider(size_t loadThreadCount, size_t tileCacheSize,
+                 std::unique_ptr<DiskTileCache> diskTileCache = nullptr);
 
     /** Destructor. */
     ~DataProvider();
 
+    /** @return the hit, miss and eviction counters of the tile cache. */
+    TileCache::Stats getTileCacheStats() const;
+
+    /**
+     * Set the types of contents uploaded as compressed textures.
+     *
+     * Only affects the data sources created after this call.
+     * @param types of static contents to compress.
+     */
+    void setTextureCompression(const std::set<ContentType>& types);
+
+    /**
+     * Set a telemetry collector.
+     *
+     * @param telemetry to notify of the time taken to load tile images; must
+     *        outlive this object (optional).
+     */
+    void setTelemetryCollector(TelemetryCollector* telemetry);
+
+    /** @return the number of tile image loads waiting to start. */
+    size_t getPendingTileLoadCount() const;
+
     /**
      * Update the data sources when the scene has changed.
      *
@@ -78,19 +115,29 @@ public:
     std::unique_ptr<ContentSynchronizer> createSynchronizer(
         const Window& window, deflect::View view);
 
+    /**
+     * Add the local state of all data sources to the data of the next frame.
+     *
+     * The data sources must not be updated until the frame is synchronized.
+     * @param frame to be exchanged accross all wall processes.
+     */
+    void prepareFrameSync(FrameSync& frame);
+
     /**
      * Synchronize the swap of Tiles just before rendering.
      *
-     * @param channel to synchonize swap accross all wall processes.
+     * @param frame exchanged accross all wall processes.
      */
-    void synchronizeTilesSwap(WallToWallChannel& channel);
+    void synchronizeTilesSwap(const FrameSync& frame);
 
     /**
      * Synchronize the update of Tiles just before rendering.
      *
-     * @param channel to synchonize the update accross all wall processes.
+     * @param frame exchanged accross all wall processes.
+     * @param channel to get the synchronized time of the frame.
      */
-    void synchronizeTilesUpdate(WallToWallChannel& channel);
+    void synchronizeTilesUpdate(const FrameSync& frame,
+                                const WallToWallChannel& channel);
 
 public slots:
     /** Start loading a tile image asynchronously. */
@@ -110,19 +157,26 @@ signals:
     void imageLoaded();
 
 private:
-    using Watcher = QFutureWatcher<void>;
-    QList<Watcher*> _watchers;
+    // First member: must outlive the data sources which use it.
+    TileCache _tileCache;
 
     std::map<QUuid, DataSourceSharedPtr> _dataSources;
+    std::map<QUuid, FrameSync::Key> _swapTilesKeys;
+    std::set<ContentType> _compressedTypes;
+    TelemetryCollector* _telemetry = nullptr;
 
     struct TileUpdateInfo
     {
         TileWeakPtr tile;
         deflect::View view;
+        qreal visibleArea;
     };
     using TileUpdateList = std::vector<TileUpdateInfo>;
     std::map<uint, TileUpdateList> _tileImageRequests;
 
+    // Last member: stopped first, as requests call back into this object.
+    TileLoadScheduler _scheduler;
+
     void _createOrUpdateDataSource(const Content& content);
     DataSourceSharedPtr _getOrCreateDataSource(const Content& content);
 
@@ -130,7 +184,8 @@ private:
     void _startAsyncTileImageRequests(DataSourceSharedPtr source);
     void _handleStreamError(const QString& uri);
     void _load(DataSourceSharedPtr source, const TileUpdateList& tileList);
-    void _handleFinished();
+    void _prefetch(DataSourceSharedPtr source, const Indices& tileIds,
+                   deflect::View view);
 };
 
 #endif
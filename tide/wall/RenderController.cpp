@@ -48,24 +48,66 @@
 #include "scene/Scene.h"
 #include "scene/ScreenLock.h"
 #include "swapsync/SwapSynchronizer.h"
+#include "tools/FramePacer.h"
+#include "tools/TelemetryCollector.h"
+#include "utils/log.h"
+#include "utils/trace.h"
+
+#include <QBuffer>
+#include <QSysInfo>
+#include <QtConcurrent>
+
+#include <cmath>
+
+namespace
+{
+QByteArray _encode(const QImage& image, const ScreenshotRequest& request)
+{
+    auto screenshot = image.convertToFormat(QImage::Format_RGB32);
+    if (request.scale != 1.0)
+    {
+        const auto size = QSize(std::round(image.width() * request.scale),
+                                std::round(image.height() * request.scale));
+        screenshot = screenshot.scaled(size, Qt::IgnoreAspectRatio,
+                                       Qt::SmoothTransformation);
+    }
+
+    QByteArray data;
+    QBuffer buffer{&data};
+    const auto format = request.format.toLatin1();
+    if (!screenshot.save(&buffer, format.constData(), request.quality))
+        print_log(LOG_ERROR, LOG_GENERAL, "could not encode screenshot as %s",
+                  format.constData());
+    return data;
+}
+}
 
 RenderController::RenderController(const WallConfiguration& config,
                                    DataProvider& provider,
                                    WallToWallChannel& wallChannel,
                                    NetworkBarrier& swapSyncBarrier,
-                                   const SwapSync type)
+                                   const SwapSync type,
+                                   std::unique_ptr<FramePacer> framePacer,
+                                   TelemetryCollector* telemetry)
     : _windows{WallWindow::createWindows(config, provider)}
     , _provider{provider}
     , _wallChannel{wallChannel}
+    , _framePacer{std::move(framePacer)}
+    , _telemetry{telemetry}
 {
     _connectSwapSyncObjects();
     _connectRedrawSignal();
     _connectScreenshotSignals();
     _setupSwapSynchronization(swapSyncBarrier, type);
+    _setupFramePacing();
+    _setupTelemetry();
     updateScene(Scene::create(config.surfaces));
 }
 
-RenderController::~RenderController() = default;
+RenderController::~RenderController()
+{
+    _screenshotEncoders.waitForFinished();
+}
 
 void RenderController::updateScene(ScenePtr scene)
 {
@@ -97,12 +139,31 @@ void RenderController::updateCountdownStatus(CountdownStatusPtr status)
     _requestRender();
 }
 
-void RenderController::updateRequestScreenshot()
+void RenderController::updateRequestScreenshot(
+    const ScreenshotRequest request)
 {
+    _screenshotRequest = request;
     _syncScreenshot.update(true);
     _requestRender();
 }
 
+void RenderController::updateTraceRequest(const TraceRequest request)
+{
+    switch (request.action)
+    {
+    case TraceRequest::Action::start:
+        trace::clear();
+        trace::setEnabled(true);
+        break;
+    case TraceRequest::Action::stop:
+        trace::setEnabled(false);
+        break;
+    case TraceRequest::Action::dump:
+        _dumpTrace(request);
+        break;
+    }
+}
+
 void RenderController::updateQuit()
 {
     _syncQuit.update(true);
@@ -117,6 +178,8 @@ void RenderController::timerEvent(QTimerEvent* qtEvent)
         _requestRender();
     else if (qtEvent->timerId() == _stopRenderingDelayTimer)
         _stopRendering();
+    else if (qtEvent->timerId() == _telemetryTimer)
+        _reportTelemetry();
 }
 
 void RenderController::_connectSwapSyncObjects()
@@ -155,10 +218,44 @@ void RenderController::_connectScreenshotSignals()
     for (auto&& window : _windows)
     {
         connect(window.get(), &WallWindow::imageGrabbed, this,
-                &RenderController::screenshotRendered);
+                &RenderController::_encodeScreenshot);
     }
 }
 
+void RenderController::_encodeScreenshot(const QImage image,
+                                         const QPoint index)
+{
+    // Downscaling and encoding are slow, do them in parallel for all windows
+    const auto request = _screenshotRequest;
+    _screenshotEncoders.addFuture(QtConcurrent::run([this, image, index,
+                                                     request] {
+        emit screenshotRendered(_encode(image, request), index);
+    }));
+}
+
+void RenderController::_dumpTrace(const TraceRequest& request)
+{
+    // Align all times on the clock of the first wall process
+    const auto offset = _wallChannel.getClockOffset();
+    using ns = std::chrono::nanoseconds;
+    const auto offsetNs = std::chrono::duration_cast<ns>(offset).count();
+    const auto rank = _wallChannel.getRank();
+    const auto name = QString("Wall #%1 (%2)")
+                          .arg(rank)
+                          .arg(QSysInfo::machineHostName())
+                          .toStdString();
+
+    TraceReply reply;
+    reply.rank = rank;
+    reply.requestSendTime = request.sendTime;
+    reply.requestReceiveTime = request.receiveTime + offsetNs;
+    // The master process is the first one in the trace
+    reply.events = trace::toChromeEvents(trace::getEvents(), rank + 1, name,
+                                         offset);
+    reply.sendTime = trace::toNanoseconds(trace::clock::now() + offset);
+    emit traceDumped(reply);
+}
+
 void RenderController::_setupSwapSynchronization(
     NetworkBarrier& swapSyncBarrier, const SwapSync type)
 {
@@ -173,6 +270,30 @@ void RenderController::_setupSwapSynchronization(
         window->setSwapSynchronizer(_swapSynchronizer.get());
 }
 
+void RenderController::_setupFramePacing()
+{
+    if (!_framePacer || _windows.empty())
+        return;
+
+    print_log(LOG_INFO, LOG_GENERAL, "Frame pacing enabled");
+
+    // The windows of a process swap together, measure the first one only
+    _windows.front()->setFramePacer(_framePacer.get());
+}
+
+void RenderController::_setupTelemetry()
+{
+    if (!_telemetry)
+        return;
+
+    for (auto&& window : _windows)
+        window->setTelemetryCollector(_telemetry);
+
+    // Reports continue while idle, which tells the master the process is alive
+    const auto interval = _telemetry->getInterval().count();
+    _telemetryTimer = startTimer(int(interval));
+}
+
 void RenderController::_requestRender()
 {
     killTimer(_stopRenderingDelayTimer);
@@ -181,11 +302,47 @@ void RenderController::_requestRender()
     _idleRedrawTimer = 0;
 
     if (_renderTimer == 0)
-        _renderTimer = startTimer(5, Qt::PreciseTimer);
+        _renderTimer = startTimer(_getRenderTimerInterval(), Qt::PreciseTimer);
+}
+
+int RenderController::_getRenderTimerInterval() const
+{
+    if (!_framePacer)
+        return 5;
+
+    const auto now = FramePacer::clock::now();
+    const auto delay = _framePacer->getNextFrameStart(now) - now;
+
+    // Qt timers have a resolution of 1ms, rather start early than late
+    using ms = std::chrono::milliseconds;
+    return std::max(0, int(std::chrono::duration_cast<ms>(delay).count()));
+}
+
+void RenderController::_schedulePacedFrame()
+{
+    print_log(LOG_VERBOSE, LOG_GENERAL, "frame slack: %.2f ms",
+              std::chrono::duration<double, std::milli>(
+                  _framePacer->getStats().lastSlack)
+                  .count());
+
+    killTimer(_renderTimer);
+    _renderTimer = startTimer(_getRenderTimerInterval(), Qt::PreciseTimer);
 }
 
 void RenderController::_syncAndRender()
 {
+    TIDE_TRACE_SCOPE("syncAndRender");
+    if (_framePacer)
+        _framePacer->beginFrame(FramePacer::clock::now());
+
+    using clock = TelemetryCollector::clock;
+    const auto frameStart = clock::now();
+    _synchronizeFrame();
+    const auto syncWait = clock::now() - frameStart;
+
+    // Data sources are synchronized first, in the state they were in when the
+    // frame was prepared. The scene update may then add or remove some.
+    _synchronizeDataSourceUpdates();
     _synchronizeSceneUpdates();
     if (_syncQuit.get())
     {
@@ -193,13 +350,20 @@ void RenderController::_syncAndRender()
         return;
     }
 
-    _synchronizeDataSourceUpdates();
-    _renderAllWindows();
     _scheduleRedraw();
+    _renderAllWindows();
+    _collectRedrawRequests();
+
+    if (_telemetry)
+        _telemetry->addFrame(clock::now() - frameStart, syncWait);
+
+    if (_framePacer && _renderTimer != 0)
+        _schedulePacedFrame();
 }
 
 void RenderController::_renderAllWindows()
 {
+    TIDE_TRACE_SCOPE("renderAllWindows");
     const auto grab = _syncScreenshot.get();
     if (grab)
         _syncScreenshot = SwapSyncObject<bool>{false};
@@ -212,12 +376,15 @@ void RenderController::_renderAllWindows()
     }
 }
 
-void RenderController::_scheduleRedraw()
+void RenderController::_collectRedrawRequests()
 {
     for (const auto& window : _windows)
         _redrawNeeded = _redrawNeeded || window->needRedraw();
+}
 
-    if (_wallChannel.allReady(!_redrawNeeded))
+void RenderController::_scheduleRedraw()
+{
+    if (_frameSync.allTrue(_syncKeys.idle))
         _scheduleStopRendering();
     else
         _requestRender();
@@ -243,25 +410,52 @@ void RenderController::_stopRendering()
         _idleRedrawTimer = startTimer(60000 /*ms*/);
 }
 
-void RenderController::_synchronizeSceneUpdates()
+void RenderController::_synchronizeFrame()
 {
-    auto versionCheckFunc = std::bind(&WallToWallChannel::checkVersion,
-                                      &_wallChannel, std::placeholders::_1);
+    // All the data needed to synchronize the frame is exchanged at once to
+    // avoid a long sequence of collective operations between wall processes.
+    _frameSync.clear();
+    _syncKeys.scene = _frameSync.addVersion(_syncScene.getVersion());
+    _syncKeys.markers = _frameSync.addVersion(_syncMarkers.getVersion());
+    _syncKeys.options = _frameSync.addVersion(_syncOptions.getVersion());
+    _syncKeys.lock = _frameSync.addVersion(_syncLock.getVersion());
+    _syncKeys.countdownStatus =
+        _frameSync.addVersion(_syncCountdownStatus.getVersion());
+    _syncKeys.screenshot = _frameSync.addVersion(_syncScreenshot.getVersion());
+    _syncKeys.quit = _frameSync.addVersion(_syncQuit.getVersion());
+    _syncKeys.idle = _frameSync.addFlag(!_redrawNeeded);
+    _provider.prepareFrameSync(_frameSync);
+
+    TIDE_TRACE_SCOPE("synchronizeFrame");
+    _wallChannel.synchronize(_frameSync);
+}
 
-    _syncScene.sync(versionCheckFunc);
-    _syncMarkers.sync(versionCheckFunc);
-    _syncOptions.sync(versionCheckFunc);
-    _syncLock.sync(versionCheckFunc);
-    _syncCountdownStatus.sync(versionCheckFunc);
-    _syncScreenshot.sync(versionCheckFunc);
-    _syncQuit.sync(versionCheckFunc);
+void RenderController::_synchronizeSceneUpdates()
+{
+    TIDE_TRACE_SCOPE("synchronizeScene");
+    _syncScene.sync(_frameSync.getVersionCheck(_syncKeys.scene));
+    _syncMarkers.sync(_frameSync.getVersionCheck(_syncKeys.markers));
+    _syncOptions.sync(_frameSync.getVersionCheck(_syncKeys.options));
+    _syncLock.sync(_frameSync.getVersionCheck(_syncKeys.lock));
+    _syncCountdownStatus.sync(
+        _frameSync.getVersionCheck(_syncKeys.countdownStatus));
+    _syncScreenshot.sync(_frameSync.getVersionCheck(_syncKeys.screenshot));
+    _syncQuit.sync(_frameSync.getVersionCheck(_syncKeys.quit));
 }
 
 void RenderController::_synchronizeDataSourceUpdates()
 {
-    _wallChannel.synchronizeClock();
-    _provider.synchronizeTilesSwap(_wallChannel);
-    _provider.synchronizeTilesUpdate(_wallChannel);
+    _provider.synchronizeTilesSwap(_frameSync);
+    _provider.synchronizeTilesUpdate(_frameSync, _wallChannel);
+}
+
+void RenderController::_reportTelemetry()
+{
+    auto telemetry = _telemetry->collect(TelemetryCollector::clock::now());
+    telemetry.rank = _wallChannel.getRank();
+    telemetry.tileQueueDepth = uint32_t(_provider.getPendingTileLoadCount());
+    telemetry.cacheBytes = _provider.getTileCacheStats().size;
+    emit telemetryReported(telemetry);
 }
 
 void RenderController::_terminateRendering()
@@ -269,8 +463,27 @@ void RenderController::_terminateRendering()
     killTimer(_renderTimer);
     killTimer(_stopRenderingDelayTimer);
     killTimer(_idleRedrawTimer);
+    killTimer(_telemetryTimer);
 
     for (auto&& window : _windows)
         window.release()->deleteLater();
     _windows.clear();
+
+    if (_framePacer)
+        _logFramePacingStats();
+}
+
+void RenderController::_logFramePacingStats() const
+{
+    using ms = std::chrono::duration<double, std::milli>;
+    const auto stats = _framePacer->getStats();
+    const auto meanSlack =
+        stats.frames > 0 ? ms(stats.totalSlack).count() / stats.frames : 0.0;
+    print_log(LOG_INFO, LOG_GENERAL,
+              "frame pacing: refresh interval: %.3f ms, %llu frames, "
+              "%llu missed deadlines, slack mean: %.2f ms min: %.2f ms",
+              ms(_framePacer->getRefreshInterval()).count(),
+              (unsigned long long)stats.frames,
+              (unsigned long long)stats.missedDeadlines, meanSlack,
+              ms(stats.minSlack).count());
 }
@@ -42,13 +42,24 @@
 
 #include "types.h"
 
+#include "network/FrameSync.h"
+#include "network/ScreenshotRequest.h"
+#include "network/TraceReply.h"
+#include "network/TraceRequest.h"
+#include "network/WallTelemetry.h"
 #include "tools/SwapSyncObject.h"
 
+#include <QFutureSynchronizer>
 #include <QImage>
 #include <QObject>
 
 /**
  * Setup the scene and control the rendering options during runtime.
+ *
+ * Frames are rendered as soon as possible on a 5ms timer, or just in time for
+ * the next refresh of the displays if a FramePacer is provided. If a
+ * TelemetryCollector is provided, the performance counters of the process are
+ * reported at its interval.
  */
 class RenderController : public QObject
 {
@@ -58,7 +69,9 @@ class RenderController : public QObject
 public:
     RenderController(const WallConfiguration& config, DataProvider& provider,
                      WallToWallChannel& wallChannel,
-                     NetworkBarrier& swapSyncBarrier, SwapSync type);
+                     NetworkBarrier& swapSyncBarrier, SwapSync type,
+                     std::unique_ptr<FramePacer> framePacer = nullptr,
+                     TelemetryCollector* telemetry = nullptr);
     ~RenderController();
 
 public slots:
@@ -67,17 +80,30 @@ public slots:
     void updateOptions(OptionsPtr options);
     void updateLock(ScreenLockPtr lock);
     void updateCountdownStatus(CountdownStatusPtr status);
-    void updateRequestScreenshot();
+    void updateRequestScreenshot(ScreenshotRequest request);
+    void updateTraceRequest(TraceRequest request);
     void updateQuit();
 
 signals:
-    void screenshotRendered(QImage image, QPoint index);
+    /**
+     * Emitted for each window once its screenshot has been encoded.
+     * Emitted from a worker thread.
+     */
+    void screenshotRendered(QByteArray image, QPoint index);
+
+    /** Emitted with the events of this process when a dump was requested. */
+    void traceDumped(TraceReply reply);
+
+    /** Emitted at the telemetry interval with the counters of the period. */
+    void telemetryReported(WallTelemetry telemetry);
 
 private:
     std::vector<WallWindowPtr> _windows;
     DataProvider& _provider;
     WallToWallChannel& _wallChannel;
     std::unique_ptr<SwapSynchronizer> _swapSynchronizer;
+    std::unique_ptr<FramePacer> _framePacer;
+    TelemetryCollector* _telemetry = nullptr;
 
     SwapSyncObject<ScenePtr> _syncScene;
     SwapSyncObject<MarkersPtr> _syncMarkers;
@@ -85,12 +111,29 @@ private:
     SwapSyncObject<ScreenLockPtr> _syncLock;
     SwapSyncObject<CountdownStatusPtr> _syncCountdownStatus;
     SwapSyncObject<bool> _syncScreenshot{false};
+    ScreenshotRequest _screenshotRequest;
+    QFutureSynchronizer<void> _screenshotEncoders;
     SwapSyncObject<bool> _syncQuit{false};
 
     int _renderTimer = 0;
     int _stopRenderingDelayTimer = 0;
     int _idleRedrawTimer = 0;
-    bool _redrawNeeded = false;
+    int _telemetryTimer = 0;
+    bool _redrawNeeded = true;
+
+    FrameSync _frameSync;
+    struct FrameSyncKeys
+    {
+        FrameSync::Key scene = 0;
+        FrameSync::Key markers = 0;
+        FrameSync::Key options = 0;
+        FrameSync::Key lock = 0;
+        FrameSync::Key countdownStatus = 0;
+        FrameSync::Key screenshot = 0;
+        FrameSync::Key quit = 0;
+        FrameSync::Key idle = 0;
+    };
+    FrameSyncKeys _syncKeys;
 
     void timerEvent(QTimerEvent* qtEvent) final;
 
@@ -98,21 +141,31 @@ private:
     void _connectSwapSyncObjects();
     void _connectRedrawSignal();
     void _connectScreenshotSignals();
+    void _encodeScreenshot(QImage image, QPoint index);
+    void _dumpTrace(const TraceRequest& request);
     void _setupSwapSynchronization(NetworkBarrier& swapSyncBarrier,
                                    SwapSync type);
+    void _setupFramePacing();
+    void _setupTelemetry();
 
     /** Synchronization and rendering. */
     void _requestRender();
+    int _getRenderTimerInterval() const;
+    void _schedulePacedFrame();
     void _syncAndRender();
     void _renderAllWindows();
+    void _collectRedrawRequests();
     void _scheduleRedraw();
     void _scheduleStopRendering();
     void _stopRendering();
+    void _synchronizeFrame();
     void _synchronizeSceneUpdates();
     void _synchronizeDataSourceUpdates();
+    void _reportTelemetry();
 
     /** Shutdown. */
     void _terminateRendering();
+    void _logFramePacingStats() const;
 };
 
 #endif
@@ -48,16 +48,82 @@
 #include "network/WallToMasterChannel.h"
 #include "network/WallToWallChannel.h"
 #include "scene/VectorialContent.h"
+#include "tools/DiskTileCache.h"
+#include "tools/FramePacer.h"
+#include "tools/TelemetryCollector.h"
+#include "utils/log.h"
 
 #include <QThreadPool>
 
+namespace
+{
+std::unique_ptr<DiskTileCache> _createDiskTileCache(const Configuration& config)
+{
+    const auto& directory = config.folders.tileCache;
+    if (directory.isEmpty())
+        return nullptr;
+
+    const auto maxSize = uint64_t(config.global.tileCacheDiskSize) << 20;
+    try
+    {
+        return std::make_unique<DiskTileCache>(directory.toStdString(),
+                                               maxSize);
+    }
+    catch (const std::runtime_error& e)
+    {
+        print_log(LOG_WARN, LOG_GENERAL, "disk tile cache disabled: %s",
+                  e.what());
+        return nullptr;
+    }
+}
+
+std::set<ContentType> _getCompressedContentTypes(const Configuration& config)
+{
+    const auto& compression = config.global.textureCompression;
+    auto types = std::set<ContentType>();
+    if (compression.image)
+        types.insert(ContentType::image);
+    if (compression.imagePyramid)
+        types.insert(ContentType::image_pyramid);
+    if (compression.pdf)
+        types.insert(ContentType::pdf);
+    if (compression.svg)
+        types.insert(ContentType::svg);
+    return types;
+}
+
+std::unique_ptr<FramePacer> _createFramePacer(const Configuration& config)
+{
+    const auto& pacing = config.global.framePacing;
+    if (!pacing.enabled)
+        return nullptr;
+
+    auto settings = FramePacer::Settings();
+    settings.safetyMargin = std::chrono::microseconds{pacing.safetyMargin};
+    if (pacing.refreshRate > 0)
+        settings.refreshInterval =
+            std::chrono::microseconds{1000000 / pacing.refreshRate};
+    return std::make_unique<FramePacer>(settings);
+}
+
+std::unique_ptr<TelemetryCollector> _createTelemetryCollector(
+    const Configuration& config)
+{
+    const auto interval = config.global.telemetryInterval;
+    if (interval == 0)
+        return nullptr;
+
+    return std::make_unique<TelemetryCollector>(
+        std::chrono::milliseconds{interval});
+}
+}
+
 WallApplication::WallApplication(int& argc_, char** argv_,
                                  MPICommunicator& masterRecvComm,
                                  MPICommunicator& masterSendComm,
                                  MPICommunicator& wallToWallComm,
                                  NetworkBarrier& swapSyncBarrier)
     : QGuiApplication{argc_, argv_}
-    , _provider{new DataProvider}
     , _fromMasterChannel{new WallFromMasterChannel(masterRecvComm)}
     , _toMasterChannel{new WallToMasterChannel(masterSendComm)}
     , _wallChannel{new WallToWallChannel{wallToWallComm}}
@@ -65,9 +131,20 @@ WallApplication::WallApplication(int& argc_, char** argv_,
     qml::registerTypes();
 
     const auto config = _fromMasterChannel->receiveConfiguration();
+    masterRecvComm.setWaitPolicies(config);
+    masterSendComm.setWaitPolicies(config);
+    wallToWallComm.setWaitPolicies(config);
     const auto rank = (uint)wallToWallComm.getRank();
     _config = std::make_unique<WallConfiguration>(config, rank);
 
+    if (config.global.shareFramesOnHost)
+    {
+        const auto host = (int)_config->hostLeaderIndex;
+        auto hostComm = std::make_unique<MPICommunicator>(wallToWallComm, host);
+        hostComm->setWaitPolicies(config);
+        _fromMasterChannel->shareFramesOnHost(std::move(hostComm));
+    }
+
     Content::setMaxScale(config.settings.contentMaxScale);
     VectorialContent::setMaxScale(config.settings.contentMaxScaleVectorial);
 
@@ -75,12 +152,24 @@ WallApplication::WallApplication(int& argc_, char** argv_,
     // on the same machine
     const auto prCount = _config->processCountForHost;
     const auto maxThreads = std::max(QThread::idealThreadCount() / prCount, 2);
-    QThreadPool::globalInstance()->setMaxThreadCount(maxThreads);
+    // The tiles are loaded by the DataProvider's own pool of maxThreads; the
+    // global pool only encodes the screenshots, one task per window.
+    const auto windowsCount = std::max(int(_config->screens.size()), 1);
+    QThreadPool::globalInstance()->setMaxThreadCount(
+        std::min(windowsCount, maxThreads));
+    const auto tileCacheSize = size_t(config.global.tileCacheSize) << 20;
+    _telemetry = _createTelemetryCollector(config);
+    _provider = std::make_unique<DataProvider>(maxThreads, tileCacheSize,
+                                               _createDiskTileCache(config));
+    _provider->setTextureCompression(_getCompressedContentTypes(config));
+    _provider->setTelemetryCollector(_telemetry.get());
 
     _renderController =
         std::make_unique<RenderController>(*_config, *_provider, *_wallChannel,
                                            swapSyncBarrier,
-                                           config.global.swapsync);
+                                           config.global.swapsync,
+                                           _createFramePacer(config),
+                                           _telemetry.get());
     _initMPIConnections();
 }
 
@@ -105,6 +194,10 @@ void WallApplication::_initMPIConnections()
             _renderController.get(),
             &RenderController::updateRequestScreenshot);
 
+    connect(_fromMasterChannel.get(),
+            &WallFromMasterChannel::receivedTraceRequest,
+            _renderController.get(), &RenderController::updateTraceRequest);
+
     connect(_fromMasterChannel.get(), SIGNAL(received(ScenePtr)),
             _renderController.get(), SLOT(updateScene(ScenePtr)));
 
@@ -128,6 +221,12 @@ void WallApplication::_initMPIConnections()
     connect(_renderController.get(), &RenderController::screenshotRendered,
             _toMasterChannel.get(), &WallToMasterChannel::sendScreenshot);
 
+    connect(_renderController.get(), &RenderController::traceDumped,
+            _toMasterChannel.get(), &WallToMasterChannel::sendTrace);
+
+    connect(_renderController.get(), &RenderController::telemetryReported,
+            _toMasterChannel.get(), &WallToMasterChannel::sendTelemetry);
+
     if (_wallChannel->getRank() == 0)
     {
         connect(_provider.get(), &DataProvider::requestPixelStreamFrame,
@@ -81,6 +81,8 @@ public:
 
 private:
     std::unique_ptr<WallConfiguration> _config;
+    // Must outlive the provider and render controller which use it.
+    std::unique_ptr<TelemetryCollector> _telemetry;
     std::unique_ptr<DataProvider> _provider;
     std::unique_ptr<RenderController> _renderController;
 
@@ -64,4 +64,6 @@ WallConfiguration::WallConfiguration(const Configuration& config,
                       [& host = host](const auto& p) {
                           return p.host == host;
                       });
+    while (config.processes[hostLeaderIndex].host != host)
+        ++hostLeaderIndex;
 }
@@ -63,6 +63,9 @@ struct WallConfiguration : public Process
 
     /** The number of wall processes running on the same host. */
     int processCountForHost = 0;
+
+    /** The index of the first wall process running on the same host. */
+    uint hostLeaderIndex = 0;
 };
 
 #endif
@@ -39,39 +39,163 @@
 
 #include "CachedDataSource.h"
 
-#include "data/QtImage.h"
+#include "CompressedImage.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace
+{
+void _releaseRaster(void* raster)
+{
+    delete static_cast<DiskTileCache::RasterPtr*>(raster);
+}
+
+/** @return an image using the raster memory mapped from the disk cache. */
+QImage _toImage(DiskTileCache::RasterPtr raster)
+{
+    const auto& info = raster->getInfo();
+    return QImage{raster->getData(), int(info.width), int(info.height),
+                  int(info.bytesPerLine), QImage::Format(info.format),
+                  _releaseRaster, new DiskTileCache::RasterPtr{raster}};
+}
+}
+
+CachedDataSource::CachedDataSource(TileCache& cache)
+    : _cache{cache}
+{
+}
+
+CachedDataSource::~CachedDataSource()
+{
+    _cache.remove(this);
+}
 
 ImagePtr CachedDataSource::getTileImage(const uint tileId,
                                         const deflect::View view) const
 {
-    auto& cache = _getCache(view);
+    const auto key = _makeKey(tileId, view);
+
+    auto image = _cache.get(key);
+    if (!image.isNull())
     {
         const QMutexLocker lock(&_mutex);
-        if (cache.contains(tileId))
-            return std::make_shared<QtImage>(cache[tileId]);
+        if (_prefetched.erase(key))
+            ++_prefetchStats.hits;
+        return _makeImage(image);
     }
 
-    const auto image =
-        QtImage::toGlCompatibleFormat(getCachableTileImage(tileId, view));
-    if (image.isNull())
-        throw std::logic_error("Cachable tile images should not be null");
+    image = _loadTileImage(tileId, view);
+    _cache.insert(key, image);
+    {
+        const QMutexLocker lock(&_mutex);
+        _prefetched.erase(key); // evicted before it could be used
+    }
+    return _makeImage(image);
+}
 
+void CachedDataSource::prefetchTile(const uint tileId,
+                                    const deflect::View view) const
+{
+    const auto key = _makeKey(tileId, view);
     {
         const QMutexLocker lock(&_mutex);
-        cache.insert(tileId, image);
+        ++_prefetchStats.requested;
     }
-    return std::make_shared<QtImage>(image);
+    if (_cache.contains(key))
+        return;
+
+    // The tile may have been loaded by getTileImage() in the meantime
+    if (!_cache.insert(key, _loadTileImage(tileId, view)))
+        return;
+
+    const QMutexLocker lock(&_mutex);
+    _prefetched.insert(key);
+    ++_prefetchStats.loaded;
 }
 
-bool CachedDataSource::contains(const uint tileId) const
+DataSource::PrefetchStats CachedDataSource::getPrefetchStats() const
 {
     const QMutexLocker lock(&_mutex);
-    return _cacheLeftOrMono.contains(tileId);
+    return _prefetchStats;
+}
+
+void CachedDataSource::pinTile(const uint tileId) const
+{
+    _cache.pin(this, tileId);
+}
+
+void CachedDataSource::unpinTile(const uint tileId) const
+{
+    _cache.unpin(this, tileId);
+}
+
+void CachedDataSource::setTextureCompression(const bool enable)
+{
+    _compressTextures = enable;
+}
+
+bool CachedDataSource::contains(const uint tileId) const
+{
+    return _cache.contains(_makeKey(tileId, deflect::View::mono));
+}
+
+TileCache::Key CachedDataSource::_makeKey(const uint tileId,
+                                          const deflect::View view) const
+{
+    const auto rightEye = view == deflect::View::right_eye && isStereo();
+    return {this, tileId, rightEye ? 1u : 0u};
+}
+
+std::string CachedDataSource::_makeDiskKey(const uint tileId,
+                                           const deflect::View view) const
+{
+    // The modification time invalidates the tiles of modified files
+    const auto uri = getUri();
+    const auto modified = QFileInfo{uri}.lastModified().toMSecsSinceEpoch();
+    const auto size = getTileRect(tileId).size();
+    const auto eye = _makeKey(tileId, view).eye;
+    return QString("%1|%2|%3|%4|%5x%6|%7")
+        .arg(uri)
+        .arg(modified)
+        .arg(getTileLod(tileId))
+        .arg(tileId)
+        .arg(size.width())
+        .arg(size.height())
+        .arg(eye)
+        .toStdString();
+}
+
+QImage CachedDataSource::_loadTileImage(const uint tileId,
+                                        const deflect::View view) const
+{
+    auto diskCache = isPersistentlyCachable() ? _cache.getDiskCache() : nullptr;
+    const auto diskKey =
+        diskCache ? _makeDiskKey(tileId, view) : std::string();
+    if (diskCache)
+    {
+        if (auto raster = diskCache->load(diskKey))
+            return _toImage(std::move(raster));
+    }
+
+    const auto image =
+        QtImage::toGlCompatibleFormat(getCachableTileImage(tileId, view));
+    if (image.isNull())
+        throw std::logic_error("Cachable tile images should not be null");
+
+    if (diskCache)
+    {
+        const auto info = DiskTileCache::RasterInfo{
+            uint32_t(image.width()), uint32_t(image.height()),
+            uint32_t(image.bytesPerLine()), uint32_t(image.format())};
+        diskCache->store(diskKey, info, image.constBits());
+    }
+    return image;
 }
 
-CachedDataSource::Cache& CachedDataSource::_getCache(
-    const deflect::View view) const
+ImagePtr CachedDataSource::_makeImage(const QImage& image) const
 {
-    return view == deflect::View::right_eye && isStereo() ? _cacheRight
-                                                          : _cacheLeftOrMono;
+    if (_compressTextures && CompressedImage::isCompressible(image))
+        return std::make_shared<CompressedImage>(image);
+    return std::make_shared<QtImage>(image);
 }
@@ -42,19 +42,51 @@
 
 #include "DataSource.h"
 
+#include "tools/TileCache.h"
+
 #include <QImage>
-#include <QMap>
 #include <QMutex>
 
+#include <set>
+
 /**
- * A data source which maintains a cache of the requested tiles.
+ * A data source which keeps the requested tiles in the TileCache of the
+ * wall process.
  */
 class CachedDataSource : public DataSource
 {
 public:
+    /**
+     * Constructor.
+     * @param cache where to keep the tile images, must outlive this object.
+     */
+    explicit CachedDataSource(TileCache& cache);
+
+    /** Remove the tiles of this source from the cache. */
+    ~CachedDataSource();
+
     /** @copydoc DataSource::getTileImage threadsafe */
     ImagePtr getTileImage(uint tileId, deflect::View view) const override;
 
+    /** @copydoc DataSource::prefetchTile threadsafe */
+    void prefetchTile(uint tileId, deflect::View view) const override;
+
+    /** @copydoc DataSource::getPrefetchStats threadsafe */
+    PrefetchStats getPrefetchStats() const final;
+
+    /** @copydoc DataSource::pinTile threadsafe */
+    void pinTile(uint tileId) const final;
+
+    /** @copydoc DataSource::unpinTile threadsafe */
+    void unpinTile(uint tileId) const final;
+
+    /**
+     * Provide the opaque tiles as compressed images (encoded on the loading
+     * threads, the cache keeps the uncompressed images).
+     * @param enable true to compress the opaque tiles.
+     */
+    void setTextureCompression(bool enable);
+
 protected:
     /** Check if the cache contains an image (used for SVGGpuImage only). */
     bool contains(const uint tileId) const;
@@ -67,12 +99,20 @@ private:
     /** @return true is the source is stereo. */
     virtual bool isStereo() const = 0;
 
+    /** @return true if the tiles are worth keeping in the disk cache. */
+    virtual bool isPersistentlyCachable() const { return false; }
+
+    TileCache& _cache;
+    bool _compressTextures = false;
+
     mutable QMutex _mutex;
-    using Cache = QMap<uint, QImage>;
-    mutable Cache _cacheLeftOrMono;
-    mutable Cache _cacheRight;
+    mutable std::set<TileCache::Key> _prefetched; // not yet used for display
+    mutable PrefetchStats _prefetchStats;
 
-    Cache& _getCache(deflect::View view) const;
+    TileCache::Key _makeKey(uint tileId, deflect::View view) const;
+    std::string _makeDiskKey(uint tileId, deflect::View view) const;
+    QImage _loadTileImage(uint tileId, deflect::View view) const;
+    ImagePtr _makeImage(const QImage& image) const;
 };
 
 #endif
@@ -53,6 +53,14 @@
 class DataSource
 {
 public:
+    /** Statistics about the tiles prefetched ahead of their use. */
+    struct PrefetchStats
+    {
+        size_t requested = 0; // prefetchTile() calls
+        size_t loaded = 0;    // tiles which were not already available
+        size_t hits = 0;      // loaded tiles later used by getTileImage()
+    };
+
     virtual ~DataSource() = default;
 
     /** @return the uri of the data source. */
@@ -71,6 +79,27 @@ public:
      */
     virtual ImagePtr getTileImage(uint tileId, deflect::View view) const = 0;
 
+    /**
+     * Load a tile image ahead of its use (only for cached sources).
+     * Called asynchronously, possibly concurrently with getTileImage().
+     * threadsafe.
+     * @throw std::exception on error.
+     */
+    virtual void prefetchTile(uint tileId, deflect::View view) const
+    {
+        Q_UNUSED(tileId);
+        Q_UNUSED(view);
+    }
+
+    /** @return the statistics about prefetched tiles. threadsafe */
+    virtual PrefetchStats getPrefetchStats() const { return PrefetchStats(); }
+    /**
+     * Keep a visible tile in the cache until it is unpinned (only for cached
+     * sources). Calls are reference counted. threadsafe.
+     */
+    virtual void pinTile(uint tileId) const { Q_UNUSED(tileId); }
+    /** Release a tile pinned with pinTile(). threadsafe. */
+    virtual void unpinTile(uint tileId) const { Q_UNUSED(tileId); }
     /** @return the coordinates of a tile. */
     virtual QRect getTileRect(uint tileId) const = 0;
 
@@ -84,13 +113,28 @@ public:
     /** @return the max LOD level (top of pyramid, lowest resolution). */
     virtual uint getMaxLod() const = 0;
 
+    /** @return the LOD level of a tile. */
+    virtual uint getTileLod(uint tileId) const
+    {
+        Q_UNUSED(tileId);
+        return 0;
+    }
+
     /** @return the index of the tile to use for a preview. */
     virtual uint getPreviewTileId() const { return 0; }
     /** Allow advancing to the next frame (synchronization / flow control). */
     virtual void allowNextFrame() {}
-    /** Synchronize the advance to the next frame of the data. */
-    virtual void synchronizeFrameAdvance(WallToWallChannel& channel)
+    /** Add the local state needed by synchronizeFrameAdvance() to a frame. */
+    virtual void prepareFrameSync(FrameSync& frame) { Q_UNUSED(frame); }
+    /**
+     * Synchronize the advance to the next frame of the data.
+     * @param frame the data exchanged by all processes, see prepareFrameSync().
+     * @param channel to get the synchronized time of the frame.
+     */
+    virtual void synchronizeFrameAdvance(const FrameSync& frame,
+                                         const WallToWallChannel& channel)
     {
+        Q_UNUSED(frame);
         Q_UNUSED(channel);
     }
 
@@ -58,7 +58,20 @@
 #include "datasources/ImagePyramidDataSource.h"
 #endif
 
-std::unique_ptr<DataSource> DataSourceFactory::create(const Content& content)
+namespace
+{
+template <typename Source, typename... Args>
+std::unique_ptr<DataSource> _makeCached(const bool compressTextures,
+                                        Args&&... args)
+{
+    auto source = std::make_unique<Source>(std::forward<Args>(args)...);
+    source->setTextureCompression(compressTextures);
+    return std::move(source);
+}
+}
+
+std::unique_ptr<DataSource> DataSourceFactory::create(
+    const Content& content, TileCache& cache, const bool compressTextures)
 {
     switch (content.getType())
     {
@@ -73,20 +86,22 @@ std::unique_ptr<DataSource> DataSourceFactory::create(const Content& content)
 #endif
         return std::make_unique<PixelStreamUpdater>(content.getUri());
     case ContentType::svg:
-        return std::make_unique<SVGTiler>(content.getUri(),
-                                          content.getMaxDimensions());
+        return _makeCached<SVGTiler>(compressTextures, content.getUri(),
+                                     content.getMaxDimensions(), cache);
     case ContentType::image:
-        return std::make_unique<ImageSource>(content.getUri());
+        return _makeCached<ImageSource>(compressTextures, content.getUri(),
+                                        cache);
 
 #if TIDE_ENABLE_PDF_SUPPORT
     case ContentType::pdf:
-        return std::make_unique<PDFTiler>(content.getUri(),
-                                          content.getMaxDimensions());
+        return _makeCached<PDFTiler>(compressTextures, content.getUri(),
+                                     content.getMaxDimensions(), cache);
 #endif
 
 #if TIDE_USE_TIFF
     case ContentType::image_pyramid:
-        return std::make_unique<ImagePyramidDataSource>(content.getUri());
+        return _makeCached<ImagePyramidDataSource>(compressTextures,
+                                                   content.getUri(), cache);
 #endif
     default:
         throw std::logic_error("No data source for this content type");
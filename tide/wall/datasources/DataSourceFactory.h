@@ -48,7 +48,15 @@
 class DataSourceFactory
 {
 public:
-    static std::unique_ptr<DataSource> create(const Content& content);
+    /**
+     * Create a data source.
+     * @param content for which to create the data source.
+     * @param cache for the tile images of the static contents.
+     * @param compressTextures provide compressed tiles for static contents.
+     */
+    static std::unique_ptr<DataSource> create(const Content& content,
+                                              TileCache& cache,
+                                              bool compressTextures = false);
 };
 
 #endif
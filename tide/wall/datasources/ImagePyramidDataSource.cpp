@@ -56,8 +56,10 @@ uint _getTileSize(const TiffPyramidReader& tif)
 }
 }
 
-ImagePyramidDataSource::ImagePyramidDataSource(const QString& uri)
-    : _uri{uri}
+ImagePyramidDataSource::ImagePyramidDataSource(const QString& uri,
+                                               TileCache& cache)
+    : LodTiler{cache}
+    , _uri{uri}
 {
     try
     {
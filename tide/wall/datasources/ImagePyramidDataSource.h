@@ -49,7 +49,7 @@ class ImagePyramidDataSource : public LodTiler
 {
 public:
     /** Constructor. */
-    explicit ImagePyramidDataSource(const QString& uri);
+    ImagePyramidDataSource(const QString& uri, TileCache& cache);
 
     /** Destructor. */
     ~ImagePyramidDataSource();
@@ -41,8 +41,9 @@
 
 #include "data/ImageReader.h"
 
-ImageSource::ImageSource(const QString& uri)
-    : _reader{std::make_unique<ImageReader>(uri)}
+ImageSource::ImageSource(const QString& uri, TileCache& cache)
+    : CachedDataSource{cache}
+    , _reader{std::make_unique<ImageReader>(uri)}
 {
 }
 
@@ -53,8 +53,9 @@ public:
     /**
      * Construct an image source.
      * @param uri of the image file.
+     * @param cache for the image.
      */
-    explicit ImageSource(const QString& uri);
+    ImageSource(const QString& uri, TileCache& cache);
     ~ImageSource();
 
     /** @copydoc DataSource::getUri */
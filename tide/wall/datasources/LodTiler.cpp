@@ -64,11 +64,15 @@ uint LodTiler::getMaxLod() const
     return _getLodTool().getMaxLod();
 }
 
+uint LodTiler::getTileLod(const uint tileId) const
+{
+    return _getLodTool().getTileIndex(tileId).lod;
+}
+
 QRectF LodTiler::getNormalizedTileRect(const uint tileId) const
 {
     const auto tile = QRectF{getTileRect(tileId)};
-    const auto lod = _getLodTool().getTileIndex(tileId).lod;
-    const auto area = getTilesArea(lod, 0);
+    const auto area = getTilesArea(getTileLod(tileId), 0);
 
     const auto t =
         QTransform::fromScale(1.0 / area.width(), 1.0 / area.height());
@@ -48,6 +48,8 @@
 class LodTiler : public CachedDataSource
 {
 public:
+    using CachedDataSource::CachedDataSource;
+
     /** @copydoc DataSource::getTileRect */
     QRect getTileRect(uint tileId) const override;
 
@@ -61,12 +63,18 @@ public:
     /** @copydoc DataSource::getMaxLod */
     uint getMaxLod() const final;
 
+    /** @copydoc DataSource::getTileLod */
+    uint getTileLod(uint tileId) const final;
+
     /** Get the tile rectangle in normalized coordinates. */
     QRectF getNormalizedTileRect(uint tileId) const;
 
 private:
     /** @return the LOD information for the DataSource. */
     virtual const LodTools& _getLodTool() const = 0;
+
+    /** Tiles of PDF, SVG and image pyramids are cached on disk. */
+    bool isPersistentlyCachable() const final { return true; }
 };
 
 #endif
@@ -247,28 +247,37 @@ void MovieUpdater::allowNextFrame()
     _readyForNextFrame = true;
 }
 
-void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
+void MovieUpdater::prepareFrameSync(FrameSync& frame)
 {
     const bool visible = synchronizers.haveVisibleTiles();
-    const double frameDuration = _frameDuration;
 
-    bool inSync = false;
-    {
-        // protect _sharedTimestamp & _currentPosition from getTileImage()
-        const QMutexLocker lock(&_mutex);
+    // protect _sharedTimestamp & _currentPosition from getTileImage()
+    const QMutexLocker lock(&_mutex);
 
-        // Jump to the skip position
-        if (_skipping && !_loopedBack)
-            _sharedTimestamp = _skipPosition;
+    // Jump to the skip position
+    if (_skipping && !_loopedBack)
+        _sharedTimestamp = _skipPosition;
 
-        inSync = std::abs(_sharedTimestamp - _currentPosition) <= frameDuration;
-    }
+    const bool inSync =
+        std::abs(_sharedTimestamp - _currentPosition) <= _frameDuration;
+
+    _syncKeys.readyToAdvance = frame.addFlag(inSync || !visible);
+    _syncKeys.readyToSkip = frame.addFlag(!inSync || !visible);
 
+    // Always exchange timestamp for processes where _currentPosition is not
+    // advancing to allow seek if visible again.
+    _syncKeys.leaderCandidate = frame.addFlag(visible && inSync);
+    _syncKeys.position = frame.addValue(_currentPosition);
+}
+
+void MovieUpdater::synchronizeFrameAdvance(const FrameSync& frame,
+                                           const WallToWallChannel& channel)
+{
     // If any visible updater is out-of-sync, only update those ones. This
     // causes a seek in the movie to _sharedTimestamp. The time stands still in
     // this case to avoid seeking of all processes if this seek takes longer
     // than frameDuration.
-    if (!channel.allReady(inSync || !visible))
+    if (!frame.allTrue(_syncKeys.readyToAdvance))
     {
         _timer.resetTime(channel.getTime());
         if (_readyForNextFrame)
@@ -281,7 +290,7 @@ void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
     {
         _timer.resetTime(channel.getTime());
         if (_skipping && _readyForNextFrame)
-            if (channel.allReady(!inSync || !visible))
+            if (frame.allTrue(_syncKeys.readyToSkip))
                 _triggerFrameUpdate();
         return;
     }
@@ -290,7 +299,7 @@ void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
     // frame duration and decode speed accordingly.
     _timer.setCurrentTime(channel.getTime());
     _elapsedTime += _timer.getElapsedTimeInSeconds();
-    if (_elapsedTime < frameDuration || !_readyForNextFrame)
+    if (_elapsedTime < _frameDuration || !_readyForNextFrame)
         return;
     {
         // protect _sharedTimestamp & _currentPosition from getTileImage()
@@ -298,12 +307,8 @@ void MovieUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
 
         // advance to the next frame, keep correct elapsedTime as vsync
         // frequency of this function might not match movie frequency.
-        _sharedTimestamp = _currentPosition + frameDuration;
-        _elapsedTime -= frameDuration;
-
-        // Always exchange timestamp for processes where _currentPosition is not
-        // advancing to allow seek if visible again.
-        _exchangeSharedTimestamp(channel, visible && inSync);
+        _sharedTimestamp = _getNextTimestamp(frame);
+        _elapsedTime -= _frameDuration;
     }
     // unlock _mutex before to avoid deadlocks
     _triggerFrameUpdate();
@@ -317,15 +322,12 @@ void MovieUpdater::_triggerFrameUpdate()
     emit pictureUpdated();
 }
 
-void MovieUpdater::_exchangeSharedTimestamp(WallToWallChannel& channel,
-                                            const bool isCandidate)
+double MovieUpdater::_getNextTimestamp(const FrameSync& frame) const
 {
-    const int leader = channel.electLeader(isCandidate);
+    // All processes follow the position of the same leader, if any
+    const int leader = frame.getLastTrueRank(_syncKeys.leaderCandidate);
     if (leader < 0)
-        return;
+        return _currentPosition + _frameDuration;
 
-    if (leader == channel.getRank())
-        channel.broadcast(_sharedTimestamp);
-    else
-        _sharedTimestamp = channel.receiveTimestampBroadcast(leader);
+    return frame.getValue(_syncKeys.position, leader) + _frameDuration;
 }
@@ -41,6 +41,7 @@
 #define MOVIEUPDATER_H
 
 #include "datasources/DataSource.h"
+#include "network/FrameSync.h"
 #include "tools/ElapsedTimer.h"
 #include "tools/FpsCounter.h"
 #include "types.h"
@@ -93,8 +94,12 @@ public:
     /** @copydoc DataSource::allowNextFrame */
     void allowNextFrame() final;
 
+    /** @copydoc DataSource::prepareFrameSync */
+    void prepareFrameSync(FrameSync& frame) final;
+
     /** @copydoc DataSource::synchronizeFrameAdvance */
-    void synchronizeFrameAdvance(WallToWallChannel& channel) final;
+    void synchronizeFrameAdvance(const FrameSync& frame,
+                                 const WallToWallChannel& channel) final;
 
     /** @return current / max fps, movie position in percentage. */
     QString getStatistics() const;
@@ -117,7 +122,7 @@ signals:
 
 private:
     void _triggerFrameUpdate();
-    void _exchangeSharedTimestamp(WallToWallChannel& channel, bool isCandidate);
+    double _getNextTimestamp(const FrameSync& frame) const;
 
     QString _uri;
     std::unique_ptr<FFMPEGMovie> _ffmpegMovie;
@@ -136,6 +141,15 @@ private:
     ElapsedTimer _timer;
     double _elapsedTime = 0.0;
 
+    struct FrameSyncKeys
+    {
+        FrameSync::Key readyToAdvance = 0;
+        FrameSync::Key readyToSkip = 0;
+        FrameSync::Key leaderCandidate = 0;
+        FrameSync::Key position = 0;
+    };
+    FrameSyncKeys _syncKeys;
+
     mutable QMutex _mutex;
     mutable double _sharedTimestamp = 0.0;
     mutable double _currentPosition = -1.0;
@@ -55,8 +55,10 @@ namespace
 const uint tileSize = 2048;
 }
 
-PDFTiler::PDFTiler(const QString& uri, const QSize& maxImageSize)
-    : _uri{uri}
+PDFTiler::PDFTiler(const QString& uri, const QSize& maxImageSize,
+                   TileCache& cache)
+    : LodTiler{cache}
+    , _uri{uri}
 {
     try
     {
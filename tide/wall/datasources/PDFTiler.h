@@ -56,7 +56,7 @@ class PDFTiler : public QObject, public LodTiler
 
 public:
     /** Constructor. */
-    explicit PDFTiler(const QString& uri, const QSize& maxImageSize);
+    PDFTiler(const QString& uri, const QSize& maxImageSize, TileCache& cache);
 
     /** Destructor. */
     ~PDFTiler();
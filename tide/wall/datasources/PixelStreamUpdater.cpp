@@ -39,7 +39,7 @@
 
 #include "PixelStreamUpdater.h"
 
-#include "network/WallToWallChannel.h"
+#include "network/FrameSync.h"
 #include "tools/PixelStreamAssembler.h"
 #include "tools/PixelStreamPassthrough.h"
 #include "utils/log.h"
@@ -159,14 +159,20 @@ void PixelStreamUpdater::allowNextFrame()
     _readyToSwap = true;
 }
 
-void PixelStreamUpdater::synchronizeFrameAdvance(WallToWallChannel& channel)
+void PixelStreamUpdater::prepareFrameSync(FrameSync& frame)
 {
+    _frameVersionKey = frame.addVersion(_swapSyncFrame.getVersion());
+}
+
+void PixelStreamUpdater::synchronizeFrameAdvance(
+    const FrameSync& frame, const WallToWallChannel& channel)
+{
+    Q_UNUSED(channel);
+
     if (!_readyToSwap)
         return;
 
-    const auto versionCheckFunc = std::bind(&WallToWallChannel::checkVersion,
-                                            &channel, std::placeholders::_1);
-    _swapSyncFrame.sync(versionCheckFunc);
+    _swapSyncFrame.sync(frame.getVersionCheck(_frameVersionKey));
 }
 
 void PixelStreamUpdater::setNextFrame(deflect::server::FramePtr frame)
@@ -180,8 +186,12 @@ void PixelStreamUpdater::_onFrameSwapped(deflect::server::FramePtr frame)
 {
     _readyToSwap = false;
 
-    auto leftOrMono = std::make_shared<deflect::server::Frame>();
-    auto right = std::make_shared<deflect::server::Frame>();
+    // The tiles' image data may point into the received message, which is
+    // owned by the original frame; keep it alive with the split frames.
+    const auto deleter = [frame](deflect::server::Frame* f) { delete f; };
+    auto leftOrMono =
+        deflect::server::FramePtr{new deflect::server::Frame, deleter};
+    auto right = deflect::server::FramePtr{new deflect::server::Frame, deleter};
 
     _splitByView(frame->tiles, leftOrMono->tiles, right->tiles);
     _sortByChannelAndPosition(leftOrMono->tiles);
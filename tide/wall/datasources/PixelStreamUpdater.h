@@ -43,6 +43,7 @@
 #include "types.h"
 
 #include "DataSource.h"
+#include "network/FrameSync.h"
 #include "tools/SwapSyncObject.h"
 
 #include <QObject>
@@ -92,8 +93,12 @@ public:
     /** @copydoc DataSource::allowNextFrame */
     void allowNextFrame() final;
 
+    /** @copydoc DataSource::prepareFrameSync */
+    void prepareFrameSync(FrameSync& frame) final;
+
     /** @copydoc DataSource::synchronizeFrameAdvance */
-    void synchronizeFrameAdvance(WallToWallChannel& channel) final;
+    void synchronizeFrameAdvance(const FrameSync& frame,
+                                 const WallToWallChannel& channel) final;
 
     /** Set the frame to be rendered next. */
     void setNextFrame(deflect::server::FramePtr frame);
@@ -115,6 +120,7 @@ private:
     mutable QReadWriteLock _frameMutex;
     mutable std::unique_ptr<std::vector<std::mutex>> _perTileLock;
     bool _readyToSwap = true;
+    FrameSync::Key _frameVersionKey = 0;
 
     void _onFrameSwapped(deflect::server::FramePtr frame);
     void _createFrameProcessors();
@@ -71,6 +71,21 @@ uint SVGGpuImage::getGLPixelFormat() const
     return _image->getGLPixelFormat();
 }
 
+uint SVGGpuImage::getGLCompressedFormat() const
+{
+    return _image->getGLCompressedFormat();
+}
+
+const uint8_t* SVGGpuImage::getCompressedData() const
+{
+    return _image->getCompressedData();
+}
+
+size_t SVGGpuImage::getCompressedDataSize() const
+{
+    return _image->getCompressedDataSize();
+}
+
 bool SVGGpuImage::isGpuImage() const
 {
     return true;
@@ -71,6 +71,15 @@ public:
     /** @copydoc Image::getGLPixelFormat */
     uint getGLPixelFormat() const override;
 
+    /** @copydoc Image::getGLCompressedFormat */
+    uint getGLCompressedFormat() const override;
+
+    /** @copydoc Image::getCompressedData */
+    const uint8_t* getCompressedData() const override;
+
+    /** @copydoc Image::getCompressedDataSize */
+    size_t getCompressedDataSize() const override;
+
     /** @copydoc Image::isGpuImage */
     bool isGpuImage() const final;
 
@@ -53,7 +53,9 @@ namespace
 const uint tileSize = 1024;
 }
 
-SVGTiler::SVGTiler(const QString& uri, const QSize& maxImageSize)
+SVGTiler::SVGTiler(const QString& uri, const QSize& maxImageSize,
+                   TileCache& cache)
+    : LodTiler{cache}
 {
     try
     {
@@ -88,6 +90,12 @@ ImagePtr SVGTiler::getTileImage(const uint tileId,
 }
 
 #if !(TIDE_USE_CAIRO && TIDE_USE_RSVG)
+void SVGTiler::prefetchTile(const uint tileId, const deflect::View view) const
+{
+    Q_UNUSED(tileId);
+    Q_UNUSED(view);
+}
+
 ImagePtr SVGTiler::renderAndCacheGpuImage(const uint tileId,
                                           const deflect::View view) const
 {
@@ -51,7 +51,7 @@ class SVGTiler : public LodTiler
 {
 public:
     /** Constructor. */
-    explicit SVGTiler(const QString& uri, const QSize& maxImageSize);
+    SVGTiler(const QString& uri, const QSize& maxImageSize, TileCache& cache);
 
     /** Destructor. */
     ~SVGTiler();
@@ -66,6 +66,9 @@ public:
     ImagePtr getTileImage(uint tileId, deflect::View view) const final;
 
 #if !(TIDE_USE_CAIRO && TIDE_USE_RSVG)
+    /** No prefetching, the SVG tiles can only be rendered on the GPU. */
+    void prefetchTile(uint tileId, deflect::View view) const final;
+
     /** Called exclusively by SVGGpuImage from the GL render thread. */
     ImagePtr renderAndCacheGpuImage(uint tileId, deflect::View view) const;
 #endif
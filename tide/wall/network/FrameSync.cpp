@@ -0,0 +1,169 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "FrameSync.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+template <typename T>
+uint64_t _toWord(const T value)
+{
+    static_assert(sizeof(T) == sizeof(uint64_t), "value must be 64 bits");
+    uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+template <typename T>
+T _fromWord(const uint64_t word)
+{
+    static_assert(sizeof(T) == sizeof(uint64_t), "value must be 64 bits");
+    T value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+}
+}
+
+void FrameSync::clear()
+{
+    _localValues.clear();
+    _globalValues.clear();
+}
+
+FrameSync::Key FrameSync::addVersion(const uint64_t version)
+{
+    return _add(version);
+}
+
+FrameSync::Key FrameSync::addFlag(const bool value)
+{
+    return _add(value ? 1 : 0);
+}
+
+FrameSync::Key FrameSync::addValue(const double value)
+{
+    return _add(_toWord(value));
+}
+
+FrameSync::Key FrameSync::addTimestamp(const clock::time_point timestamp)
+{
+    return _add(_toWord(timestamp.time_since_epoch().count()));
+}
+
+const std::vector<uint64_t>& FrameSync::getLocalValues() const
+{
+    return _localValues;
+}
+
+void FrameSync::setGlobalValues(std::vector<uint64_t> values)
+{
+    if (_localValues.empty() || values.size() % _localValues.size() != 0)
+        throw std::invalid_argument("global values do not match local values");
+
+    _globalValues = std::move(values);
+}
+
+size_t FrameSync::getProcessCount() const
+{
+    if (_localValues.empty())
+        return 0;
+    return _globalValues.size() / _localValues.size();
+}
+
+bool FrameSync::checkVersion(const Key key) const
+{
+    const auto version = _localValues.at(key);
+    for (size_t rank = 0; rank < getProcessCount(); ++rank)
+    {
+        if (_get(key, rank) != version)
+            return false;
+    }
+    return true;
+}
+
+SyncFunction FrameSync::getVersionCheck(const Key key) const
+{
+    return [this, key](uint64_t) { return checkVersion(key); };
+}
+
+bool FrameSync::allTrue(const Key key) const
+{
+    for (size_t rank = 0; rank < getProcessCount(); ++rank)
+    {
+        if (!_get(key, rank))
+            return false;
+    }
+    return true;
+}
+
+int FrameSync::getLastTrueRank(const Key key) const
+{
+    for (int rank = getProcessCount() - 1; rank >= 0; --rank)
+    {
+        if (_get(key, rank))
+            return rank;
+    }
+    return -1;
+}
+
+double FrameSync::getValue(const Key key, const int rank) const
+{
+    return _fromWord<double>(_get(key, rank));
+}
+
+FrameSync::clock::time_point FrameSync::getTimestamp(const Key key,
+                                                     const int rank) const
+{
+    const auto ticks = _fromWord<clock::rep>(_get(key, rank));
+    return clock::time_point{clock::duration{ticks}};
+}
+
+FrameSync::Key FrameSync::_add(const uint64_t value)
+{
+    _localValues.push_back(value);
+    return _localValues.size() - 1;
+}
+
+uint64_t FrameSync::_get(const Key key, const int rank) const
+{
+    return _globalValues.at(rank * _localValues.size() + key);
+}
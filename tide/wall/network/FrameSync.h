@@ -0,0 +1,123 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef FRAMESYNC_H
+#define FRAMESYNC_H
+
+#include "tools/SwapSyncObject.h"
+
+#include <chrono>
+#include <vector>
+
+/**
+ * Synchronization data of all wall processes for a single frame.
+ *
+ * Rather than running one collective operation for every object which must be
+ * synchronized, all the local values are first added to a FrameSync in the
+ * same order on each process. They are then exchanged with a single call to
+ * WallToWallChannel::synchronize(), after which the global results can be
+ * queried using the keys returned when adding the values.
+ */
+class FrameSync
+{
+public:
+    using clock = std::chrono::high_resolution_clock;
+    using Key = size_t;
+
+    /** Clear all values to prepare a new frame. */
+    void clear();
+
+    /** @name Local values, to add before the exchange. */
+    //@{
+    /** Add a version number, see checkVersion(). */
+    Key addVersion(uint64_t version);
+
+    /** Add a boolean state, see allTrue() and getLastTrueRank(). */
+    Key addFlag(bool value);
+
+    /** Add a floating point value, see getValue(). */
+    Key addValue(double value);
+
+    /** Add a timestamp, see getTimestamp(). */
+    Key addTimestamp(clock::time_point timestamp);
+
+    /** @return the local values to exchange with the other processes. */
+    const std::vector<uint64_t>& getLocalValues() const;
+    //@}
+
+    /**
+     * Set the values gathered from all processes.
+     * @param values of all processes, ordered by rank.
+     * @throw std::invalid_argument if the size does not match the local values
+     */
+    void setGlobalValues(std::vector<uint64_t> values);
+
+    /** @name Global results, to query after the exchange. */
+    //@{
+    /** @return the number of processes which participated in the exchange. */
+    size_t getProcessCount() const;
+
+    /** @return true if all processes added the same version for the key. */
+    bool checkVersion(Key key) const;
+
+    /** @return a function to synchronize a SwapSyncObject using the key. */
+    SyncFunction getVersionCheck(Key key) const;
+
+    /** @return true if all processes added a true flag for the key. */
+    bool allTrue(Key key) const;
+
+    /** @return the last rank which added a true flag for the key, or -1. */
+    int getLastTrueRank(Key key) const;
+
+    /** @return the value added by a given process for the key. */
+    double getValue(Key key, int rank) const;
+
+    /** @return the timestamp added by a given process for the key. */
+    clock::time_point getTimestamp(Key key, int rank) const;
+    //@}
+
+private:
+    std::vector<uint64_t> _localValues;
+    std::vector<uint64_t> _globalValues;
+
+    Key _add(uint64_t value);
+    uint64_t _get(Key key, int rank) const;
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "SceneDeltaDecoder.h"
+
+#include "scene/SceneDelta.h"
+#include "utils/log.h"
+
+namespace
+{
+class out_of_step_error : public std::runtime_error
+{
+    using runtime_error::runtime_error;
+};
+
+WindowPtr _find(const std::map<QUuid, WindowPtr>& windows, const QUuid& id)
+{
+    const auto it = windows.find(id);
+    if (it == windows.end())
+        throw out_of_step_error("unknown window in scene patch");
+    return it->second;
+}
+}
+
+ScenePtr SceneDeltaDecoder::apply(const SceneDelta& delta)
+{
+    if (delta.isKeyframe())
+        return _applyKeyframe(delta);
+
+    if (!_inSync)
+        return ScenePtr();
+
+    if (delta.baseVersion != _version)
+    {
+        print_log(LOG_WARN, LOG_GENERAL,
+                  "scene patch out of step, waiting for next keyframe");
+        _inSync = false;
+        return ScenePtr();
+    }
+
+    try
+    {
+        return _applyPatch(delta);
+    }
+    catch (const out_of_step_error& e)
+    {
+        print_log(LOG_WARN, LOG_GENERAL, "%s, waiting for next keyframe",
+                  e.what());
+        _inSync = false;
+        return ScenePtr();
+    }
+}
+
+uint64_t SceneDeltaDecoder::getVersion() const
+{
+    return _version;
+}
+
+bool SceneDeltaDecoder::isInSync() const
+{
+    return _inSync;
+}
+
+ScenePtr SceneDeltaDecoder::_applyKeyframe(const SceneDelta& delta)
+{
+    _storeWindows(*delta.keyframe);
+    _version = delta.version;
+    _inSync = true;
+    return delta.keyframe;
+}
+
+ScenePtr SceneDeltaDecoder::_applyPatch(const SceneDelta& delta)
+{
+    auto windows = _windows;
+    for (const auto& window : delta.windows)
+        windows[window->getID()] = window;
+
+    auto surfaces = std::vector<SurfacePtr>();
+    for (const auto& surfaceDelta : delta.surfaces)
+    {
+        auto group = DisplayGroup::create(surfaceDelta.groupCoordinates.size());
+        group->setCoordinates(surfaceDelta.groupCoordinates);
+
+        for (const auto& id : surfaceDelta.windowIds)
+            group->add(_find(windows, id));
+
+        if (!surfaceDelta.fullscreenWindowId.isNull())
+            group->setFullscreenWindow(
+                _find(windows, surfaceDelta.fullscreenWindowId));
+
+        surfaces.emplace_back(
+            std::make_shared<Surface>(surfaces.size(), std::move(group),
+                                      surfaceDelta.background,
+                                      surfaceDelta.contextMenu));
+    }
+
+    auto scene = Scene::create(std::move(surfaces));
+    _storeWindows(*scene);
+    _version = delta.version;
+    return scene;
+}
+
+void SceneDeltaDecoder::_storeWindows(const Scene& scene)
+{
+    _windows.clear();
+    for (const auto& window : scene.getWindows())
+        _windows[window->getID()] = window;
+}
@@ -0,0 +1,85 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef SCENEDELTADECODER_H
+#define SCENEDELTADECODER_H
+
+#include "types.h"
+
+#include <QUuid>
+
+#include <map>
+
+struct SceneDelta;
+
+/**
+ * Reconstruct the Scene on the wall processes from the received SceneDeltas.
+ *
+ * The windows which are not part of a patch are reused from the previous
+ * scene. If a patch does not apply to the current version, all subsequent
+ * patches are ignored until the next keyframe is received.
+ */
+class SceneDeltaDecoder
+{
+public:
+    /**
+     * Apply a delta received from the master process.
+     * @param delta the keyframe or patch to apply.
+     * @return the updated scene, or nullptr if the delta could not be applied
+     *         because this process is waiting for a keyframe.
+     */
+    ScenePtr apply(const SceneDelta& delta);
+
+    /** @return the version of the last scene successfully decoded. */
+    uint64_t getVersion() const;
+
+    /** @return true if patches can be applied (a keyframe was received). */
+    bool isInSync() const;
+
+private:
+    uint64_t _version = 0;
+    bool _inSync = false;
+    std::map<QUuid, WindowPtr> _windows;
+
+    ScenePtr _applyKeyframe(const SceneDelta& delta);
+    ScenePtr _applyPatch(const SceneDelta& delta);
+    void _storeWindows(const Scene& scene);
+};
+
+#endif
@@ -40,14 +40,19 @@
 #include "WallFromMasterChannel.h"
 
 #include "configuration/Configuration.h"
+#include "network/FrameWireFormat.h"
 #include "network/MPICommunicator.h"
+#include "network/SharedMemoryRing.h"
 #include "scene/CountdownStatus.h"
 #include "scene/Markers.h"
 #include "scene/Options.h"
 #include "scene/Scene.h"
+#include "scene/SceneDelta.h"
 #include "scene/ScreenLock.h"
 #include "scene/Window.h"
 #include "serialization/utils.h"
+#include "utils/log.h"
+#include "utils/trace.h"
 #include "json/serialization.h"
 #include "json/templates.h"
 
@@ -55,102 +60,340 @@
 
 #include <QApplication>
 
+#include <cstring>
+#include <istream>
+#include <thread>
+
+#include <unistd.h>
+
 namespace
 {
 const int RANK0 = 0;
+const int HOST_LEADER = 0;
+
+// Enough for a frame and the scene updates that follow it to be received
+// while the previous frame is being decoded.
+const size_t receiveSlotsCount = 4;
+
+// Frames shared on the host stay referenced by the receive slots and by the
+// frames being decoded or rendered; beyond that they are copied.
+const size_t sharedFramesSlotsCount = 2 * receiveSlotsCount;
 }
 
 WallFromMasterChannel::WallFromMasterChannel(MPICommunicator& communicator)
     : _communicator{communicator}
+    , _ring{receiveSlotsCount}
 {
 }
 
+WallFromMasterChannel::~WallFromMasterChannel()
+{
+    if (_hostCommunicator)
+    {
+        print_log(LOG_DEBUG, LOG_MPI,
+                  "frames shared on host: %zu, copied: %zu",
+                  _sharedFramesCount, _copiedFramesCount);
+    }
+    const auto metrics = _ring.getMetrics();
+    print_log(LOG_DEBUG, LOG_MPI,
+              "receive slots: %zu, peak occupancy: %zu, messages: %zu, "
+              "stalls: %zu",
+              metrics.slotsCount, metrics.peakOccupiedSlots,
+              metrics.receivedCount, metrics.stalledCount);
+}
+
+WallFromMasterChannel::ReceiveMetrics
+    WallFromMasterChannel::getReceiveMetrics() const
+{
+    return _ring.getMetrics();
+}
+
 Configuration WallFromMasterChannel::receiveConfiguration()
 {
     const auto mh = _communicator.receiveBroadcastHeader(RANK0);
     if (mh.type != MessageType::CONFIG)
         throw std::logic_error("Configuation object expected from master");
-    return receiveJsonBroadcast<Configuration>(mh.size);
+
+    QByteArray data(mh.size, Qt::Uninitialized);
+    _communicator.receiveBroadcast(RANK0, data.data(), mh.size);
+    const auto config = json::unpack<Configuration>(data);
+    _communicator.setBroadcastPipeline(config.global.broadcastSegmentSize,
+                                       config.global.broadcastSegmentsInFlight);
+    return config;
+}
+
+void WallFromMasterChannel::shareFramesOnHost(
+    std::unique_ptr<MPICommunicator> hostCommunicator)
+{
+    _hostCommunicator = std::move(hostCommunicator);
+    if (_hostCommunicator->getSize() == 1)
+        return;
+
+    const auto isLeader = _hostCommunicator->getRank() == HOST_LEADER;
+    const auto leaderPid =
+        _hostCommunicator->broadcastValue(::getpid(), HOST_LEADER);
+    const auto prefix = "/tide-frames-" + std::to_string(leaderPid);
+
+    // The readers open the ring once the leader has created it. If any
+    // process fails, the frames are copied to all the processes instead.
+    for (const auto createRing : {true, false})
+    {
+        int failed = 0;
+        try
+        {
+            if (createRing && isLeader)
+            {
+                _sharedFrames = std::make_unique<SharedMemoryRing>(
+                    prefix, sharedFramesSlotsCount);
+            }
+            else if (!createRing && !isLeader)
+            {
+                _sharedFramesReader =
+                    std::make_unique<SharedMemoryRingReader>(prefix);
+            }
+        }
+        catch (const std::runtime_error& e)
+        {
+            print_log(LOG_WARN, LOG_MPI, "%s", e.what());
+            failed = 1;
+        }
+        if (_hostCommunicator->globalSum(failed) > 0)
+        {
+            _sharedFrames.reset();
+            _sharedFramesReader.reset();
+            return;
+        }
+    }
 }
 
 void WallFromMasterChannel::processMessages()
 {
+    std::thread worker{[this] {
+        while (auto message = _ring.next())
+        {
+            processMessage(*message);
+            // The end of the payload may not have been needed yet
+            message->progress.wait();
+            _ring.release();
+        }
+    }};
+
     while (_processMessages)
         receiveMessage();
+
+    _ring.close();
+    worker.join();
 }
 
 void WallFromMasterChannel::receiveMessage()
 {
-    const auto mh = _communicator.receiveBroadcastHeader(RANK0);
-    switch (mh.type)
+    auto message = _ring.acquire();
+    if (message->owner)
+    {
+        // The data wraps the shared memory of a previous frame
+        message->data = QByteArray();
+        message->owner.reset();
+    }
+    message->header = _communicator.receiveBroadcastHeader(RANK0);
+
+    switch (message->header.type)
+    {
+    case MessageType::PIXELSTREAM_SCATTER:
+        message->data = _communicator.receiveScatter(RANK0);
+        break;
+    case MessageType::PIXELSTREAM_HOST:
+        receiveHostFrame(*message);
+        break;
+    case MessageType::QUIT:
+        _processMessages = false;
+        break;
+    case MessageType::CONFIG:
+        throw std::logic_error("Configuation object not expected at runtime");
+        break;
+    default:
+        receiveBroadcast(*message);
+        return;
+    }
+
+    message->progress.reset(message->data.size());
+    message->progress.setReceived(message->data.size());
+    _ring.commit();
+}
+
+void WallFromMasterChannel::processMessage(const ReceivedMessage& message)
+{
+    switch (message.header.type)
     {
     case MessageType::SCENE:
-        emit received(receiveQObjectBroadcast<ScenePtr>(mh.size));
+        processSceneDelta(message);
         break;
     case MessageType::OPTIONS:
-        emit received(receiveQObjectBroadcast<OptionsPtr>(mh.size));
+        emit received(getQObject<OptionsPtr>(message));
         break;
     case MessageType::LOCK:
-        emit received(receiveQObjectBroadcast<ScreenLockPtr>(mh.size));
+        emit received(getQObject<ScreenLockPtr>(message));
         break;
     case MessageType::MARKERS:
-        emit received(receiveQObjectBroadcast<MarkersPtr>(mh.size));
+        emit received(getQObject<MarkersPtr>(message));
         break;
     case MessageType::COUNTDOWN_STATUS:
-        emit received(receiveQObjectBroadcast<CountdownStatusPtr>(mh.size));
+        emit received(getQObject<CountdownStatusPtr>(message));
         break;
     case MessageType::PIXELSTREAM:
-#if BOOST_VERSION >= 106000
-        emit received(
-            receiveBinaryBroadcast<deflect::server::FramePtr>(mh.size));
-#else
-        // WAR missing support for std::shared_ptr
-        // The copy of the Frame object is not too expensive because its
-        // Tiles' imageData are QByteArray (implicitly shared).
-        emit received(std::make_shared<deflect::server::Frame>(
-            receiveBinaryBroadcast<deflect::server::Frame>(mh.size)));
-#endif
+    case MessageType::PIXELSTREAM_SCATTER:
+    case MessageType::PIXELSTREAM_HOST:
+        // The tiles reference the whole message
+        message.progress.wait();
+        emit received(wireformat::decode(message.data, message.owner));
         break;
     case MessageType::IMAGE:
-        emit receivedScreenshotRequest();
+        emit receivedScreenshotRequest(
+            deserialize<ScreenshotRequest>(message));
+        break;
+    case MessageType::TRACE:
+    {
+        auto request = deserialize<TraceRequest>(message);
+        request.receiveTime = trace::toNanoseconds(trace::clock::now());
+        emit receivedTraceRequest(request);
         break;
+    }
     case MessageType::QUIT:
-        _processMessages = false;
         emit receivedQuit();
         break;
-    case MessageType::CONFIG:
-        throw std::logic_error("Configuation object not expected at runtime");
-        break;
     default:
         break;
     }
 }
 
-void WallFromMasterChannel::receiveBroadcast(const size_t messageSize)
+void WallFromMasterChannel::processSceneDelta(const ReceivedMessage& message)
 {
-    _buffer.setSize(messageSize);
-    _communicator.receiveBroadcast(RANK0, _buffer.data(), messageSize);
+    const auto delta = deserialize<SceneDelta>(message);
+    if (auto scene = _sceneDecoder.apply(delta))
+    {
+        // Windows reused from the previous scene already belong to the main
+        // thread, moveToThread() leaves them untouched.
+        scene->moveToThread(QApplication::instance()->thread());
+        emit received(scene);
+    }
 }
 
-template <typename T>
-T WallFromMasterChannel::receiveBinaryBroadcast(const size_t messageSize)
+void WallFromMasterChannel::receiveBroadcast(ReceivedMessage& message)
 {
-    receiveBroadcast(messageSize);
-    return serialization::get<T>(_buffer);
+    const auto messageSize = message.header.size;
+    auto& data = message.data;
+
+    // Decoded frames keep referencing the data of their slot; receive into a
+    // new buffer in this case instead of detaching (copying) the old one.
+    if (!data.isDetached())
+        data = QByteArray(messageSize, Qt::Uninitialized);
+    else
+        data.resize(messageSize);
+
+    // Hand the message to the worker before its payload arrives, the worker
+    // reads each segment once received. The data must not be accessed from
+    // here after commit() except through this buffer.
+    const auto buffer = data.data();
+    auto& progress = message.progress;
+    progress.reset(messageSize);
+    _ring.commit();
+
+    _communicator.receiveBroadcast(RANK0, buffer, messageSize,
+                                   [&progress](const size_t offset,
+                                               const size_t size) {
+                                       progress.setReceived(offset + size);
+                                   });
 }
 
-template <typename T>
-T WallFromMasterChannel::receiveJsonBroadcast(const size_t messageSize)
+void WallFromMasterChannel::receiveHostFrame(ReceivedMessage& message)
+{
+    // Empty on all but the first process of each host
+    auto data = _communicator.receiveScatter(RANK0);
+
+    if (!_hostCommunicator || _hostCommunicator->getSize() == 1)
+    {
+        message.data = data;
+        return;
+    }
+
+    if (_hostCommunicator->getRank() == HOST_LEADER)
+    {
+        shareHostFrame(data);
+        message.data = data;
+    }
+    else
+        receiveSharedHostFrame(message);
+}
+
+void WallFromMasterChannel::shareHostFrame(const QByteArray& data)
 {
-    receiveBroadcast(messageSize);
-    const auto data = QByteArray::fromRawData(_buffer.data(), _buffer.size());
-    return json::unpack<T>(data);
+    const auto readersCount = uint32_t(_hostCommunicator->getSize() - 1);
+    SharedMemoryRing::Slot slot;
+    try
+    {
+        if (_sharedFrames &&
+            _sharedFrames->write(data.constData(), data.size(), readersCount,
+                                 slot))
+        {
+            _hostCommunicator->broadcast(
+                MessageType::PIXELSTREAM_HOST,
+                QByteArray::fromRawData(reinterpret_cast<const char*>(&slot),
+                                        sizeof(slot)));
+            ++_sharedFramesCount;
+            return;
+        }
+    }
+    catch (const std::runtime_error& e)
+    {
+        print_log(LOG_WARN, LOG_MPI, "%s", e.what());
+    }
+
+    // Fall back to sending a copy of the frame to each process
+    _hostCommunicator->broadcast(MessageType::PIXELSTREAM, data);
+    ++_copiedFramesCount;
+}
+
+void WallFromMasterChannel::receiveSharedHostFrame(ReceivedMessage& message)
+{
+    const auto header = _hostCommunicator->receiveBroadcastHeader(HOST_LEADER);
+    QByteArray payload(header.size, Qt::Uninitialized);
+    _hostCommunicator->receiveBroadcast(HOST_LEADER, payload.data(),
+                                        header.size);
+
+    if (header.type != MessageType::PIXELSTREAM_HOST)
+    {
+        message.data = payload;
+        ++_copiedFramesCount;
+        return;
+    }
+
+    SharedMemoryRing::Slot slot;
+    std::memcpy(&slot, payload.constData(), sizeof(slot));
+    try
+    {
+        auto frame = _sharedFramesReader->read(slot);
+        message.data = QByteArray::fromRawData(frame.get(), slot.size);
+        message.owner = std::move(frame);
+        ++_sharedFramesCount;
+    }
+    catch (const std::runtime_error& e)
+    {
+        print_log(LOG_ERROR, LOG_MPI, "%s", e.what());
+        message.header.type = MessageType::NONE;
+    }
 }
 
 template <typename T>
-T WallFromMasterChannel::receiveQObjectBroadcast(const size_t messageSize)
+T WallFromMasterChannel::getQObject(const ReceivedMessage& message)
 {
-    auto qobject = receiveBinaryBroadcast<T>(messageSize);
+    auto qobject = deserialize<T>(message);
     qobject->moveToThread(QApplication::instance()->thread());
     return qobject;
 }
+
+template <typename T>
+T WallFromMasterChannel::deserialize(const ReceivedMessage& message)
+{
+    ReceiveStreamBuffer buffer{message.data.constData(), message.progress};
+    std::istream stream{&buffer};
+    return serialization::get<T>(stream);
+}
@@ -40,33 +40,78 @@
 #ifndef WALLFROMMASTERCHANNEL_H
 #define WALLFROMMASTERCHANNEL_H
 
-#include "network/ReceiveBuffer.h"
+#include "network/MessageHeader.h"
+#include "network/ScreenshotRequest.h"
+#include "network/ReceiveProgress.h"
+#include "network/ReceiveRing.h"
+#include "network/SceneDeltaDecoder.h"
+#include "network/TraceRequest.h"
 #include "types.h"
 
+#include <QByteArray>
 #include <QObject>
 
+class SharedMemoryRing;
+class SharedMemoryRingReader;
+
 /**
  * Receiving channel from the master application to the wall processes.
+ *
+ * Messages are received in a ring of slots and deserialized by a separate
+ * worker thread, so that a slow deserialization does not delay the reception
+ * of the next messages. Reception blocks when all the slots are occupied.
+ *
+ * The worker starts deserializing a broadcast message once its first segments
+ * are received, while the next ones are still in transit.
  */
 class WallFromMasterChannel : public QObject
 {
     Q_OBJECT
     Q_DISABLE_COPY(WallFromMasterChannel)
 
+    struct ReceivedMessage
+    {
+        MessageHeader header;
+        QByteArray data;
+        std::shared_ptr<const void> owner; // owns data if not null
+        ReceiveProgress progress;          // of data
+    };
+
 public:
+    using ReceiveMetrics = ReceiveRing<ReceivedMessage>::Metrics;
+
     /** Constructor */
     WallFromMasterChannel(MPICommunicator& communicator);
 
+    /** Destructor, logs the receive metrics. */
+    ~WallFromMasterChannel();
+
+    /** @return the occupancy metrics of the receive slots. */
+    ReceiveMetrics getReceiveMetrics() const;
+
     /**
      * Receive the inital Configuration sent by the master process.
      * @return configuration object.
      */
     Configuration receiveConfiguration();
 
+    /**
+     * Share the pixel stream frames sent once per host by the master.
+     *
+     * The first process of the host receives the frames and places them in a
+     * ring of shared memory segments, where the other processes map them.
+     * Each segment is reused once all the processes have released the frame
+     * it holds; frames are copied to the processes when none is free.
+     * @param hostCommunicator between the wall processes of this host, with
+     *        the one which receives the frames as rank 0.
+     */
+    void shareFramesOnHost(std::unique_ptr<MPICommunicator> hostCommunicator);
+
 public slots:
     /**
      * Process messages until the QUIT message is received.
-     * This method is blocking and should be called from the processing thread.
+     * This method is blocking and should be called from the receiving thread.
+     * The signals are emitted from the deserialization worker thread.
      */
     void processMessages();
 
@@ -108,8 +153,15 @@ signals:
 
     /**
      * Emitted when a screenshot was requested.
+     * @param request The scale and encoding of the requested images.
+     */
+    void receivedScreenshotRequest(ScreenshotRequest request);
+
+    /**
+     * Emitted when the recording of trace events was controlled.
+     * @param request The action to perform, with the reception time set.
      */
-    void receivedScreenshotRequest();
+    void receivedTraceRequest(TraceRequest request);
 
     /**
      * Emitted when the quit message was recieved.
@@ -118,18 +170,27 @@ signals:
 
 private:
     MPICommunicator& _communicator;
-    ReceiveBuffer _buffer;
+    std::unique_ptr<MPICommunicator> _hostCommunicator;
+    std::unique_ptr<SharedMemoryRing> _sharedFrames;
+    std::unique_ptr<SharedMemoryRingReader> _sharedFramesReader;
+    size_t _sharedFramesCount = 0;
+    size_t _copiedFramesCount = 0;
+    ReceiveRing<ReceivedMessage> _ring;
+    SceneDeltaDecoder _sceneDecoder;
     bool _processMessages = true;
 
     void receiveMessage();
+    void receiveBroadcast(ReceivedMessage& message);
+    void receiveHostFrame(ReceivedMessage& message);
+    void shareHostFrame(const QByteArray& data);
+    void receiveSharedHostFrame(ReceivedMessage& message);
 
-    void receiveBroadcast(const size_t messageSize);
-    template <typename T>
-    T receiveBinaryBroadcast(const size_t messageSize);
+    void processMessage(const ReceivedMessage& message);
+    void processSceneDelta(const ReceivedMessage& message);
     template <typename T>
-    T receiveJsonBroadcast(const size_t messageSize);
+    T getQObject(const ReceivedMessage& message);
     template <typename T>
-    T receiveQObjectBroadcast(const size_t messageSize);
+    T deserialize(const ReceivedMessage& message);
 };
 
 #endif
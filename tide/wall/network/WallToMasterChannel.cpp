@@ -48,12 +48,27 @@ WallToMasterChannel::WallToMasterChannel(MPICommunicator& communicator)
 {
 }
 
-void WallToMasterChannel::sendScreenshot(const QImage image, const QPoint index)
+void WallToMasterChannel::sendScreenshot(const QByteArray image,
+                                         const QPoint index)
 {
     const auto data = serialization::toBinary(image, index);
     _communicator.send(MessageType::IMAGE, data, 0);
 }
 
+// cppcheck-suppress passedByValue
+void WallToMasterChannel::sendTrace(const TraceReply reply)
+{
+    const auto data = serialization::toBinary(reply);
+    _communicator.send(MessageType::TRACE, data, 0);
+}
+
+// cppcheck-suppress passedByValue
+void WallToMasterChannel::sendTelemetry(const WallTelemetry telemetry)
+{
+    const auto data = serialization::toBinary(telemetry);
+    _communicator.send(MessageType::TELEMETRY, data, 0);
+}
+
 void WallToMasterChannel::sendRequestFrame(const QString uri)
 {
     const auto data = serialization::toBinary(uri);
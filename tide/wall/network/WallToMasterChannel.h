@@ -41,6 +41,8 @@
 #ifndef WALLTOMASTERCHANNEL_H
 #define WALLTOMASTERCHANNEL_H
 
+#include "network/TraceReply.h"
+#include "network/WallTelemetry.h"
 #include "types.h"
 
 #include <QImage> // needed by moc compiler on Travis OSX
@@ -73,10 +75,22 @@ public slots:
 
     /**
      * Send a screenshot to the master application
-     * @param image the rendered image
+     * @param image the rendered image, encoded as requested
      * @param index the global index of the window sending the image
      */
-    void sendScreenshot(QImage image, QPoint index);
+    void sendScreenshot(QByteArray image, QPoint index);
+
+    /**
+     * Send the trace events of this process to the master application
+     * @param reply the events and the times of the request and reply
+     */
+    void sendTrace(TraceReply reply);
+
+    /**
+     * Send the performance counters of this process to the master application
+     * @param telemetry the counters of the last reporting period
+     */
+    void sendTelemetry(WallTelemetry telemetry);
 
     /**
      * Send quit message to the master application to stop the receiver.
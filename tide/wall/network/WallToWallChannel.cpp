@@ -40,7 +40,6 @@
 #include "WallToWallChannel.h"
 
 #include "network/MPICommunicator.h"
-#include "serialization/chrono.h"
 #include "serialization/utils.h"
 #include "utils/log.h"
 
@@ -48,7 +47,12 @@
 
 WallToWallChannel::WallToWallChannel(MPICommunicator& communicator)
     : _communicator{communicator}
+    , _collectives{communicator}
 {
+    print_log(LOG_DEBUG, LOG_MPI, "wall processes on %d node(s), %s",
+              _collectives.getNodeCount(),
+              _collectives.isHierarchical() ? "hierarchical collectives"
+                                            : "flat collectives");
 }
 
 int WallToWallChannel::getRank() const
@@ -58,12 +62,12 @@ int WallToWallChannel::getRank() const
 
 int WallToWallChannel::globalSum(const int localValue) const
 {
-    return _communicator.globalSum(localValue);
+    return _collectives.globalSum(localValue);
 }
 
 bool WallToWallChannel::allReady(const bool isReady) const
 {
-    return _communicator.globalSum(isReady ? 1 : 0) == _communicator.getSize();
+    return _collectives.globalSum(isReady ? 1 : 0) == _communicator.getSize();
 }
 
 WallToWallChannel::clock::time_point WallToWallChannel::getTime() const
@@ -71,17 +75,27 @@ WallToWallChannel::clock::time_point WallToWallChannel::getTime() const
     return _timestamp;
 }
 
-void WallToWallChannel::synchronizeClock()
+WallToWallChannel::clock::duration WallToWallChannel::getClockOffset() const
 {
-    if (_communicator.getRank() == RANK0)
-        _sendClock();
-    else
-        _receiveClock();
+    return _clockOffset;
+}
+
+void WallToWallChannel::synchronize(FrameSync& frame)
+{
+    const auto clockKey = frame.addTimestamp(clock::now());
+    const auto lastExitKey = frame.addTimestamp(_lastSyncExit);
+    frame.setGlobalValues(_collectives.gatherAll(frame.getLocalValues()));
+    const auto exitTime = clock::now();
+
+    _timestamp = frame.getTimestamp(clockKey, RANK0);
+    if (_lastSyncExit != clock::time_point())
+        _clockOffset = frame.getTimestamp(lastExitKey, RANK0) - _lastSyncExit;
+    _lastSyncExit = exitTime;
 }
 
 bool WallToWallChannel::checkVersion(const uint64_t version) const
 {
-    const auto versions = _communicator.gatherAll(version);
+    const auto versions = _collectives.gatherAll({version});
     for (const auto& v : versions)
     {
         if (v != version)
@@ -92,19 +106,8 @@ bool WallToWallChannel::checkVersion(const uint64_t version) const
 
 int WallToWallChannel::electLeader(const bool isCandidate)
 {
-    const int status = isCandidate ? (1 << getRank()) : 0;
-    int globalStatus = globalSum(status);
-
-    if (globalStatus <= 0)
-        return -1;
-
-    int leader = 0;
-    while (globalStatus > 1)
-    {
-        globalStatus = globalStatus >> 1;
-        ++leader;
-    }
-    return leader;
+    // The candidate with the highest rank is elected
+    return _collectives.globalMax(isCandidate ? getRank() : -1);
 }
 
 void WallToWallChannel::broadcast(const double timestamp)
@@ -123,26 +126,3 @@ double WallToWallChannel::receiveTimestampBroadcast(const int src)
 
     return serialization::get<double>(_buffer);
 }
-
-void WallToWallChannel::_sendClock()
-{
-    assert(_communicator.getRank() == RANK0);
-
-    _timestamp = clock::now();
-
-    _communicator.broadcast(MessageType::FRAME_CLOCK,
-                            serialization::toBinary(_timestamp));
-}
-
-void WallToWallChannel::_receiveClock()
-{
-    assert(_communicator.getRank() != RANK0);
-
-    const auto header = _communicator.receiveBroadcastHeader(RANK0);
-    assert(header.type == MessageType::FRAME_CLOCK);
-
-    _buffer.setSize(header.size);
-    _communicator.receiveBroadcast(RANK0, _buffer.data(), _buffer.size());
-
-    _timestamp = serialization::get<clock::time_point>(_buffer);
-}
@@ -40,15 +40,18 @@
 #ifndef WALLTOWALLCHANNEL_H
 #define WALLTOWALLCHANNEL_H
 
+#include "network/FrameSync.h"
+#include "network/HierarchicalCollectives.h"
 #include "network/ReceiveBuffer.h"
 #include "types.h"
 
 #include <QObject>
 
-#include <chrono>
-
 /**
  * Communication channel between the Wall processes.
+ *
+ * Collective operations are node-aware when several wall processes run on
+ * each node, see HierarchicalCollectives.
  */
 class WallToWallChannel : public QObject
 {
@@ -56,7 +59,7 @@ class WallToWallChannel : public QObject
     Q_DISABLE_COPY(WallToWallChannel)
 
 public:
-    using clock = std::chrono::high_resolution_clock;
+    using clock = FrameSync::clock;
 
     /** Constructor */
     WallToWallChannel(MPICommunicator& communicator);
@@ -77,8 +80,25 @@ public:
     /** Get the current timestamp, synchronized accross processes. */
     clock::time_point getTime() const;
 
-    /** Synchronize clock time across all processes. */
-    void synchronizeClock();
+    /**
+     * Get the offset of the local clock relative to the first process.
+     *
+     * It is estimated from the times at which the processes leave the previous
+     * synchronize() operation, which they all do at about the same moment.
+     * @return the duration to add to local times to align them on rank 0.
+     */
+    clock::duration getClockOffset() const;
+
+    /**
+     * Exchange the synchronization data of a frame with all processes.
+     *
+     * This is the only collective operation required for rendering a frame. It
+     * also synchronizes the clock time across all processes, see getTime() and
+     * getClockOffset().
+     * @param frame with the local values added in the same order on all
+     *        processes; contains the global results after the call.
+     */
+    void synchronize(FrameSync& frame);
 
     /** Check that all processes have the same version of an object. */
     bool checkVersion(uint64_t version) const;
@@ -101,11 +121,11 @@ public:
 
 private:
     MPICommunicator& _communicator;
+    HierarchicalCollectives _collectives;
     ReceiveBuffer _buffer;
     clock::time_point _timestamp;
-
-    void _sendClock();
-    void _receiveClock();
+    clock::time_point _lastSyncExit;
+    clock::duration _clockOffset = clock::duration::zero();
 };
 
 #endif
@@ -66,7 +66,7 @@ BackgroundRenderer::BackgroundRenderer(const Background& background,
     auto emptyGroup = DisplayGroup::create(context.screenRect.size());
     const auto helper = VisibilityHelper{*emptyGroup, context.screenRect,
                                          context.isAlphaBlendingEnabled()};
-    _renderer->update(window, helper.getVisibleArea(*window));
+    _renderer->update(window, helper.getVisibleRegion(*window));
 }
 
 BackgroundRenderer::~BackgroundRenderer()
@@ -73,9 +73,12 @@ void DisplayGroupRenderer::_updateWindowItems(const DisplayGroup& displayGroup)
     const QQuickItem* parentItem = nullptr;
     const auto helper = VisibilityHelper{displayGroup, _context.screenRect,
                                          _context.isAlphaBlendingEnabled()};
+    const auto visibleRegions = helper.getVisibleRegions();
 
-    for (const auto& window : displayGroup.getWindows())
+    const auto& windows = displayGroup.getWindows();
+    for (size_t i = 0; i < windows.size(); ++i)
     {
+        const auto& window = windows[i];
         const auto& id = window->getID();
 
         updatedWindows.insert(id);
@@ -83,7 +86,7 @@ void DisplayGroupRenderer::_updateWindowItems(const DisplayGroup& displayGroup)
         if (!_windowItems.contains(id))
             _createWindowQmlItem(window);
 
-        _windowItems[id]->update(window, helper.getVisibleArea(*window));
+        _windowItems[id]->update(window, visibleRegions[i]);
 
         // Update stacking order
         auto quickItem = _windowItems[id]->getQuickItem();
@@ -0,0 +1,175 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "FramebufferReader.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#if QT_VERSION >= 0x050600
+#include <QOpenGLExtraFunctions>
+#endif
+
+#include <cstring> // std::memcpy
+
+namespace
+{
+// Conservative duration of a full screen transfer when fences are unavailable
+const qint64 fallbackDelayMs = 20;
+
+#if QT_VERSION >= 0x050600
+bool _hasFences(const QOpenGLContext& context)
+{
+    const auto version = context.format().version();
+    if (context.isOpenGLES())
+        return version >= qMakePair(3, 0);
+    return version >= qMakePair(3, 2) || context.hasExtension("GL_ARB_sync");
+}
+#endif
+}
+
+FramebufferReader::FramebufferReader()
+{
+    _pbo.setUsagePattern(QOpenGLBuffer::StreamRead);
+}
+
+FramebufferReader::~FramebufferReader()
+{
+    _deleteFence();
+    _pbo.destroy();
+}
+
+void FramebufferReader::start(const QSize& size)
+{
+    auto context = QOpenGLContext::currentContext();
+    auto gl = context->functions();
+
+    if (!_pbo.isCreated())
+        _pbo.create();
+
+    _deleteFence();
+    _size = size;
+
+    _pbo.bind();
+    const auto byteCount = 4 * size.width() * size.height();
+    if (_pbo.size() != byteCount)
+        _pbo.allocate(byteCount);
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, context->defaultFramebufferObject());
+    gl->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    gl->glReadPixels(0, 0, size.width(), size.height(), GL_RGBA,
+                     GL_UNSIGNED_BYTE, nullptr);
+    _pbo.release();
+
+#if QT_VERSION >= 0x050600
+    if (_hasFences(*context))
+    {
+        auto glExtra = context->extraFunctions();
+        _fence = glExtra->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+#endif
+    gl->glFlush(); // make sure the transfer starts now
+    _timer.start();
+    _pending = true;
+}
+
+bool FramebufferReader::isPending() const
+{
+    return _pending;
+}
+
+bool FramebufferReader::isReady()
+{
+    if (!_pending)
+        return false;
+
+#if QT_VERSION >= 0x050600
+    if (_fence)
+    {
+        auto gl = QOpenGLContext::currentContext()->extraFunctions();
+        const auto status =
+            gl->glClientWaitSync(static_cast<GLsync>(_fence), 0, 0);
+        return status == GL_ALREADY_SIGNALED ||
+               status == GL_CONDITION_SATISFIED;
+    }
+#endif
+    return _timer.hasExpired(fallbackDelayMs);
+}
+
+QImage FramebufferReader::read()
+{
+    if (!_pending)
+        return QImage();
+
+    _deleteFence();
+    _pending = false;
+
+    auto image = QImage{_size, QImage::Format_RGBA8888};
+
+    _pbo.bind();
+    const auto map = _pbo.map(QOpenGLBuffer::ReadOnly);
+    const auto data = static_cast<const uchar*>(map);
+    if (data)
+    {
+        // OpenGL stores the bottom row first
+        const auto rowSize = size_t(image.bytesPerLine());
+        for (auto y = 0; y < image.height(); ++y)
+        {
+            const auto src = data + (image.height() - 1 - y) * rowSize;
+            std::memcpy(image.scanLine(y), src, rowSize);
+        }
+        _pbo.unmap();
+    }
+    else
+        image = QImage();
+    _pbo.release();
+
+    return image;
+}
+
+void FramebufferReader::_deleteFence()
+{
+#if QT_VERSION >= 0x050600
+    if (_fence)
+    {
+        auto gl = QOpenGLContext::currentContext()->extraFunctions();
+        gl->glDeleteSync(static_cast<GLsync>(_fence));
+    }
+#endif
+    _fence = nullptr;
+}
@@ -0,0 +1,94 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef FRAMEBUFFERREADER_H
+#define FRAMEBUFFERREADER_H
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QOpenGLBuffer>
+
+/**
+ * Read back the content of a window asynchronously.
+ *
+ * The pixels are read into a pixel pack buffer, which returns immediately, and
+ * only mapped once a fence indicates that the transfer is complete so that the
+ * render thread never waits for the GPU. Without fences (GL < 3.2), the buffer
+ * is mapped after a delay which is long enough for the transfer to complete.
+ *
+ * All methods must be called from the render thread with the GL context of the
+ * window current.
+ */
+class FramebufferReader
+{
+public:
+    FramebufferReader();
+
+    /** Release the GL resources, the GL context must be current. */
+    ~FramebufferReader();
+
+    /**
+     * Start reading the default framebuffer of the current context.
+     * @param size of the framebuffer in pixels.
+     */
+    void start(const QSize& size);
+
+    /** @return true if a read was started and its image not yet retrieved. */
+    bool isPending() const;
+
+    /** @return true if the image can be retrieved without blocking. */
+    bool isReady();
+
+    /**
+     * Retrieve the image of the pending read, which completes it.
+     * @return the image, top row first; blocks if the read is not ready.
+     */
+    QImage read();
+
+private:
+    QOpenGLBuffer _pbo{QOpenGLBuffer::PixelPackBuffer};
+    QSize _size;
+    void* _fence = nullptr;
+    QElapsedTimer _timer;
+    bool _pending = false;
+
+    void _deleteFence();
+};
+
+#endif
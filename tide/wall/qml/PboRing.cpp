@@ -0,0 +1,220 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "PboRing.h"
+
+#include "data/Image.h"
+#include "textureUtils.h"
+#include "utils/log.h"
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#if QT_VERSION >= 0x050600
+#include <QOpenGLExtraFunctions>
+#endif
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace
+{
+// Offsets of the texture data must be aligned for glTexSubImage2D
+const size_t regionAlignment = 256;
+
+// Never wait forever for the GPU if a fence is lost
+const GLuint64 fenceTimeoutNs = 1000000000;
+
+using BufferStorageFunc = void(QOPENGLF_APIENTRYP)(GLenum, GLsizeiptr,
+                                                   const void*, GLbitfield);
+
+#if QT_VERSION >= 0x050600
+BufferStorageFunc _getBufferStorage(QOpenGLContext& context)
+{
+    if (context.isOpenGLES())
+        return nullptr;
+
+    const auto version = context.format().version();
+    if (version < qMakePair(4, 4) &&
+        !context.hasExtension("GL_ARB_buffer_storage"))
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<BufferStorageFunc>(
+        context.getProcAddress("glBufferStorage"));
+}
+#endif
+
+size_t _align(const size_t size)
+{
+    return (size + regionAlignment - 1) / regionAlignment * regionAlignment;
+}
+}
+
+PboRing::~PboRing()
+{
+    for (auto i = 0u; i < bufferCount; ++i)
+        _deleteFence(i);
+    if (_storage.isCreated())
+        _storage.destroy(); // also unmaps the buffer
+}
+
+void PboRing::upload(const Image& image, const uint srcTextureIdx)
+{
+    if (!_initialized)
+        _init();
+
+    _current = (_current + 1) % bufferCount;
+
+    if (_persistent)
+        _reserveStorage(image.getDataSize(srcTextureIdx));
+
+    if (!_persistent)
+    {
+        textureUtils::upload(image, srcTextureIdx, *_buffers[_current]);
+        return;
+    }
+
+    _waitFence(_current);
+    image.writeData(srcTextureIdx, _mapped + _current * _regionSize);
+}
+
+void PboRing::copy(QSGTexture& texture, const uint glTexFormat,
+                   const bool generateMipmaps)
+{
+    if (!_persistent)
+    {
+        textureUtils::copy(*_buffers[_current], texture, glTexFormat,
+                           generateMipmaps);
+        return;
+    }
+
+    textureUtils::copy(_storage, texture, glTexFormat, generateMipmaps,
+                       _current * _regionSize);
+#if QT_VERSION >= 0x050600
+    auto gl = QOpenGLContext::currentContext()->extraFunctions();
+    _deleteFence(_current);
+    _fences[_current] = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+void PboRing::_init()
+{
+    _initialized = true;
+#if QT_VERSION >= 0x050600
+    _persistent = !!_getBufferStorage(*QOpenGLContext::currentContext());
+#endif
+    if (_persistent)
+        return;
+
+    for (auto& buffer : _buffers)
+        buffer = textureUtils::createPbo(true);
+}
+
+void PboRing::_reserveStorage(const size_t size)
+{
+#if QT_VERSION >= 0x050600
+    if (_regionSize >= size)
+        return;
+
+    for (auto i = 0u; i < bufferCount; ++i)
+        _waitFence(i);
+    if (_storage.isCreated())
+        _storage.destroy();
+
+    auto context = QOpenGLContext::currentContext();
+    auto gl = context->extraFunctions();
+    const auto bufferStorage = _getBufferStorage(*context);
+
+    _regionSize = _align(size);
+    const auto totalSize = GLsizeiptr(_regionSize * bufferCount);
+    const auto flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    _storage.create();
+    _storage.bind();
+    bufferStorage(GL_PIXEL_UNPACK_BUFFER, totalSize, nullptr, flags);
+    _mapped = static_cast<uint8_t*>(
+        gl->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, totalSize, flags));
+    _storage.release();
+
+    if (!_mapped)
+    {
+        print_log(LOG_WARN, LOG_GENERAL,
+                  "persistent mapping of PBO failed, using regular PBOs");
+        _storage.destroy();
+        _regionSize = 0;
+        _persistent = false;
+        for (auto& buffer : _buffers)
+            buffer = textureUtils::createPbo(true);
+    }
+#else
+    Q_UNUSED(size);
+#endif
+}
+
+void PboRing::_waitFence(const size_t index)
+{
+#if QT_VERSION >= 0x050600
+    if (!_fences[index])
+        return;
+
+    auto gl = QOpenGLContext::currentContext()->extraFunctions();
+    gl->glClientWaitSync(static_cast<GLsync>(_fences[index]),
+                         GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeoutNs);
+    _deleteFence(index);
+#else
+    Q_UNUSED(index);
+#endif
+}
+
+void PboRing::_deleteFence(const size_t index)
+{
+#if QT_VERSION >= 0x050600
+    if (_fences[index])
+    {
+        auto gl = QOpenGLContext::currentContext()->extraFunctions();
+        gl->glDeleteSync(static_cast<GLsync>(_fences[index]));
+    }
+#endif
+    _fences[index] = nullptr;
+}
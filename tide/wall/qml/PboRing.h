@@ -0,0 +1,114 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef PBORING_H
+#define PBORING_H
+
+#include "types.h"
+
+#include <QOpenGLBuffer>
+
+#include <array>
+
+class QSGTexture;
+
+/**
+ * Ring of pixel unpack buffers for the uploads of dynamic textures.
+ *
+ * Each upload writes to the next of three buffers, so that the CPU never
+ * writes to a buffer which the GPU may still be copying to a texture.
+ *
+ * With GL_ARB_buffer_storage (core in GL 4.4), the three buffers are regions of
+ * a single immutable buffer which stays persistently mapped: images write their
+ * pixels straight into it without any map/unmap call, and a fence placed after
+ * each copy to a texture protects its region until the GPU has read it.
+ * Otherwise, three regular buffers are mapped and unmapped for each upload.
+ *
+ * All methods except the constructor must be called from the render thread
+ * with the GL context current. The GL resources are created on first use.
+ */
+class PboRing
+{
+public:
+    PboRing() = default;
+
+    /** Release the GL resources, the GL context must be current if any. */
+    ~PboRing();
+
+    /** @return true if the buffers are persistently mapped. */
+    bool isPersistent() const { return _persistent; }
+
+    /**
+     * Write a texture plane of an image to the next buffer of the ring.
+     * @param image the source image.
+     * @param srcTextureIdx the texture plane of the source image.
+     */
+    void upload(const Image& image, uint srcTextureIdx);
+
+    /**
+     * Copy the last uploaded buffer to a GPU texture.
+     * @param texture the target texture, must be of the same size as the image.
+     * @param glTexFormat the format of the OpenGL texture.
+     * @param generateMipmaps true to regenerate the mipmaps of the texture.
+     */
+    void copy(QSGTexture& texture, uint glTexFormat, bool generateMipmaps);
+
+private:
+    static const size_t bufferCount = 3;
+
+    bool _initialized = false;
+    bool _persistent = false;
+    size_t _current = 0;
+    size_t _regionSize = 0;
+
+    // Persistently mapped buffer and its regions' fences
+    QOpenGLBuffer _storage{QOpenGLBuffer::PixelUnpackBuffer};
+    uint8_t* _mapped = nullptr;
+    std::array<void*, bufferCount> _fences{{nullptr, nullptr, nullptr}};
+
+    // Fallback buffers
+    std::array<std::unique_ptr<QOpenGLBuffer>, bufferCount> _buffers;
+
+    void _init();
+    void _reserveStorage(size_t size);
+    void _waitFence(size_t index);
+    void _deleteFence(size_t index);
+};
+
+#endif
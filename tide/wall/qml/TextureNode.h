@@ -56,6 +56,12 @@ public:
     /** Set the surface of the node. */
     virtual void setCoord(const QRectF& coord) = 0;
 
+    /**
+     * Set the size of the node on screen in pixels, which dynamic nodes use to
+     * skip the generation of mipmaps when displayed at roughly 1:1 scale.
+     */
+    virtual void setDisplaySize(const QSizeF& size) = 0;
+
     /** Upload the given image to the back PBO. */
     virtual void uploadTexture(const Image& image) = 0;
 
@@ -49,20 +49,22 @@ std::unique_ptr<TextureNode> TextureNodeFactoryImpl::create(
     switch (format)
     {
     case TextureFormat::rgba:
-        return std::make_unique<TextureNodeRGBA>(_window, dynamic);
+        return std::make_unique<TextureNodeRGBA>(_window, dynamic, _pool);
     case TextureFormat::yuv444:
     case TextureFormat::yuv422:
     case TextureFormat::yuv420:
-        return std::make_unique<TextureNodeYUV>(_window, dynamic);
+        return std::make_unique<TextureNodeYUV>(_window, dynamic, _pool);
     default:
         throw std::runtime_error("unsupported texture format");
     }
 }
 
-TextureNodeFactoryImpl::TextureNodeFactoryImpl(QQuickWindow& window,
-                                               const TextureType type)
+TextureNodeFactoryImpl::TextureNodeFactoryImpl(
+    QQuickWindow& window, const TextureType type,
+    std::weak_ptr<TexturePool> pool)
     : _window{window}
     , _type{type}
+    , _pool{std::move(pool)}
 {
 }
 
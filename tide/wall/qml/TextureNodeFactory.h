@@ -43,6 +43,7 @@
 #include "TextureNode.h"
 
 class QQuickWindow;
+class TexturePool;
 
 /**
  * Abstract TextureNode factory for all supported texture formats.
@@ -69,13 +70,15 @@ public:
 class TextureNodeFactoryImpl : public TextureNodeFactory
 {
 public:
-    TextureNodeFactoryImpl(QQuickWindow& _window, TextureType _type);
+    TextureNodeFactoryImpl(QQuickWindow& _window, TextureType _type,
+                           std::weak_ptr<TexturePool> pool = {});
     std::unique_ptr<TextureNode> create(TextureFormat format) final;
     bool needToChangeNodeType(TextureFormat a, TextureFormat b) const final;
 
 private:
     QQuickWindow& _window;
     TextureType _type = TextureType::static_;
+    std::weak_ptr<TexturePool> _pool;
 };
 
 #endif
@@ -39,15 +39,21 @@
 
 #include "TextureNodeRGBA.h"
 
+#include "TexturePool.h"
 #include "data/Image.h"
 #include "textureUtils.h"
 
+#include <QOpenGLFunctions>
 #include <QQuickWindow>
 
-TextureNodeRGBA::TextureNodeRGBA(QQuickWindow& window, const bool dynamic)
+TextureNodeRGBA::TextureNodeRGBA(QQuickWindow& window, const bool dynamic,
+                                 std::weak_ptr<TexturePool> pool)
     : _window(window)
     , _dynamicTexture(dynamic)
+    , _pool(std::move(pool))
     , _texture(window.createTextureFromId(0, QSize(1, 1)))
+    , _textureFormat(GL_RGBA8)
+    , _nextTextureFormat(GL_RGBA8)
 {
     if (_texture) // needed for null texture in unit tests without a scene graph
         setTexture(_texture.get());
@@ -55,6 +61,12 @@ TextureNodeRGBA::TextureNodeRGBA(QQuickWindow& window, const bool dynamic)
     setMipmapFiltering(QSGTexture::Linear);
 }
 
+TextureNodeRGBA::~TextureNodeRGBA()
+{
+    _recycle(std::move(_texture));
+    _recycle(std::move(_pbo));
+}
+
 void TextureNodeRGBA::setMipmapFiltering(const QSGTexture::Filtering filtering_)
 {
     auto mat = static_cast<QSGOpaqueTextureMaterial*>(material());
@@ -74,10 +86,22 @@ void TextureNodeRGBA::uploadTexture(const Image& image)
     else
         setTextureCoordinatesTransform(QSGSimpleTextureNode::NoTransform);
 
-    if (!_pbo)
-        _pbo = textureUtils::createPbo(_dynamicTexture);
-
-    textureUtils::upload(image, 0, *_pbo);
+    _nextTextureFormat = GL_RGBA8;
+    if (_dynamicTexture)
+        _pboRing.upload(image, 0);
+    else if (_isCompressionSupported(image))
+    {
+        if (!_pbo)
+            _pbo = _createPbo(image.getCompressedDataSize());
+        textureUtils::uploadCompressed(image, *_pbo);
+        _nextTextureFormat = image.getGLCompressedFormat();
+    }
+    else
+    {
+        if (!_pbo)
+            _pbo = _createPbo(image.getDataSize(0));
+        textureUtils::upload(image, 0, *_pbo);
+    }
 
     _nextTextureSize = image.getTextureSize();
     _glImageFormat = image.getGLPixelFormat();
@@ -85,13 +109,65 @@ void TextureNodeRGBA::uploadTexture(const Image& image)
 
 void TextureNodeRGBA::swap()
 {
-    if (_texture->textureSize() != _nextTextureSize)
-        _texture = textureUtils::createTextureRgba(_nextTextureSize, _window);
+    if (_texture->textureSize() != _nextTextureSize ||
+        _textureFormat != _nextTextureFormat)
+    {
+        auto texture = _createTexture(_nextTextureSize, _nextTextureFormat);
+        _recycle(std::move(_texture));
+        _texture = std::move(texture);
+        _textureFormat = _nextTextureFormat;
+    }
 
-    textureUtils::copy(*_pbo, *_texture, _glImageFormat);
+    if (_dynamicTexture)
+    {
+        const auto mipmaps =
+            textureUtils::needMipmaps(_nextTextureSize, _displaySize);
+        _pboRing.copy(*_texture, _glImageFormat, mipmaps);
+        setMipmapFiltering(mipmaps ? QSGTexture::Linear : QSGTexture::None);
+    }
+    else
+    {
+        if (_textureFormat == GL_RGBA8)
+            textureUtils::copy(*_pbo, *_texture, _glImageFormat);
+        else
+            textureUtils::copyCompressed(*_pbo, *_texture, _textureFormat);
+        _recycle(std::move(_pbo));
+    }
     setTexture(_texture.get());
     markDirty(DirtyMaterial);
+}
+
+bool TextureNodeRGBA::_isCompressionSupported(const Image& image) const
+{
+    const auto format = image.getGLCompressedFormat();
+    return format != 0 && textureUtils::isCompressedFormatSupported(format);
+}
 
-    if (!_dynamicTexture)
-        _pbo.reset();
+std::unique_ptr<QSGTexture> TextureNodeRGBA::_createTexture(const QSize& size,
+                                                            const uint format)
+{
+    if (auto pool = _pool.lock())
+        return pool->getTexture(size, format);
+    if (format == GL_RGBA8)
+        return textureUtils::createTextureRgba(size, _window);
+    return textureUtils::createCompressedTexture(size, format, _window);
+}
+
+std::unique_ptr<QOpenGLBuffer> TextureNodeRGBA::_createPbo(const size_t size)
+{
+    if (auto pool = _pool.lock())
+        return pool->getPbo(size, _dynamicTexture);
+    return textureUtils::createPbo(_dynamicTexture);
+}
+
+void TextureNodeRGBA::_recycle(std::unique_ptr<QSGTexture> texture)
+{
+    if (auto pool = _pool.lock())
+        pool->recycle(std::move(texture), _textureFormat);
+}
+
+void TextureNodeRGBA::_recycle(std::unique_ptr<QOpenGLBuffer> pbo)
+{
+    if (auto pool = _pool.lock())
+        pool->recycle(std::move(pbo), _dynamicTexture);
 }
@@ -40,6 +40,7 @@
 #ifndef TEXTURENODERGBA_H
 #define TEXTURENODERGBA_H
 
+#include "PboRing.h"
 #include "TextureNode.h"
 
 #include <QOpenGLBuffer>
@@ -47,6 +48,7 @@
 #include <memory>
 
 class QQuickWindow;
+class TexturePool;
 
 /**
  * A node with a double buffered texture.
@@ -56,9 +58,15 @@ class QQuickWindow;
  * display the results.
  *
  * The texture can be either static or dynamic:
- * * In the dynamic case, two PBOs are used for real-time texture updates.
+ * * In the dynamic case, a PboRing is used for real-time texture updates and
+ *   mipmaps are only generated if the texture is minified on screen.
  * * In the static case, a single PBO is used for the initial texture upload and
  *   then released in the first call to swap() so that no memory is wasted.
+ *   Images with compressed data are uploaded to a compressed texture if the
+ *   OpenGL context supports its format.
+ *
+ * If a TexturePool is provided, textures and PBOs are obtained from it and
+ * given back to it when they are no longer needed.
  */
 class TextureNodeRGBA : public QSGSimpleTextureNode, public TextureNode
 {
@@ -67,26 +75,43 @@ public:
      * Create a textured rectangle for rendering RGBA images on the GPU.
      * @param window a reference to the quick window for generating textures.
      * @param dynamic true if the texture is going to be updated more than once.
+     * @param pool optional pool to recycle the textures and PBOs.
      */
-    TextureNodeRGBA(QQuickWindow& window, bool dynamic);
+    TextureNodeRGBA(QQuickWindow& window, bool dynamic,
+                    std::weak_ptr<TexturePool> pool = {});
+
+    /** Give the textures and PBOs back to the pool. */
+    ~TextureNodeRGBA();
 
     /** @sa QSGOpaqueTextureMaterial::setMipmapFiltering */
     void setMipmapFiltering(QSGTexture::Filtering filtering);
 
     QRectF getCoord() const final { return rect(); }
     void setCoord(const QRectF& coord) final { setRect(coord); }
+    void setDisplaySize(const QSizeF& size) final { _displaySize = size; }
     void uploadTexture(const Image& image) final;
     void swap() final;
 
 private:
     QQuickWindow& _window;
     bool _dynamicTexture = false;
+    std::weak_ptr<TexturePool> _pool;
 
     std::unique_ptr<QSGTexture> _texture;
     std::unique_ptr<QOpenGLBuffer> _pbo;
+    PboRing _pboRing;
 
+    QSizeF _displaySize;
     QSize _nextTextureSize;
     uint _glImageFormat = 0;
+    uint _textureFormat;
+    uint _nextTextureFormat;
+
+    bool _isCompressionSupported(const Image& image) const;
+    std::unique_ptr<QSGTexture> _createTexture(const QSize& size, uint format);
+    std::unique_ptr<QOpenGLBuffer> _createPbo(size_t size);
+    void _recycle(std::unique_ptr<QSGTexture> texture);
+    void _recycle(std::unique_ptr<QOpenGLBuffer> pbo);
 };
 
 #endif
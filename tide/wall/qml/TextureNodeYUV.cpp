@@ -39,6 +39,7 @@
 
 #include "TextureNodeYUV.h"
 
+#include "TexturePool.h"
 #include "data/Image.h"
 #include "textureUtils.h"
 #include "utils/yuv.h"
@@ -186,9 +187,11 @@ const YUVState* _getMaterialState(const QSGGeometryNode& node)
     return static_cast<const YUVShaderMaterial*>(node.material())->state();
 }
 
-TextureNodeYUV::TextureNodeYUV(QQuickWindow& window, const bool dynamic)
+TextureNodeYUV::TextureNodeYUV(QQuickWindow& window, const bool dynamic,
+                               std::weak_ptr<TexturePool> pool)
     : _window(window)
     , _dynamicTexture(dynamic)
+    , _pool(std::move(pool))
 {
     // Set up geometry, actual vertices will be initialized in updatePaintNode
     const auto& attr = QSGGeometry::defaultAttributes_TexturedPoint2D();
@@ -206,6 +209,12 @@ TextureNodeYUV::TextureNodeYUV(QQuickWindow& window, const bool dynamic)
     appendChildNode(&_node);
 }
 
+TextureNodeYUV::~TextureNodeYUV()
+{
+    _recycleTextures();
+    _recyclePbos();
+}
+
 QRectF TextureNodeYUV::getCoord() const
 {
     return _rect;
@@ -222,6 +231,11 @@ void TextureNodeYUV::setCoord(const QRectF& rect)
     _node.markDirty(QSGNode::DirtyGeometry);
 }
 
+void TextureNodeYUV::setDisplaySize(const QSizeF& size)
+{
+    _displaySize = size;
+}
+
 void TextureNodeYUV::uploadTexture(const Image& image)
 {
     if (!image.getTextureSize().isValid())
@@ -230,8 +244,8 @@ void TextureNodeYUV::uploadTexture(const Image& image)
         throw std::runtime_error("TextureNodeYUV image format must be GL_RED");
 
     auto state = _getMaterialState(_node);
-    if (!state->pboY)
-        _createPbos();
+    if (!_dynamicTexture && !state->pboY)
+        _createPbos(image);
 
     _uploadToPbos(image);
 
@@ -251,7 +265,7 @@ void TextureNodeYUV::swap()
     markDirty(DirtyMaterial);
 
     if (!_dynamicTexture)
-        _deletePbos();
+        _recyclePbos();
 }
 
 bool TextureNodeYUV::_needTextureChange() const
@@ -264,6 +278,8 @@ bool TextureNodeYUV::_needTextureChange() const
 void TextureNodeYUV::_createTextures(const QSize& size,
                                      const TextureFormat format)
 {
+    _recycleTextures();
+
     auto state = _getMaterialState(_node);
     const auto uvSize = yuv::getUVSize(size, format);
     state->textureY = _createTexture(size);
@@ -275,23 +291,52 @@ void TextureNodeYUV::_createTextures(const QSize& size,
 std::unique_ptr<QSGTexture> TextureNodeYUV::_createTexture(
     const QSize& size) const
 {
-    auto texture = textureUtils::createTexture(size, _window);
+    auto pool = _pool.lock();
+    auto texture = pool ? pool->getTexture(size, GL_R8)
+                        : textureUtils::createTexture(size, _window);
     texture->setFiltering(QSGTexture::Linear);
     texture->setMipmapFiltering(QSGTexture::Linear);
     return texture;
 }
 
-void TextureNodeYUV::_createPbos()
+void TextureNodeYUV::_recycleTextures()
 {
+    auto pool = _pool.lock();
+    if (!pool)
+        return;
+
     auto state = _getMaterialState(_node);
-    state->pboY = textureUtils::createPbo(_dynamicTexture);
-    state->pboU = textureUtils::createPbo(_dynamicTexture);
-    state->pboV = textureUtils::createPbo(_dynamicTexture);
+    pool->recycle(std::move(state->textureY), GL_R8);
+    pool->recycle(std::move(state->textureU), GL_R8);
+    pool->recycle(std::move(state->textureV), GL_R8);
 }
 
-void TextureNodeYUV::_deletePbos()
+void TextureNodeYUV::_createPbos(const Image& image)
 {
     auto state = _getMaterialState(_node);
+    state->pboY = _createPbo(image.getDataSize(0));
+    state->pboU = _createPbo(image.getDataSize(1));
+    state->pboV = _createPbo(image.getDataSize(2));
+}
+
+std::unique_ptr<QOpenGLBuffer> TextureNodeYUV::_createPbo(
+    const size_t size) const
+{
+    if (auto pool = _pool.lock())
+        return pool->getPbo(size, _dynamicTexture);
+    return textureUtils::createPbo(_dynamicTexture);
+}
+
+void TextureNodeYUV::_recyclePbos()
+{
+    auto state = _getMaterialState(_node);
+    if (auto pool = _pool.lock())
+    {
+        pool->recycle(std::move(state->pboY), _dynamicTexture);
+        pool->recycle(std::move(state->pboU), _dynamicTexture);
+        pool->recycle(std::move(state->pboV), _dynamicTexture);
+        return;
+    }
     state->pboY.reset();
     state->pboU.reset();
     state->pboV.reset();
@@ -299,6 +344,13 @@ void TextureNodeYUV::_deletePbos()
 
 void TextureNodeYUV::_uploadToPbos(const Image& image)
 {
+    if (_dynamicTexture)
+    {
+        for (auto i = 0u; i < _pboRings.size(); ++i)
+            _pboRings[i].upload(image, i);
+        return;
+    }
+
     auto state = _getMaterialState(_node);
     textureUtils::upload(image, 0, *state->pboY);
     textureUtils::upload(image, 1, *state->pboU);
@@ -308,6 +360,22 @@ void TextureNodeYUV::_uploadToPbos(const Image& image)
 void TextureNodeYUV::_copyPbosToTextures()
 {
     auto state = _getMaterialState(_node);
+    if (_dynamicTexture)
+    {
+        const auto mipmaps =
+            textureUtils::needMipmaps(_nextTextureSize, _displaySize);
+        const auto filtering = mipmaps ? QSGTexture::Linear : QSGTexture::None;
+        const std::array<QSGTexture*, 3> textures{{state->textureY.get(),
+                                                   state->textureU.get(),
+                                                   state->textureV.get()}};
+        for (auto i = 0u; i < textures.size(); ++i)
+        {
+            _pboRings[i].copy(*textures[i], GL_RED, mipmaps);
+            textures[i]->setMipmapFiltering(filtering);
+        }
+        return;
+    }
+
     textureUtils::copy(*state->pboY, *state->textureY, GL_RED);
     textureUtils::copy(*state->pboU, *state->textureU, GL_RED);
     textureUtils::copy(*state->pboV, *state->textureV, GL_RED);
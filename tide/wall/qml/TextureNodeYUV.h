@@ -40,12 +40,17 @@
 #ifndef TEXTURENODEYUV_H
 #define TEXTURENODEYUV_H
 
+#include "PboRing.h"
 #include "TextureNode.h"
 
 #include <QSGNode>
 
+#include <array>
+
+class QOpenGLBuffer;
 class QQuickWindow;
 class QSGTexture;
+class TexturePool;
 
 /**
  * A node with a double buffered YUV texture.
@@ -55,9 +60,13 @@ class QSGTexture;
  * display the results.
  *
  * The texture can be either static or dynamic:
- * * In the dynamic case, two PBOs are used for real-time texture updates.
+ * * In the dynamic case, a PboRing per plane is used for real-time texture
+ *   updates and mipmaps are only generated if the texture is minified.
  * * In the static case, a single PBO is used for the initial texture upload and
  *   then released in the first call to swap() so that no memory is wasted.
+ *
+ * If a TexturePool is provided, textures and PBOs are obtained from it and
+ * given back to it when they are no longer needed.
  */
 class TextureNodeYUV : public QSGNode, public TextureNode
 {
@@ -66,29 +75,40 @@ public:
      * Create a textured rectangle for rendering YUV images on the GPU.
      * @param window a reference to the quick window for generating textures.
      * @param dynamic true if the texture is going to be updated more than once.
+     * @param pool optional pool to recycle the textures and PBOs.
      */
-    TextureNodeYUV(QQuickWindow& window, bool dynamic);
+    TextureNodeYUV(QQuickWindow& window, bool dynamic,
+                   std::weak_ptr<TexturePool> pool = {});
+
+    /** Give the textures and PBOs back to the pool. */
+    ~TextureNodeYUV();
 
     QRectF getCoord() const final;
     void setCoord(const QRectF& rect) final;
+    void setDisplaySize(const QSizeF& size) final;
     void uploadTexture(const Image& image) final;
     void swap() final;
 
 private:
     QQuickWindow& _window;
     bool _dynamicTexture = false;
+    std::weak_ptr<TexturePool> _pool;
 
     QRectF _rect;
     QSGGeometryNode _node;
+    std::array<PboRing, 3> _pboRings;
 
+    QSizeF _displaySize;
     QSize _nextTextureSize;
     TextureFormat _nextFormat;
 
     bool _needTextureChange() const;
     void _createTextures(const QSize& size, TextureFormat format);
     std::unique_ptr<QSGTexture> _createTexture(const QSize& size) const;
-    void _createPbos();
-    void _deletePbos();
+    void _recycleTextures();
+    void _createPbos(const Image& image);
+    std::unique_ptr<QOpenGLBuffer> _createPbo(size_t size) const;
+    void _recyclePbos();
     void _uploadToPbos(const Image& image);
     void _copyPbosToTextures();
     void _swapPbos();
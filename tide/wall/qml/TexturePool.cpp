@@ -0,0 +1,121 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TexturePool.h"
+
+#include "textureUtils.h"
+#include "tools/bc1.h"
+
+#include <QOpenGLFunctions>
+
+namespace
+{
+size_t _getTextureMemory(const QSize& size, const uint format)
+{
+    if (format == bc1::glFormat)
+        return bc1::getCompressedSize(
+            size.width(), size.height(),
+            bc1::getLevelCount(size.width(), size.height()));
+
+    const auto bytesPerPixel = format == GL_RGBA8 ? 4 : 1;
+    const auto size0 = size_t(size.width()) * size.height() * bytesPerPixel;
+    return size0 + size0 / 3; // mipmaps
+}
+}
+
+TexturePool::TexturePool(QQuickWindow& window, const size_t maxSize)
+    : _window(window)
+    , _textures{maxSize / 2}
+    , _pbos{maxSize / 2}
+{
+}
+
+std::unique_ptr<QSGTexture> TexturePool::getTexture(const QSize& size,
+                                                    const uint format)
+{
+    if (auto texture = _textures.take({size.width(), size.height(), format}))
+        return texture;
+
+    if (format == GL_RGBA8)
+        return textureUtils::createTextureRgba(size, _window);
+    if (format == GL_R8)
+        return textureUtils::createTexture(size, _window);
+    return textureUtils::createCompressedTexture(size, format, _window);
+}
+
+void TexturePool::recycle(std::unique_ptr<QSGTexture> texture,
+                          const uint format)
+{
+    if (!texture || texture->textureId() == 0)
+        return;
+
+    const auto size = texture->textureSize();
+    const auto memory = _getTextureMemory(size, format);
+    _textures.give({size.width(), size.height(), format}, std::move(texture),
+                   memory);
+}
+
+std::unique_ptr<QOpenGLBuffer> TexturePool::getPbo(const size_t size,
+                                                   const bool dynamic)
+{
+    if (auto pbo = _pbos.take({size, dynamic}))
+        return pbo;
+    return textureUtils::createPbo(dynamic);
+}
+
+void TexturePool::recycle(std::unique_ptr<QOpenGLBuffer> pbo,
+                          const bool dynamic)
+{
+    if (!pbo || pbo->size() <= 0)
+        return;
+
+    const auto size = size_t(pbo->size());
+    _pbos.give({size, dynamic}, std::move(pbo), size);
+}
+
+void TexturePool::clear()
+{
+    _textures.setMaxSize(0);
+    _pbos.setMaxSize(0);
+}
+
+TexturePool::Stats TexturePool::getStats() const
+{
+    return {_textures.getStats(), _pbos.getStats()};
+}
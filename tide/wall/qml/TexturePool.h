@@ -0,0 +1,133 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TEXTUREPOOL_H
+#define TEXTUREPOOL_H
+
+#include "tools/ResourcePool.h"
+
+#include <QOpenGLBuffer>
+#include <QSGTexture>
+
+#include <tuple>
+#include <utility>
+
+class QQuickWindow;
+
+/**
+ * Pool of unused GPU textures and PBOs of a window, kept for reuse.
+ *
+ * Texture nodes give their textures and PBOs back to the pool when they are
+ * resized or destroyed instead of deleting them, which avoids a continuous
+ * allocate/free cycle in the driver when tiles come and go or when streams
+ * change size. Textures are recycled by size and internal format, PBOs by size
+ * and usage pattern. The budget is shared equally between textures and PBOs.
+ *
+ * All methods must be called from the render thread with the GL context of the
+ * window current.
+ */
+class TexturePool
+{
+public:
+    using TextureKey = std::tuple<int, int, uint>; // width, height, format
+    using PboKey = std::pair<size_t, bool>;        // size, dynamic
+    using TexturePoolStats = ResourcePool<TextureKey, QSGTexture>::Stats;
+    using PboPoolStats = ResourcePool<PboKey, QOpenGLBuffer>::Stats;
+
+    /** Statistics of the pool. */
+    struct Stats
+    {
+        TexturePoolStats textures;
+        PboPoolStats pbos;
+    };
+
+    /**
+     * Create a pool.
+     * @param window the window for which to create the textures.
+     * @param maxSize the memory budget of the unused resources [bytes].
+     */
+    TexturePool(QQuickWindow& window, size_t maxSize);
+
+    /**
+     * Get a texture, reusing an unused one if possible.
+     * @param size in pixels.
+     * @param format the OpenGL internal format, GL_R8 or GL_RGBA8.
+     * @return a texture with undefined content.
+     */
+    std::unique_ptr<QSGTexture> getTexture(const QSize& size, uint format);
+
+    /**
+     * Give back a texture obtained with getTexture().
+     * @param texture to reuse, deleted if its id is 0 (placeholder).
+     * @param format the format given to getTexture().
+     */
+    void recycle(std::unique_ptr<QSGTexture> texture, uint format);
+
+    /**
+     * Get a PBO, reusing an unused one if possible.
+     * @param size the desired size in bytes, to find a PBO that will not need
+     *        to be reallocated.
+     * @param dynamic true if the buffer is going to be updated frequently.
+     * @return an empty or allocated PBO.
+     */
+    std::unique_ptr<QOpenGLBuffer> getPbo(size_t size, bool dynamic);
+
+    /**
+     * Give back a PBO obtained with getPbo().
+     * @param pbo to reuse, deleted if it was never allocated.
+     * @param dynamic the usage pattern given to getPbo().
+     */
+    void recycle(std::unique_ptr<QOpenGLBuffer> pbo, bool dynamic);
+
+    /**
+     * Delete all the unused resources and stop recycling; resources given back
+     * after this call are deleted immediately.
+     */
+    void clear();
+
+    /** @return the statistics of the pool. */
+    Stats getStats() const;
+
+private:
+    QQuickWindow& _window;
+    ResourcePool<TextureKey, QSGTexture> _textures;
+    ResourcePool<PboKey, QOpenGLBuffer> _pbos;
+};
+
+#endif
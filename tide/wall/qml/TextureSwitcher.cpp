@@ -40,6 +40,7 @@
 #include "TextureSwitcher.h"
 
 #include "data/Image.h"
+#include "utils/trace.h"
 
 void TextureSwitcher::setNextImage(ImagePtr image)
 {
@@ -110,6 +111,7 @@ void TextureSwitcher::_createNextNode(TextureNodeFactory& factory)
 
 void TextureSwitcher::_uploadImage(TextureNode& node)
 {
+    TIDE_TRACE_SCOPE("uploadTexture");
     node.uploadTexture(*_image);
     _format = _image->getFormat();
     _image.reset();
@@ -40,8 +40,10 @@
 #include "qml/Tile.h"
 
 #include "TextureNodeFactory.h"
+#include "WallWindow.h"
 #include "utils/log.h"
 
+#include <QQuickWindow>
 #include <QSGNode>
 
 TilePtr Tile::create(const uint id, const QRect& rect, const TextureType type)
@@ -116,6 +118,19 @@ void Tile::updateBackTexture(ImagePtr image, TilePtr self)
     QQuickItem::update();
 }
 
+qreal Tile::getVisibleArea() const
+{
+    const auto parent = parentItem();
+    if (!parent || !window())
+        return 0.0;
+
+    const auto rect = _policy == FillParent ? parent->boundingRect()
+                                            : QRectF{_nextCoord};
+    const auto windowRect = QRectF{QPointF(), window()->size()};
+    const auto area = parent->mapRectToScene(rect).intersected(windowRect);
+    return area.width() * area.height();
+}
+
 void Tile::setSizePolicy(const SizePolicy policy)
 {
     _policy = policy;
@@ -142,12 +157,17 @@ QSGNode* Tile::updatePaintNode(QSGNode* node, QQuickItem::UpdatePaintNodeData*)
     auto textureNode =
         std::unique_ptr<TextureNode>(dynamic_cast<TextureNode*>(node));
 
-    TextureNodeFactoryImpl factory{*window(), _type};
+    auto wallWindow = qobject_cast<WallWindow*>(window());
+    auto pool = wallWindow ? wallWindow->getTexturePool()
+                           : std::weak_ptr<TexturePool>();
+    TextureNodeFactoryImpl factory{*window(), _type, pool};
     _textureSwitcher.update(textureNode, factory);
     if (!textureNode)
         return nullptr;
 
     textureNode->setCoord(boundingRect());
+    const auto displaySize = mapRectToScene(boundingRect()).size();
+    textureNode->setDisplaySize(displaySize * window()->devicePixelRatio());
 
     _textureSwitcher.updateBorderNode(*textureNode);
 
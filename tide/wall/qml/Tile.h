@@ -87,6 +87,12 @@ public:
      */
     void update(const QRect& rect);
 
+    /**
+     * @return the area of the tile which is visible in its window in pixels,
+     *         once it will have been updated to its next coordinates.
+     */
+    qreal getVisibleArea() const;
+
     /**
      * Set the size policy.
      * @param policy defines how the tile should resize and position itself
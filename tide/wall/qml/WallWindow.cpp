@@ -41,15 +41,20 @@
 
 #include "WallConfiguration.h"
 #include "WallRenderContext.h"
+#include "qml/FramebufferReader.h"
 #include "qml/TestPattern.h"
+#include "qml/TexturePool.h"
 #include "qml/WallSurfaceRenderer.h"
 #include "qml/qscreens.h"
 #include "scene/Background.h"
 #include "scene/Options.h"
 #include "scene/Surface.h"
 #include "swapsync/SwapSynchronizer.h"
+#include "tools/FramePacer.h"
+#include "tools/TelemetryCollector.h"
 #include "utils/log.h"
 #include "utils/qml.h"
+#include "utils/trace.h"
 
 #include <deflect/qt/QuickRenderer.h>
 
@@ -58,6 +63,7 @@
 #include <QQmlEngine>
 #include <QQuickRenderControl>
 #include <QThread>
+#include <QTimer>
 
 WallWindowPtr WallWindow::create(const WallConfiguration& config,
                                  const uint windowIndex, DataProvider& provider)
@@ -91,6 +97,9 @@ WallWindow::WallWindow(const WallConfiguration& config, const uint windowIndex,
     _surfaceIndex = screenConfig.surfaceIndex;
     _globalIndex = screenConfig.globalIndex;
 
+    const auto poolSize = size_t(config.global.texturePoolSize) << 20;
+    _texturePool = std::make_shared<TexturePool>(*this, poolSize);
+
     if (auto qscreen = qscreens::find(screenConfig.display))
         setScreen(qscreen);
     else if (!screenConfig.display.isEmpty())
@@ -126,11 +135,26 @@ size_t WallWindow::getSurfaceIndex() const
     return _surfaceIndex;
 }
 
+std::weak_ptr<TexturePool> WallWindow::getTexturePool() const
+{
+    return _texturePool;
+}
+
 void WallWindow::setSwapSynchronizer(SwapSynchronizer* synchronizer)
 {
     _synchronizer = synchronizer;
 }
 
+void WallWindow::setFramePacer(FramePacer* pacer)
+{
+    _framePacer = pacer;
+}
+
+void WallWindow::setTelemetryCollector(TelemetryCollector* telemetry)
+{
+    _telemetry = telemetry;
+}
+
 bool WallWindow::isInitialized() const
 {
     return !!_quickRenderer;
@@ -143,6 +167,7 @@ bool WallWindow::needRedraw() const
 
 void WallWindow::render(const bool grab)
 {
+    TIDE_TRACE_SCOPE("render");
     _grabImage = grab;
 
     _renderControl->polishItems();
@@ -204,28 +229,91 @@ void WallWindow::_startQuickRenderer()
 
     connect(_quickRenderer.get(), &deflect::qt::QuickRenderer::afterRender,
             [this] {
+                if (_framePacer)
+                    _framePacer->endFrame(FramePacer::clock::now());
+
+                // Read the back buffer before it becomes undefined after swap
+                if (_grabImage)
+                {
+                    _startGrab();
+                    _grabImage = false;
+                }
+
                 if (_synchronizer)
+                {
+                    const auto start = TelemetryCollector::clock::now();
                     _synchronizer->globalBarrier(*this);
+                    if (_telemetry)
+                        _telemetry->addSwapWait(
+                            TelemetryCollector::clock::now() - start);
+                }
 
-                _quickRenderer->context()->swapBuffers(this);
-                _quickRenderer->context()->functions()->glFlush();
+                {
+                    TIDE_TRACE_SCOPE("swapBuffers");
+                    _quickRenderer->context()->swapBuffers(this);
+                    _quickRenderer->context()->functions()->glFlush();
+                }
+                if (_framePacer)
+                    _framePacer->addSwap(FramePacer::clock::now());
                 QMetaObject::invokeMethod(_surfaceRenderer.get(),
                                           "updateRenderedFrames",
                                           Qt::QueuedConnection);
-                if (_grabImage)
-                {
-                    emit imageGrabbed(_renderControl->grab(), _globalIndex);
-                    _grabImage = false;
-                }
             });
 
     connect(_quickRenderer.get(), &deflect::qt::QuickRenderer::stopping,
             [this] {
                 if (_synchronizer)
                     _synchronizer->exitBarrier(*this);
+
+                _quickRenderer->context()->makeCurrent(this);
+                _framebufferReader.reset();
+                _logTexturePoolStats();
+                _texturePool->clear();
             });
 }
 
+void WallWindow::_startGrab()
+{
+    if (!_framebufferReader)
+        _framebufferReader = std::make_unique<FramebufferReader>();
+
+    _framebufferReader->start(size() * devicePixelRatio());
+    _pollGrabbedImage();
+}
+
+void WallWindow::_pollGrabbedImage()
+{
+    if (!_framebufferReader || !_framebufferReader->isPending())
+        return;
+
+    if (_framebufferReader->isReady())
+    {
+        emit imageGrabbed(_framebufferReader->read(), _globalIndex);
+        return;
+    }
+
+    // Rendering may be idle, so poll from the render thread's event loop
+    QTimer::singleShot(1, _quickRenderer.get(), [this] {
+        _quickRenderer->context()->makeCurrent(this);
+        _pollGrabbedImage();
+    });
+}
+
+void WallWindow::_logTexturePoolStats() const
+{
+    const auto stats = _texturePool->getStats();
+    print_log(LOG_INFO, LOG_GENERAL,
+              "texture pool of window %d,%d - textures hits: %llu misses: %llu "
+              "evictions: %llu, PBOs hits: %llu misses: %llu evictions: %llu",
+              _globalIndex.x(), _globalIndex.y(),
+              (unsigned long long)stats.textures.hits,
+              (unsigned long long)stats.textures.misses,
+              (unsigned long long)stats.textures.evictions,
+              (unsigned long long)stats.pbos.hits,
+              (unsigned long long)stats.pbos.misses,
+              (unsigned long long)stats.pbos.evictions);
+}
+
 void WallWindow::_setupScene(const WallConfiguration& config,
                              const uint windowIndex)
 {
@@ -46,8 +46,10 @@
 
 #include <QQuickWindow>
 
+class FramebufferReader;
 class QQuickRenderControl;
 class QQmlEngine;
+class TexturePool;
 
 /**
  * An OpenGL window in which the Qml scene is rendered.
@@ -81,6 +83,12 @@ public:
     /** @return the index of the surface that the window belongs to. */
     size_t getSurfaceIndex() const;
 
+    /**
+     * @return the pool of unused textures of the window, only to be used from
+     *         the render thread.
+     */
+    std::weak_ptr<TexturePool> getTexturePool() const;
+
     /**
      * Set a swap synchronizer.
      *
@@ -88,6 +96,21 @@ public:
      */
     void setSwapSynchronizer(SwapSynchronizer* synchronizer);
 
+    /**
+     * Set a frame pacer.
+     *
+     * @param pacer to notify when frames are rendered and swapped (optional)
+     */
+    void setFramePacer(FramePacer* pacer);
+
+    /**
+     * Set a telemetry collector.
+     *
+     * @param telemetry to notify of the time spent in the swap barrier
+     *        (optional)
+     */
+    void setTelemetryCollector(TelemetryCollector* telemetry);
+
     bool isInitialized() const;
     bool needRedraw() const;
 
@@ -114,7 +137,10 @@ public:
     void setRenderOptions(OptionsPtr options);
 
 signals:
-    /** Emitted after syncAndRender() has been called with grab set to true. */
+    /**
+     * Emitted after render() has been called with grab set to true, once the
+     * image has been read back asynchronously. Emitted from the render thread.
+     */
     void imageGrabbed(QImage image, QPoint index);
 
 private:
@@ -126,6 +152,9 @@ private:
 
     void _startQuickRenderer();
     void _setupScene(const WallConfiguration& config, uint windowIndex);
+    void _startGrab();
+    void _pollGrabbedImage();
+    void _logTexturePoolStats() const;
 
     DataProvider& _provider;
 
@@ -134,7 +163,11 @@ private:
 
     std::unique_ptr<QQuickRenderControl> _renderControl;
     SwapSynchronizer* _synchronizer = nullptr;
+    FramePacer* _framePacer = nullptr;
+    TelemetryCollector* _telemetry = nullptr;
     bool _grabImage = false;
+    std::unique_ptr<FramebufferReader> _framebufferReader;
+    std::shared_ptr<TexturePool> _texturePool;
 
     std::unique_ptr<deflect::qt::QuickRenderer> _quickRenderer;
     std::unique_ptr<QThread> _quickRendererThread;
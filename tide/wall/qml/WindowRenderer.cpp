@@ -44,6 +44,7 @@
 #include "scene/Window.h"
 #include "synchronizers/ContentSynchronizer.h"
 #include "synchronizers/PixelStreamSynchronizer.h"
+#include "tools/RectangleSet.h"
 #include "utils/qml.h"
 
 namespace
@@ -87,14 +88,16 @@ WindowRenderer::~WindowRenderer()
     _tiles.clear();
 }
 
-void WindowRenderer::update(WindowPtr window, const QRectF& visibleArea)
+void WindowRenderer::update(WindowPtr window,
+                            const RectangleSet& visibleRegion)
 {
     if (window->getVersion() != _window->getVersion())
     {
         _windowContext->setContextProperty("window", window.get());
         _window = window;
     }
-    _synchronizer->update(*_window, visibleArea);
+    _synchronizer->setVisibleRegion(*_window, visibleRegion);
+    _synchronizer->update(*_window, visibleRegion.getBoundingRect());
 }
 
 QQuickItem* WindowRenderer::getQuickItem()
@@ -62,8 +62,12 @@ public:
     /** Destructor. */
     ~WindowRenderer();
 
-    /** Update the qml object with a new data model. */
-    void update(WindowPtr window, const QRectF& visibleArea);
+    /**
+     * Update the qml object with a new data model.
+     * @param window the new window model.
+     * @param visibleRegion the visible parts of the window.
+     */
+    void update(WindowPtr window, const RectangleSet& visibleRegion);
 
     /** Get the QML item. */
     QQuickItem* getQuickItem();
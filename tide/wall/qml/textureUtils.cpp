@@ -40,6 +40,8 @@
 #include "textureUtils.h"
 
 #include "data/Image.h"
+#include "tools/bc1.h"
+#include "utils/log.h"
 
 #include <QOpenGLBuffer>
 #include <QOpenGLContext>
@@ -47,7 +49,7 @@
 #include <QQuickWindow>
 #include <QSGTexture>
 
-#include <cstring> // std::memcpy
+#include <mutex>
 
 namespace textureUtils
 {
@@ -57,12 +59,22 @@ void upload(const Image& image, const uint srcTextureIdx, QOpenGLBuffer& pbo)
     const auto size = image.getDataSize(srcTextureIdx);
     if (size_t(pbo.size()) != size)
         pbo.allocate(size);
-    auto pboData = pbo.map(QOpenGLBuffer::WriteOnly);
-    std::memcpy(pboData, image.getData(srcTextureIdx), size);
+    auto pboData = static_cast<uint8_t*>(pbo.map(QOpenGLBuffer::WriteOnly));
+    image.writeData(srcTextureIdx, pboData);
     pbo.unmap();
     pbo.release();
 }
 
+void uploadCompressed(const Image& image, QOpenGLBuffer& pbo)
+{
+    pbo.bind();
+    const auto size = image.getCompressedDataSize();
+    if (size_t(pbo.size()) != size)
+        pbo.allocate(size);
+    pbo.write(0, image.getCompressedData(), size);
+    pbo.release();
+}
+
 GLint _getUnpackAlignment(const uint textureWidth)
 {
     if (textureWidth % 4 == 0)
@@ -72,7 +84,8 @@ GLint _getUnpackAlignment(const uint textureWidth)
     return 1;
 }
 
-void copy(QOpenGLBuffer& pbo, QSGTexture& texture, const uint glTexFormat)
+void copy(QOpenGLBuffer& pbo, QSGTexture& texture, const uint glTexFormat,
+          const bool generateMipmaps, const size_t offset)
 {
     auto gl = QOpenGLContext::currentContext()->functions();
 
@@ -84,9 +97,47 @@ void copy(QOpenGLBuffer& pbo, QSGTexture& texture, const uint glTexFormat)
     texture.bind();
     pbo.bind();
     gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureSize.width(),
-                        textureSize.height(), glTexFormat, GL_UNSIGNED_BYTE, 0);
+                        textureSize.height(), glTexFormat, GL_UNSIGNED_BYTE,
+                        reinterpret_cast<const void*>(offset));
+    pbo.release();
+    if (generateMipmaps)
+        gl->glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void copyCompressed(QOpenGLBuffer& pbo, QSGTexture& texture,
+                    const uint glFormat)
+{
+    auto gl = QOpenGLContext::currentContext()->functions();
+
+    auto width = texture.textureSize().width();
+    auto height = texture.textureSize().height();
+    const auto levelCount = bc1::getLevelCount(width, height);
+
+    texture.bind();
+    pbo.bind();
+    size_t offset = 0;
+    for (auto level = 0u; level < levelCount; ++level)
+    {
+        const auto size = bc1::getLevelSize(width, height);
+        gl->glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width,
+                                      height, glFormat, size,
+                                      reinterpret_cast<const void*>(offset));
+        offset += size;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
     pbo.release();
-    gl->glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+bool needMipmaps(const QSize& textureSize, const QSizeF& displaySize)
+{
+    if (displaySize.isEmpty())
+        return true;
+
+    // Largest minification for which linear filtering is good enough
+    const auto maxFactor = 1.25;
+    return textureSize.width() > displaySize.width() * maxFactor ||
+           textureSize.height() > displaySize.height() * maxFactor;
 }
 
 std::unique_ptr<QSGTexture> createTexture(const QSize& size,
@@ -126,6 +177,61 @@ std::unique_ptr<QSGTexture> createTextureRgba(const QSize& size,
         window.createTextureFromId(textureID, size, textureFlags)};
 }
 
+std::unique_ptr<QSGTexture> createCompressedTexture(const QSize& size,
+                                                    const uint glFormat,
+                                                    QQuickWindow& window)
+{
+    if (glFormat != bc1::glFormat)
+        throw std::invalid_argument("unsupported compressed texture format");
+
+    auto gl = QOpenGLContext::currentContext()->functions();
+
+    auto textureID = GLuint{0};
+    gl->glActiveTexture(GL_TEXTURE0);
+    gl->glGenTextures(1, &textureID);
+    gl->glBindTexture(GL_TEXTURE_2D, textureID);
+
+    // Compressed mipmaps can not be generated by the GPU, allocate them all
+    auto width = size.width();
+    auto height = size.height();
+    const auto levelCount = bc1::getLevelCount(width, height);
+    for (auto level = 0u; level < levelCount; ++level)
+    {
+        gl->glCompressedTexImage2D(GL_TEXTURE_2D, level, glFormat, width,
+                                   height, 0, bc1::getLevelSize(width, height),
+                                   nullptr);
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+
+    const auto textureFlags = QQuickWindow::CreateTextureOptions(
+        QQuickWindow::TextureOwnsGLTexture | QQuickWindow::TextureHasMipmaps);
+    return std::unique_ptr<QSGTexture>{
+        window.createTextureFromId(textureID, size, textureFlags)};
+}
+
+bool isCompressedFormatSupported(const uint glFormat)
+{
+    if (glFormat != bc1::glFormat)
+        return false;
+
+    const auto context = QOpenGLContext::currentContext();
+    const auto supported =
+        context->hasExtension("GL_EXT_texture_compression_s3tc") ||
+        context->hasExtension("GL_EXT_texture_compression_dxt1");
+    if (!supported)
+    {
+        static std::once_flag warning;
+        std::call_once(warning, [] {
+            print_log(LOG_WARN, LOG_GENERAL,
+                      "S3TC texture compression is not supported, tiles "
+                      "will be uploaded uncompressed");
+        });
+    }
+    return supported;
+}
+
 std::unique_ptr<QOpenGLBuffer> createPbo(const bool dynamic)
 {
     auto pbo =
@@ -70,6 +70,26 @@ std::unique_ptr<QSGTexture> createTexture(const QSize& size,
 std::unique_ptr<QSGTexture> createTextureRgba(const QSize& size,
                                               QQuickWindow& window);
 
+/**
+ * Create a texture for compressed data, with all its mipmap levels.
+ *
+ * @param size in pixels.
+ * @param glFormat the compressed format, currently only bc1::glFormat.
+ * @param window the QQuickWindow needed to create a QSGTexture wrapper.
+ * @return a QSGTexture owning its GL texture.
+ */
+std::unique_ptr<QSGTexture> createCompressedTexture(const QSize& size,
+                                                    uint glFormat,
+                                                    QQuickWindow& window);
+
+/**
+ * Check if the current OpenGL context supports a compressed texture format.
+ *
+ * @param glFormat the compressed format.
+ * @return true if textures of this format can be created.
+ */
+bool isCompressedFormatSupported(uint glFormat);
+
 /**
  * Create a Pixel Buffer Object.
  *
@@ -87,14 +107,44 @@ std::unique_ptr<QOpenGLBuffer> createPbo(bool dynamic);
  */
 void upload(const Image& image, const uint srcTextureIdx, QOpenGLBuffer& pbo);
 
+/**
+ * Upload the compressed data of an image to a PBO.
+ *
+ * @param image the source image, which must have compressed data.
+ * @param pbo the target PBO, will be resized to the compressed data size.
+ */
+void uploadCompressed(const Image& image, QOpenGLBuffer& pbo);
+
 /**
  * Copy a PBO to a GPU texture.
  *
  * @param pbo the source PBO.
  * @param texture the target texture, must be of the same size as the PBO.
  * @param glTexFormat the format of the OpenGL texture.
+ * @param generateMipmaps true to regenerate the mipmaps of the texture.
+ * @param offset of the texture data in the PBO [bytes].
+ */
+void copy(QOpenGLBuffer& pbo, QSGTexture& texture, uint glTexFormat,
+          bool generateMipmaps = true, size_t offset = 0);
+
+/**
+ * Copy a PBO with compressed data to a GPU texture.
+ *
+ * @param pbo the source PBO, with all the mipmap levels of the texture.
+ * @param texture the target texture, from createCompressedTexture().
+ * @param glFormat the compressed format of the texture.
+ */
+void copyCompressed(QOpenGLBuffer& pbo, QSGTexture& texture, uint glFormat);
+
+/**
+ * Check if a texture needs mipmaps to be displayed at a given size.
+ *
+ * @param textureSize the size of the texture in pixels.
+ * @param displaySize the size at which it is displayed in pixels.
+ * @return false if the texture is displayed at roughly 1:1 scale or magnified,
+ *         where sampling the mipmaps would not make a visible difference.
  */
-void copy(QOpenGLBuffer& pbo, QSGTexture& texture, uint glTexFormat);
+bool needMipmaps(const QSize& textureSize, const QSizeF& displaySize);
 }
 
 #endif
@@ -40,6 +40,7 @@
 #include "SwapSynchronizerHardware.h"
 
 #include "network/WallToWallChannel.h"
+#include "utils/trace.h"
 
 namespace
 {
@@ -64,6 +65,7 @@ void SwapSynchronizerHardware::globalBarrier(const QWindow& window)
     if (_initialized)
         return;
 
+    TIDE_TRACE_SCOPE("joinSwapGroup");
     _globalBarrier.waitForAll();
 
     _hardwareSwapGroup.add(window);
@@ -39,8 +39,11 @@
 
 #include "SwapSynchronizerSoftware.h"
 
+#include "utils/trace.h"
+
 void SwapSynchronizerSoftware::globalBarrier(const QWindow&)
 {
+    TIDE_TRACE_SCOPE("swapBarrier");
     waitForAll();
 }
 
@@ -55,6 +55,8 @@ BasicSynchronizer::BasicSynchronizer(DataSourceSharedPtr source,
 
 BasicSynchronizer::~BasicSynchronizer()
 {
+    if (_tileAdded)
+        _dataSource->unpinTile(0);
     _dataSource->synchronizers.deregister(this);
 }
 
@@ -128,6 +130,7 @@ void BasicSynchronizer::_createTile()
 
     _tileAdded = true;
     _addTile = false;
+    _dataSource->pinTile(0);
     emit addTile(Tile::create(0, QRect{QPoint(), getTilesArea(0)}), 0);
 }
 
@@ -70,6 +70,15 @@ public:
     /** Update the Content. */
     virtual void update(const Window& window, const QRectF& visibleArea) = 0;
 
+    /**
+     * Set the exact visible parts of the window, in window coordinates.
+     *
+     * Called before update(), which receives the bounding rectangle of the
+     * region as its visibleArea. Synchronizers can use it to skip the parts of
+     * the content which are covered by other windows.
+     */
+    virtual void setVisibleRegion(const Window&, const RectangleSet&) {}
+
     /**
      * Update the tiles.
      * Call addTile, updateTile and zoomContextTileChanged only in this method.
@@ -163,6 +172,9 @@ signals:
     /** Request an update of a specific tile. */
     void requestTileUpdate(TilePtr tile, deflect::View view);
 
+    /** Request to preload tiles which are likely to become visible soon. */
+    void requestTilesPrefetch(Indices tileIds, deflect::View view);
+
     /** Notify that the zoom context tile has changed and must be recreated. */
     void zoomContextTileChanged(bool visible);
 
@@ -43,8 +43,10 @@
 #include "qml/Tile.h"
 #include "scene/Window.h"
 #include "scene/ZoomHelper.h"
+#include "utils/stl.h"
 
 #include <QTextStream>
+#include <QTransform>
 
 LodSynchronizer::LodSynchronizer(DataSourceSharedPtr source)
     : TiledSynchronizer{TileSwapPolicy::SwapTilesIndependently}
@@ -58,6 +60,8 @@ LodSynchronizer::LodSynchronizer(DataSourceSharedPtr source)
 
 LodSynchronizer::~LodSynchronizer()
 {
+    for (auto i : getVisibleTiles())
+        _source->unpinTile(i);
     _source->synchronizers.deregister(this);
 }
 
@@ -75,6 +79,13 @@ void LodSynchronizer::updateTiles()
         _zoomContextTileDirty = false;
         emit zoomContextTileChanged(getZoomContextVisible());
     }
+
+    if (!_prefetchRequests.empty())
+    {
+        emit requestTilesPrefetch(_prefetchRequests, getView());
+        _prefetchRequests.clear();
+        emit statisticsChanged();
+    }
 }
 
 QString LodSynchronizer::getStatistics() const
@@ -84,6 +95,12 @@ QString LodSynchronizer::getStatistics() const
     stream << "LOD:  " << getLod() << "/" << getLodCount() - 1;
     const auto area = getTilesArea(getLod());
     stream << "  res: " << area.width() << "x" << area.height();
+    const auto prefetch = getDataSource().getPrefetchStats();
+    if (prefetch.loaded > 0)
+    {
+        stream << "  prefetch hits: " << prefetch.hits << "/"
+               << prefetch.loaded;
+    }
     return stats;
 }
 
@@ -106,6 +123,8 @@ uint LodSynchronizer::getLodCount() const
 void LodSynchronizer::update(const Window& window, const QRectF& visibleArea,
                              const bool forceUpdate)
 {
+    _updatePrefetch(window, visibleArea);
+
     const auto lod = _findCurrentLod(window);
     const auto tilesArea = _computeVisibleTilesArea(window, visibleArea, lod);
 
@@ -183,3 +202,37 @@ uint LodSynchronizer::_findLod(const QSize& targetDisplaySize) const
     }
     return lod;
 }
+
+void LodSynchronizer::_updatePrefetch(const Window& window,
+                                      const QRectF& visibleArea)
+{
+    const auto zoomHelper = ZoomHelper{window};
+    const auto area = zoomHelper.toTilesArea(visibleArea, QSize{1, 1});
+    const auto displaySize = zoomHelper.getContentRect().size();
+    _predictor.addSample({area, displaySize}, ViewportPredictor::clock::now());
+
+    if (!_predictor.isMoving())
+    {
+        _prefetchSet.clear();
+        return;
+    }
+
+    const auto predicted = _predictor.predict();
+    const auto lod = _findLod(predicted.displaySize.toSize());
+    const auto tilesSurface = _getTilesArea(lod);
+    const auto predictedTilesArea =
+        QTransform::fromScale(tilesSurface.width(), tilesSurface.height())
+            .mapRect(predicted.area);
+
+    const auto& source = getDataSource();
+    const auto prefetchSet =
+        source.computeVisibleSet(predictedTilesArea, lod, getChannel());
+    const auto visibleSet = source.computeVisibleSet(
+        _computeVisibleTilesArea(window, visibleArea, lod), lod, getChannel());
+
+    // Only request the tiles which were not already predicted last frame
+    const auto newTiles =
+        set_difference(set_difference(prefetchSet, visibleSet), _prefetchSet);
+    _prefetchRequests.insert(newTiles.begin(), newTiles.end());
+    _prefetchSet = prefetchSet;
+}
@@ -42,8 +42,13 @@
 
 #include "TiledSynchronizer.h"
 
+#include "tools/ViewportPredictor.h"
+
 /**
  * Base synchronizer for tiled contents with multiple levels of detail.
+ *
+ * While the user pans or zooms, the tiles of the area predicted to become
+ * visible shortly are prefetched into the data source cache.
  */
 class LodSynchronizer : public TiledSynchronizer
 {
@@ -97,11 +102,16 @@ private:
                                     const uint lod) const;
     uint _findCurrentLod(const Window& window) const;
     uint _findLod(const QSize& targetDisplaySize) const;
+    void _updatePrefetch(const Window& window, const QRectF& visibleArea);
 
     DataSourceSharedPtr _source;
     bool _zoomContextTileDirty = true;
     uint _lod = 0;
     std::vector<QRectF> _visibleTilesArea{{QRectF()}};
+
+    ViewportPredictor _predictor;
+    Indices _prefetchSet;
+    Indices _prefetchRequests;
 };
 
 #endif
@@ -48,6 +48,18 @@ TiledSynchronizer::TiledSynchronizer(const TileSwapPolicy policy)
 {
 }
 
+void TiledSynchronizer::setVisibleRegion(const Window& window,
+                                         const RectangleSet& visibleRegion)
+{
+    Q_UNUSED(window);
+
+    if (visibleRegion == _visibleRegion)
+        return;
+
+    _visibleRegion = visibleRegion;
+    markTilesDirty();
+}
+
 void TiledSynchronizer::onSwapReady(TilePtr tile)
 {
     if (_policy == SwapTilesSynchronously &&
@@ -145,8 +157,20 @@ Indices TiledSynchronizer::_computeVisibleTilesAndAddMissingOnes()
 
 Indices TiledSynchronizer::_computeVisibleTiles(const uint lod) const
 {
-    return getDataSource().computeVisibleSet(getVisibleTilesArea(lod), lod,
-                                             getChannel());
+    const auto tilesArea = getVisibleTilesArea(lod);
+    auto tiles =
+        getDataSource().computeVisibleSet(tilesArea, lod, getChannel());
+    if (_visibleRegion.isEmpty() || tilesArea.isEmpty())
+        return tiles;
+
+    for (auto it = tiles.begin(); it != tiles.end();)
+    {
+        if (_isInVisibleRegion(getDataSource().getTileRect(*it), tilesArea))
+            ++it;
+        else
+            it = tiles.erase(it);
+    }
+    return tiles;
 }
 
 void TiledSynchronizer::_addTiles(const Indices& tiles, const uint lod)
@@ -155,7 +179,10 @@ void TiledSynchronizer::_addTiles(const Indices& tiles, const uint lod)
     const auto type = _getTextureType();
     const auto zOrder = getLodCount() - lod - 1;
     for (auto i : tiles)
+    {
+        source.pinTile(i);
         emit addTile(Tile::create(i, source.getTileRect(i), type), zOrder);
+    }
 }
 
 void TiledSynchronizer::_updateTiles(const Indices& tiles)
@@ -167,7 +194,10 @@ void TiledSynchronizer::_updateTiles(const Indices& tiles)
 void TiledSynchronizer::_removeTiles(const Indices& tiles)
 {
     for (auto i : tiles)
+    {
+        getDataSource().unpinTile(i);
         _removeTile(i);
+    }
 }
 
 void TiledSynchronizer::_removeTile(const size_t tileIndex)
@@ -183,3 +213,18 @@ TextureType TiledSynchronizer::_getTextureType() const
     return getDataSource().isDynamic() ? TextureType::dynamic
                                        : TextureType::static_;
 }
+
+bool TiledSynchronizer::_isInVisibleRegion(const QRect& tile,
+                                           const QRectF& tilesArea) const
+{
+    // The visible tiles area is the bounding rectangle of the visible region
+    // mapped to tiles space, which gives the inverse mapping for the tiles.
+    const auto windowArea = _visibleRegion.getBoundingRect();
+    const auto xScale = windowArea.width() / tilesArea.width();
+    const auto yScale = windowArea.height() / tilesArea.height();
+    const auto tileWindowArea =
+        QRectF{windowArea.x() + (tile.x() - tilesArea.x()) * xScale,
+               windowArea.y() + (tile.y() - tilesArea.y()) * yScale,
+               tile.width() * xScale, tile.height() * yScale};
+    return _visibleRegion.intersects(tileWindowArea);
+}
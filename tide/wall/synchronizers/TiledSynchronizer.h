@@ -41,6 +41,7 @@
 #define TILEDSYNCHRONIZER_H
 
 #include "synchronizers/ContentSynchronizer.h"
+#include "tools/RectangleSet.h"
 
 /**
  * A base synchronizer used for tiled content types with optional LOD.
@@ -60,6 +61,14 @@ public:
     /** Constructor */
     explicit TiledSynchronizer(TileSwapPolicy policy);
 
+    /**
+     * Skip the tiles of the visible tiles area which do not overlap with the
+     * visible region, i.e. which are covered by other windows.
+     * @copydoc ContentSynchronizer::setVisibleRegion
+     */
+    void setVisibleRegion(const Window& window,
+                          const RectangleSet& visibleRegion) override;
+
     /** @copydoc ContentSynchronizer::updateTiles */
     void updateTiles() override;
 
@@ -91,6 +100,8 @@ protected:
 
     /** @return the channel used to obtain the list of visible tiles. */
     virtual uint getChannel() const { return 0; }
+    /** @return the tiles currently visible, pinned in the data source. */
+    const Indices& getVisibleTiles() const { return _visibleSet; }
 private:
     /** @return the area to obtain the visible tiles from the data source. */
     virtual QRectF getVisibleTilesArea(uint lod) const = 0;
@@ -102,6 +113,7 @@ private:
     void _removeTiles(const Indices& tiles);
     void _removeTile(size_t tileIndex);
     TextureType _getTextureType() const;
+    bool _isInVisibleRegion(const QRect& tile, const QRectF& tilesArea) const;
 
     TileSwapPolicy _policy;
 
@@ -113,6 +125,8 @@ private:
     Indices _syncSet;
     Indices _removeLaterSet;
 
+    RectangleSet _visibleRegion;
+
     bool _tilesDirty = true;
     bool _updateExistingTiles = false;
 };
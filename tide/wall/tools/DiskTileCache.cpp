@@ -0,0 +1,336 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "DiskTileCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+const char magic[8] = {'T', 'I', 'D', 'E', 'T', 'I', 'L', '1'};
+const char* fileExtension = ".tile";
+const size_t dataAlignment = 64;
+
+// Cleanup deletes files until the cache is below this fraction of its budget
+const double cleanupTarget = 0.9;
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytesPerLine;
+    uint32_t format;
+    uint64_t keySize;
+};
+
+size_t _getDataOffset(const size_t keySize)
+{
+    const auto size = sizeof(FileHeader) + keySize;
+    return (size + dataAlignment - 1) / dataAlignment * dataAlignment;
+}
+
+uint64_t _fnv1a(const std::string& key)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto c : key)
+    {
+        hash ^= uint8_t(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool _endsWith(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void _makePath(const std::string& path)
+{
+    for (auto pos = path.find('/', 1); pos != std::string::npos;
+         pos = path.find('/', pos + 1))
+    {
+        ::mkdir(path.substr(0, pos).c_str(), 0777);
+    }
+    if (::mkdir(path.c_str(), 0777) != 0 && errno != EEXIST)
+        throw std::runtime_error("could not create tile cache directory: " +
+                                 path + " (" + std::strerror(errno) + ")");
+}
+
+bool _writeAll(const int fd, const void* data, size_t size)
+{
+    auto ptr = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        const auto written = ::write(fd, ptr, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        ptr += written;
+        size -= size_t(written);
+    }
+    return true;
+}
+
+struct FileEntry
+{
+    std::string path;
+    uint64_t size;
+    struct timespec lastUse;
+};
+
+bool _isOlder(const FileEntry& a, const FileEntry& b)
+{
+    if (a.lastUse.tv_sec != b.lastUse.tv_sec)
+        return a.lastUse.tv_sec < b.lastUse.tv_sec;
+    return a.lastUse.tv_nsec < b.lastUse.tv_nsec;
+}
+
+std::vector<FileEntry> _listFiles(const std::string& directory)
+{
+    std::vector<FileEntry> files;
+    auto dir = ::opendir(directory.c_str());
+    if (!dir)
+        return files;
+
+    while (const auto entry = ::readdir(dir))
+    {
+        const auto name = std::string{entry->d_name};
+        if (!_endsWith(name, fileExtension))
+            continue;
+
+        const auto path = directory + "/" + name;
+        struct stat info;
+        if (::stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+            files.push_back({path, uint64_t(info.st_size), info.st_mtim});
+    }
+    ::closedir(dir);
+    return files;
+}
+}
+
+DiskTileCache::Raster::Raster(void* mapping, const size_t mappingSize,
+                              const RasterInfo& info, const size_t dataOffset)
+    : _mapping{mapping}
+    , _mappingSize{mappingSize}
+    , _info(info)
+    , _data{static_cast<const uint8_t*>(mapping) + dataOffset}
+{
+}
+
+DiskTileCache::Raster::~Raster()
+{
+    ::munmap(_mapping, _mappingSize);
+}
+
+DiskTileCache::DiskTileCache(const std::string& directory,
+                             const uint64_t maxSize)
+    : _directory{directory}
+    , _maxSize{maxSize}
+{
+    _makePath(_directory);
+    cleanup();
+}
+
+DiskTileCache::RasterPtr DiskTileCache::load(const std::string& key)
+{
+    const auto filename = _getFilename(key);
+    const auto miss = [this] {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        ++_stats.misses;
+        return RasterPtr();
+    };
+
+    const auto fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return miss();
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(FileHeader))
+    {
+        ::close(fd);
+        return miss();
+    }
+
+    const auto size = size_t(info.st_size);
+    const auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return miss();
+
+    // Validate the file, which may be corrupt or be a hash collision
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const auto offset = _getDataOffset(header.keySize);
+    const auto dataSize = uint64_t(header.bytesPerLine) * header.height;
+    const auto keyData = static_cast<const char*>(mapping) + sizeof(header);
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+        header.keySize != key.size() || offset + dataSize != size ||
+        key.compare(0, key.size(), keyData, header.keySize) != 0)
+    {
+        ::munmap(mapping, size);
+        return miss();
+    }
+
+    // Update the modification time which serves as LRU timestamp
+    ::utimensat(AT_FDCWD, filename.c_str(), nullptr, 0);
+
+    const auto rasterInfo = RasterInfo{header.width, header.height,
+                                       header.bytesPerLine, header.format};
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        ++_stats.hits;
+    }
+    return RasterPtr{new Raster{mapping, size, rasterInfo, offset}};
+}
+
+bool DiskTileCache::store(const std::string& key, const RasterInfo& info,
+                          const void* data)
+{
+    FileHeader header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.width = info.width;
+    header.height = info.height;
+    header.bytesPerLine = info.bytesPerLine;
+    header.format = info.format;
+    header.keySize = key.size();
+
+    const auto offset = _getDataOffset(key.size());
+    const auto dataSize = size_t(info.bytesPerLine) * info.height;
+    const auto paddingSize = offset - sizeof(header) - key.size();
+    const auto padding = std::vector<char>(paddingSize, 0);
+
+    const auto filename = _getFilename(key);
+    std::string tmpFilename;
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        tmpFilename = filename + "." + std::to_string(::getpid()) + "." +
+                      std::to_string(_tmpCounter++) + ".tmp";
+    }
+
+    const auto fd =
+        ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if (fd < 0)
+        return false;
+
+    const auto written = _writeAll(fd, &header, sizeof(header)) &&
+                         _writeAll(fd, key.data(), key.size()) &&
+                         _writeAll(fd, padding.data(), padding.size()) &&
+                         _writeAll(fd, data, dataSize);
+    ::close(fd);
+
+    // Atomic replace, concurrent readers keep their own mapping
+    if (!written || ::rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        ::unlink(tmpFilename.c_str());
+        return false;
+    }
+
+    const std::lock_guard<std::mutex> lock{_mutex};
+    ++_stats.writes;
+    _size += offset + dataSize;
+    if (_size > _maxSize)
+        _cleanup();
+    return true;
+}
+
+void DiskTileCache::cleanup()
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    _cleanup();
+}
+
+uint64_t DiskTileCache::getSize() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _size;
+}
+
+DiskTileCache::Stats DiskTileCache::getStats() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _stats;
+}
+
+std::string DiskTileCache::_getFilename(const std::string& key) const
+{
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx",
+                  (unsigned long long)_fnv1a(key));
+    return _directory + "/" + name + fileExtension;
+}
+
+void DiskTileCache::_cleanup()
+{
+    // Rescan the directory, which may be shared with other processes
+    auto files = _listFiles(_directory);
+    _size = 0;
+    for (const auto& file : files)
+        _size += file.size;
+
+    if (_size <= _maxSize)
+        return;
+
+    std::sort(files.begin(), files.end(), _isOlder);
+    const auto target = uint64_t(_maxSize * cleanupTarget);
+    for (const auto& file : files)
+    {
+        if (_size <= target)
+            break;
+        if (::unlink(file.path.c_str()) == 0)
+            ++_stats.evictions;
+        _size -= file.size;
+    }
+}
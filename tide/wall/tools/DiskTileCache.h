@@ -0,0 +1,146 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef DISKTILECACHE_H
+#define DISKTILECACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Persistent, content-addressed cache of raster tiles on disk.
+ *
+ * Each tile is stored in its own file, named after a hash of its key (which
+ * should identify the content and its version, e.g. uri + modification time +
+ * lod + tile id + size). Tiles are mapped read-only in memory when loaded.
+ *
+ * Files are written under a temporary name and atomically renamed, so that
+ * multiple processes of the same host can share the directory safely. When the
+ * total size exceeds the budget, the least recently used files are deleted.
+ * All methods are threadsafe.
+ */
+class DiskTileCache
+{
+public:
+    /** Description of the pixels of a raster. */
+    struct RasterInfo
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t bytesPerLine = 0;
+        uint32_t format = 0; // opaque to the cache, e.g. a QImage::Format
+    };
+
+    /** A raster mapped read-only from a cache file. */
+    class Raster
+    {
+    public:
+        ~Raster();
+
+        const RasterInfo& getInfo() const { return _info; }
+        const uint8_t* getData() const { return _data; }
+    private:
+        friend class DiskTileCache;
+        Raster(void* mapping, size_t mappingSize, const RasterInfo& info,
+               size_t dataOffset);
+
+        void* _mapping;
+        size_t _mappingSize;
+        RasterInfo _info;
+        const uint8_t* _data;
+    };
+    using RasterPtr = std::shared_ptr<const Raster>;
+
+    /** Statistics of the cache for this process. */
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t writes = 0;
+        uint64_t evictions = 0;
+    };
+
+    /**
+     * Open or create a cache.
+     * @param directory where to store the tiles, created if needed.
+     * @param maxSize the maximum size of the files in the directory [bytes].
+     * @throw std::runtime_error if the directory can not be created.
+     */
+    DiskTileCache(const std::string& directory, uint64_t maxSize);
+
+    /** @return the raster stored for the key, or nullptr if not found. */
+    RasterPtr load(const std::string& key);
+
+    /**
+     * Store a raster.
+     * @param key identifying the raster.
+     * @param info the description of the pixels.
+     * @param data the pixels, info.bytesPerLine * info.height bytes.
+     * @return false if the raster could not be written.
+     */
+    bool store(const std::string& key, const RasterInfo& info,
+               const void* data);
+
+    /** Delete the least recently used files until the size is in budget. */
+    void cleanup();
+
+    /** @return the directory of the cache. */
+    const std::string& getDirectory() const { return _directory; }
+    /** @return the size of the files in the cache, as last seen [bytes]. */
+    uint64_t getSize() const;
+
+    /** @return the statistics of the cache for this process. */
+    Stats getStats() const;
+
+private:
+    const std::string _directory;
+    const uint64_t _maxSize;
+
+    mutable std::mutex _mutex;
+    uint64_t _size = 0;
+    uint64_t _tmpCounter = 0;
+    Stats _stats;
+
+    std::string _getFilename(const std::string& key) const;
+    void _cleanup();
+};
+
+#endif
@@ -0,0 +1,224 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "FramePacer.h"
+
+#include <algorithm>
+
+namespace
+{
+const size_t warmupSwaps = 8; // to measure the refresh interval
+const size_t frameHistory = 32;
+const auto maxWarmupInterval = std::chrono::milliseconds{100};
+const int maxRefreshGap = 4; // longer gaps are pauses of the rendering
+const int intervalSmoothing = 16;
+const int phaseSmoothing = 4;
+}
+
+FramePacer::FramePacer(const Settings& settings)
+    : _settings(settings)
+    , _interval(settings.refreshInterval)
+{
+}
+
+FramePacer::clock::time_point FramePacer::getNextFrameStart(
+    const time_point now)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_hasVsync || _interval == duration::zero())
+    {
+        _hasPlan = false;
+        return now;
+    }
+
+    const auto lead = _getFrameDuration() + _settings.safetyMargin;
+    auto earliest = now + lead;
+    // Never target the deadline of the previous frame again
+    if (_hasDeadline)
+        earliest = std::max(earliest, _deadline + _interval / 2);
+
+    _plannedDeadline = _getDeadline(earliest);
+    _hasPlan = true;
+    return _plannedDeadline - lead;
+}
+
+void FramePacer::beginFrame(const time_point time)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    _inFrame = true;
+    _frameStart = time;
+
+    if (_hasPlan)
+    {
+        _deadline = _plannedDeadline;
+        _hasDeadline = true;
+        _hasPlan = false;
+    }
+    else if (_hasVsync && _interval > duration::zero())
+    {
+        auto earliest = time + _getFrameDuration();
+        if (_hasDeadline)
+            earliest = std::max(earliest, _deadline + _interval / 2);
+        _deadline = _getDeadline(earliest);
+        _hasDeadline = true;
+    }
+    else
+        _hasDeadline = false;
+}
+
+void FramePacer::endFrame(const time_point time)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_inFrame)
+        return;
+    _inFrame = false;
+
+    const auto frameDuration = time - _frameStart;
+    if (_frameDurations.size() < frameHistory)
+        _frameDurations.push_back(frameDuration);
+    else
+        _frameDurations[_nextFrameDuration] = frameDuration;
+    _nextFrameDuration = (_nextFrameDuration + 1) % frameHistory;
+
+    if (!_hasDeadline)
+        return;
+
+    const auto slack = _deadline - time;
+    _stats.minSlack =
+        _stats.frames == 0 ? slack : std::min(_stats.minSlack, slack);
+    _stats.lastSlack = slack;
+    _stats.totalSlack += slack;
+    ++_stats.frames;
+    if (slack < duration::zero())
+        ++_stats.missedDeadlines;
+}
+
+void FramePacer::addSwap(const time_point time)
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!_hasVsync)
+    {
+        _hasVsync = true;
+        _vsync = time;
+        _lastSwap = time;
+        return;
+    }
+
+    const auto delta = time - _lastSwap;
+    _lastSwap = time;
+
+    if (_settings.refreshInterval == duration::zero())
+        _updateInterval(delta);
+
+    if (_interval == duration::zero() || delta >= maxRefreshGap * _interval)
+    {
+        _vsync = time;
+        return;
+    }
+
+    // Swaps return with some jitter, smooth the phase of the refresh
+    const auto expected = _getDeadline(time - _interval / 2);
+    _vsync = expected + (time - expected) / phaseSmoothing;
+}
+
+FramePacer::clock::duration FramePacer::getRefreshInterval() const
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _interval;
+}
+
+FramePacer::clock::duration FramePacer::getFrameDuration() const
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _getFrameDuration();
+}
+
+FramePacer::Stats FramePacer::getStats() const
+{
+    const std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void FramePacer::_updateInterval(const duration delta)
+{
+    // The median of the first intervals is robust to a few missed frames
+    if (_warmupIntervals.size() < warmupSwaps)
+    {
+        if (delta > duration::zero() && delta < maxWarmupInterval)
+            _warmupIntervals.push_back(delta);
+        if (_warmupIntervals.size() == warmupSwaps)
+        {
+            auto median = _warmupIntervals.begin() + warmupSwaps / 2;
+            std::nth_element(_warmupIntervals.begin(), median,
+                             _warmupIntervals.end());
+            _interval = *median;
+        }
+        return;
+    }
+
+    if (delta >= maxRefreshGap * _interval)
+        return;
+
+    // Missed frames count as several refresh intervals
+    const auto periods =
+        std::max<duration::rep>(1, (delta + _interval / 2) / _interval);
+    const auto sample = delta / periods;
+    _interval += (sample - _interval) / intervalSmoothing;
+}
+
+FramePacer::clock::duration FramePacer::_getFrameDuration() const
+{
+    if (_frameDurations.empty())
+        return duration::zero();
+    return *std::max_element(_frameDurations.begin(), _frameDurations.end());
+}
+
+FramePacer::clock::time_point FramePacer::_getDeadline(
+    const time_point earliest) const
+{
+    if (earliest <= _vsync)
+        return _vsync;
+    const auto periods = (earliest - _vsync + _interval - duration{1}) /
+                         _interval;
+    return _vsync + periods * _interval;
+}
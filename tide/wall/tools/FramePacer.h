@@ -0,0 +1,154 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * Align the start of the frames with the refresh of the displays.
+ *
+ * The refresh interval and phase of the displays are estimated from the times
+ * at which swapBuffers() returns, from which the deadline of the next swap is
+ * predicted. Each frame is started as late as possible for this deadline:
+ * the expected duration of the frame (the longest of the recent frames) plus
+ * a safety margin before it. This way the frames are synchronized with the
+ * freshest scene and data source state and presented with a stable latency,
+ * instead of jittering between one and two refresh intervals.
+ *
+ * The slack of each frame, i.e. how much time was left before the deadline
+ * when the frame was ready to be swapped, is recorded in the statistics.
+ *
+ * Times are given by the caller, which allows testing with a simulated clock.
+ * All methods are threadsafe (frames are started from the main thread and
+ * swapped from the render thread).
+ */
+class FramePacer
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /** Pacing parameters. */
+    struct Settings
+    {
+        /** Refresh interval of the displays, 0 to measure it from swaps. */
+        clock::duration refreshInterval{0};
+
+        /** Time kept free before the deadline in addition to frame time. */
+        clock::duration safetyMargin = std::chrono::milliseconds{2};
+    };
+
+    /** Statistics of the paced frames. */
+    struct Stats
+    {
+        uint64_t frames = 0;          // frames with a predicted deadline
+        uint64_t missedDeadlines = 0; // frames ready after their deadline
+        clock::duration lastSlack{0}; // negative if the deadline was missed
+        clock::duration minSlack{0};
+        clock::duration totalSlack{0};
+    };
+
+    /** Constructor. */
+    explicit FramePacer(const Settings& settings);
+
+    /**
+     * Get the time at which to start the next frame.
+     *
+     * @param now the current time.
+     * @return the start time for the next swap deadline, or now if the
+     *         refresh of the displays is not known yet.
+     */
+    clock::time_point getNextFrameStart(clock::time_point now);
+
+    /** Mark the start of a frame (scene and data sources synchronization). */
+    void beginFrame(clock::time_point time);
+
+    /** Mark a frame as rendered and ready to be swapped. */
+    void endFrame(clock::time_point time);
+
+    /** Add the time at which swapBuffers() returned. */
+    void addSwap(clock::time_point time);
+
+    /** @return the estimated refresh interval, 0 if not known yet. */
+    clock::duration getRefreshInterval() const;
+
+    /** @return the expected duration of a frame. */
+    clock::duration getFrameDuration() const;
+
+    /** @return the statistics of the paced frames. */
+    Stats getStats() const;
+
+private:
+    using duration = clock::duration;
+    using time_point = clock::time_point;
+
+    const Settings _settings;
+    mutable std::mutex _mutex;
+
+    // Refresh of the displays
+    duration _interval{0};
+    std::vector<duration> _warmupIntervals;
+    bool _hasVsync = false;
+    time_point _vsync; // smoothed time of the last swap
+    time_point _lastSwap;
+
+    // Current frame
+    bool _inFrame = false;
+    time_point _frameStart;
+    time_point _deadline; // of the current frame, if _hasDeadline
+    bool _hasDeadline = false;
+    time_point _plannedDeadline; // of the next frame, if _hasPlan
+    bool _hasPlan = false;
+
+    // Duration of the recent frames
+    std::vector<duration> _frameDurations;
+    size_t _nextFrameDuration = 0;
+
+    Stats _stats;
+
+    void _updateInterval(duration delta);
+    duration _getFrameDuration() const;
+    time_point _getDeadline(time_point earliest) const;
+};
+
+#endif
@@ -236,6 +236,7 @@ void PixelStreamChannelAssembler::_decodeSourceTiles(
     for (auto i : indices)
     {
         auto& tile = _frame->tiles.at(i);
+        checkImageData(tile);
 
         if (tile.format == deflect::Format::jpeg)
 #ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
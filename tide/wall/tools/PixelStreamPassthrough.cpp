@@ -53,6 +53,7 @@ ImagePtr PixelStreamPassthrough::getTileImage(
     const uint tileIndex, deflect::server::TileDecoder& decoder)
 {
     auto& tile = _frame->tiles.at(tileIndex);
+    checkImageData(tile);
     if (tile.format == deflect::Format::jpeg)
     {
 #ifndef DEFLECT_USE_LEGACY_LIBJPEGTURBO
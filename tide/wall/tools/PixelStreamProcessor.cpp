@@ -41,6 +41,8 @@
 
 #include <deflect/server/Tile.h>
 
+#include <stdexcept>
+
 PixelStreamProcessor::~PixelStreamProcessor()
 {
 }
@@ -49,3 +51,11 @@ QRect PixelStreamProcessor::toRect(const deflect::server::Tile& tile) const
 {
     return QRect(tile.x, tile.y, tile.width, tile.height);
 }
+
+void PixelStreamProcessor::checkImageData(
+    const deflect::server::Tile& tile) const
+{
+    // The master only sends to each process the tiles that it displays
+    if (tile.imageData.isEmpty())
+        throw std::runtime_error("Tile image data not sent to this process");
+}
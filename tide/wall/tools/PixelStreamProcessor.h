@@ -75,6 +75,12 @@ public:
 protected:
     /** @return the coordinates of the tile as a QRect. */
     QRect toRect(const deflect::server::Tile& tile) const;
+
+    /**
+     * Check that the image data of a tile was received by this process.
+     * @throw std::runtime_error if the tile was sent without its image data.
+     */
+    void checkImageData(const deflect::server::Tile& tile) const;
 };
 
 #endif
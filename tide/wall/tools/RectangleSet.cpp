@@ -0,0 +1,345 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "RectangleSet.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+template <typename Spans>
+Spans _unite(const Spans& a, const Spans& b)
+{
+    auto result = Spans();
+    result.reserve(a.size() + b.size());
+
+    auto itA = a.begin();
+    auto itB = b.begin();
+    while (itA != a.end() || itB != b.end())
+    {
+        const auto takeA =
+            itB == b.end() || (itA != a.end() && itA->left < itB->left);
+        const auto& span = takeA ? *itA++ : *itB++;
+
+        // Merge overlapping and adjacent spans
+        if (!result.empty() && span.left <= result.back().right)
+            result.back().right = std::max(result.back().right, span.right);
+        else
+            result.push_back(span);
+    }
+    return result;
+}
+
+template <typename Spans>
+Spans _subtract(const Spans& a, const Spans& b)
+{
+    auto result = Spans();
+    result.reserve(a.size() + b.size());
+
+    auto itB = b.begin();
+    for (auto span : a)
+    {
+        // Skip the spans of b entirely on the left of this span
+        while (itB != b.end() && itB->right <= span.left)
+            ++itB;
+
+        for (auto it = itB; it != b.end() && it->left < span.right; ++it)
+        {
+            if (it->left > span.left)
+                result.push_back({span.left, it->left});
+            span.left = std::max(span.left, it->right);
+        }
+        if (span.left < span.right)
+            result.push_back(span);
+    }
+    return result;
+}
+
+/** @return the range of bands which overlap [top; bottom[ vertically. */
+template <typename It>
+std::pair<It, It> _findBands(const It begin, const It end, const qreal top,
+                             const qreal bottom)
+{
+    using Band = typename std::iterator_traits<It>::value_type;
+    const auto first =
+        std::upper_bound(begin, end, top, [](const qreal y, const Band& b) {
+            return y < b.bottom;
+        });
+    const auto last =
+        std::lower_bound(first, end, bottom, [](const Band& b, const qreal y) {
+            return b.top < y;
+        });
+    return {first, last};
+}
+
+/** Append a band, coalescing it with the previous one if they match. */
+template <typename Bands, typename Spans>
+void _appendBand(Bands& bands, const qreal top, const qreal bottom,
+                 Spans&& spans)
+{
+    if (spans.empty())
+        return;
+
+    if (!bands.empty() && bands.back().bottom == top &&
+        bands.back().spans == spans)
+    {
+        bands.back().bottom = bottom;
+        return;
+    }
+    bands.push_back({top, bottom, std::move(spans)});
+}
+}
+
+bool RectangleSet::Span::operator==(const Span& other) const
+{
+    return left == other.left && right == other.right;
+}
+
+RectangleSet::RectangleSet(const QRectF& rect)
+{
+    if (!rect.isEmpty())
+        _bands.push_back({rect.top(), rect.bottom(),
+                          Spans{{rect.left(), rect.right()}}});
+}
+
+bool RectangleSet::isEmpty() const
+{
+    return _bands.empty();
+}
+
+qreal RectangleSet::getArea() const
+{
+    auto area = qreal(0);
+    for (const auto& band : _bands)
+    {
+        for (const auto& span : band.spans)
+            area += (span.right - span.left) * (band.bottom - band.top);
+    }
+    return area;
+}
+
+QRectF RectangleSet::getBoundingRect() const
+{
+    if (_bands.empty())
+        return QRectF();
+
+    auto left = _bands.front().spans.front().left;
+    auto right = _bands.front().spans.back().right;
+    for (const auto& band : _bands)
+    {
+        left = std::min(left, band.spans.front().left);
+        right = std::max(right, band.spans.back().right);
+    }
+    return QRectF{QPointF{left, _bands.front().top},
+                  QPointF{right, _bands.back().bottom}};
+}
+
+std::vector<QRectF> RectangleSet::getRects() const
+{
+    auto rects = std::vector<QRectF>();
+    for (const auto& band : _bands)
+    {
+        for (const auto& span : band.spans)
+            rects.emplace_back(QPointF{span.left, band.top},
+                               QPointF{span.right, band.bottom});
+    }
+    return rects;
+}
+
+bool RectangleSet::intersects(const QRectF& rect) const
+{
+    if (rect.isEmpty())
+        return false;
+
+    // First band which ends below the top of the rectangle
+    auto band = std::upper_bound(_bands.begin(), _bands.end(), rect.top(),
+                                 [](const qreal y, const Band& b) {
+                                     return y < b.bottom;
+                                 });
+    for (; band != _bands.end() && band->top < rect.bottom(); ++band)
+    {
+        for (const auto& span : band->spans)
+        {
+            if (span.left >= rect.right())
+                break;
+            if (span.right > rect.left())
+                return true;
+        }
+    }
+    return false;
+}
+
+RectangleSet RectangleSet::united(const RectangleSet& other) const
+{
+    auto set = *this;
+    set |= other;
+    return set;
+}
+
+RectangleSet RectangleSet::subtracted(const RectangleSet& other) const
+{
+    auto set = *this;
+    set -= other;
+    return set;
+}
+
+RectangleSet& RectangleSet::operator|=(const RectangleSet& other)
+{
+    if (isEmpty())
+        _bands = other._bands;
+    else
+        _apply(other, Operation::unite);
+    return *this;
+}
+
+RectangleSet& RectangleSet::operator-=(const RectangleSet& other)
+{
+    _apply(other, Operation::subtract);
+    return *this;
+}
+
+RectangleSet RectangleSet::translated(const qreal dx, const qreal dy) const
+{
+    auto set = *this;
+    for (auto& band : set._bands)
+    {
+        band.top += dy;
+        band.bottom += dy;
+        for (auto& span : band.spans)
+        {
+            span.left += dx;
+            span.right += dx;
+        }
+    }
+    return set;
+}
+
+bool RectangleSet::operator==(const RectangleSet& other) const
+{
+    return std::equal(_bands.begin(), _bands.end(), other._bands.begin(),
+                      other._bands.end(), [](const Band& a, const Band& b) {
+                          return a.top == b.top && a.bottom == b.bottom &&
+                                 a.spans == b.spans;
+                      });
+}
+
+bool RectangleSet::operator!=(const RectangleSet& other) const
+{
+    return !(*this == other);
+}
+
+void RectangleSet::_apply(const RectangleSet& other,
+                          const Operation operation)
+{
+    if (isEmpty() || other.isEmpty())
+        return;
+
+    // Only the bands of this set which overlap the other one are affected
+    const auto rangeA = _findBands(_bands.begin(), _bands.end(),
+                                   other._bands.front().top,
+                                   other._bands.back().bottom);
+    if (rangeA.first == rangeA.second && operation == Operation::subtract)
+        return;
+
+    // The bands of the other set matter only where they overlap this one,
+    // except for a union where they are all added.
+    auto rangeB = std::make_pair(other._bands.begin(), other._bands.end());
+    if (operation == Operation::subtract)
+    {
+        const auto top = rangeA.first->top;
+        const auto bottom = std::prev(rangeA.second)->bottom;
+        rangeB = _findBands(other._bands.begin(), other._bands.end(), top,
+                            bottom);
+    }
+
+    // Sweep line: all the band edges of both ranges, from top to bottom
+    auto edges = std::vector<qreal>();
+    for (auto it = rangeA.first; it != rangeA.second; ++it)
+    {
+        edges.push_back(it->top);
+        edges.push_back(it->bottom);
+    }
+    for (auto it = rangeB.first; it != rangeB.second; ++it)
+    {
+        edges.push_back(it->top);
+        edges.push_back(it->bottom);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    static const Spans noSpans;
+    auto itA = rangeA.first;
+    auto itB = rangeB.first;
+
+    // The bands above the range are kept as they are
+    auto bands = Bands();
+    bands.reserve(_bands.size() + edges.size());
+    std::move(_bands.begin(), rangeA.first, std::back_inserter(bands));
+
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+        const auto y0 = edges[i];
+        const auto y1 = edges[i + 1];
+
+        // Edges include all band limits: a band either covers [y0; y1] or not
+        while (itA != rangeA.second && itA->bottom <= y0)
+            ++itA;
+        while (itB != rangeB.second && itB->bottom <= y0)
+            ++itB;
+        const auto inA = itA != rangeA.second && itA->top <= y0;
+        const auto inB = itB != rangeB.second && itB->top <= y0;
+        const auto& spansA = inA ? itA->spans : noSpans;
+        const auto& spansB = inB ? itB->spans : noSpans;
+
+        if (operation == Operation::unite)
+            _appendBand(bands, y0, y1, _unite(spansA, spansB));
+        else if (inA)
+            _appendBand(bands, y0, y1, _subtract(spansA, spansB));
+    }
+
+    // The bands below the range are kept, the first one may be coalesced
+    auto it = rangeA.second;
+    if (it != _bands.end())
+    {
+        _appendBand(bands, it->top, it->bottom, std::move(it->spans));
+        std::move(++it, _bands.end(), std::back_inserter(bands));
+    }
+    _bands = std::move(bands);
+}
@@ -0,0 +1,127 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef RECTANGLESET_H
+#define RECTANGLESET_H
+
+#include <QRectF>
+
+#include <vector>
+
+/**
+ * An exact set of rectangular areas, for instance the visible parts of a
+ * window partially covered by other windows.
+ *
+ * The set is stored as horizontal bands sorted from top to bottom, each with
+ * a sorted list of disjoint spans. Boolean operations sweep the band edges of
+ * both operands from top to bottom, so their cost grows with the number of
+ * bands and spans rather than with the number of rectangles combined.
+ */
+class RectangleSet
+{
+public:
+    /** Create an empty set. */
+    RectangleSet() = default;
+
+    /** Create a set from a rectangle, empty if the rectangle is empty. */
+    explicit RectangleSet(const QRectF& rect);
+
+    /** @return true if the set covers no area. */
+    bool isEmpty() const;
+
+    /** @return the total area covered by the set. */
+    qreal getArea() const;
+
+    /** @return the bounding rectangle of the set, empty if the set is. */
+    QRectF getBoundingRect() const;
+
+    /** @return disjoint rectangles covering the set, one per band span. */
+    std::vector<QRectF> getRects() const;
+
+    /** @return true if the set and the rectangle overlap (not just touch). */
+    bool intersects(const QRectF& rect) const;
+
+    /** @return the union of this set and another one. */
+    RectangleSet united(const RectangleSet& other) const;
+
+    /** @return this set minus another one. */
+    RectangleSet subtracted(const RectangleSet& other) const;
+
+    /**
+     * @name In-place operations.
+     * Only the bands within the vertical extent of the other set are updated.
+     */
+    //@{
+    RectangleSet& operator|=(const RectangleSet& other);
+    RectangleSet& operator-=(const RectangleSet& other);
+    //@}
+
+    /** @return this set translated by the given offset. */
+    RectangleSet translated(qreal dx, qreal dy) const;
+
+    bool operator==(const RectangleSet& other) const;
+    bool operator!=(const RectangleSet& other) const;
+
+private:
+    struct Span
+    {
+        qreal left;
+        qreal right;
+        bool operator==(const Span& other) const;
+    };
+    using Spans = std::vector<Span>;
+
+    struct Band
+    {
+        qreal top;
+        qreal bottom;
+        Spans spans;
+    };
+    using Bands = std::vector<Band>;
+    Bands _bands;
+
+    enum class Operation
+    {
+        unite,
+        subtract
+    };
+    void _apply(const RectangleSet& other, Operation operation);
+};
+
+#endif
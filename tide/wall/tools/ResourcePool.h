@@ -0,0 +1,182 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef RESOURCEPOOL_H
+#define RESOURCEPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+
+/**
+ * Memory-budgeted pool of unused resources kept for reuse.
+ *
+ * Resources given back to the pool are stored by key until taken again. When
+ * their total size exceeds the budget, the least recently given resources are
+ * deleted. The pool is not threadsafe.
+ */
+template <typename Key, typename Resource>
+class ResourcePool
+{
+public:
+    /** Statistics of the pool. */
+    struct Stats
+    {
+        uint64_t hits = 0;      // take() returned a pooled resource
+        uint64_t misses = 0;    // take() found no resource for the key
+        uint64_t recycled = 0;  // resources given back and kept
+        uint64_t evictions = 0; // resources deleted to respect the budget
+        size_t count = 0;       // number of pooled resources
+        size_t size = 0;        // [bytes]
+        size_t maxSize = 0;     // [bytes]
+    };
+
+    /**
+     * Create a pool.
+     * @param maxSize the memory budget of the unused resources [bytes].
+     */
+    explicit ResourcePool(const size_t maxSize)
+        : _maxSize{maxSize}
+    {
+    }
+
+    /**
+     * Take a resource out of the pool.
+     * @return the resource, or nullptr if the pool has none for the key.
+     */
+    std::unique_ptr<Resource> take(const Key& key)
+    {
+        const auto it = _index.find(key);
+        if (it == _index.end())
+        {
+            ++_stats.misses;
+            return nullptr;
+        }
+        ++_stats.hits;
+
+        const auto entry = it->second;
+        _index.erase(it);
+
+        auto resource = std::move(entry->resource);
+        _size -= entry->size;
+        _entries.erase(entry);
+        return resource;
+    }
+
+    /**
+     * Give back an unused resource, evicting older ones if needed.
+     * @param key the key to take() the resource again.
+     * @param resource the resource to keep.
+     * @param size the memory used by the resource [bytes].
+     */
+    void give(const Key& key, std::unique_ptr<Resource> resource,
+              const size_t size)
+    {
+        if (!resource)
+            return;
+
+        if (size > _maxSize)
+        {
+            ++_stats.evictions;
+            return;
+        }
+
+        _entries.push_front(Entry{key, std::move(resource), size});
+        _index.emplace(key, _entries.begin());
+        _size += size;
+        ++_stats.recycled;
+        _evict();
+    }
+
+    /** Change the budget, evicting resources if needed. */
+    void setMaxSize(const size_t maxSize)
+    {
+        _maxSize = maxSize;
+        _evict();
+    }
+
+    /** @return the statistics of the pool. */
+    Stats getStats() const
+    {
+        auto stats = _stats;
+        stats.count = _entries.size();
+        stats.size = _size;
+        stats.maxSize = _maxSize;
+        return stats;
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        std::unique_ptr<Resource> resource;
+        size_t size = 0;
+    };
+    using Entries = std::list<Entry>; // most recently given first
+
+    size_t _maxSize = 0;
+    size_t _size = 0;
+    Entries _entries;
+    std::multimap<Key, typename Entries::iterator> _index;
+    Stats _stats;
+
+    void _evict()
+    {
+        while (_size > _maxSize)
+        {
+            const auto last = std::prev(_entries.end());
+            const auto range = _index.equal_range(last->key);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == last)
+                {
+                    _index.erase(it);
+                    break;
+                }
+            }
+            _size -= last->size;
+            _entries.erase(last);
+            ++_stats.evictions;
+        }
+    }
+};
+
+#endif
@@ -41,6 +41,7 @@
 #define SWAPSYNCOBJECT_H
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 
 /** Function to be used to synchronize the swapping. */
@@ -72,6 +73,8 @@ public:
 
     /** Get the front object */
     T get() const { return _frontObject; }
+    /** Get the version of the back object, incremented by each update. */
+    uint64_t getVersion() const { return _version; }
     /** Update the back object. */
     void update(const T& newObject)
     {
@@ -0,0 +1,151 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TelemetryCollector.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+float _toMs(const TelemetryCollector::clock::duration duration)
+{
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+
+// Nearest-rank percentile of sorted values
+float _getPercentile(
+    const std::vector<TelemetryCollector::clock::duration>& sorted,
+    const double percentile)
+{
+    if (sorted.empty())
+        return 0.f;
+    const auto rank = std::ceil(percentile / 100.0 * sorted.size());
+    const auto index = std::max(size_t(rank), size_t(1)) - 1;
+    return _toMs(sorted[std::min(index, sorted.size() - 1)]);
+}
+}
+
+void TelemetryCollector::Durations::add(const clock::duration duration)
+{
+    ++count;
+    total += duration;
+    max = std::max(max, duration);
+}
+
+float TelemetryCollector::Durations::getMean() const
+{
+    return count > 0 ? _toMs(total) / count : 0.f;
+}
+
+float TelemetryCollector::Durations::getMax() const
+{
+    return _toMs(max);
+}
+
+TelemetryCollector::TelemetryCollector(
+    const std::chrono::milliseconds interval, const clock::time_point start)
+    : _interval{interval}
+    , _periodStart{start}
+{
+    _frameTimes.reserve(maxFrameSamples);
+}
+
+std::chrono::milliseconds TelemetryCollector::getInterval() const
+{
+    return _interval;
+}
+
+void TelemetryCollector::addFrame(const clock::duration frameTime,
+                                  const clock::duration syncWait)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _frames.add(frameTime);
+    _syncWaits.add(syncWait);
+    if (_frameTimes.size() < maxFrameSamples)
+        _frameTimes.push_back(frameTime);
+}
+
+void TelemetryCollector::addSwapWait(const clock::duration wait)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _swapWaits.add(wait);
+}
+
+void TelemetryCollector::addTileLoad(const clock::duration loadTime)
+{
+    std::lock_guard<std::mutex> lock{_mutex};
+    _tileLoads.add(loadTime);
+}
+
+WallTelemetry TelemetryCollector::collect(const clock::time_point now)
+{
+    std::vector<clock::duration> frameTimes;
+    frameTimes.reserve(maxFrameSamples);
+
+    WallTelemetry telemetry;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        telemetry.period = _toMs(now - _periodStart);
+        telemetry.frames = _frames.count;
+        telemetry.frameTimeMean = _frames.getMean();
+        telemetry.frameTimeMax = _frames.getMax();
+        telemetry.syncWaitMean = _syncWaits.getMean();
+        telemetry.syncWaitMax = _syncWaits.getMax();
+        telemetry.swapWaitMean = _swapWaits.getMean();
+        telemetry.swapWaitMax = _swapWaits.getMax();
+        telemetry.tilesLoaded = _tileLoads.count;
+        telemetry.decodeTimeMean = _tileLoads.getMean();
+        telemetry.decodeTimeMax = _tileLoads.getMax();
+
+        // Sort outside of the lock, swapping keeps the reserved capacity
+        frameTimes.swap(_frameTimes);
+        _frames = Durations();
+        _syncWaits = Durations();
+        _swapWaits = Durations();
+        _tileLoads = Durations();
+        _periodStart = now;
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    telemetry.frameTimeP50 = _getPercentile(frameTimes, 50.0);
+    telemetry.frameTimeP90 = _getPercentile(frameTimes, 90.0);
+    telemetry.frameTimeP99 = _getPercentile(frameTimes, 99.0);
+    return telemetry;
+}
@@ -0,0 +1,120 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TELEMETRYCOLLECTOR_H
+#define TELEMETRYCOLLECTOR_H
+
+#include "network/WallTelemetry.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+/**
+ * Collect the performance counters of a wall process over reporting periods.
+ *
+ * Frames are added by the main thread, swap barrier waits by the render
+ * threads and tile loads by the loading threads; all methods are threadsafe.
+ * Each sample costs a lock and a few additions, and the frame times of a
+ * period are only sorted once, when it is collected.
+ *
+ * Times are given by the caller, which allows testing with a simulated clock.
+ */
+class TelemetryCollector
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /** Maximum number of frame times kept per period for the percentiles. */
+    static const size_t maxFrameSamples = 4096;
+
+    /**
+     * Create a collector.
+     * @param interval the reporting interval.
+     * @param start the start of the first period.
+     */
+    explicit TelemetryCollector(std::chrono::milliseconds interval,
+                                clock::time_point start = clock::now());
+
+    /** @return the reporting interval. */
+    std::chrono::milliseconds getInterval() const;
+
+    /**
+     * Add a rendered frame.
+     * @param frameTime the time to synchronize and render the frame.
+     * @param syncWait the part of it spent in the frame synchronization.
+     */
+    void addFrame(clock::duration frameTime, clock::duration syncWait);
+
+    /** Add the time spent by a render thread in the swap barrier. */
+    void addSwapWait(clock::duration wait);
+
+    /** Add the time taken to load (decode) a tile image. */
+    void addTileLoad(clock::duration loadTime);
+
+    /**
+     * Get the counters of the period since the previous call and start a new
+     * period. The caller sets the rank and the tile queue and cache state.
+     * @param now the end of the period.
+     */
+    WallTelemetry collect(clock::time_point now);
+
+private:
+    struct Durations
+    {
+        uint32_t count = 0;
+        clock::duration total{0};
+        clock::duration max{0};
+
+        void add(clock::duration duration);
+        float getMean() const;
+        float getMax() const;
+    };
+
+    const std::chrono::milliseconds _interval;
+    mutable std::mutex _mutex;
+    clock::time_point _periodStart;
+    std::vector<clock::duration> _frameTimes;
+    Durations _frames;
+    Durations _syncWaits;
+    Durations _swapWaits;
+    Durations _tileLoads;
+};
+
+#endif
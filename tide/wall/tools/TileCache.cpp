@@ -0,0 +1,155 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TileCache.h"
+
+namespace
+{
+size_t _getSize(const QImage& image)
+{
+    return size_t(image.bytesPerLine()) * size_t(image.height());
+}
+}
+
+TileCache::TileCache(const size_t maxSize,
+                     std::unique_ptr<DiskTileCache> diskCache)
+    : _diskCache{std::move(diskCache)}
+{
+    _stats.maxSize = maxSize;
+}
+
+QImage TileCache::get(const Key& key)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto it = _index.find(key);
+    if (it == _index.end())
+    {
+        ++_stats.misses;
+        return QImage();
+    }
+    ++_stats.hits;
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->image;
+}
+
+bool TileCache::contains(const Key& key) const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _index.count(key) > 0;
+}
+
+bool TileCache::insert(const Key& key, const QImage& image)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+
+    const auto it = _index.find(key);
+    const auto added = it == _index.end();
+    if (!added)
+        _erase(it->second);
+
+    _entries.push_front({key, image, _getSize(image)});
+    _index[key] = _entries.begin();
+    _stats.size += _entries.front().size;
+    ++_stats.tileCount;
+
+    _evict();
+    return added;
+}
+
+void TileCache::pin(const void* source, const uint tileId)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    ++_pins[{source, tileId}];
+}
+
+void TileCache::unpin(const void* source, const uint tileId)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto it = _pins.find({source, tileId});
+    if (it == _pins.end())
+        return;
+
+    if (--it->second == 0)
+    {
+        _pins.erase(it);
+        _evict();
+    }
+}
+
+void TileCache::remove(const void* source)
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+
+    auto it = _index.lower_bound(Key{source, 0, 0});
+    while (it != _index.end() && it->first.source == source)
+        _erase((it++)->second);
+
+    auto pin = _pins.lower_bound({source, 0});
+    while (pin != _pins.end() && pin->first.first == source)
+        pin = _pins.erase(pin);
+}
+
+TileCache::Stats TileCache::getStats() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _stats;
+}
+
+void TileCache::_erase(const Entries::iterator it)
+{
+    _stats.size -= it->size;
+    --_stats.tileCount;
+    _index.erase(it->key);
+    _entries.erase(it);
+}
+
+void TileCache::_evict()
+{
+    auto it = _entries.end();
+    while (_stats.size > _stats.maxSize && it != _entries.begin())
+    {
+        --it;
+        if (_pins.count({it->key.source, it->key.tileId}))
+            continue;
+
+        const auto evicted = it++;
+        _erase(evicted);
+        ++_stats.evictions;
+    }
+}
@@ -0,0 +1,154 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TILECACHE_H
+#define TILECACHE_H
+
+#include "DiskTileCache.h"
+
+#include <QImage>
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+/**
+ * Memory-budgeted cache of tile images shared by all the data sources of a
+ * wall process.
+ *
+ * When the size of the images exceeds the budget, the least recently used
+ * tiles are evicted. Pinned tiles (those currently visible) are never evicted,
+ * the cache may thus temporarily exceed its budget if the visible tiles alone
+ * do not fit in it. All methods are threadsafe.
+ *
+ * An optional DiskTileCache provides a second, persistent level for the data
+ * sources whose tiles are expensive to produce.
+ */
+class TileCache
+{
+public:
+    /** The identifier of a tile image. */
+    struct Key
+    {
+        const void* source = nullptr;
+        uint tileId = 0;
+        uint eye = 0; // the tiles of stereo sources differ for each eye
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(source, tileId, eye) <
+                   std::tie(other.source, other.tileId, other.eye);
+        }
+    };
+
+    /** Statistics of the cache. */
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t tileCount = 0;
+        size_t size = 0;    // [bytes]
+        size_t maxSize = 0; // [bytes]
+    };
+
+    /**
+     * Create a cache.
+     * @param maxSize the memory budget of the cache [bytes].
+     * @param diskCache optional persistent cache.
+     */
+    explicit TileCache(size_t maxSize,
+                       std::unique_ptr<DiskTileCache> diskCache = nullptr);
+
+    /** @return the persistent cache, or nullptr if disabled. */
+    DiskTileCache* getDiskCache() const { return _diskCache.get(); }
+
+    /**
+     * Get a tile image, counted as a hit or a miss.
+     * @return the image, or a null image if it is not in the cache.
+     */
+    QImage get(const Key& key);
+
+    /** @return true if the cache contains a tile (does not affect stats). */
+    bool contains(const Key& key) const;
+
+    /**
+     * Insert or replace a tile image, evicting other tiles if needed.
+     * @return true if the tile was not already in the cache.
+     */
+    bool insert(const Key& key, const QImage& image);
+
+    /** Protect the tiles of a source from eviction (reference counted). */
+    void pin(const void* source, uint tileId);
+
+    /** Release a pin(), allowing the tiles to be evicted again. */
+    void unpin(const void* source, uint tileId);
+
+    /** Remove all the tiles and pins of a source. */
+    void remove(const void* source);
+
+    /** @return the statistics of the cache. */
+    Stats getStats() const;
+
+private:
+    struct Entry
+    {
+        Key key;
+        QImage image;
+        size_t size = 0;
+    };
+    using Entries = std::list<Entry>; // most recently used first
+    using PinKey = std::pair<const void*, uint>;
+
+    std::unique_ptr<DiskTileCache> _diskCache;
+
+    mutable std::mutex _mutex;
+    Entries _entries;
+    std::map<Key, Entries::iterator> _index;
+    std::map<PinKey, uint> _pins;
+    Stats _stats;
+
+    void _erase(Entries::iterator it);
+    void _evict();
+};
+
+#endif
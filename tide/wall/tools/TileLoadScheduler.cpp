@@ -0,0 +1,158 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "TileLoadScheduler.h"
+
+#include <algorithm>
+
+TileLoadScheduler::TileLoadScheduler(const size_t threadCount)
+{
+    const auto count = std::max(threadCount, size_t(1));
+    for (auto i = size_t(0); i < count; ++i)
+        _threads.emplace_back(&TileLoadScheduler::_run, this);
+}
+
+TileLoadScheduler::~TileLoadScheduler()
+{
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        _stats.cancelled += _queue.size();
+        _queue.clear();
+        _stopping = true;
+    }
+    _requestsAvailable.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void TileLoadScheduler::submit(Request request)
+{
+    {
+        const std::lock_guard<std::mutex> lock{_mutex};
+        _queue.push_back({std::move(request), _sequence++});
+        std::push_heap(_queue.begin(), _queue.end(), _hasLowerPriority);
+    }
+    _requestsAvailable.notify_one();
+}
+
+size_t TileLoadScheduler::cancelObsoleteRequests()
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    const auto isObsolete = [](const Entry& entry) {
+        return entry.request.isObsolete && entry.request.isObsolete();
+    };
+    const auto end = std::remove_if(_queue.begin(), _queue.end(), isObsolete);
+    const auto count = size_t(std::distance(end, _queue.end()));
+    if (count == 0)
+        return 0;
+
+    _queue.erase(end, _queue.end());
+    std::make_heap(_queue.begin(), _queue.end(), _hasLowerPriority);
+    _stats.cancelled += count;
+    if (_queue.empty() && _running == 0)
+        _idle.notify_all();
+    return count;
+}
+
+size_t TileLoadScheduler::getPendingCount() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _queue.size();
+}
+
+TileLoadScheduler::Stats TileLoadScheduler::getStats() const
+{
+    const std::lock_guard<std::mutex> lock{_mutex};
+    return _stats;
+}
+
+void TileLoadScheduler::waitForIdle()
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    _idle.wait(lock, [this] { return _queue.empty() && _running == 0; });
+}
+
+bool TileLoadScheduler::_hasLowerPriority(const Entry& a, const Entry& b)
+{
+    const auto& ra = a.request;
+    const auto& rb = b.request;
+    if (ra.sourceType != rb.sourceType)
+        return ra.sourceType > rb.sourceType;
+    if (ra.lod != rb.lod)
+        return ra.lod < rb.lod;
+    if (ra.area != rb.area)
+        return ra.area < rb.area;
+    return a.sequence > b.sequence;
+}
+
+void TileLoadScheduler::_run()
+{
+    Entry entry;
+    while (_takeNext(entry))
+    {
+        const auto obsolete =
+            entry.request.isObsolete && entry.request.isObsolete();
+        if (!obsolete)
+            entry.request.load();
+        entry = Entry();
+
+        const std::lock_guard<std::mutex> lock{_mutex};
+        if (obsolete)
+            ++_stats.cancelled;
+        else
+            ++_stats.loaded;
+        if (--_running == 0 && _queue.empty())
+            _idle.notify_all();
+    }
+}
+
+bool TileLoadScheduler::_takeNext(Entry& entry)
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    _requestsAvailable.wait(lock,
+                            [this] { return _stopping || !_queue.empty(); });
+    if (_stopping)
+        return false;
+
+    std::pop_heap(_queue.begin(), _queue.end(), _hasLowerPriority);
+    entry = std::move(_queue.back());
+    _queue.pop_back();
+    ++_running;
+    return true;
+}
@@ -0,0 +1,138 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef TILELOADSCHEDULER_H
+#define TILELOADSCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Load tile images on a dedicated pool of threads, by order of priority.
+ *
+ * Requests are ranked by type of data source (streams before movies before
+ * static contents, with speculative prefetching last), then coarse levels of
+ * detail first and finally by decreasing on-screen area, so that a screen
+ * quickly fills up with low resolution tiles before the details arrive.
+ * Requests that become obsolete, for instance because their tile was removed
+ * from the visible set, are cancelled before they start.
+ */
+class TileLoadScheduler
+{
+public:
+    /** The type of data source of a request, by decreasing priority. */
+    enum class SourceType
+    {
+        stream,
+        movie,
+        static_,
+        prefetch
+    };
+
+    /** A tile load request. */
+    struct Request
+    {
+        SourceType sourceType = SourceType::static_;
+        unsigned int lod = 0;   // higher (coarser) levels are loaded first
+        double area = 0.0;      // larger on-screen areas are loaded first
+        std::function<bool()> isObsolete; // checked before starting the load
+        std::function<void()> load;
+    };
+
+    /** Statistics of the scheduler. */
+    struct Stats
+    {
+        uint64_t loaded = 0;
+        uint64_t cancelled = 0;
+    };
+
+    /**
+     * Start the scheduler.
+     * @param threadCount the number of loading threads, at least one.
+     */
+    explicit TileLoadScheduler(size_t threadCount);
+
+    /** Cancel the pending requests and wait for the running ones to finish. */
+    ~TileLoadScheduler();
+
+    /** Add a request to the queue. Thread safe. */
+    void submit(Request request);
+
+    /**
+     * Remove the pending requests which have become obsolete.
+     * @return the number of requests cancelled.
+     */
+    size_t cancelObsoleteRequests();
+
+    /** @return the number of requests waiting to start. */
+    size_t getPendingCount() const;
+
+    /** @return the statistics of the scheduler. */
+    Stats getStats() const;
+
+    /** Wait until all the pending requests are loaded or cancelled. */
+    void waitForIdle();
+
+private:
+    struct Entry
+    {
+        Request request;
+        uint64_t sequence = 0;
+    };
+    static bool _hasLowerPriority(const Entry& a, const Entry& b);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _requestsAvailable;
+    std::condition_variable _idle;
+    std::vector<Entry> _queue; // heap ordered by _hasLowerPriority
+    uint64_t _sequence = 0;
+    size_t _running = 0;
+    bool _stopping = false;
+    Stats _stats;
+    std::vector<std::thread> _threads;
+
+    void _run();
+    bool _takeNext(Entry& entry);
+};
+
+#endif
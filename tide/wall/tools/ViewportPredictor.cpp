@@ -0,0 +1,161 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "ViewportPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Samples further apart than this mean that the viewport stood still
+const auto maxSampleInterval = std::chrono::milliseconds{200};
+
+// Weight of the latest sample in the smoothed velocity
+const qreal smoothing = 0.5;
+
+// Relative change below which the viewport is considered static
+const qreal motionThreshold = 0.01;
+
+template <typename T>
+T _mix(const T& previous, const T& current)
+{
+    return previous * (1.0 - smoothing) + current * smoothing;
+}
+
+QRectF _extrapolate(const QRectF& rect, const QRectF& velocity,
+                    const qreal dt)
+{
+    return {rect.x() + velocity.x() * dt, rect.y() + velocity.y() * dt,
+            std::max(rect.width() + velocity.width() * dt, 0.0),
+            std::max(rect.height() + velocity.height() * dt, 0.0)};
+}
+
+QRectF _velocity(const QRectF& from, const QRectF& to, const qreal dt)
+{
+    return {(to.x() - from.x()) / dt, (to.y() - from.y()) / dt,
+            (to.width() - from.width()) / dt,
+            (to.height() - from.height()) / dt};
+}
+
+qreal _relativeChange(const qreal delta, const qreal reference)
+{
+    return reference > 0.0 ? std::abs(delta) / reference : 0.0;
+}
+}
+
+ViewportPredictor::ViewportPredictor(const clock::duration lookahead)
+    : _lookahead{lookahead}
+{
+}
+
+void ViewportPredictor::addSample(const Viewport& viewport,
+                                  const clock::time_point time)
+{
+    if (_hasSample && time < _lastTime)
+        return;
+
+    if (_hasSample && time > _lastTime)
+    {
+        const auto interval = time - _lastTime;
+        if (interval > maxSampleInterval)
+        {
+            _areaVelocity = QRectF();
+            _displaySizeVelocity = QSizeF{0.0, 0.0};
+        }
+        else
+        {
+            const auto dt = std::chrono::duration<qreal>{interval}.count();
+            const auto areaVelocity = _velocity(_last.area, viewport.area, dt);
+            const auto sizeVelocity =
+                (viewport.displaySize - _last.displaySize) / dt;
+
+            _areaVelocity = QRectF{
+                _mix(_areaVelocity.x(), areaVelocity.x()),
+                _mix(_areaVelocity.y(), areaVelocity.y()),
+                _mix(_areaVelocity.width(), areaVelocity.width()),
+                _mix(_areaVelocity.height(), areaVelocity.height())};
+            _displaySizeVelocity = _mix(_displaySizeVelocity, sizeVelocity);
+        }
+    }
+
+    _hasSample = true;
+    _last = viewport;
+    _lastTime = time;
+}
+
+bool ViewportPredictor::isMoving() const
+{
+    if (!_hasSample)
+        return false;
+
+    const auto predicted = predict();
+    const auto& area = _last.area;
+    const auto& size = _last.displaySize;
+
+    const auto changes = {
+        _relativeChange(predicted.area.x() - area.x(), area.width()),
+        _relativeChange(predicted.area.y() - area.y(), area.height()),
+        _relativeChange(predicted.area.width() - area.width(), area.width()),
+        _relativeChange(predicted.area.height() - area.height(),
+                        area.height()),
+        _relativeChange(predicted.displaySize.width() - size.width(),
+                        size.width()),
+        _relativeChange(predicted.displaySize.height() - size.height(),
+                        size.height())};
+    return std::max(changes) > motionThreshold;
+}
+
+ViewportPredictor::Viewport ViewportPredictor::predict() const
+{
+    const auto dt = std::chrono::duration<qreal>{_lookahead}.count();
+
+    auto size = _last.displaySize + _displaySizeVelocity * dt;
+    size = size.expandedTo(QSizeF{0.0, 0.0});
+
+    return {_extrapolate(_last.area, _areaVelocity, dt), size};
+}
+
+void ViewportPredictor::reset()
+{
+    _hasSample = false;
+    _last = Viewport();
+    _areaVelocity = QRectF();
+    _displaySizeVelocity = QSizeF{0.0, 0.0};
+}
@@ -0,0 +1,101 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef VIEWPORTPREDICTOR_H
+#define VIEWPORTPREDICTOR_H
+
+#include <QRectF>
+#include <QSizeF>
+
+#include <chrono>
+
+/**
+ * Extrapolate the recent motion of a viewport to anticipate pan and zoom.
+ *
+ * The velocity of the visible area and of the display size is estimated from
+ * consecutive samples (smoothed over time) and used to predict where the
+ * viewport will be after a short look-ahead delay.
+ */
+class ViewportPredictor
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /** A viewport on a content. */
+    struct Viewport
+    {
+        /** The visible area, normalized to the size of the content. */
+        QRectF area;
+
+        /** The size at which the whole content is displayed (zoom level). */
+        QSizeF displaySize;
+    };
+
+    /**
+     * Constructor.
+     * @param lookahead how far into the future predict() extrapolates.
+     */
+    explicit ViewportPredictor(
+        clock::duration lookahead = std::chrono::milliseconds{250});
+
+    /** Add the viewport of the current frame. */
+    void addSample(const Viewport& viewport, clock::time_point time);
+
+    /** @return true if the viewport has been moving in the recent samples. */
+    bool isMoving() const;
+
+    /** @return the predicted viewport after the look-ahead delay. */
+    Viewport predict() const;
+
+    /** Forget the motion history. */
+    void reset();
+
+private:
+    clock::duration _lookahead;
+
+    bool _hasSample = false;
+    Viewport _last;
+    clock::time_point _lastTime;
+
+    // Velocities in normalized units or pixels per second
+    QRectF _areaVelocity;
+    QSizeF _displaySizeVelocity{0.0, 0.0};
+};
+
+#endif
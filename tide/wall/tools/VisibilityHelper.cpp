@@ -42,6 +42,15 @@
 #include "scene/DisplayGroup.h"
 #include "scene/Window.h"
 
+namespace
+{
+RectangleSet _globalToWindowCoordinates(const RectangleSet& region,
+                                        const QRectF& window)
+{
+    return region.translated(-window.x(), -window.y());
+}
+}
+
 VisibilityHelper::VisibilityHelper(const DisplayGroup& displayGroup,
                                    const QRect& visibleArea,
                                    const bool alphaBlending)
@@ -51,61 +60,21 @@ VisibilityHelper::VisibilityHelper(const DisplayGroup& displayGroup,
 {
 }
 
-QRectF _cutOverlap(const QRectF& window, const QRectF& other)
-{
-    if (other.contains(window))
-        return QRectF();
-
-    const QRectF overlap = window.intersected(other);
-    if (overlap.isEmpty())
-        return window;
-
-    // Full horizontal cut
-    if (overlap.width() >= window.width())
-    {
-        QRectF area(window);
-        if (overlap.top() <= window.top())
-            area.setTop(overlap.bottom());
-        else if (overlap.bottom() >= window.bottom())
-            area.setBottom(overlap.top());
-        return area;
-    }
-
-    // Full vertical cut
-    if (overlap.height() >= window.height())
-    {
-        QRectF area(window);
-        if (overlap.left() <= window.left())
-            area.setLeft(overlap.right());
-        else if (overlap.right() >= window.right())
-            area.setRight(overlap.left());
-        return area;
-    }
-
-    return window;
-}
-
-QRectF _globalToWindowCoordinates(const QRectF& area, const QRectF& window)
+QRectF VisibilityHelper::getVisibleArea(const Window& window) const
 {
-    return area.translated(-window.x(), -window.y());
+    return getVisibleRegion(window).getBoundingRect();
 }
 
-QRectF VisibilityHelper::getVisibleArea(const Window& window) const
+RectangleSet VisibilityHelper::getVisibleRegion(const Window& window) const
 {
-    const auto& windowCoords = window.getDisplayCoordinates();
-
-    auto area = windowCoords.intersected(_visibleArea);
+    const auto area = _getUnoccludedArea(window);
     if (area.isEmpty())
-        return QRectF();
-
-    if (window.isFullscreen())
-        return _globalToWindowCoordinates(area, windowCoords);
+        return RectangleSet();
 
-    if (_displayGroup.hasFullscreenWindows())
-        return QRectF();
-
-    if (window.isFocused())
-        return _globalToWindowCoordinates(area, windowCoords);
+    const auto& windowCoords = window.getDisplayCoordinates();
+    auto region = RectangleSet{area};
+    if (!_canBeOccluded(window))
+        return _globalToWindowCoordinates(region, windowCoords);
 
     auto winIsAbove = false;
     for (const auto& win : _displayGroup.getWindows())
@@ -115,18 +84,77 @@ QRectF VisibilityHelper::getVisibleArea(const Window& window) const
             winIsAbove = !window.isPanel(); // panels are above regular windows
             continue;
         }
-        if (win->isHidden())
-            continue;
 
-        if ((winIsAbove || win->isFocused()) &&
-            (!_alphaBlending || !win->getContent().hasTransparency()))
+        if ((winIsAbove || win->isFocused()) && _isOccluding(*win))
         {
-            area = _cutOverlap(area, win->getDisplayCoordinates());
+            region -= _getOccludedArea(*win);
+            if (region.isEmpty())
+                return RectangleSet();
         }
+    }
+
+    return _globalToWindowCoordinates(region, windowCoords);
+}
 
-        if (area.isEmpty())
-            return QRectF();
+std::vector<RectangleSet> VisibilityHelper::getVisibleRegions() const
+{
+    const auto& windows = _displayGroup.getWindows();
+
+    // Focused windows are above all the other ones
+    auto focusedArea = RectangleSet();
+    for (const auto& win : windows)
+    {
+        if (win->isFocused() && _isOccluding(*win))
+            focusedArea |= _getOccludedArea(*win);
     }
 
-    return _globalToWindowCoordinates(area, windowCoords);
+    auto regions = std::vector<RectangleSet>(windows.size());
+    auto areaAbove = RectangleSet();
+    for (auto i = windows.size(); i-- > 0;)
+    {
+        const auto& window = *windows[i];
+        const auto area = _getUnoccludedArea(window);
+        if (!area.isEmpty())
+        {
+            auto region = RectangleSet{area};
+            if (_canBeOccluded(window))
+            {
+                region -= focusedArea;
+                if (!window.isPanel()) // panels are above regular windows
+                    region -= areaAbove;
+            }
+            regions[i] = _globalToWindowCoordinates(
+                region, window.getDisplayCoordinates());
+        }
+
+        if (_isOccluding(window))
+            areaAbove |= _getOccludedArea(window);
+    }
+    return regions;
+}
+
+QRectF VisibilityHelper::_getUnoccludedArea(const Window& window) const
+{
+    const auto area = window.getDisplayCoordinates().intersected(_visibleArea);
+    if (!window.isFullscreen() && _displayGroup.hasFullscreenWindows())
+        return QRectF();
+    return area;
+}
+
+bool VisibilityHelper::_canBeOccluded(const Window& window) const
+{
+    return !window.isFullscreen() && !window.isFocused();
+}
+
+bool VisibilityHelper::_isOccluding(const Window& window) const
+{
+    return !window.isHidden() &&
+           (!_alphaBlending || !window.getContent().hasTransparency());
+}
+
+RectangleSet VisibilityHelper::_getOccludedArea(const Window& window) const
+{
+    // Only the visible area matters, which keeps the accumulated area small
+    return RectangleSet{
+        window.getDisplayCoordinates().intersected(_visibleArea)};
 }
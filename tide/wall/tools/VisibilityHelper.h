@@ -42,8 +42,14 @@
 
 #include "types.h"
 
+#include "tools/RectangleSet.h"
+
 /**
  * Helper to determine the visible parts of windows on the wall.
+ *
+ * The visible parts of a window are computed exactly, as the set of
+ * rectangles of its area which are not covered by the opaque windows above
+ * it or by the focused windows.
  */
 class VisibilityHelper
 {
@@ -51,12 +57,34 @@ public:
     VisibilityHelper(const DisplayGroup& displayGroup, const QRect& visibleArea,
                      bool alphaBlending);
 
+    /**
+     * @return the bounding rectangle of the visible parts of a window, in
+     *         window coordinates.
+     */
     QRectF getVisibleArea(const Window& window) const;
 
+    /** @return the visible parts of a window, in window coordinates. */
+    RectangleSet getVisibleRegion(const Window& window) const;
+
+    /**
+     * Get the visible parts of all the windows of the group at once.
+     *
+     * The windows are visited once from top to bottom while accumulating the
+     * area they cover, instead of comparing each window with all the others.
+     * @return the visible parts of the windows, in the order of
+     *         DisplayGroup::getWindows() and in window coordinates.
+     */
+    std::vector<RectangleSet> getVisibleRegions() const;
+
 private:
     const DisplayGroup& _displayGroup;
     const QRect& _visibleArea;
     bool _alphaBlending = false;
+
+    QRectF _getUnoccludedArea(const Window& window) const;
+    bool _canBeOccluded(const Window& window) const;
+    bool _isOccluding(const Window& window) const;
+    RectangleSet _getOccludedArea(const Window& window) const;
 };
 
 #endif
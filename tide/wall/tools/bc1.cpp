@@ -0,0 +1,367 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#include "bc1.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace bc1
+{
+namespace
+{
+const size_t blockSize = 8; // bytes
+const int blockDim = 4;     // pixels
+const int powerIterations = 8;
+
+using Pixels = std::vector<uint8_t>; // RGBA, tightly packed
+
+struct Color
+{
+    float r = 0.f;
+    float g = 0.f;
+    float b = 0.f;
+};
+
+int _half(const int size)
+{
+    return std::max(1, size / 2);
+}
+
+Pixels _toRgba(const uint8_t* pixels, const int width, const int height,
+               const size_t bytesPerLine, const PixelOrder order)
+{
+    const auto swapRB = order == PixelOrder::bgra;
+    auto rgba = Pixels(size_t(width) * height * 4);
+    auto dst = rgba.data();
+    for (int y = 0; y < height; ++y)
+    {
+        const auto src = pixels + y * bytesPerLine;
+        for (int x = 0; x < width; ++x, dst += 4)
+        {
+            dst[0] = src[4 * x + (swapRB ? 2 : 0)];
+            dst[1] = src[4 * x + 1];
+            dst[2] = src[4 * x + (swapRB ? 0 : 2)];
+            dst[3] = 255;
+        }
+    }
+    return rgba;
+}
+
+Pixels _downsample(const Pixels& src, const int width, const int height)
+{
+    const auto w = _half(width);
+    const auto h = _half(height);
+    auto dst = Pixels(size_t(w) * h * 4);
+    for (int y = 0; y < h; ++y)
+    {
+        const auto y0 = std::min(2 * y, height - 1);
+        const auto y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < w; ++x)
+        {
+            const auto x0 = std::min(2 * x, width - 1);
+            const auto x1 = std::min(2 * x + 1, width - 1);
+            for (int c = 0; c < 4; ++c)
+            {
+                const auto sum = src[4 * (y0 * width + x0) + c] +
+                                 src[4 * (y0 * width + x1) + c] +
+                                 src[4 * (y1 * width + x0) + c] +
+                                 src[4 * (y1 * width + x1) + c];
+                dst[4 * (y * w + x) + c] = uint8_t((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+uint16_t _to565(const Color& c)
+{
+    const auto quantize = [](const float value, const int max) {
+        const auto q = int(std::lround(value * max / 255.f));
+        return std::min(std::max(q, 0), max);
+    };
+    return uint16_t(quantize(c.r, 31) << 11 | quantize(c.g, 63) << 5 |
+                    quantize(c.b, 31));
+}
+
+void _from565(const uint16_t c, int rgb[3])
+{
+    const auto r = (c >> 11) & 31;
+    const auto g = (c >> 5) & 63;
+    const auto b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void _makePalette(const uint16_t c0, const uint16_t c1, int palette[4][3])
+{
+    _from565(c0, palette[0]);
+    _from565(c1, palette[1]);
+    for (int i = 0; i < 3; ++i)
+    {
+        if (c0 > c1)
+        {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+        else
+        {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0; // transparent black in 3-color mode
+        }
+    }
+}
+
+/** Find the principal axis of the colors of a block by power iteration. */
+Color _getPrincipalAxis(const Color (&block)[16], const Color& mean)
+{
+    float cov[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f}; // rr rg rb gg gb bb
+    for (const auto& p : block)
+    {
+        const auto r = p.r - mean.r;
+        const auto g = p.g - mean.g;
+        const auto b = p.b - mean.b;
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+
+    auto axis = Color{1.f, 1.f, 1.f};
+    for (int i = 0; i < powerIterations; ++i)
+    {
+        const auto r = cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b;
+        const auto g = cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b;
+        const auto b = cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b;
+        const auto norm = std::max({std::abs(r), std::abs(g), std::abs(b)});
+        if (norm < 1e-6f)
+            return Color{};
+        axis = Color{r / norm, g / norm, b / norm};
+    }
+    return axis;
+}
+
+void _writeBlock(const uint16_t c0, const uint16_t c1, const uint32_t indices,
+                 uint8_t* out)
+{
+    out[0] = uint8_t(c0 & 0xff);
+    out[1] = uint8_t(c0 >> 8);
+    out[2] = uint8_t(c1 & 0xff);
+    out[3] = uint8_t(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        out[4 + i] = uint8_t(indices >> (8 * i));
+}
+
+void _encodeBlock(const Color (&block)[16], uint8_t* out)
+{
+    auto mean = Color{};
+    for (const auto& p : block)
+    {
+        mean.r += p.r / 16.f;
+        mean.g += p.g / 16.f;
+        mean.b += p.b / 16.f;
+    }
+
+    // Endpoints: extremes of the colors projected on the principal axis
+    const auto axis = _getPrincipalAxis(block, mean);
+    auto minT = 0.f;
+    auto maxT = 0.f;
+    for (const auto& p : block)
+    {
+        const auto t = (p.r - mean.r) * axis.r + (p.g - mean.g) * axis.g +
+                       (p.b - mean.b) * axis.b;
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    const auto endpoint = [&](const float t) {
+        return Color{mean.r + t * axis.r, mean.g + t * axis.g,
+                     mean.b + t * axis.b};
+    };
+    auto c0 = _to565(endpoint(maxT));
+    auto c1 = _to565(endpoint(minT));
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    if (c0 == c1) // uniform block, all pixels use color 0
+    {
+        _writeBlock(c0, c1, 0, out);
+        return;
+    }
+
+    int palette[4][3];
+    _makePalette(c0, c1, palette);
+
+    uint32_t indices = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        auto bestIndex = 0u;
+        auto bestDistance = std::numeric_limits<float>::max();
+        for (auto j = 0u; j < 4; ++j)
+        {
+            const auto r = block[i].r - palette[j][0];
+            const auto g = block[i].g - palette[j][1];
+            const auto b = block[i].b - palette[j][2];
+            const auto distance = r * r + g * g + b * b;
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestIndex = j;
+            }
+        }
+        indices |= bestIndex << (2 * i);
+    }
+    _writeBlock(c0, c1, indices, out);
+}
+
+void _encodeLevel(const Pixels& rgba, const int width, const int height,
+                  uint8_t* out)
+{
+    Color block[16];
+    for (int by = 0; by < height; by += blockDim)
+    {
+        for (int bx = 0; bx < width; bx += blockDim, out += blockSize)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                // Pixels outside the image repeat the last row / column
+                const auto x = std::min(bx + i % blockDim, width - 1);
+                const auto y = std::min(by + i / blockDim, height - 1);
+                const auto p = &rgba[4 * (size_t(y) * width + x)];
+                block[i] = Color{float(p[0]), float(p[1]), float(p[2])};
+            }
+            _encodeBlock(block, out);
+        }
+    }
+}
+}
+
+unsigned int getLevelCount(int width, int height)
+{
+    auto count = 1u;
+    while (width > 1 || height > 1)
+    {
+        width = _half(width);
+        height = _half(height);
+        ++count;
+    }
+    return count;
+}
+
+size_t getLevelSize(const int width, const int height)
+{
+    const auto blocksX = size_t(width + blockDim - 1) / blockDim;
+    const auto blocksY = size_t(height + blockDim - 1) / blockDim;
+    return blocksX * blocksY * blockSize;
+}
+
+size_t getCompressedSize(int width, int height, const unsigned int levelCount)
+{
+    size_t size = 0;
+    for (auto level = 0u; level < levelCount; ++level)
+    {
+        size += getLevelSize(width, height);
+        width = _half(width);
+        height = _half(height);
+    }
+    return size;
+}
+
+std::vector<uint8_t> encode(const uint8_t* pixels, int width, int height,
+                            const size_t bytesPerLine, const PixelOrder order,
+                            const unsigned int levelCount)
+{
+    auto output = std::vector<uint8_t>(
+        getCompressedSize(width, height, levelCount));
+    auto out = output.data();
+
+    auto rgba = _toRgba(pixels, width, height, bytesPerLine, order);
+    for (auto level = 0u; level < levelCount; ++level)
+    {
+        if (level > 0)
+        {
+            rgba = _downsample(rgba, width, height);
+            width = _half(width);
+            height = _half(height);
+        }
+        _encodeLevel(rgba, width, height, out);
+        out += getLevelSize(width, height);
+    }
+    return output;
+}
+
+std::vector<uint8_t> decode(const uint8_t* blocks, const int width,
+                            const int height)
+{
+    auto rgba = std::vector<uint8_t>(size_t(width) * height * 4);
+    for (int by = 0; by < height; by += blockDim)
+    {
+        for (int bx = 0; bx < width; bx += blockDim, blocks += blockSize)
+        {
+            const auto c0 = uint16_t(blocks[0] | blocks[1] << 8);
+            const auto c1 = uint16_t(blocks[2] | blocks[3] << 8);
+            const auto indices =
+                uint32_t(blocks[4]) | uint32_t(blocks[5]) << 8 |
+                uint32_t(blocks[6]) << 16 | uint32_t(blocks[7]) << 24;
+            int palette[4][3];
+            _makePalette(c0, c1, palette);
+
+            for (int i = 0; i < 16; ++i)
+            {
+                const auto x = bx + i % blockDim;
+                const auto y = by + i / blockDim;
+                if (x >= width || y >= height)
+                    continue;
+
+                const auto index = (indices >> (2 * i)) & 3;
+                const auto transparent = c0 <= c1 && index == 3;
+                auto p = &rgba[4 * (size_t(y) * width + x)];
+                p[0] = uint8_t(palette[index][0]);
+                p[1] = uint8_t(palette[index][1]);
+                p[2] = uint8_t(palette[index][2]);
+                p[3] = transparent ? 0 : 255;
+            }
+        }
+    }
+    return rgba;
+}
+}
@@ -0,0 +1,103 @@
+/*********************************************************************/
+/* Copyright (c) 2018, EPFL/Blue Brain Project                       */
+/*                     Raphael Dumusc <raphael.dumusc@epfl.ch>       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE  IS  PROVIDED  BY  THE  ECOLE  POLYTECHNIQUE    */
+/*    FEDERALE DE LAUSANNE  ''AS IS''  AND ANY EXPRESS OR IMPLIED    */
+/*    WARRANTIES, INCLUDING, BUT  NOT  LIMITED  TO,  THE  IMPLIED    */
+/*    WARRANTIES OF MERCHANTABILITY AND FITNESS FOR  A PARTICULAR    */
+/*    PURPOSE  ARE  DISCLAIMED.  IN  NO  EVENT  SHALL  THE  ECOLE    */
+/*    POLYTECHNIQUE  FEDERALE  DE  LAUSANNE  OR  CONTRIBUTORS  BE    */
+/*    LIABLE  FOR  ANY  DIRECT,  INDIRECT,  INCIDENTAL,  SPECIAL,    */
+/*    EXEMPLARY,  OR  CONSEQUENTIAL  DAMAGES  (INCLUDING, BUT NOT    */
+/*    LIMITED TO,  PROCUREMENT  OF  SUBSTITUTE GOODS OR SERVICES;    */
+/*    LOSS OF USE, DATA, OR  PROFITS;  OR  BUSINESS INTERRUPTION)    */
+/*    HOWEVER CAUSED AND  ON ANY THEORY OF LIABILITY,  WHETHER IN    */
+/*    CONTRACT, STRICT LIABILITY,  OR TORT  (INCLUDING NEGLIGENCE    */
+/*    OR OTHERWISE) ARISING  IN ANY WAY  OUT OF  THE USE OF  THIS    */
+/*    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.   */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of Ecole polytechnique federale de Lausanne.          */
+/*********************************************************************/
+
+#ifndef BC1_H
+#define BC1_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * CPU encoder for BC1 (S3TC DXT1) compressed textures.
+ *
+ * BC1 stores each block of 4x4 opaque pixels in 8 bytes: two RGB565 endpoints
+ * and a 2-bit index per pixel into a palette of four colors interpolated
+ * between them. This is an eighth of the size of RGBA8 textures.
+ */
+namespace bc1
+{
+/** Byte order of the input pixels, 32 bits per pixel. */
+enum class PixelOrder
+{
+    rgba,
+    bgra // QImage::Format_RGB32 and Format_ARGB32* on little endian hosts
+};
+
+/** The OpenGL format of the data: GL_COMPRESSED_RGB_S3TC_DXT1_EXT. */
+const unsigned int glFormat = 0x83F0;
+
+/** @return the number of mipmap levels of an image, down to 1x1. */
+unsigned int getLevelCount(int width, int height);
+
+/** @return the size of a compressed image level [bytes]. */
+size_t getLevelSize(int width, int height);
+
+/** @return the size of a compressed image and its first mipmap levels. */
+size_t getCompressedSize(int width, int height, unsigned int levelCount);
+
+/**
+ * Encode an opaque image.
+ *
+ * @param pixels the first row of the image, 32 bits per pixel.
+ * @param width of the image in pixels.
+ * @param height of the image in pixels.
+ * @param bytesPerLine the stride between the rows of pixels.
+ * @param order of the color channels; the alpha channel is ignored.
+ * @param levelCount the number of levels to encode. The mipmaps are generated
+ *        by successive 2x2 box filtering of the image. The levels are stored
+ *        one after the other, starting with the full-size image.
+ * @return the compressed levels, of getCompressedSize() bytes.
+ */
+std::vector<uint8_t> encode(const uint8_t* pixels, int width, int height,
+                            size_t bytesPerLine, PixelOrder order,
+                            unsigned int levelCount = 1);
+
+/**
+ * Decode a compressed image level.
+ *
+ * @param blocks the compressed level.
+ * @param width of the image in pixels.
+ * @param height of the image in pixels.
+ * @return the RGBA pixels of the image, 4 * width * height bytes.
+ */
+std::vector<uint8_t> decode(const uint8_t* blocks, int width, int height);
+}
+
+#endif